@@ -218,9 +218,114 @@
  * v3.6.109 - SPIFFS WRITE HARDENING: Added file.flush() before file.close() in all config write functions
  *            (saveCertificateToSPIFFS, save_imap_config, save_runtime_settings, chatgpt_save_config, restore
  *            handler); restore handler now checks print() return value and logs error on 0-byte write
+ * v3.6.110 - ARENA MESSAGE QUEUE: Replaced 25-slot fixed QueuedMessage array (6.5KB, 249B inline per slot) with a ring arena
+ *            of variable-length records sized to the actual message; capacity now in bytes (QUEUE_ARENA_SIZE 6KB,
+ *            64KB when PSRAM is detected), ~80 typical 60-char pages fit where 25 did before; /api 503 reports
+ *            queue_capacity_bytes/queue_bytes_free instead of max_queue_size
+ * v3.6.111 - QUEUE JOURNAL: Pending messages survive crashes, brownouts and watchdog resets; enqueue/complete
+ *            entries (seq + CRC32) are batched in RAM and appended to round-robin /qjournalN.bin segments
+ *            from loop() every 500ms, never during the transmission guard; segments are compacted to the
+ *            live queue at 8KB and replayed in order at boot (QUEUE_JOURNAL_ENABLED flag)
+ * v3.6.112 - LOCK-FREE QUEUE INGEST: Removed queue_mux; producers reserve arena space with a CAS on the tail
+ *            index and publish each record by storing its header last (release), the core 0 TX task
+ *            consumes with acquire loads and zeroes released records; message transliteration and
+ *            truncation run entirely before reservation, so no heap work happens with interrupts masked
+ * v3.6.113 - NON-BLOCKING EMR: EMR pattern is now prepended to the encoded FLEX frame and sent in the same FIFO
+ *            stream instead of a separate startTransmit + 2s busy-wait + 100ms delay; interval and pattern
+ *            configurable on the FLEX page (flex.emr_interval_s / flex.emr_pattern); TX setup/airtime/EMR
+ *            timing metrics on /status and in MQTT status payloads
+ * v3.6.114 - AIRTIME LEDGER & BUDGETS: Measured and encoded airtime tracked per frequency and per ingest source
+ *            (queued records now carry their source); per-frequency token buckets (default 45 s/min,
+ *            1800 s/hour, 0 = unlimited) charged at enqueue and settled with the measured TX time;
+ *            /api and Grafana webhook return 429 + Retry-After, MQTT rejects with a failed ack;
+ *            minute/hour utilisation on /status and in the MQTT status "airtime" object
+ * v3.6.115 - PAGE DEDUPLICATION: 64-entry FNV-1a index of capcode + frequency + text suppresses pages already
+ *            queued or sent within a per-source window (dedup.* in settings, defaults api 30s, grafana 300s,
+ *            mqtt 60s, imap 600s); /api reports status "deduplicated", Grafana results and MQTT acks flag
+ *            duplicates, suppression counters per source on /status and in MQTT status
+ * v3.6.116 - DELIVERY TRACKING: every queued page carries a message ID (MQTT id, /api id, Grafana fingerprint,
+ *            else <source>-<seq>) stored in the queue record and journal; queued/transmitting/transmitted/
+ *            failed/deduplicated events with timestamps and airtime go to a RAM ring drained by loop() into
+ *            batched MQTT delivery acks; /api "wait" long-polls until the page is transmitted or failed
+ * v3.6.117 - MQTT OUTBOX: 16-entry ordered outbox of serialized publishes replaces the single deferred status
+ *            string; statuses evict the oldest queued status when full, delivery acks back-pressure into
+ *            the event ring; flushed oldest-first outside the TX guard, optionally mirrored to
+ *            /mqtt_outbox.txt across reboots, depth/peak/drop counters on /status and in MQTT status
+ * v3.6.118 - PROMETHEUS METRICS: GET /metrics exposes lock-free fixed-bucket histograms (queue wait, encode,
+ *            FIFO refill latency, airtime, web handler, MQTT connect/publish, IMAP check, ChatGPT request)
+ *            plus TX/dedup/airtime/outbox counters, queue, heap/PSRAM and per-task stack high-water gauges;
+ *            web handler timing via a first-registered RequestHandler that stamps each request
+ * v3.6.119 - UTF-8 TRANSLITERATION: Replaced the 37-pass String::replace() accent converter with a
+ *            single-pass in-place UTF-8 decoder and a compile-time table covering Latin-1
+ *            Supplement, Latin Extended-A and common punctuation (smart quotes, dashes, ellipsis,
+ *            euro, trademark). Unmapped or malformed sequences become '?' instead of raw bytes.
+ *            Applied once in queue_submit_message() for every ingest path
+ * v3.6.120 - MESSAGE TYPE SELECTION: Withdrawn. The bundled tinyflex only builds alphanumeric
+ *            frames, so every page is still sent as alphanumeric; numeric and tone-only pages wait
+ *            for an encoder that can build them
+ * v3.6.121 - RADIO PROFILES: Frequency/power switches in the TX task go through radio_select_channel(),
+ *            which caches the SX127x FRF/PA/OCP/PA_DAC registers per channel (8 LRU slots) and
+ *            writes them back in one SPI burst. Misses use RadioLib and are captured; the cache
+ *            is flushed when the ppm correction changes. Switch time is exported on /metrics
+ * v3.6.122 - HOT TRANSMITTER: The TX task looks ahead after each page and keeps the RF amplifier
+ *            powered while the next queued page is on the same channel, and for the new
+ *            rf_amplifier_hold_ms (default 2000 ms) after the queue drains, so back-to-back pages
+ *            skip the stabilization delay. The radio still returns to standby after every page.
+ *            Turnaround and hot starts are reported on /status, MQTT status and /metrics
+ * v3.6.123 - FRAME ALIGNMENT: Optional FLEX frame scheduling. With RTC/NTP time the TX task sends
+ *            each page in the next frame its capcode listens to (home frame = capcode mod 128, then
+ *            every 2^collapse frames), compensating for the RF amp delay and EMR preamble, and
+ *            writes that cycle/frame into the frame's FIW. Of the first 8 queued pages the one whose
+ *            frame comes first goes next; a long hold is spent waiting for new work, not blocking.
+ *            Configured as flex.frame_alignment / flex.frame_collapse on the FLEX page
+ * v3.6.124 - REPEAT TRANSMISSIONS: Per-message "repeat" (0-5) and "repeat_interval" (5-3600 s) on
+ *            /api, MQTT and Grafana labels. The TX task keeps the encoded frame of the first
+ *            copy and re-sends it when due, interleaved with queued pages; copies report a
+ *            "repeated" delivery ack and count as one logical message
+ * v3.6.125 - PAGER GROUPS: Named capcode groups (8 x 16) edited on the FLEX page and addressed
+ *            with "group" on /api and MQTT or a group label in Grafana. A group page uses one
+ *            queue/journal entry and one message ID; members listening in the same frame share
+ *            one multi-address frame (one vector per address, one message), and the TX task
+ *            reports a single delivery
+ * v3.6.126 - STATIC WEB ASSETS: Shared CSS/JS moved out of get_html_header() into pre-gzipped blobs
+ *            (web_assets.h, one stylesheet per theme) served from /assets/ with ETag, 304 and
+ *            immutable Cache-Control; pages now carry only their dynamic markup
+ * v3.6.127 - WEB TASK: HTTP moved out of loop() into its own FreeRTOS task (core 1, 2 ms poll, no 20 ms
+ *            throttle). UI routes run under a recursive service lock loop() holds per iteration;
+ *            /api and /api/v1/alerts run lock-free against the queue so webhooks are accepted while
+ *            MQTT/IMAP/ChatGPT work is in progress. logMessage() serialized by log_lock, display
+ *            wake-ups from the web task deferred to loop(), queue-full 503s carry Retry-After.
+ *            An optional second listener (api.ingest_port, off by default, "Ingest" task) serves
+ *            only the ingest routes, so UI pages, log downloads and long-polls on port 80 cannot
+ *            hold webhook senders; ingest handlers read a published IngestSettings snapshot
+ * v3.6.128 - STREAMING GRAFANA INGEST: Webhook alerts walked one element at a time through a field
+ *            filter (BufferReadStream + json_walk_array), queued in batches of 8 via the new
+ *            queue_submit_batch() (one arena reservation, one TX wake-up), response streamed in
+ *            chunks; heap peak per request in the response and flex_grafana_heap_peak_bytes
+ * v3.6.129 - BATCH API: POST /api/batch takes an array of up to 32 /api message objects, validates and
+ *            airtime-admits all of them first, then queues them in one queue_submit_batch() call;
+ *            ?atomic=true for all-or-nothing. Per-item status and queue positions in the response.
+ *            /api validation moved to api_message_to_item() and shared
+ * v3.6.130 - API AUTH CACHE: Authorization headers are checked against SHA-256 digests of the
+ *            expected values, built once and compared in constant time (no per-request base64
+ *            decoding). Optional bearer token (Authorization: Bearer) configured on the API
+ *            page. flex_api_auth_seconds histogram
+ * v3.6.131 - SEGMENTED LOG STORE: The persistent log is 8 segment files written round-robin with
+ *            the head recorded in /serial.idx. Flushes are one append; rotation moves the head
+ *            and drops the oldest segment instead of copying the tail to /serial.tmp. Total size
+ *            configurable (16-256KB, default 32KB). /download_logs streams chunked.
+ *            flex_log_flush_seconds, flex_log_rotations_total, flex_log_stored_bytes
+ * v3.6.132 - INDEXED LOG QUERIES: In-RAM line index per log segment (offset + timestamp every 16
+ *            lines, rebuilt at boot) so tail/N and since-time reads seek directly. /logs takes
+ *            since/severity/prefix, streams chunked JSON (now escaped) and, like /download_logs,
+ *            runs outside service_lock. read_log_tail() builds on the same query path
+ * v3.6.133 - SYSLOG SHIPPER: logMessage() only queues syslog lines (32-entry ring, drops counted);
+ *            a low-priority task ships them over one persistent TCP connection with octet-counted
+ *            framing (RFC 5425/6587), or as UDP datagrams, in batches of 8 with reconnect backoff
+ *            1s-60s. flex_syslog_records_total, flex_syslog_queue_depth, flex_syslog_reconnects_total
 */
 
-#define CURRENT_VERSION "v3.6.109"
+#define CURRENT_VERSION "v3.6.133"
 
 /*
  * ============================================================================
@@ -265,8 +370,15 @@
  *   - Shows IMAP operations, NTP sync, RTC status, memory usage
  *   - Comment out for production builds to reduce serial traffic
  *
+ * QUEUE_JOURNAL_ENABLED (true/false):
+ *   - true:  Journal enqueue/complete events to SPIFFS (/qjournalN.bin), undelivered
+ *            messages are replayed into the queue after watchdog, brownout or crash resets
+ *   - false: Queue lives in RAM only, pending messages are lost on reset
+ *   - Uses ~16KB of SPIFFS at most (segments rotate and compact to live entries)
+ *
  */
 #define RTC_ENABLED true
+#define QUEUE_JOURNAL_ENABLED true
 #define ENABLE_IMAP
 #define ENABLE_DEBUG
 
@@ -307,13 +419,24 @@
 #include <HTTPClient.h>         // HTTP client (built-in)
 #include <SPIFFS.h>             // Flash filesystem (built-in)
 #include <vector>               // STL vector (built-in)
+#include <deque>                // STL deque (built-in)
 #include <memory>               // STL smart pointers
 #include <utility>              // STL forwarding helpers
 #include <type_traits>          // Type trait utilities for template helpers
+#include <atomic>               // Lock-free queue indices
 #include "esp_task_wdt.h"       // Watchdog timer (built-in)
+#include "esp_heap_caps.h"      // Capability-based heap allocation (PSRAM)
+#include "mbedtls/sha256.h"     // Credential digests for API authentication (built-in)
 
 #include "tinyflex/tinyflex.h"           // Project: FLEX protocol
 #include "boards/boards.h"               // Project: Board pin definitions
+#include "web_assets/web_assets.h"       // Project: Gzipped web UI stylesheets/script
+#include "api_auth/api_auth.h"           // Project: Authorization header parsing
+#include "utf8_translit/utf8_translit.h" // Project: UTF-8 to ASCII transliteration
+#include "flex_frame/flex_frame.h"       // Project: FLEX frame timing and FIW patching
+#include "syslog_format/syslog_format.h" // Project: Syslog line and frame formatting
+#include "log_time/log_time.h"           // Project: Log line timestamp parsing
+#include "queue_journal/queue_journal.h" // Project: Queue journal entry format
 
 
 #define MAX_CHATGPT_PROMPTS 10
@@ -321,9 +444,12 @@
 #define SERIAL_BAUD 115200
 
 #define TX_FREQ_DEFAULT 931.9375
+// FLEX 1600 bps 2-level only: the SX127x FSK modem has no 4-level mode, and tinyflex only
+// emits 1600/2 frames; 3200/2 is not implemented yet (docs/FIRMWARE.md)
 #define TX_BITRATE 1.6
 #define TX_DEVIATION 5
 #define TX_POWER_DEFAULT 2
+#define RF_AMP_HOLD_DEFAULT_MS 2000
 #define RX_BANDWIDTH 10.4
 #define PREAMBLE_LENGTH 0
 
@@ -370,16 +496,68 @@
 #define CONFIG_MAGIC 0xF1E7
 #define CONFIG_VERSION 3
 
-#define MAX_LOG_FILE_SIZE     32768
-#define LOG_TRUNCATE_SIZE     8192
 #define LOG_BUFFER_SIZE       2048
 #define LOG_FLUSH_INTERVAL_MS 1000
 #define LOG_FLUSH_THRESHOLD   (LOG_BUFFER_SIZE * 3 / 4)
 
+// The persistent log is a ring of LOG_SEGMENT_COUNT files written round-robin. Flushes append
+// to the head segment; once it is full the head moves on and the oldest segment is dropped,
+// so rotation never copies log data. /serial.idx records which segment is the head.
+#define LOG_SEGMENT_COUNT      8
+#define LOG_STORAGE_KB_DEFAULT 32
+#define LOG_STORAGE_KB_MIN     16
+#define LOG_STORAGE_KB_MAX     256
+#define LOG_INDEX_FILE         "/serial.idx"
+#define LOG_INDEX_TMP_FILE     "/serial.idx.tmp"   // Written first, then renamed over LOG_INDEX_FILE
+#define LOG_INDEX_MAGIC        0x4C4F4753      // "LOGS"
+#define LOG_INDEX_VERSION      1
+
+struct LogStoreIndex {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t segment_count;
+    uint8_t head;
+    uint8_t reserved;
+    uint32_t generation;            // Rotations since the store was created
+};
+
+// In-RAM line index per segment: a checkpoint every LOG_LINE_INDEX_STRIDE lines holds the line's
+// byte offset and timestamp, so tail and since-time queries seek to within a few lines of their
+// start instead of reading the log from the top. Rebuilt from the segments at boot.
+#define LOG_LINE_INDEX_STRIDE  16
+#define LOG_LINE_INDEX_POINTS  32      // Later lines in a segment are reached by reading on
+#define LOG_LINE_MAX           256     // Matches the line buffer in append_to_log_file()
+
+struct LogCheckpoint {
+    uint32_t offset;
+    uint32_t time;                  // Device-local seconds since 1970, 0 if logged before clock sync
+};
+
+struct LogSegmentLines {
+    uint16_t lines;
+    uint8_t points;
+    LogCheckpoint point[LOG_LINE_INDEX_POINTS];
+};
+
+struct LogQuery {
+    uint32_t lines;                 // Newest N lines, 0 = no limit
+    uint32_t since;                 // Device-local seconds, 0 = no limit
+    uint8_t max_severity;           // detectSeverity() level, 7 = everything
+    const char* prefix;             // Message prefix such as "MQTT:", NULL = any
+};
+
 static char     log_buffer[LOG_BUFFER_SIZE];
 static size_t   log_buffer_len    = 0;
 static uint32_t log_last_flush_ms = 0;
 
+static bool     log_store_ready = false;
+static uint8_t  log_store_head = 0;
+static uint32_t log_store_generation = 0;
+static uint32_t log_segment_limit = LOG_STORAGE_KB_DEFAULT * 1024 / LOG_SEGMENT_COUNT;
+static uint32_t log_segment_bytes[LOG_SEGMENT_COUNT];
+static uint32_t log_store_rotations = 0;
+static LogSegmentLines log_segment_lines[LOG_SEGMENT_COUNT];
+
 #define CHECK_HEAP(size) (ESP.getFreeHeap() > (size + 8192))
 
 
@@ -437,29 +615,60 @@ struct CoreConfig {
     uint8_t reserved[200];
 };
 
+#define TX_SOURCE_SLOTS 8           // Entries in per-source settings arrays, one per TxSource
+
+// Address book: a named group is queued as one page. tinyflex builds one address per frame; the
+// TX task adds the other members listening in that frame to it (flex_frame_add_addresses()),
+// so a group usually costs one page of airtime per frame used. Admission and reservation still
+// charge one page per member, since a frame the encoder lays out differently is sent to one
+// member only, and the reservation is settled against the frames actually sent.
+#define PAGER_GROUP_MAX          8
+#define PAGER_GROUP_NAME_MAX     16
+#define PAGER_GROUP_MEMBERS_MAX  16
+
+struct PagerGroup {
+    char name[PAGER_GROUP_NAME_MAX + 1];   // Empty = unused slot
+    uint8_t count;
+    uint32_t capcodes[PAGER_GROUP_MEMBERS_MAX];
+};
+
 struct DeviceSettings {
     uint8_t theme;
     char banner_message[17];
     float timezone_offset_hours;
     char ntp_server[64];
+    uint16_t log_storage_kb;        // Flash reserved for the persistent log, split into segments
     bool enable_low_battery_alert;
     bool enable_power_disconnect_alert;
     bool enable_rf_amplifier;
     uint8_t rf_amplifier_power_pin;
     uint16_t rf_amplifier_delay_ms;
+    uint16_t rf_amplifier_hold_ms;  // Keep the amp powered this long after the queue drains
     bool rf_amplifier_active_high;
     float default_frequency;
     uint64_t default_capcode;
     float default_txpower;
     float frequency_correction_ppm;
+    uint16_t emr_interval_s;
+    bool flex_frame_alignment;      // Send each page in its capcode's FLEX frame (needs RTC/NTP time)
+    uint8_t flex_frame_collapse;    // Pagers wake every 2^collapse frames, 0-7
+    uint8_t emr_pattern[8];
+    uint8_t emr_pattern_length;
+    uint16_t airtime_budget_minute_s;
+    uint16_t airtime_budget_hour_s;
+    uint16_t dedup_window_s[TX_SOURCE_SLOTS];
+    PagerGroup pager_groups[PAGER_GROUP_MAX];
     bool api_enabled;
     uint16_t http_port;
     char api_username[33];
     char api_password[65];
+    char api_token[65];             // Optional bearer token, empty = Basic auth only
+    uint16_t api_ingest_port;       // Listener serving only the ingest routes, 0 = off
     bool mqtt_enabled;
     uint32_t mqtt_boot_delay_ms;
     bool mqtt_notify_failures;
     uint32_t mqtt_retry_interval_mins;
+    bool mqtt_outbox_persist;
     bool imap_enabled;
     bool grafana_enabled;
     char mqtt_server[128];
@@ -492,6 +701,7 @@ String current_connected_ssid = "";
 #define MQTT_CA_CERT_FILE "/mqtt_ca.pem"
 #define MQTT_DEVICE_CERT_FILE "/mqtt_cert.pem"
 #define MQTT_DEVICE_KEY_FILE "/mqtt_key.pem"
+#define MQTT_OUTBOX_FILE "/mqtt_outbox.txt"
 
 #define LED_OFF()  digitalWrite(LED_PIN, LOW)
 #define LED_ON()   digitalWrite(LED_PIN, HIGH)
@@ -511,7 +721,28 @@ float current_frequency = TX_FREQ_DEFAULT;
 int8_t current_tx_power = TX_POWER_DEFAULT;
 bool current_mail_drop = false;
 
-WebServer webServer(WEB_SERVER_PORT);
+// WebServer buffers a POST body in full as the "plain" argument, but arg() returns a copy of it;
+// the ingest handlers parse the buffered body in place instead. Each listener also keeps the
+// last API credentials it verified (only its own task reads or writes them).
+class IngestWebServer : public WebServer {
+public:
+    using WebServer::WebServer;
+
+    ApiAuthCache auth_cache = {};
+
+    const String& body() const {
+        static const String empty;
+        for (int i = 0; i < _currentArgCount; i++) {
+            if (_currentArgs[i].key == "plain") {
+                return _currentArgs[i].value;
+            }
+        }
+        return empty;
+    }
+};
+
+IngestWebServer webServer(WEB_SERVER_PORT);
+IngestWebServer ingestServer(0);    // Started on settings.api_ingest_port when that is set
 
 WiFiClientSecure wifiClientSecure;
 PubSubClient mqttClient;
@@ -609,7 +840,6 @@ unsigned long boot_phase_start = 0;
 
 // Core 0 transmission task
 TaskHandle_t tx_task_handle = NULL;
-portMUX_TYPE queue_mux = portMUX_INITIALIZER_UNLOCKED;
 volatile unsigned long core0_last_heartbeat = 0;
 volatile bool display_update_requested = false;
 
@@ -649,20 +879,100 @@ volatile device_state_t device_state = STATE_IDLE;
 device_state_t previous_state = STATE_IDLE;
 unsigned long state_timeout = 0;
 
-#define MAX_QUEUE_SIZE 25
+// Message queue: lock-free MPSC ring arena of variable-length records (capacity in bytes).
+// Producers (web/MQTT/IMAP/AT on core 1) reserve space with a CAS on queue_tail and publish
+// by storing the record header last; the core 0 TX task is the only consumer of queue_head.
+#define QUEUE_ARENA_SIZE        6144
+#define QUEUE_ARENA_SIZE_PSRAM  (64 * 1024)
+
+#define QUEUE_RECORD_COMMITTED  0x80000000UL   // Header flag: record body is complete
+#define QUEUE_RECORD_WRAP       0x40000000UL   // Header flag: padding to end of arena
+#define QUEUE_RECORD_TAKEN      0x20000000UL   // Header flag: sent ahead of the head, released when the head reaches it
+#define QUEUE_RECORD_SIZE_MASK  0x0000FFFFUL
+#define QUEUE_RECORD_ALIGN      4
+#define QUEUE_MESSAGE_ID_MAX    40             // Caller-supplied delivery ID (MQTT id, API id, Grafana fingerprint)
 
 struct QueuedMessage {
+    std::atomic<uint32_t> header;   // Record size | QUEUE_RECORD_* flags, 0 = not yet published
+    uint8_t message_length;
+    int8_t power;
+    bool mail_drop;
+    uint8_t source;                 // TX_SOURCE_* ingest path
     uint32_t capcode;
     float frequency;
-    int power;
+    uint32_t seq;                   // Journal sequence number
+    uint32_t dedup_key;             // Dedup index entry holding this record, 0 = not tracked
+    uint16_t airtime_reserved_ms;   // Budget charged at enqueue, settled after TX
+    uint32_t enqueued_ms;           // millis() at enqueue (or replay), for queue wait metrics
+    uint8_t repeat;                 // Extra copies to send after the first, 0 = none
+    uint16_t repeat_interval_s;     // Spacing between copies
+    uint8_t id_length;
+    uint8_t group_count;            // Group page: member capcodes follow the message ID, 0 = capcode only
+    char message[];                 // NUL-terminated text, the NUL-terminated message ID, then group_count
+                                    // unaligned uint32_t capcodes
+};
+
+#define QUEUE_RECORD_HEADER_SIZE offsetof(QueuedMessage, message)
+#define QUEUE_RECORD_SIZE(len, id_len, members) \
+    ((uint16_t)((QUEUE_RECORD_HEADER_SIZE + (len) + 1 + (id_len) + 1 + (members) * sizeof(uint32_t) + 3) & ~3))
+#define QUEUE_RECORD_PAGE_MAX_SIZE QUEUE_RECORD_SIZE(MAX_FLEX_MESSAGE_LENGTH, QUEUE_MESSAGE_ID_MAX, 0)   // Largest single-capcode page
+
+// One page of a queue_submit_batch() call: queue_batch_prepare() fills text from the caller's
+// message, the submit fills result, seq and (when left empty) message_id
+#define QUEUE_BATCH_PENDING       0
+#define QUEUE_BATCH_QUEUED        1
+#define QUEUE_BATCH_DEDUPLICATED  2
+#define QUEUE_BATCH_FULL          3
+#define QUEUE_BATCH_SKIPPED       4       // Set by the caller before submitting: left out of the batch
+#define QUEUE_BATCH_RATE_LIMITED  5       // Airtime budget exhausted, retry_after_s is set
+
+struct QueueBatchItem {
+    uint32_t capcode;
+    const struct PagerGroup* group;         // Non-null replaces capcode
+    float frequency;
+    int8_t power;
     bool mail_drop;
-    char message[MAX_FLEX_MESSAGE_LENGTH + 1];
+    uint8_t repeat;
+    uint16_t repeat_interval_s;
+    uint8_t text_length;
+    uint8_t result;                         // QUEUE_BATCH_*
+    uint16_t record_size;                   // Working state of queue_submit_batch()
+    uint16_t airtime_reserved_ms;
+    uint32_t retry_after_s;                 // QUEUE_BATCH_RATE_LIMITED: seconds until the budget allows it
+    uint32_t hash;
+    uint32_t seq;
+    char text[MAX_FLEX_MESSAGE_LENGTH + 1];
+    char message_id[QUEUE_MESSAGE_ID_MAX + 1];
 };
 
-QueuedMessage message_queue[MAX_QUEUE_SIZE];
-volatile int queue_head = 0;
-volatile int queue_tail = 0;
-volatile int queue_count = 0;
+uint8_t* queue_arena = nullptr;
+size_t queue_arena_capacity = 0;
+bool queue_arena_in_psram = false;
+std::atomic<uint32_t> queue_head(0);                // Consumer-owned read offset
+std::atomic<uint32_t> queue_tail(0);                // Producer reservation offset
+std::atomic<int> queue_count(0);
+std::atomic<uint32_t> queue_next_seq(1);
+std::atomic<bool> queue_snapshot_active(false);     // Journal compaction is copying the arena
+std::atomic<bool> queue_release_pending(false);     // Consumer is zeroing a released record
+
+// Persistent queue journal: append-only segments, batched in RAM and flushed from loop()
+#define JOURNAL_SEGMENT_COUNT     3
+#define JOURNAL_SEGMENT_SIZE      8192
+#define JOURNAL_BUFFER_SIZE       2048
+#define JOURNAL_FLUSH_INTERVAL_MS 500
+#define JOURNAL_FLUSH_THRESHOLD   (JOURNAL_BUFFER_SIZE / 2)
+#define JOURNAL_SNAPSHOT_WAIT_TICKS 10    // Ticks compaction yields for a record release to finish
+#define JOURNAL_TAIL_MAX (MAX_FLEX_MESSAGE_LENGTH + 1 + QUEUE_MESSAGE_ID_MAX + 1 + PAGER_GROUP_MEMBERS_MAX * sizeof(uint32_t))
+
+portMUX_TYPE journal_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t  journal_buffer[JOURNAL_BUFFER_SIZE];
+static size_t   journal_buffer_len = 0;
+static bool     journal_overflow = false;
+static bool     journal_ready = false;
+static uint8_t  journal_active_segment = 0;
+static uint32_t journal_generation = 0;
+static size_t   journal_segment_bytes = 0;
+static uint32_t journal_last_flush_ms = 0;
 
 char at_buffer[AT_BUFFER_SIZE];
 int at_buffer_pos = 0;
@@ -676,7 +986,53 @@ volatile bool fifo_empty = false;
 volatile bool transmission_processing_complete = false;
 volatile bool transmission_in_progress = false;
 
-String current_message_id = "";
+// Delivery tracking: the TX task reports per-message lifecycle events into a RAM ring that
+// loop() drains into batched MQTT acks; a short history backs the /api long-poll
+#define API_BATCH_MAX             32      // Messages per POST /api/batch
+#define DELIVERY_EVENT_QUEUE_SIZE 32
+#define DELIVERY_HISTORY_SIZE     (API_BATCH_MAX * 2)   // A full batch plus the pages around it
+#define DELIVERY_PUBLISH_BATCH    8
+#define DELIVERY_WAITERS_MAX      4       // Concurrent /api long-polls
+#define API_WAIT_MAX_S            30
+#define API_TOKEN_MIN_LENGTH      16      // Shortest accepted bearer token
+
+enum DeliveryStatus {
+    DELIVERY_QUEUED = 0,
+    DELIVERY_TRANSMITTING,
+    DELIVERY_TRANSMITTED,
+    DELIVERY_FAILED,
+    DELIVERY_DEDUPLICATED,
+    DELIVERY_REPEATED               // A repeat copy went on air; the message stays "transmitted"
+};
+
+const char* const delivery_status_names[] = {
+    "queued", "transmitting", "transmitted", "failed", "deduplicated", "repeated"
+};
+
+struct DeliveryEvent {
+    uint32_t seq;                   // Queue sequence number, 0 if the page never entered the queue
+    uint32_t timestamp;             // Unix time of the transition
+    uint32_t airtime_ms;            // Measured on-air time (transmitted only)
+    uint8_t status;                 // DELIVERY_*
+    uint8_t source;                 // TX_SOURCE_*
+    char message_id[QUEUE_MESSAGE_ID_MAX + 1];
+};
+
+portMUX_TYPE delivery_mux = portMUX_INITIALIZER_UNLOCKED;
+static DeliveryEvent delivery_events[DELIVERY_EVENT_QUEUE_SIZE];
+static uint8_t  delivery_events_head = 0;
+static uint8_t  delivery_events_count = 0;
+static uint32_t delivery_events_dropped = 0;         // Since last logged
+static uint32_t delivery_events_dropped_total = 0;
+static DeliveryEvent delivery_history[DELIVERY_HISTORY_SIZE];
+static uint8_t  delivery_history_next = 0;
+
+// /api long-polls park here; delivery_event() notifies the task waiting on a settled seq
+struct DeliveryWaiter {
+    uint32_t seq;
+    TaskHandle_t task;
+};
+static DeliveryWaiter delivery_waiters[DELIVERY_WAITERS_MAX];
 
 uint8_t tx_data_buffer[2048] = {0};
 int current_tx_total_length = 0;
@@ -726,7 +1082,374 @@ static bool battery_first_check = true;
 
 unsigned long last_emr_transmission = 0;
 bool first_message_sent = false;
-const unsigned long EMR_TIMEOUT_MS = 600000UL;
+#define EMR_PATTERN_MAX_LENGTH 8
+#define EMR_INTERVAL_DEFAULT_S 600
+
+// FLEX timing (frame and cycle lengths in flex_frame.h)
+#define FLEX_COLLAPSE_DEFAULT 4
+#define FLEX_FRAME_GUARD_MS 5           // startTransmit() to first bit on air
+#define FLEX_HOLD_INLINE_MS 50          // Frame holds up to this long are waited out before keyup
+#define FLEX_LOOKAHEAD_PAGES 8          // Queued pages weighed for the next frame when aligning
+
+// TX timing metrics (written by the core 0 TX task after each transmission)
+struct TxTimingMetrics {
+    uint32_t transmissions;
+    uint32_t emr_bursts;
+    uint32_t last_setup_ms;         // Dequeue to startTransmit (retune, encode, RF amp delay)
+    uint32_t last_airtime_ms;       // startTransmit to FIFO drained, EMR included
+    uint32_t last_emr_ms;           // Airtime added by the EMR preamble, 0 if none was sent
+    uint32_t last_switch_us;        // Last frequency/power change, 0 if the page needed none
+    uint32_t profile_hits;          // Channel switches served from a cached register profile
+    uint32_t profile_misses;        // Channel switches that went through RadioLib
+    uint32_t last_turnaround_ms;    // Previous page end (or frame hold end) to this page's startTransmit, back-to-back only
+    uint32_t hot_starts;            // Pages keyed up with the RF amplifier already powered
+    uint32_t frame_aligned;         // Frames timed to start on their capcode's FLEX frame
+    uint32_t last_frame_wait_ms;    // Hold before the last aligned frame
+    uint8_t last_cycle;             // Cycle and frame the last aligned frame started in
+    uint8_t last_frame;
+    uint32_t fiw_patched;           // Aligned frames sent with their FIW set to the frame's cycle/frame
+    uint32_t fiw_unpatched;         // Aligned frames sent as encoded: no FIW found that verified
+    uint32_t repeats_sent;          // Repeat copies put on air (not counted in transmissions)
+    uint32_t repeats_skipped;       // Repeat copies dropped: no free slot or memory, or over airtime budget
+    uint32_t group_pages;           // Transmissions addressed to a pager group (one per group page)
+};
+
+TxTimingMetrics tx_metrics = {};
+
+// Repeat copies of sent pages (TX task only). Each slot keeps the encoded frame so a repeat
+// goes back on air between other queued pages without being encoded again.
+// TX_Core0 runs the page pipeline and logs from it: logMessagef() formats floats into a 200-byte
+// buffer and appends to SPIFFS under log_lock (the path SYSLOG_TASK_STACK_SIZE is sized for),
+// with TxSession/TxPage and the delivery publish below it.
+#define TX_TASK_STACK_SIZE 8192
+#define TX_TASK_STACK_LOW_WATER 1024    // Free bytes below which the TX task logs a warning once
+
+#define TX_REPEAT_SLOTS 4
+#define TX_REPEAT_MAX 5
+#define TX_REPEAT_INTERVAL_DEFAULT_S 30
+#define TX_REPEAT_INTERVAL_MIN_S 5
+#define TX_REPEAT_INTERVAL_MAX_S 3600
+
+struct TxRepeat {
+    uint8_t* frames;                // TxRepeatFrame + encoded page (no EMR) per capcode, nullptr = slot free
+    size_t frames_length;
+    uint8_t frame_count;
+    uint8_t remaining;
+    uint8_t sent;                   // Copies sent so far, the original included
+    uint8_t source;
+    int8_t power;
+    uint16_t interval_s;
+    uint32_t capcode;
+    float frequency;
+    uint32_t seq;
+    uint32_t due_ms;
+    uint32_t copy_pending;          // Bit per frame of the copy on air still to send, 0 = no copy in progress
+    uint32_t copy_airtime_ms;
+    char message_id[QUEUE_MESSAGE_ID_MAX + 1];
+};
+
+struct TxRepeatFrame {
+    uint32_t capcode;
+    uint16_t length;
+};
+
+static TxRepeat tx_repeats[TX_REPEAT_SLOTS];
+
+// Per-channel SX127x register snapshots (TX task only). The first switch to a frequency/power
+// pair goes through RadioLib and captures the result; later switches write it back directly.
+#define RADIO_PROFILE_SLOTS 8
+#define RADIO_PROFILE_BURST_LENGTH 6    // RegFrfMsb (0x06) .. RegOcp (0x0B)
+
+struct RadioProfile {
+    float frequency;                // As queued, before ppm correction
+    int8_t power;
+    bool valid;
+    uint8_t registers[RADIO_PROFILE_BURST_LENGTH];   // FRF MSB/MID/LSB, PaConfig, PaRamp, Ocp
+    uint8_t pa_dac;
+    uint32_t last_used_ms;
+};
+
+RadioProfile radio_profiles[RADIO_PROFILE_SLOTS] = {};
+float radio_profiles_ppm = 0.0;     // Correction the cached FRF values were computed with
+
+// Prometheus /metrics: fixed-bucket histograms updated with relaxed atomics, so the core 0
+// TX task records without taking a lock. Bounds are in the histogram's own unit (us or ms).
+#define METRICS_MAX_BUCKETS 12
+
+struct MetricHistogram {
+    const char* name;               // Exported as <name>_seconds
+    const char* help;
+    uint32_t unit_us;               // Microseconds per observed unit
+    uint8_t bound_count;
+    uint32_t bounds[METRICS_MAX_BUCKETS];
+    std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1];    // Non-cumulative, last is +Inf
+    std::atomic<uint64_t> sum;                                  // 64-bit: microsecond sums pass 2^32 in about an hour
+    std::atomic<uint32_t> count;
+};
+
+MetricHistogram metric_queue_wait = { "flex_queue_wait", "Time a page spent queued before the TX task picked it up", 1000, 11,
+                                      { 10, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000 } };
+MetricHistogram metric_encode = { "flex_encode", "FLEX encode time per page", 1, 10,
+                                  { 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000 } };
+MetricHistogram metric_fifo_refill = { "flex_fifo_refill_latency", "FIFO-empty interrupt to radio FIFO refill", 1, 10,
+                                       { 50, 100, 250, 500, 1000, 1500, 2000, 5000, 10000, 20000 } };
+MetricHistogram metric_radio_switch = { "flex_radio_switch", "Frequency/power change before a page", 1, 10,
+                                        { 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000 } };
+MetricHistogram metric_turnaround = { "flex_tx_turnaround", "End of one page to start of the next while the queue is busy", 1000, 10,
+                                      { 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000 } };
+MetricHistogram metric_airtime = { "flex_airtime", "Measured on-air time per page, EMR included", 1000, 10,
+                                   { 250, 500, 1000, 1500, 2000, 3000, 4000, 6000, 8000, 12000 } };
+MetricHistogram metric_web_handler = { "flex_web_handler", "HTTP request handling time", 1000, 11,
+                                       { 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000 } };
+MetricHistogram metric_mqtt_connect = { "flex_mqtt_connect", "MQTT broker connect round trip", 1000, 9,
+                                        { 100, 250, 500, 1000, 2000, 3000, 5000, 10000, 20000 } };
+MetricHistogram metric_mqtt_publish = { "flex_mqtt_publish", "MQTT publish call duration", 1000, 10,
+                                        { 1, 5, 10, 25, 50, 100, 250, 500, 1000, 5000 } };
+MetricHistogram metric_imap_check = { "flex_imap_check", "IMAP account check round trip", 1000, 9,
+                                      { 250, 500, 1000, 2500, 5000, 10000, 20000, 30000, 60000 } };
+MetricHistogram metric_api_auth = { "flex_api_auth", "API Authorization header check", 1, 8,
+                                    { 25, 50, 100, 250, 500, 1000, 2500, 5000 } };
+MetricHistogram metric_log_flush = { "flex_log_flush", "Log buffer flush to flash, segment rotation included", 1, 9,
+                                     { 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000 } };
+MetricHistogram metric_chatgpt_request = { "flex_chatgpt_request", "ChatGPT API request round trip", 1000, 8,
+                                           { 250, 500, 1000, 2500, 5000, 10000, 20000, 30000 } };
+
+volatile uint32_t fifo_empty_us = 0;          // Set by the FIFO-empty ISR
+TaskHandle_t loop_task_handle = NULL;
+
+// HTTP runs in its own task so a slow browser never stalls loop() (MQTT, IMAP, AT) and loop()
+// never stalls webhook senders. Routes registered with web_route() touch loop-owned state
+// (settings, service clients, SPIFFS config, display) and run under service_lock, which loop()
+// holds for each iteration; ingest routes register with webServer.on() directly and only touch
+// the lock-free queue, the mux-protected ledgers and the published IngestSettings, so they are
+// accepted while loop() is busy. The log readers (/logs, /download_logs) are in that lane too;
+// the log store has log_lock.
+// A WebServer handles one connection at a time, so on port 80 an ingest request still queues
+// behind a UI page waiting for service_lock, a long-poll or a log download. The optional
+// ingest listener (settings.api_ingest_port) serves only the three ingest routes from its own
+// task and never holds a connection open: it does not take service_lock and ignores "wait".
+#define WEB_TASK_STACK_SIZE          10240
+#define WEB_TASK_PRIORITY            2       // Above loopTask (1), below TX_Core0; both listeners
+#define WEB_TASK_POLL_MS             2
+#define WEB_SERVICE_LOCK_TIMEOUT_MS  5000    // UI request waits this long for loop() before 503
+#define WEB_BUSY_RETRY_AFTER_S       2
+#define QUEUE_FULL_RETRY_AFTER_S     2       // About one page of airtime for the queue to drain
+
+SemaphoreHandle_t service_lock = NULL;       // Recursive: loop() per iteration, web_route() handlers
+SemaphoreHandle_t log_lock = NULL;           // Recursive: log buffer and SPIFFS log store
+std::atomic<uint32_t> web_busy_rejections(0);
+
+// Registered ahead of every route: the WebServer asks it first for each request, so it stamps
+// the start time and declines; web_handle_client() observes the elapsed time afterwards
+class WebTimingHandler : public RequestHandler {
+public:
+    bool canHandle(HTTPMethod method, const String& uri) override {
+        (void)method;
+        (void)uri;
+        start_us = micros();
+        return false;
+    }
+
+    volatile uint32_t start_us = 0;
+};
+
+// One listener and the task polling it
+struct WebLane {
+    WebServer* server;
+    const char* task_name;
+    WebTimingHandler* timing;
+    TaskHandle_t task;
+};
+
+WebLane web_lane = { &webServer, "Web", nullptr, NULL };
+WebLane ingest_lane = { &ingestServer, "Ingest", nullptr, NULL };
+
+// The settings the ingest routes read. Those handlers run on the Web and Ingest tasks without
+// service_lock, so they never read settings: ingest_settings_publish() writes these fields and
+// the API credential digests into a free slot whenever service_lock is released and then makes
+// it current. A request pins the current slot with an IngestSettingsSnapshot for as long as it
+// runs, so neither side copies the struct or holds a lock while reading it.
+struct IngestSettings {
+    bool api_enabled;
+    bool grafana_enabled;
+    uint64_t default_capcode;
+    float default_frequency;
+    float default_txpower;
+    uint16_t dedup_window_s[TX_SOURCE_SLOTS];
+    PagerGroup pager_groups[PAGER_GROUP_MAX];
+    bool api_bearer_enabled;
+    uint8_t api_basic_digest[32];
+    uint8_t api_bearer_digest[32];
+    unsigned int api_auth_generation;   // Changes with the digests, invalidating ApiAuthCache entries
+};
+
+// The current slot, one pinned by each listener task and one for the writer to fill
+#define INGEST_SETTINGS_SLOTS 4
+
+IngestSettings ingest_settings_slots[INGEST_SETTINGS_SLOTS] = {};
+std::atomic<uint8_t> ingest_settings_current(0);
+std::atomic<uint8_t> ingest_settings_readers[INGEST_SETTINGS_SLOTS];
+
+// Pins the current IngestSettings slot. The reader count is raised before the slot is checked
+// to still be current, so ingest_settings_publish() never refills a slot a request is reading;
+// a reader that lost the race to a publish drops its count unread and takes the new slot.
+class IngestSettingsSnapshot {
+public:
+    IngestSettingsSnapshot() {
+        while (true) {
+            slot = ingest_settings_current.load();
+            ingest_settings_readers[slot].fetch_add(1);
+            if (ingest_settings_current.load() == slot) {
+                break;
+            }
+            ingest_settings_readers[slot].fetch_sub(1);
+        }
+    }
+
+    ~IngestSettingsSnapshot() {
+        ingest_settings_readers[slot].fetch_sub(1);
+    }
+
+    IngestSettingsSnapshot(const IngestSettingsSnapshot&) = delete;
+    IngestSettingsSnapshot& operator=(const IngestSettingsSnapshot&) = delete;
+
+    const IngestSettings& settings() const {
+        return ingest_settings_slots[slot];
+    }
+
+private:
+    uint8_t slot;
+};
+
+// Read-only Stream over a request body the WebServer already holds, so ArduinoJson can
+// deserialize a JSON array one element at a time instead of building the whole document
+class BufferReadStream : public Stream {
+public:
+    BufferReadStream(const char* data, size_t length) : data_(data), length_(length), position_(0) {
+        setTimeout(0);              // Never wait for more input: the buffer is all there is
+    }
+    int available() override { return (int)(length_ - position_); }
+    int read() override { return (position_ < length_) ? (uint8_t)data_[position_++] : -1; }
+    int peek() override { return (position_ < length_) ? (uint8_t)data_[position_] : -1; }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    const char* data_;
+    size_t length_;
+    size_t position_;
+};
+
+// Grafana webhook: the buffered body is walked once, one alert at a time through a field
+// filter, into a GrafanaAlert per alert (a few hundred bytes, well under the alert's JSON);
+// those are queued in batches of GRAFANA_BATCH_SIZE and the response is streamed from them
+#define GRAFANA_BATCH_SIZE        8
+#define GRAFANA_MAX_ALERTS        128     // Alerts past this are refused with "Too many alerts"
+#define GRAFANA_RESPONSE_CHUNK    1024
+
+enum GrafanaOutcomeCode : uint8_t {
+    GRAFANA_OUTCOME_QUEUED = 0,
+    GRAFANA_OUTCOME_DEDUPLICATED,
+    GRAFANA_OUTCOME_UNKNOWN_GROUP,
+    GRAFANA_OUTCOME_RATE_LIMITED,
+    GRAFANA_OUTCOME_QUEUE_FULL
+};
+
+struct GrafanaOutcome {
+    uint8_t code;                   // GrafanaOutcomeCode
+    uint32_t value;                 // Queue seq when queued, retry-after seconds when rate limited
+};
+
+struct GrafanaAlert {
+    struct QueueBatchItem item;
+    String alert_name;
+    String group_name;              // Requested group, kept for the unknown group error
+    bool truncated;
+    struct GrafanaOutcome outcome;
+};
+
+uint32_t grafana_heap_peak_last = 0;    // Heap used by the most recent webhook request
+uint32_t grafana_heap_peak_max = 0;
+
+// Airtime ledger: measured and encoded airtime per frequency and per ingest source, with
+// per-frequency token buckets (airtime_budget_minute_s / airtime_budget_hour_s, 0 = unlimited)
+#define AIRTIME_MAX_FREQUENCIES     8
+#define AIRTIME_ESTIMATE_DEFAULT_MS 1900
+#define AIRTIME_MINUTE_MS           60000UL
+#define AIRTIME_HOUR_MS             3600000UL
+#define AIRTIME_BUDGET_MINUTE_DEFAULT_S 45
+#define AIRTIME_BUDGET_HOUR_DEFAULT_S   1800
+
+enum TxSource : uint8_t {
+    TX_SOURCE_SYSTEM = 0,
+    TX_SOURCE_API,
+    TX_SOURCE_GRAFANA,
+    TX_SOURCE_MQTT,
+    TX_SOURCE_IMAP,
+    TX_SOURCE_CHATGPT,
+    TX_SOURCE_WEB,
+    TX_SOURCE_AT,
+    TX_SOURCE_COUNT
+};
+
+const char* const tx_source_names[TX_SOURCE_COUNT] = {
+    "system", "api", "grafana", "mqtt", "imap", "chatgpt", "web", "at"
+};
+
+static_assert(TX_SOURCE_COUNT == TX_SOURCE_SLOTS, "TX_SOURCE_SLOTS must match TxSource");
+
+struct AirtimeWindow {              // Sliding window from current + previous period
+    uint32_t period_start_ms;
+    uint32_t current_ms;
+    uint32_t previous_ms;
+};
+
+struct AirtimeBucket {
+    float tokens_ms;
+    uint32_t last_refill_ms;
+};
+
+struct AirtimeLedgerEntry {
+    float frequency;                // 0 = unused slot (frequency table only)
+    uint64_t airtime_ms;            // Measured startTransmit to FIFO drained
+    uint64_t encoded_ms;            // Encoded length at TX_BITRATE
+    uint32_t transmissions;
+    uint32_t last_activity_ms;
+    AirtimeWindow minute;
+    AirtimeWindow hour;
+    AirtimeBucket minute_budget;
+    AirtimeBucket hour_budget;
+};
+
+AirtimeLedgerEntry airtime_frequencies[AIRTIME_MAX_FREQUENCIES] = {};
+AirtimeLedgerEntry airtime_sources[TX_SOURCE_COUNT] = {};
+uint32_t airtime_estimate_ms = AIRTIME_ESTIMATE_DEFAULT_MS;
+uint32_t airtime_rejections = 0;
+portMUX_TYPE airtime_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Dedup index: FNV-1a hash of capcode + frequency + text. A page is a duplicate while a copy
+// is still in the queue, and for the source's window after the last copy was sent.
+#define DEDUP_INDEX_SIZE 64
+
+struct DedupEntry {
+    uint32_t hash;                  // 0 = unused
+    uint32_t last_seen_ms;          // Enqueue, then refreshed when a copy is sent
+    uint16_t queued;                // Copies in the queue, released by the TX task
+};
+
+const uint16_t dedup_default_windows_s[TX_SOURCE_COUNT] = {
+    0,      // system
+    30,     // api
+    300,    // grafana
+    60,     // mqtt
+    600,    // imap
+    0,      // chatgpt
+    0,      // web
+    0       // at
+};
+
+DedupEntry dedup_index[DEDUP_INDEX_SIZE] = {};
+uint32_t dedup_suppressed[TX_SOURCE_COUNT] = {};
+portMUX_TYPE dedup_mux = portMUX_INITIALIZER_UNLOCKED;
 
 unsigned long mqttReconnectBackoff = 10000;
 
@@ -743,8 +1466,34 @@ inline bool transmission_guard_active() {
     return TRANSMISSION_GUARD_ACTIVE();
 }
 
-static String mqtt_deferred_status_payload = "";
-static String mqtt_deferred_ack_payload = "";
+// MQTT outbox: bounded FIFO of serialized publishes held while the transmission guard is up
+// or the broker is unreachable. Only touched from loop(), so no locking.
+#define MQTT_OUTBOX_SIZE            16
+#define MQTT_OUTBOX_FLUSH_BATCH     8
+#define MQTT_OUTBOX_PERSIST_DELAY_MS 5000
+#define MQTT_OUTBOX_STATUS          'S'
+#define MQTT_OUTBOX_ACK             'A'
+
+enum MqttOutboxPolicy {
+    MQTT_OUTBOX_DROP_OLDEST = 0,    // Evict the oldest entry of the same kind (status snapshots)
+    MQTT_OUTBOX_DROP_NEWEST         // Refuse the new entry, keep what is queued (delivery acks)
+};
+
+struct MqttOutboxEntry {
+    char kind;                      // MQTT_OUTBOX_STATUS / MQTT_OUTBOX_ACK
+    String label;                   // Log text, so the payload never has to be re-parsed
+    String payload;
+};
+
+static MqttOutboxEntry mqtt_outbox[MQTT_OUTBOX_SIZE];
+static uint8_t  mqtt_outbox_head = 0;
+static uint8_t  mqtt_outbox_count = 0;
+static uint8_t  mqtt_outbox_high_water = 0;
+static uint32_t mqtt_outbox_dropped_oldest = 0;
+static uint32_t mqtt_outbox_dropped_newest = 0;
+static uint32_t mqtt_outbox_published = 0;
+static bool     mqtt_outbox_dirty = false;
+static uint32_t mqtt_outbox_changed_ms = 0;
 
 static device_state_t ntp_previous_state = STATE_IDLE;
 static bool ntp_state_active = false;
@@ -912,10 +1661,7 @@ void async_delay(unsigned long ms) {
     unsigned long start = millis();
     while ((unsigned long)(millis() - start) < ms) {
         feed_watchdog();
-        yield();
-        if (wifi_connected || ap_mode_active) {
-            webServer.handleClient();
-        }
+        delay(1);
     }
 }
 
@@ -1089,7 +1835,8 @@ void setup_watchdog() {
 }
 
 void feed_watchdog() {
-    if (watchdog_task_registered) {
+    // Only loopTask is subscribed; handlers shared with the web task call this too
+    if (watchdog_task_registered && xTaskGetCurrentTaskHandle() == loop_task_handle) {
         esp_task_wdt_reset();
     }
 }
@@ -1175,7 +1922,10 @@ void imap_scheduler_loop() {
 
         logMessagef("IMAP: Processing account %d", entry.account_id);
 
-        if (imap_check_account_clean(entry.account_id)) {
+        unsigned long check_start = millis();
+        bool checked = imap_check_account_clean(entry.account_id);
+        metrics_observe(&metric_imap_check, millis() - check_start);
+        if (checked) {
             entry.failed_attempts = 0;
             entry.next_check_time = current_time + (10 * 60000UL);
         } else {
@@ -1214,9 +1964,7 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
             int id_end = raw_msg.indexOf("\"", id_start);
             if (id_end != -1) {
                 String msg_id = raw_msg.substring(id_start, id_end);
-                if (msg_id.length() > 0) {
-                    sendDeliveryAck(msg_id, "failed");
-                }
+                delivery_event(0, msg_id.c_str(), TX_SOURCE_MQTT, DELIVERY_FAILED, 0);
             }
         }
         return;
@@ -1239,11 +1987,24 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
     bool mail_drop_from_msg = doc.containsKey("mail_drop");
     bool mail_drop = mail_drop_from_msg ? doc["mail_drop"] : false;
 
+    const PagerGroup* group = nullptr;
+    String group_name = doc["group"] | "";
+    if (group_name.length() > 0) {
+        group = pager_group_find(settings.pager_groups, group_name.c_str());
+        if (group == nullptr) {
+            logMessage("MQTT: Message rejected - unknown group '" + group_name + "'");
+            delivery_event(0, id.c_str(), TX_SOURCE_MQTT, DELIVERY_FAILED, 0);
+            return;
+        }
+        capcode = group->capcodes[0];
+    }
+
+    uint8_t repeat = constrain(doc["repeat"] | 0, 0, TX_REPEAT_MAX);
+    uint16_t repeat_interval_s = constrain(doc["repeat_interval"] | 0, 0, TX_REPEAT_INTERVAL_MAX_S);
+
     if (msg.length() == 0) {
         logMessage("MQTT: Message rejected - missing mandatory 'message' field");
-        if (id.length() > 0) {
-            sendDeliveryAck(id, "failed");
-        }
+        delivery_event(0, id.c_str(), TX_SOURCE_MQTT, DELIVERY_FAILED, 0);
         return;
     }
 
@@ -1269,8 +2030,6 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
 
     paging_message = truncate_message_with_ellipsis(paging_message);
 
-    current_message_id = id;
-
     DynamicJsonDocument debugDoc(256);
     debugDoc["type"] = type;
     debugDoc["from"] = from;
@@ -1280,7 +2039,7 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
     serializeJson(debugDoc, debugJson);
 
     String param_sources = "";
-    if (!capcode_from_msg) param_sources += "capcode=default,";
+    if (!capcode_from_msg && group == nullptr) param_sources += "capcode=default,";
     if (!frequency_from_msg) param_sources += "freq=default,";
     if (!power_from_msg) param_sources += "power=default,";
     String param_summary = "default";
@@ -1298,15 +2057,47 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
     String activity_details = "From: " + (from.length() > 0 ? from : String("MQTT")) +
                               " | Msg: " + msg_preview;
 
-    bool tx_success = queue_add_message(capcode, frequency, power, mail_drop, paging_message.c_str());
+    QueueBatchItem item = {};
+    item.capcode = (uint32_t)capcode;
+    item.group = group;
+    item.frequency = frequency;
+    item.power = (int8_t)power;
+    item.mail_drop = mail_drop;
+    item.repeat = repeat;
+    item.repeat_interval_s = repeat_interval_s;
+    strlcpy(item.message_id, id.c_str(), sizeof(item.message_id));
+    queue_batch_prepare(&item, paging_message.c_str());
+    queue_submit_batch(&item, 1, TX_SOURCE_MQTT, true);
+
+    if (item.result == QUEUE_BATCH_RATE_LIMITED) {
+        logMessagef("MQTT: Airtime budget exhausted on %.4f MHz, message id=%s rejected (retry after %u s)",
+                    frequency, id.length() ? id.c_str() : "none", (unsigned)item.retry_after_s);
+        mqtt_log_activity("Message Rejected", "Airtime budget exhausted", false,
+                          frequency, (uint32_t)(capcode & 0xFFFFFFFF));
+        mqtt_publish_status("Airtime budget exhausted - message rejected");
+        return;
+    }
+
+    bool tx_success = (item.result != QUEUE_BATCH_FULL);
+    bool deduplicated = (item.result == QUEUE_BATCH_DEDUPLICATED);
+    const char* message_id = item.message_id;
+    uint32_t seq = item.seq;
+
+    if (tx_success && deduplicated) {
+        logMessagef("MQTT: Duplicate message id=%s from=%s suppressed",
+                    id.length() ? id.c_str() : "none", from.c_str());
+        mqtt_log_activity("Message Deduplicated", activity_details.c_str(), true,
+                          frequency, (uint32_t)(capcode & 0xFFFFFFFF));
+        return;
+    }
 
     mqtt_log_activity("Message Received", activity_details.c_str(), tx_success,
                       frequency, (uint32_t)(capcode & 0xFFFFFFFF));
 
     if (tx_success) {
         char log_msg[256];
-        snprintf(log_msg, sizeof(log_msg), "MQTT: Message queued (id=%s, from=%s, capcode=%llu)",
-                 id.length() ? id.c_str() : "none", from.c_str(), capcode);
+        snprintf(log_msg, sizeof(log_msg), "MQTT: Message queued (id=%s, seq=%lu, from=%s, capcode=%llu, repeat=%u)",
+                 message_id, (unsigned long)seq, from.c_str(), capcode, (unsigned)repeat);
         logMessage(log_msg);
         char status_msg[128];
         snprintf(status_msg, sizeof(status_msg), "Message queued from %s", from.c_str());
@@ -1317,10 +2108,6 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
                  id.length() ? id.c_str() : "none", from.c_str());
         logMessage(log_msg);
         mqtt_publish_status("Queue full - message rejected");
-        if (id.length() > 0) {
-            sendDeliveryAck(id, "failed");
-        }
-        current_message_id = "";
     }
 }
 
@@ -1538,6 +2325,7 @@ bool mqtt_connect() {
 
     bool connected = mqttClient.connect(settings.mqtt_thing_name, NULL, NULL, NULL, 0, 0, NULL, false);
     unsigned long mqtt_connect_time = millis() - mqtt_connect_start;
+    metrics_observe(&metric_mqtt_connect, mqtt_connect_time);
 
     yield();
 
@@ -1735,28 +2523,56 @@ void mqtt_publish_status(const String& status) {
         return;
     }
 
-    DynamicJsonDocument doc(256);
+    DynamicJsonDocument doc(1536);
     doc["device"] = settings.mqtt_thing_name;
     doc["status"] = status;
     doc["timestamp"] = millis();
 
+    JsonObject tx = doc.createNestedObject("tx");
+    tx["transmissions"] = tx_metrics.transmissions;
+    tx["emr_bursts"] = tx_metrics.emr_bursts;
+    tx["repeats_sent"] = tx_metrics.repeats_sent;
+    tx["group_pages"] = tx_metrics.group_pages;
+    tx["repeats_skipped"] = tx_metrics.repeats_skipped;
+    tx["last_setup_ms"] = tx_metrics.last_setup_ms;
+    tx["last_airtime_ms"] = tx_metrics.last_airtime_ms;
+    tx["last_emr_ms"] = tx_metrics.last_emr_ms;
+    tx["last_switch_us"] = tx_metrics.last_switch_us;
+    tx["profile_hits"] = tx_metrics.profile_hits;
+    tx["profile_misses"] = tx_metrics.profile_misses;
+    tx["last_turnaround_ms"] = tx_metrics.last_turnaround_ms;
+    tx["hot_starts"] = tx_metrics.hot_starts;
+    tx["frame_aligned"] = tx_metrics.frame_aligned;
+    tx["last_frame_wait_ms"] = tx_metrics.last_frame_wait_ms;
+    tx["fiw_patched"] = tx_metrics.fiw_patched;
+    tx["fiw_unpatched"] = tx_metrics.fiw_unpatched;
+
+    airtime_fill_json(doc.createNestedObject("airtime"));
+    doc["deduplicated"] = dedup_suppressed_total();
+
+    JsonObject outbox = doc.createNestedObject("outbox");
+    outbox["depth"] = mqtt_outbox_count;
+    outbox["high_water"] = mqtt_outbox_high_water;
+    outbox["dropped_oldest"] = mqtt_outbox_dropped_oldest;
+    outbox["dropped_newest"] = mqtt_outbox_dropped_newest;
+    outbox["events_dropped"] = delivery_events_dropped_total;
+
     String output;
     serializeJson(doc, output);
 
-    if (transmission_guard_active()) {
-        mqtt_deferred_status_payload = output;
-        return;
-    }
-
-    if (mqttClient.connected()) {
-        if (mqttClient.publish(settings.mqtt_publish_topic, output.c_str())) {
+    // Publish directly only when nothing older is waiting, so the broker sees outbox order
+    if (!transmission_guard_active() && mqttClient.connected() && mqtt_outbox_count == 0) {
+        unsigned long publish_start = millis();
+        bool published = mqttClient.publish(settings.mqtt_publish_topic, output.c_str());
+        metrics_observe(&metric_mqtt_publish, millis() - publish_start);
+        if (published) {
+            mqtt_outbox_published++;
             logMessagef("MQTT: Status published: %s", status.c_str());
-        } else {
-            mqtt_deferred_status_payload = output;
+            return;
         }
-    } else {
-        mqtt_deferred_status_payload = output;
     }
+
+    mqtt_outbox_push(MQTT_OUTBOX_STATUS, "Status published: " + status, output, MQTT_OUTBOX_DROP_OLDEST);
 }
 
 void mqtt_send_suspension_notification() {
@@ -1772,7 +2588,7 @@ void mqtt_send_suspension_notification() {
                  " failures. Retrying every " + String(settings.mqtt_retry_interval_mins) + " minutes.";
 
     if (queue_add_message(settings.default_capcode, settings.default_frequency,
-                         settings.default_txpower, false, msg.c_str())) {
+                         settings.default_txpower, false, msg.c_str(), TX_SOURCE_SYSTEM)) {
         mqtt_failure_notification_sent = true;
         logMessage("MQTT: Suspension notification sent to pager");
     }
@@ -1802,59 +2618,157 @@ void mqtt_log_activity(const char* event, const char* details, bool success, flo
     mqtt_activity_count++;
 }
 
-void sendDeliveryAck(String messageId, String status) {
-    if (!settings.mqtt_enabled || strlen(settings.mqtt_publish_topic) == 0 || messageId.length() == 0) {
-        return;
+// =============================================================================
+// MQTT OUTBOX - Ordered, bounded publish queue with optional flash persistence
+// =============================================================================
+
+// Removes the entry at position index (0 = oldest), keeping the remaining order
+static void mqtt_outbox_remove_at(uint8_t index) {
+    for (uint8_t i = index; i + 1 < mqtt_outbox_count; i++) {
+        mqtt_outbox[(mqtt_outbox_head + i) % MQTT_OUTBOX_SIZE] =
+            std::move(mqtt_outbox[(mqtt_outbox_head + i + 1) % MQTT_OUTBOX_SIZE]);
     }
 
-    DynamicJsonDocument ackDoc(256);
-    ackDoc["type"] = "delivery_ack";
-    ackDoc["message_id"] = messageId;
-    ackDoc["status"] = status;
-    ackDoc["timestamp"] = getUnixTimestamp();
-    ackDoc["device"] = String(settings.mqtt_thing_name);
+    MqttOutboxEntry& last = mqtt_outbox[(mqtt_outbox_head + mqtt_outbox_count - 1) % MQTT_OUTBOX_SIZE];
+    last.label = "";
+    last.payload = "";
+    mqtt_outbox_count--;
+    mqtt_outbox_dirty = true;
+    mqtt_outbox_changed_ms = millis();
+}
+
+bool mqtt_outbox_push(char kind, String label, const String& payload, uint8_t policy) {
+    label.replace('\t', ' ');
+    label.replace('\n', ' ');
+
+    if (mqtt_outbox_count >= MQTT_OUTBOX_SIZE) {
+        int victim = -1;
+        if (policy == MQTT_OUTBOX_DROP_OLDEST) {
+            for (uint8_t i = 0; i < mqtt_outbox_count; i++) {
+                if (mqtt_outbox[(mqtt_outbox_head + i) % MQTT_OUTBOX_SIZE].kind == kind) {
+                    victim = i;
+                    break;
+                }
+            }
+        }
+
+        if (victim < 0) {
+            mqtt_outbox_dropped_newest++;
+            logMessagef("MQTT: Outbox full, dropped new entry (%s)", label.c_str());
+            return false;
+        }
+
+        logMessagef("MQTT: Outbox full, dropped oldest entry (%s)",
+                    mqtt_outbox[(mqtt_outbox_head + victim) % MQTT_OUTBOX_SIZE].label.c_str());
+        mqtt_outbox_remove_at((uint8_t)victim);
+        mqtt_outbox_dropped_oldest++;
+    }
 
-    String ackPayload;
-    serializeJson(ackDoc, ackPayload);
+    MqttOutboxEntry& entry = mqtt_outbox[(mqtt_outbox_head + mqtt_outbox_count) % MQTT_OUTBOX_SIZE];
+    entry.kind = kind;
+    entry.label = label;
+    entry.payload = payload;
+    mqtt_outbox_count++;
+    mqtt_outbox_high_water = max(mqtt_outbox_high_water, mqtt_outbox_count);
+    mqtt_outbox_dirty = true;
+    mqtt_outbox_changed_ms = millis();
+    return true;
+}
 
-    if (transmission_guard_active() || !mqttClient.connected()) {
-        mqtt_deferred_ack_payload = ackPayload;
+// Publishes queued entries oldest first; stops at the first failure so order is preserved
+void mqtt_outbox_flush() {
+    if (mqtt_outbox_count == 0 || !settings.mqtt_enabled || !mqttClient.connected()) {
         return;
     }
 
-    if (mqttClient.publish(settings.mqtt_publish_topic, ackPayload.c_str())) {
-        logMessagef("MQTT: Delivery ACK sent for %s (%s)", messageId.c_str(), status.c_str());
-    } else {
-        mqtt_deferred_ack_payload = ackPayload;
+    for (uint8_t sent = 0; sent < MQTT_OUTBOX_FLUSH_BATCH && mqtt_outbox_count > 0; sent++) {
+        MqttOutboxEntry& entry = mqtt_outbox[mqtt_outbox_head];
+        unsigned long publish_start = millis();
+        bool published = mqttClient.publish(settings.mqtt_publish_topic, entry.payload.c_str());
+        metrics_observe(&metric_mqtt_publish, millis() - publish_start);
+        if (!published) {
+            return;
+        }
+
+        logMessagef("MQTT: %s", entry.label.c_str());
+        entry.label = "";
+        entry.payload = "";
+        mqtt_outbox_head = (mqtt_outbox_head + 1) % MQTT_OUTBOX_SIZE;
+        mqtt_outbox_count--;
+        mqtt_outbox_published++;
+        mqtt_outbox_dirty = true;
+        mqtt_outbox_changed_ms = millis();
     }
 }
 
-void mqtt_flush_deferred() {
-    if (!settings.mqtt_enabled || !mqttClient.connected()) {
+// Mirrors the outbox to flash once it has been stable for MQTT_OUTBOX_PERSIST_DELAY_MS, so a
+// broker outage followed by a reboot does not lose queued acks. Line format: kind TAB label TAB payload
+void mqtt_outbox_persist_if_due() {
+    if (!settings.mqtt_outbox_persist || !mqtt_outbox_dirty) {
+        return;
+    }
+    if ((millis() - mqtt_outbox_changed_ms) < MQTT_OUTBOX_PERSIST_DELAY_MS) {
         return;
     }
+    mqtt_outbox_dirty = false;
 
-    if (mqtt_deferred_ack_payload.length() > 0) {
-        if (mqttClient.publish(settings.mqtt_publish_topic, mqtt_deferred_ack_payload.c_str())) {
-            DynamicJsonDocument doc(256);
-            deserializeJson(doc, mqtt_deferred_ack_payload);
-            const char* msgId = doc["message_id"];
-            const char* msgStatus = doc["status"];
-            logMessagef("MQTT: Delivery ACK sent for %s (%s)", msgId, msgStatus);
-            mqtt_deferred_ack_payload = "";
-        } else {
-            return;
+    if (mqtt_outbox_count == 0) {
+        if (SPIFFS.exists(MQTT_OUTBOX_FILE)) {
+            SPIFFS.remove(MQTT_OUTBOX_FILE);
         }
+        return;
+    }
+
+    File file = SPIFFS.open(MQTT_OUTBOX_FILE, "w");
+    if (!file) {
+        logMessage("MQTT: Failed to persist outbox");
+        return;
+    }
+
+    for (uint8_t i = 0; i < mqtt_outbox_count; i++) {
+        const MqttOutboxEntry& entry = mqtt_outbox[(mqtt_outbox_head + i) % MQTT_OUTBOX_SIZE];
+        file.print(entry.kind);
+        file.print('\t');
+        file.print(entry.label);
+        file.print('\t');
+        file.print(entry.payload);
+        file.print('\n');
+    }
+    file.close();
+}
+
+void mqtt_outbox_restore() {
+    if (!SPIFFS.exists(MQTT_OUTBOX_FILE)) {
+        return;
+    }
+
+    if (!settings.mqtt_outbox_persist) {
+        SPIFFS.remove(MQTT_OUTBOX_FILE);
+        return;
+    }
+
+    File file = SPIFFS.open(MQTT_OUTBOX_FILE, "r");
+    if (!file) {
+        return;
     }
 
-    if (mqtt_deferred_status_payload.length() > 0) {
-        if (mqttClient.publish(settings.mqtt_publish_topic, mqtt_deferred_status_payload.c_str())) {
-            DynamicJsonDocument doc(256);
-            deserializeJson(doc, mqtt_deferred_status_payload);
-            const char* statusMsg = doc["status"];
-            logMessagef("MQTT: Status published: %s", statusMsg);
-            mqtt_deferred_status_payload = "";
+    int restored = 0;
+    while (file.available()) {
+        String line = file.readStringUntil('\n');
+        int label_end = line.indexOf('\t', 2);
+        if (line.length() < 3 || line.charAt(1) != '\t' || label_end < 0) {
+            continue;
         }
+        if (mqtt_outbox_push(line.charAt(0), line.substring(2, label_end), line.substring(label_end + 1),
+                             MQTT_OUTBOX_DROP_NEWEST)) {
+            restored++;
+        }
+    }
+    file.close();
+    mqtt_outbox_dirty = false;
+
+    if (restored > 0) {
+        logMessagef("MQTT: Restored %d outbox entr%s from flash", restored, restored == 1 ? "y" : "ies");
     }
 }
 
@@ -1988,7 +2902,7 @@ bool imap_check_account_clean(uint8_t account_id) {
     std::sort(message_nums.begin(), message_nums.end());
 
     for (uint32_t msg_num : message_nums) {
-        if (queue_is_full()) {
+        if (queue_is_full(QUEUE_RECORD_PAGE_MAX_SIZE)) {
             logMessage("IMAP: Queue full, stopping message processing");
             break;
         }
@@ -2065,7 +2979,7 @@ bool process_message_clean(ReadyMailIMAP::IMAPClient& imap_client, uint32_t msg_
     float frequency = account.frequency > 0 ? account.frequency : settings.default_frequency;
     int power = settings.default_txpower;
 
-    if (queue_add_message(capcode, frequency, power, account.mail_drop, truncated_message.c_str())) {
+    if (queue_add_message(capcode, frequency, power, account.mail_drop, truncated_message.c_str(), TX_SOURCE_IMAP)) {
         logMessagef("IMAP: Message %d from '%s' subject '%s' queued", msg_num, from_str.c_str(), subject_str.c_str());
         imap_client.sendCommand("UID STORE " + String(msg_num) + " +FLAGS (\\Seen)", nullptr, true);
         return true;
@@ -2098,109 +3012,370 @@ void init_imap_scheduler() {
     logMessagef("IMAP: Scheduler initialized with %d accounts", imap_schedule.size());
 }
 
+// Remote syslog is shipped by its own low-priority task: logMessage() only copies the line into
+// a bounded ring under syslog_mux, so no caller (TX task included) waits on DNS or a socket. The
+// task keeps one TCP connection open, writes RFC 5425/6587 octet-counted frames in batches and
+// reconnects with exponential backoff; in UDP mode it sends one datagram per record. Records
+// that arrive while the ring is full are dropped and counted.
+#define SYSLOG_QUEUE_SIZE          32
+#define SYSLOG_MESSAGE_MAX         224
+#define SYSLOG_BATCH               8       // Records per TCP write / UDP burst
+#define SYSLOG_FRAME_MAX           (SYSLOG_MESSAGE_MAX + 112)
+#define SYSLOG_TASK_STACK_SIZE     6144    // connect()/DNS plus logMessage() flushing to SPIFFS
+#define SYSLOG_TASK_PRIORITY       1       // Same as loopTask, below the web and TX tasks
+#define SYSLOG_CONNECT_TIMEOUT_MS  3000
+#define SYSLOG_BACKOFF_MIN_MS      1000
+#define SYSLOG_BACKOFF_MAX_MS      60000
+
+struct SyslogRecord {
+    uint32_t timestamp;             // Unix time the line was logged
+    uint8_t severity;
+    char message[SYSLOG_MESSAGE_MAX];
+};
 
-uint8_t detectSeverity(const String& message) {
-    if (message.startsWith("ERROR:") || message.startsWith("FATAL:")) return 3;
-    if (message.startsWith("WARN:") || message.startsWith("WARNING:")) return 4;
-    if (message.startsWith("SYSTEM:") || message.startsWith("CRITICAL:")) return 2;
-    if (message.startsWith("IMAP:") || message.startsWith("MQTT:")) return 5;
-    if (message.startsWith("DEBUG:")) return 7;
+TaskHandle_t syslog_task_handle = NULL;
+portMUX_TYPE syslog_mux = portMUX_INITIALIZER_UNLOCKED;
+static SyslogRecord syslog_ring[SYSLOG_QUEUE_SIZE];
+static uint8_t  syslog_ring_head = 0;
+static uint8_t  syslog_ring_count = 0;
+static uint32_t syslog_dropped = 0;
+static uint32_t syslog_sent = 0;
+static uint32_t syslog_reconnects = 0;
+static bool     syslog_connected = false;
+
+uint8_t detectSeverity(const char* message) {
+    if (strncmp(message, "ERROR:", 6) == 0 || strncmp(message, "FATAL:", 6) == 0) return 3;
+    if (strncmp(message, "WARN:", 5) == 0 || strncmp(message, "WARNING:", 8) == 0) return 4;
+    if (strncmp(message, "SYSTEM:", 7) == 0 || strncmp(message, "CRITICAL:", 9) == 0) return 2;
+    if (strncmp(message, "IMAP:", 5) == 0 || strncmp(message, "MQTT:", 5) == 0) return 5;
+    if (strncmp(message, "DEBUG:", 6) == 0) return 7;
     return 6;
 }
 
-String formatSyslogMessage(const String& message, uint8_t severity) {
-    uint8_t priority = (16 * 8) + severity;
+uint8_t detectSeverity(const String& message) {
+    return detectSeverity(message.c_str());
+}
 
-    time_t now = time(nullptr);
+// RFC 3164 line for a record, local0 facility, the banner as host and the MAC suffix as tag
+size_t format_syslog_record(const struct SyslogRecord* record, char* out, size_t size) {
+    time_t when = record->timestamp;
     struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    char timestamp[16];
-    strftime(timestamp, sizeof(timestamp), "%b %d %H:%M:%S", &timeinfo);
-
-    String hostname = String(settings.banner_message);
-    if (hostname.length() == 0) hostname = "FLEX";
+    localtime_r(&when, &timeinfo);
 
-    return "<" + String(priority) + ">" + String(timestamp) + " " + hostname + " " + mac_suffix + ": " + message;
+    const char* hostname = (settings.banner_message[0] != '\0') ? settings.banner_message : "FLEX";
+    return syslog_format_line(out, size, record->severity, &timeinfo, hostname, mac_suffix.c_str(), record->message);
 }
 
-void sendSyslog(const String& message) {
+void syslog_enqueue(const char* message) {
+    if (syslog_task_handle == NULL) return;
     if (!settings.rsyslog_enabled) return;
-    if (strlen(settings.rsyslog_server) == 0) return;
-    if (!wifi_connected) return;
+    if (settings.rsyslog_server[0] == '\0') return;
 
     uint8_t severity = detectSeverity(message);
     if (severity > settings.rsyslog_min_severity) return;
 
-    String syslogMsg = formatSyslogMessage(message, severity);
+    uint32_t now = time(nullptr);
 
-    if (settings.rsyslog_use_tcp) {
-        WiFiClient client;
-        if (client.connect(settings.rsyslog_server, settings.rsyslog_port)) {
-            client.print(syslogMsg);
-            client.stop();
-        }
+    // Filled in place: logMessage() runs on the TX task too, whose stack is small
+    portENTER_CRITICAL(&syslog_mux);
+    if (syslog_ring_count < SYSLOG_QUEUE_SIZE) {
+        SyslogRecord* record = &syslog_ring[(syslog_ring_head + syslog_ring_count) % SYSLOG_QUEUE_SIZE];
+        record->timestamp = now;
+        record->severity = severity;
+        strlcpy(record->message, message, sizeof(record->message));
+        syslog_ring_count++;
     } else {
-        WiFiUDP udp;
-        udp.beginPacket(settings.rsyslog_server, settings.rsyslog_port);
-        udp.print(syslogMsg);
-        udp.endPacket();
+        syslog_dropped++;
     }
-}
+    portEXIT_CRITICAL(&syslog_mux);
 
-
-float apply_frequency_correction(float base_freq) {
-    return base_freq * (1.0 + settings.frequency_correction_ppm / 1000000.0);
+    xTaskNotifyGive(syslog_task_handle);
 }
 
-
-void logMessage(const char* message) {
-    Serial.println(message);
-    append_to_log_file(message);
-    sendSyslog(String(message));
+static uint8_t syslog_take(struct SyslogRecord* batch, uint8_t max_count) {
+    uint8_t count = 0;
+    portENTER_CRITICAL(&syslog_mux);
+    while (count < max_count && count < syslog_ring_count) {
+        batch[count] = syslog_ring[(syslog_ring_head + count) % SYSLOG_QUEUE_SIZE];
+        count++;
+    }
+    syslog_ring_head = (syslog_ring_head + count) % SYSLOG_QUEUE_SIZE;
+    syslog_ring_count -= count;
+    portEXIT_CRITICAL(&syslog_mux);
+    return count;
 }
 
-void logMessage(const String& message) {
-    logMessage(message.c_str());
-}
+void syslog_task(void* parameter) {
+    (void)parameter;
 
-void logMessagef(const char* format, ...) {
-    va_list args;
-    va_start(args, format);
+    static SyslogRecord batch[SYSLOG_BATCH];
+    static char frames[SYSLOG_BATCH * (SYSLOG_FRAME_MAX + 6)];
+    WiFiClient tcp;
+    WiFiUDP udp;
+    IPAddress server_ip;
+    bool resolved = false;
+    uint8_t pending = 0;            // Taken from the ring but not yet delivered
+    uint32_t backoff_ms = 0;
+    uint32_t retry_at = 0;
+    bool progressed = false;        // Last pass delivered a batch, so go straight on to the next
 
-    char buffer[200];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    buffer[sizeof(buffer) - 1] = '\0';
+    char server[sizeof(settings.rsyslog_server)] = "";
+    uint16_t port = 0;
+    bool use_tcp = false;
 
-    va_end(args);
+    while (true) {
+        if (pending == 0 && syslog_ring_count == 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        } else if (!progressed) {
+            vTaskDelay(pdMS_TO_TICKS(100));
+        }
+        progressed = false;
+
+        if (!settings.rsyslog_enabled || settings.rsyslog_server[0] == '\0') {
+            portENTER_CRITICAL(&syslog_mux);
+            syslog_ring_head = 0;
+            syslog_ring_count = 0;
+            portEXIT_CRITICAL(&syslog_mux);
+            pending = 0;
+            tcp.stop();
+            syslog_connected = false;
+            continue;
+        }
 
-    logMessage(buffer);
-}
+        // Settings changed on the web page: drop the connection and resolve again
+        if (strcmp(server, settings.rsyslog_server) != 0 || port != settings.rsyslog_port ||
+            use_tcp != settings.rsyslog_use_tcp) {
+            strlcpy(server, settings.rsyslog_server, sizeof(server));
+            port = settings.rsyslog_port;
+            use_tcp = settings.rsyslog_use_tcp;
+            tcp.stop();
+            syslog_connected = false;
+            resolved = false;
+            backoff_ms = 0;
+        }
 
-bool save_core_config() {
-    logMessagef("CONFIG: Saving core config - magic=0x%X, version=%d",
-                  core_config.magic, core_config.version);
-    logMessagef("CONFIG: CoreConfig struct size: %d bytes", sizeof(CoreConfig));
+        if (!wifi_connected) {
+            if (syslog_connected) {
+                tcp.stop();
+                syslog_connected = false;
+            }
+            continue;
+        }
+        if (backoff_ms > 0 && (int32_t)(millis() - retry_at) < 0) {
+            continue;
+        }
 
-    if (!preferences.begin("flex-fsk", false)) {
-        logMessage("CONFIG: Failed to open preferences for writing");
-        return false;
-    }
+        if (pending == 0) {
+            pending = syslog_take(batch, SYSLOG_BATCH);
+        }
+        if (pending == 0) {
+            continue;
+        }
 
-    size_t bytes_written = preferences.putBytes("config", &core_config, sizeof(CoreConfig));
-    bool result = (bytes_written == sizeof(CoreConfig));
+        bool ok = resolved || WiFi.hostByName(server, server_ip);
+        resolved = ok;
 
-    preferences.end();
+        if (ok && use_tcp && !tcp.connected()) {
+            tcp.stop();
+            ok = tcp.connect(server_ip, port, SYSLOG_CONNECT_TIMEOUT_MS);
+            if (ok) {
+                tcp.setNoDelay(true);
+                syslog_reconnects++;
+            }
+        }
 
-    logMessagef("CONFIG: Preferences write: %s (%d bytes)", result ? "SUCCESS" : "FAILED", bytes_written);
+        if (ok && use_tcp) {
+            size_t length = 0;
+            for (uint8_t i = 0; i < pending; i++) {
+                char line[SYSLOG_FRAME_MAX];
+                size_t line_length = format_syslog_record(&batch[i], line, sizeof(line));
+                length += syslog_frame_octets(frames + length, sizeof(frames) - length, line, line_length);
+            }
+            ok = (tcp.write((const uint8_t*)frames, length) == length);
+        } else if (ok) {
+            for (uint8_t i = 0; i < pending && ok; i++) {
+                char line[SYSLOG_FRAME_MAX];
+                size_t line_length = format_syslog_record(&batch[i], line, sizeof(line));
+                ok = udp.beginPacket(server_ip, port) && udp.write((const uint8_t*)line, line_length) == line_length &&
+                     udp.endPacket();
+            }
+        }
 
-    return result;
+        if (ok) {
+            syslog_sent += pending;
+            pending = 0;
+            backoff_ms = 0;
+            progressed = true;
+            if (!syslog_connected) {
+                syslog_connected = true;
+                logMessagef("SYSLOG: Shipping to %s:%u over %s", server, port, use_tcp ? "TCP" : "UDP");
+            }
+        } else {
+            // The batch is kept and retried; new lines wait in the ring meanwhile
+            tcp.stop();
+            resolved = false;
+            backoff_ms = (backoff_ms == 0) ? SYSLOG_BACKOFF_MIN_MS : min(backoff_ms * 2, (uint32_t)SYSLOG_BACKOFF_MAX_MS);
+            retry_at = millis() + backoff_ms;
+            if (syslog_connected) {
+                syslog_connected = false;
+                logMessagef("SYSLOG: %s:%u unreachable, retrying with backoff", server, port);
+            }
+        }
+    }
 }
 
-bool load_core_config() {
-    if (!preferences.begin("flex-fsk", true)) {
-        logMessage("CONFIG: Failed to open preferences for reading, using defaults");
-        load_default_core_config();
-        save_core_config();
+void init_syslog_task() {
+    xTaskCreatePinnedToCore(
+        syslog_task,
+        "Syslog",
+        SYSLOG_TASK_STACK_SIZE,
+        NULL,
+        SYSLOG_TASK_PRIORITY,
+        &syslog_task_handle,
+        1
+    );
+}
+
+
+float apply_frequency_correction(float base_freq) {
+    return base_freq * (1.0 + settings.frequency_correction_ppm / 1000000.0);
+}
+
+// Stores the radio's current FRF/PA registers as the profile for frequency/power
+void radio_profile_capture(float frequency, int8_t power) {
+    RadioProfile* slot = &radio_profiles[0];
+    for (int i = 0; i < RADIO_PROFILE_SLOTS; i++) {
+        if (!radio_profiles[i].valid) {
+            slot = &radio_profiles[i];
+            break;
+        }
+        if (radio_profiles[i].last_used_ms < slot->last_used_ms) {
+            slot = &radio_profiles[i];
+        }
+    }
+
+    Module* mod = radio.getMod();
+    mod->SPIreadRegisterBurst(RADIOLIB_SX127X_REG_FRF_MSB, RADIO_PROFILE_BURST_LENGTH, slot->registers);
+    slot->pa_dac = mod->SPIreadRegister(RADIOLIB_SX1278_REG_PA_DAC);
+    slot->frequency = frequency;
+    slot->power = power;
+    slot->last_used_ms = millis();
+    slot->valid = true;
+    radio_profiles_ppm = settings.frequency_correction_ppm;
+}
+
+// Retunes the radio to frequency/power if either differs from the current channel. Cached
+// profiles are written in one SPI burst plus the PA DAC register; a miss falls back to RadioLib
+// and is captured for next time. Must be called in standby, from the TX task.
+//
+// A cache hit leaves RadioLib's own copy of the frequency behind. Nothing here reads it back:
+// setFrequency()/setOutputPower() always recompute and write the registers rather than compare
+// against the cached value, and the only readers of it are LoRa/RSSI helpers this FSK-only
+// firmware never calls. current_tx_frequency/tx_power are the source of truth for channel state.
+bool radio_select_channel(float frequency, int8_t power) {
+    bool frequency_changed = fabs(frequency - current_tx_frequency) > 0.0001;
+    bool power_changed = fabs(power - tx_power) > 0.1;
+    if (!frequency_changed && !power_changed) {
+        tx_metrics.last_switch_us = 0;
+        return true;
+    }
+
+    uint32_t start_us = micros();
+
+    if (radio_profiles_ppm != settings.frequency_correction_ppm) {
+        for (int i = 0; i < RADIO_PROFILE_SLOTS; i++) {
+            radio_profiles[i].valid = false;
+        }
+    }
+
+    for (int i = 0; i < RADIO_PROFILE_SLOTS; i++) {
+        RadioProfile* profile = &radio_profiles[i];
+        if (profile->valid && profile->power == power && fabs(profile->frequency - frequency) <= 0.0001) {
+            Module* mod = radio.getMod();
+            mod->SPIwriteRegisterBurst(RADIOLIB_SX127X_REG_FRF_MSB, profile->registers, RADIO_PROFILE_BURST_LENGTH);
+            mod->SPIwriteRegister(RADIOLIB_SX1278_REG_PA_DAC, profile->pa_dac);
+            profile->last_used_ms = millis();
+            current_tx_frequency = frequency;
+            tx_power = power;
+            tx_metrics.profile_hits++;
+            tx_metrics.last_switch_us = micros() - start_us;
+            metrics_observe(&metric_radio_switch, tx_metrics.last_switch_us);
+            return true;
+        }
+    }
+
+    if (frequency_changed) {
+        if (radio.setFrequency(apply_frequency_correction(frequency)) != RADIOLIB_ERR_NONE) {
+            return false;
+        }
+        current_tx_frequency = frequency;
+    }
+    if (power_changed) {
+        if (radio.setOutputPower(power) != RADIOLIB_ERR_NONE) {
+            return false;
+        }
+        tx_power = power;
+    }
+
+    radio_profile_capture(frequency, power);
+    tx_metrics.profile_misses++;
+    tx_metrics.last_switch_us = micros() - start_us;
+    metrics_observe(&metric_radio_switch, tx_metrics.last_switch_us);
+    return true;
+}
+
+
+void logMessage(const char* message) {
+    // Called from loop(), the web task and the TX task
+    if (log_lock != NULL) xSemaphoreTakeRecursive(log_lock, portMAX_DELAY);
+    Serial.println(message);
+    append_to_log_file(message);
+    syslog_enqueue(message);
+    if (log_lock != NULL) xSemaphoreGiveRecursive(log_lock);
+}
+
+void logMessage(const String& message) {
+    logMessage(message.c_str());
+}
+
+void logMessagef(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    char buffer[200];
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    va_end(args);
+
+    logMessage(buffer);
+}
+
+bool save_core_config() {
+    logMessagef("CONFIG: Saving core config - magic=0x%X, version=%d",
+                  core_config.magic, core_config.version);
+    logMessagef("CONFIG: CoreConfig struct size: %d bytes", sizeof(CoreConfig));
+
+    if (!preferences.begin("flex-fsk", false)) {
+        logMessage("CONFIG: Failed to open preferences for writing");
+        return false;
+    }
+
+    size_t bytes_written = preferences.putBytes("config", &core_config, sizeof(CoreConfig));
+    bool result = (bytes_written == sizeof(CoreConfig));
+
+    preferences.end();
+
+    logMessagef("CONFIG: Preferences write: %s (%d bytes)", result ? "SUCCESS" : "FAILED", bytes_written);
+
+    return result;
+}
+
+bool load_core_config() {
+    if (!preferences.begin("flex-fsk", true)) {
+        logMessage("CONFIG: Failed to open preferences for reading, using defaults");
+        load_default_core_config();
+        save_core_config();
         return false;
     }
 
@@ -2385,13 +3560,14 @@ bool save_runtime_settings() {
         return false;
     }
 
-    DynamicJsonDocument doc(4096);
+    DynamicJsonDocument doc(6144);
 
     JsonObject device = doc.createNestedObject("device");
     device["theme"] = settings.theme;
     device["banner_message"] = settings.banner_message;
     device["timezone_offset_hours"] = settings.timezone_offset_hours;
     device["ntp_server"] = settings.ntp_server;
+    device["log_storage_kb"] = settings.log_storage_kb;
 
     JsonObject alerts = doc.createNestedObject("alerts");
     alerts["low_battery"] = settings.enable_low_battery_alert;
@@ -2401,6 +3577,7 @@ bool save_runtime_settings() {
     rf_amp["enabled"] = settings.enable_rf_amplifier;
     rf_amp["power_pin"] = settings.rf_amplifier_power_pin;
     rf_amp["delay_ms"] = settings.rf_amplifier_delay_ms;
+    rf_amp["hold_ms"] = settings.rf_amplifier_hold_ms;
     rf_amp["active_high"] = settings.rf_amplifier_active_high;
 
     JsonObject flex = doc.createNestedObject("flex");
@@ -2408,18 +3585,34 @@ bool save_runtime_settings() {
     flex["default_capcode"] = String(settings.default_capcode);
     flex["default_txpower"] = settings.default_txpower;
     flex["frequency_correction_ppm"] = settings.frequency_correction_ppm;
+    flex["emr_interval_s"] = settings.emr_interval_s;
+    flex["frame_alignment"] = settings.flex_frame_alignment;
+    flex["frame_collapse"] = settings.flex_frame_collapse;
+    flex["emr_pattern"] = emr_pattern_to_hex(settings.emr_pattern, settings.emr_pattern_length);
+    flex["airtime_budget_minute_s"] = settings.airtime_budget_minute_s;
+    flex["airtime_budget_hour_s"] = settings.airtime_budget_hour_s;
+
+    JsonObject dedup = doc.createNestedObject("dedup");
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        dedup[tx_source_names[i]] = settings.dedup_window_s[i];
+    }
+
+    pager_groups_to_json(settings.pager_groups, doc.createNestedObject("groups"));
 
     JsonObject api = doc.createNestedObject("api");
     api["enabled"] = settings.api_enabled;
     api["http_port"] = settings.http_port;
     api["username"] = settings.api_username;
     api["password"] = base64_encode_string(String(settings.api_password));
+    api["token"] = base64_encode_string(String(settings.api_token));
+    api["ingest_port"] = settings.api_ingest_port;
 
     JsonObject services = doc.createNestedObject("services");
     services["mqtt_enabled"] = settings.mqtt_enabled;
     services["mqtt_boot_delay_ms"] = settings.mqtt_boot_delay_ms;
     services["mqtt_notify_failures"] = settings.mqtt_notify_failures;
     services["mqtt_retry_interval_mins"] = settings.mqtt_retry_interval_mins;
+    services["mqtt_outbox_persist"] = settings.mqtt_outbox_persist;
     services["imap_enabled"] = settings.imap_enabled;
     services["grafana_enabled"] = settings.grafana_enabled;
 
@@ -2482,7 +3675,7 @@ bool load_runtime_settings() {
         return false;
     }
 
-    DynamicJsonDocument doc(4096);
+    DynamicJsonDocument doc(6144);
     DeserializationError error = deserializeJson(doc, file);
     file.close();
 
@@ -2501,6 +3694,7 @@ bool load_runtime_settings() {
         strlcpy(settings.banner_message, device["banner_message"] | "flex-fsk-tx", sizeof(settings.banner_message));
         settings.timezone_offset_hours = device["timezone_offset_hours"] | 0.0;
         strlcpy(settings.ntp_server, device["ntp_server"] | "pool.ntp.org", sizeof(settings.ntp_server));
+        settings.log_storage_kb = constrain(device["log_storage_kb"] | LOG_STORAGE_KB_DEFAULT, LOG_STORAGE_KB_MIN, LOG_STORAGE_KB_MAX);
     }
 
     if (doc.containsKey("alerts")) {
@@ -2514,6 +3708,7 @@ bool load_runtime_settings() {
         settings.enable_rf_amplifier = rf_amp["enabled"] | false;
         settings.rf_amplifier_power_pin = rf_amp["power_pin"] | RFAMP_PWR_PIN;
         settings.rf_amplifier_delay_ms = rf_amp["delay_ms"] | 200;
+        settings.rf_amplifier_hold_ms = rf_amp["hold_ms"] | RF_AMP_HOLD_DEFAULT_MS;
         settings.rf_amplifier_active_high = rf_amp["active_high"] | true;
     }
 
@@ -2523,8 +3718,23 @@ bool load_runtime_settings() {
         settings.default_capcode = strtoull(flex["default_capcode"] | "37137", nullptr, 10);
         settings.default_txpower = flex["default_txpower"] | 10.0;
         settings.frequency_correction_ppm = flex["frequency_correction_ppm"] | 0.0;
+        settings.emr_interval_s = flex["emr_interval_s"] | EMR_INTERVAL_DEFAULT_S;
+        settings.flex_frame_alignment = flex["frame_alignment"] | false;
+        settings.flex_frame_collapse = min((int)(flex["frame_collapse"] | FLEX_COLLAPSE_DEFAULT), FLEX_COLLAPSE_MAX);
+        if (!parse_emr_pattern(flex["emr_pattern"] | "A55AA55A", settings.emr_pattern, &settings.emr_pattern_length)) {
+            parse_emr_pattern("A55AA55A", settings.emr_pattern, &settings.emr_pattern_length);
+        }
+        // Settings saved before budgets existed keep transmitting unthrottled
+        settings.airtime_budget_minute_s = flex["airtime_budget_minute_s"] | 0;
+        settings.airtime_budget_hour_s = flex["airtime_budget_hour_s"] | 0;
+    }
+
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        settings.dedup_window_s[i] = doc["dedup"][tx_source_names[i]] | dedup_default_windows_s[i];
     }
 
+    pager_groups_from_json(doc["groups"].as<JsonObject>(), settings.pager_groups);
+
     if (doc.containsKey("api")) {
         JsonObject api = doc["api"];
         settings.api_enabled = api["enabled"] | true;
@@ -2532,6 +3742,9 @@ bool load_runtime_settings() {
         strlcpy(settings.api_username, api["username"] | "admin", sizeof(settings.api_username));
         String decoded_password = base64_decode_string(api["password"] | "");
         strlcpy(settings.api_password, decoded_password.c_str(), sizeof(settings.api_password));
+        String decoded_token = base64_decode_string(api["token"] | "");
+        strlcpy(settings.api_token, decoded_token.c_str(), sizeof(settings.api_token));
+        settings.api_ingest_port = api["ingest_port"] | 0;
     }
 
     if (doc.containsKey("services")) {
@@ -2540,6 +3753,7 @@ bool load_runtime_settings() {
         settings.mqtt_boot_delay_ms = services["mqtt_boot_delay_ms"] | 0;
         settings.mqtt_notify_failures = services["mqtt_notify_failures"] | true;
         settings.mqtt_retry_interval_mins = services["mqtt_retry_interval_mins"] | 60;
+        settings.mqtt_outbox_persist = services["mqtt_outbox_persist"] | true;
         settings.imap_enabled = services["imap_enabled"] | true;
         settings.grafana_enabled = services["grafana_enabled"] | true;
     }
@@ -2625,6 +3839,7 @@ void load_default_settings() {
     strlcpy(settings.banner_message, "flex-fsk-tx", sizeof(settings.banner_message));
     settings.timezone_offset_hours = 0.0;
     strlcpy(settings.ntp_server, "pool.ntp.org", sizeof(settings.ntp_server));
+    settings.log_storage_kb = LOG_STORAGE_KB_DEFAULT;
 
     settings.enable_low_battery_alert = true;
     settings.enable_power_disconnect_alert = true;
@@ -2632,6 +3847,7 @@ void load_default_settings() {
     settings.enable_rf_amplifier = false;
     settings.rf_amplifier_power_pin = RFAMP_PWR_PIN;
     settings.rf_amplifier_delay_ms = 200;
+    settings.rf_amplifier_hold_ms = RF_AMP_HOLD_DEFAULT_MS;
     settings.rf_amplifier_active_high = true;
 
     settings.default_frequency = 931.9375;
@@ -2640,16 +3856,27 @@ void load_default_settings() {
     settings.frequency_correction_ppm = (core_config.frequency_correction_ppm != 0.0)
         ? core_config.frequency_correction_ppm
         : 0.0;
+    settings.emr_interval_s = EMR_INTERVAL_DEFAULT_S;
+    settings.flex_frame_alignment = false;
+    settings.flex_frame_collapse = FLEX_COLLAPSE_DEFAULT;
+    parse_emr_pattern("A55AA55A", settings.emr_pattern, &settings.emr_pattern_length);
+    settings.airtime_budget_minute_s = AIRTIME_BUDGET_MINUTE_DEFAULT_S;
+    settings.airtime_budget_hour_s = AIRTIME_BUDGET_HOUR_DEFAULT_S;
+    memcpy(settings.dedup_window_s, dedup_default_windows_s, sizeof(settings.dedup_window_s));
+    memset(settings.pager_groups, 0, sizeof(settings.pager_groups));
 
     settings.api_enabled = true;
     settings.http_port = 80;
     strlcpy(settings.api_username, "admin", sizeof(settings.api_username));
     strlcpy(settings.api_password, "passw0rd", sizeof(settings.api_password));
+    settings.api_token[0] = '\0';
+    settings.api_ingest_port = 0;
 
     settings.mqtt_enabled = false;
     settings.mqtt_boot_delay_ms = 0;
     settings.mqtt_notify_failures = true;
     settings.mqtt_retry_interval_mins = 60;
+    settings.mqtt_outbox_persist = true;
     settings.imap_enabled = true;
     settings.grafana_enabled = true;
 
@@ -2927,6 +4154,7 @@ String export_user_backup() {
     device["banner_message"] = String(settings.banner_message);
     device["timezone_offset_hours"] = settings.timezone_offset_hours;
     device["ntp_server"] = String(settings.ntp_server);
+    device["log_storage_kb"] = settings.log_storage_kb;
 
     JsonObject wifi = cfg.createNestedObject("wifi");
     for (int i = 0; i < stored_networks_count; i++) {
@@ -2947,6 +4175,7 @@ String export_user_backup() {
     rf_amp["enabled"] = settings.enable_rf_amplifier;
     rf_amp["power_pin"] = settings.rf_amplifier_power_pin;
     rf_amp["delay_ms"] = settings.rf_amplifier_delay_ms;
+    rf_amp["hold_ms"] = settings.rf_amplifier_hold_ms;
     rf_amp["active_high"] = settings.rf_amplifier_active_high;
 
     JsonObject flex = cfg.createNestedObject("flex");
@@ -2954,12 +4183,27 @@ String export_user_backup() {
     flex["default_capcode"] = String(settings.default_capcode);
     flex["default_txpower"] = settings.default_txpower;
     flex["frequency_correction_ppm"] = settings.frequency_correction_ppm;
+    flex["emr_interval_s"] = settings.emr_interval_s;
+    flex["frame_alignment"] = settings.flex_frame_alignment;
+    flex["frame_collapse"] = settings.flex_frame_collapse;
+    flex["emr_pattern"] = emr_pattern_to_hex(settings.emr_pattern, settings.emr_pattern_length);
+    flex["airtime_budget_minute_s"] = settings.airtime_budget_minute_s;
+    flex["airtime_budget_hour_s"] = settings.airtime_budget_hour_s;
+
+    JsonObject dedup = cfg.createNestedObject("dedup");
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        dedup[tx_source_names[i]] = settings.dedup_window_s[i];
+    }
+
+    pager_groups_to_json(settings.pager_groups, cfg.createNestedObject("groups"));
 
     JsonObject api = cfg.createNestedObject("api");
     api["enable"] = settings.api_enabled;
     api["http_port"] = settings.http_port;
     api["username"] = String(settings.api_username);
     api["password"] = base64_encode_string(String(settings.api_password));
+    api["token"] = base64_encode_string(String(settings.api_token));
+    api["ingest_port"] = settings.api_ingest_port;
 
     JsonObject grafana = cfg.createNestedObject("grafana");
     grafana["enable"] = settings.grafana_enabled;
@@ -2973,6 +4217,7 @@ String export_user_backup() {
     mqtt["publish_topic"] = String(settings.mqtt_publish_topic);
     mqtt["notify_failures"] = settings.mqtt_notify_failures;
     mqtt["retry_interval_mins"] = settings.mqtt_retry_interval_mins;
+    mqtt["outbox_persist"] = settings.mqtt_outbox_persist;
 
     JsonObject certs = mqtt.createNestedObject("certificates_b64");
 
@@ -3083,6 +4328,8 @@ bool import_user_backup(const String& json_string, String& error_msg) {
             temp_settings.timezone_offset_hours = device["timezone_offset_hours"];
         if (device.containsKey("ntp_server"))
             strncpy(temp_settings.ntp_server, device["ntp_server"].as<String>().c_str(), sizeof(temp_settings.ntp_server) - 1);
+        if (device.containsKey("log_storage_kb"))
+            temp_settings.log_storage_kb = constrain(device["log_storage_kb"].as<int>(), LOG_STORAGE_KB_MIN, LOG_STORAGE_KB_MAX);
     }
 
     if (cfg.containsKey("wifi")) {
@@ -3153,6 +4400,8 @@ bool import_user_backup(const String& json_string, String& error_msg) {
             temp_settings.rf_amplifier_power_pin = rf_amp["power_pin"];
         if (rf_amp.containsKey("delay_ms"))
             temp_settings.rf_amplifier_delay_ms = rf_amp["delay_ms"];
+        if (rf_amp.containsKey("hold_ms"))
+            temp_settings.rf_amplifier_hold_ms = rf_amp["hold_ms"];
         if (rf_amp.containsKey("active_high"))
             temp_settings.rf_amplifier_active_high = rf_amp["active_high"];
     }
@@ -3178,6 +4427,30 @@ bool import_user_backup(const String& json_string, String& error_msg) {
                 temp_settings.frequency_correction_ppm = 0.0;
             }
         }
+        if (flex.containsKey("emr_interval_s"))
+            temp_settings.emr_interval_s = constrain((long)flex["emr_interval_s"], 0L, 3600L);
+        if (flex.containsKey("frame_alignment"))
+            temp_settings.flex_frame_alignment = flex["frame_alignment"];
+        if (flex.containsKey("frame_collapse"))
+            temp_settings.flex_frame_collapse = min((int)flex["frame_collapse"], FLEX_COLLAPSE_MAX);
+        if (flex.containsKey("emr_pattern"))
+            parse_emr_pattern(flex["emr_pattern"] | "", temp_settings.emr_pattern, &temp_settings.emr_pattern_length);
+        if (flex.containsKey("airtime_budget_minute_s"))
+            temp_settings.airtime_budget_minute_s = flex["airtime_budget_minute_s"];
+        if (flex.containsKey("airtime_budget_hour_s"))
+            temp_settings.airtime_budget_hour_s = flex["airtime_budget_hour_s"];
+    }
+
+    if (cfg.containsKey("dedup")) {
+        JsonObject dedup = cfg["dedup"];
+        for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+            if (dedup.containsKey(tx_source_names[i]))
+                temp_settings.dedup_window_s[i] = dedup[tx_source_names[i]];
+        }
+    }
+
+    if (cfg.containsKey("groups")) {
+        pager_groups_from_json(cfg["groups"], temp_settings.pager_groups);
     }
 
     if (cfg.containsKey("api")) {
@@ -3186,12 +4459,18 @@ bool import_user_backup(const String& json_string, String& error_msg) {
             temp_settings.api_enabled = api["enable"];
         if (api.containsKey("http_port"))
             temp_settings.http_port = api["http_port"];
+        if (api.containsKey("ingest_port"))
+            temp_settings.api_ingest_port = api["ingest_port"];
         if (api.containsKey("username"))
             strncpy(temp_settings.api_username, api["username"].as<String>().c_str(), sizeof(temp_settings.api_username) - 1);
         if (api.containsKey("password")) {
             String decoded_password = base64_decode_string(api["password"].as<String>());
             strncpy(temp_settings.api_password, decoded_password.c_str(), sizeof(temp_settings.api_password) - 1);
         }
+        if (api.containsKey("token")) {
+            String decoded_token = base64_decode_string(api["token"].as<String>());
+            strlcpy(temp_settings.api_token, decoded_token.c_str(), sizeof(temp_settings.api_token));
+        }
     }
 
     if (cfg.containsKey("grafana")) {
@@ -3218,6 +4497,8 @@ bool import_user_backup(const String& json_string, String& error_msg) {
             temp_settings.mqtt_notify_failures = mqtt["notify_failures"];
         if (mqtt.containsKey("retry_interval_mins"))
             temp_settings.mqtt_retry_interval_mins = mqtt["retry_interval_mins"];
+        if (mqtt.containsKey("outbox_persist"))
+            temp_settings.mqtt_outbox_persist = mqtt["outbox_persist"];
 
         if (mqtt.containsKey("certificates_b64")) {
             JsonObject certs = mqtt["certificates_b64"];
@@ -3507,6 +4788,10 @@ void handle_factory_reset() {
 
 void reset_oled_timeout() {
     last_activity_time = millis();
+    if (!service_lock_held()) {
+        display_update_requested = true;    // I2C belongs to loop(); it wakes the panel
+        return;
+    }
     display_turn_on();
 }
 
@@ -3729,168 +5014,907 @@ bool flex_encode_and_store(uint64_t capcode, const char *message, bool mail_drop
     return true;
 }
 
-void send_emr_if_needed() {
-    bool need_emr = !first_message_sent || (millis() - last_emr_transmission) >= EMR_TIMEOUT_MS;
+String emr_pattern_to_hex(const uint8_t* pattern, uint8_t pattern_length) {
+    String hex = "";
+    char byte_hex[3];
+    for (uint8_t i = 0; i < pattern_length; i++) {
+        snprintf(byte_hex, sizeof(byte_hex), "%02X", pattern[i]);
+        hex += byte_hex;
+    }
+    return hex;
+}
 
-    if (need_emr) {
-        uint8_t emr_pattern[] = {0xA5, 0x5A, 0xA5, 0x5A};
-        radio.startTransmit(emr_pattern, sizeof(emr_pattern));
+bool parse_emr_pattern(const char* hex, uint8_t* pattern, uint8_t* pattern_length) {
+    size_t hex_length = strlen(hex);
+    if (hex_length == 0 || (hex_length % 2) != 0 || (hex_length / 2) > EMR_PATTERN_MAX_LENGTH) {
+        return false;
+    }
 
-        unsigned long emr_start = millis();
-        while (radio.getPacketLength() > 0 && ((unsigned long)(millis() - emr_start) < 2000)) {
-            delay(1);
+    uint8_t parsed[EMR_PATTERN_MAX_LENGTH];
+    for (size_t i = 0; i < hex_length; i += 2) {
+        if (!isxdigit((unsigned char)hex[i]) || !isxdigit((unsigned char)hex[i + 1])) {
+            return false;
         }
-        delay(100);
+        char byte_hex[3] = { hex[i], hex[i + 1], '\0' };
+        parsed[i / 2] = (uint8_t)strtoul(byte_hex, nullptr, 16);
+    }
 
-        last_emr_transmission = millis();
-        first_message_sent = true;
+    memcpy(pattern, parsed, hex_length / 2);
+    *pattern_length = (uint8_t)(hex_length / 2);
+    return true;
+}
+
+static bool pager_group_name_valid(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length > PAGER_GROUP_NAME_MAX) {
+        return false;
     }
+    for (size_t i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '-') {
+            return false;
+        }
+    }
+    return true;
 }
 
-String truncate_message_with_ellipsis(String message) {
-    if (message.length() <= MAX_FLEX_MESSAGE_LENGTH) {
-        return message;
+// Case-insensitive lookup in groups (settings.pager_groups or an IngestSettings copy), nullptr
+// if no such group
+const PagerGroup* pager_group_find(const PagerGroup* groups, const char* name) {
+    for (int i = 0; i < PAGER_GROUP_MAX; i++) {
+        const PagerGroup* group = &groups[i];
+        if (group->name[0] != '\0' && group->count > 0 && strcasecmp(group->name, name) == 0) {
+            return group;
+        }
     }
-    return message.substring(0, 245) + "...";
+    return nullptr;
 }
 
-String convert_unicode_to_ascii(String message) {
-
-    static const struct {
-        const char* unicode;
-        const char* ascii;
-    } replacements[] = {
-        {"á", "a"}, {"é", "e"}, {"í", "i"}, {"ó", "o"}, {"ú", "u"}, {"ü", "u"},
-        {"Á", "A"}, {"É", "E"}, {"Í", "I"}, {"Ó", "O"}, {"Ú", "U"}, {"Ü", "U"},
-        {"ñ", "n"}, {"Ñ", "N"},
-        {"à", "a"}, {"è", "e"}, {"ì", "i"}, {"ò", "o"}, {"ù", "u"},
-        {"À", "A"}, {"È", "E"}, {"Ì", "I"}, {"Ò", "O"}, {"Ù", "U"},
-        {"â", "a"}, {"ê", "e"}, {"î", "i"}, {"ô", "o"}, {"û", "u"},
-        {"Â", "A"}, {"Ê", "E"}, {"Î", "I"}, {"Ô", "O"}, {"Û", "U"},
-        {"¿", "?"}, {"¡", "!"}, {"°", "^"},
-        {nullptr, nullptr}
-    };
+// One "name: capcode, capcode" line per group, the format edited on the FLEX page
+String pager_groups_to_text(const PagerGroup* groups) {
+    String text = "";
+    for (int i = 0; i < PAGER_GROUP_MAX; i++) {
+        if (groups[i].name[0] == '\0') continue;
+        text += String(groups[i].name) + ":";
+        for (uint8_t j = 0; j < groups[i].count; j++) {
+            text += (j == 0 ? " " : ", ") + String(groups[i].capcodes[j]);
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+// Parses the FLEX page group list; groups is only replaced when every line is valid
+bool pager_groups_parse(const String& text, PagerGroup* groups, String& error) {
+    PagerGroup parsed[PAGER_GROUP_MAX] = {};
+    int count = 0;
+    int line_number = 0;
+    int start = 0;
+
+    while (start < (int)text.length()) {
+        int end = text.indexOf('\n', start);
+        if (end < 0) {
+            end = text.length();
+        }
+        String line = text.substring(start, end);
+        start = end + 1;
+        line_number++;
+
+        line.trim();
+        if (line.length() == 0) {
+            continue;
+        }
+
+        int colon = line.indexOf(':');
+        String name = (colon > 0) ? line.substring(0, colon) : "";
+        name.trim();
+        if (!pager_group_name_valid(name.c_str())) {
+            error = "Line " + String(line_number) + ": expected 'name: capcode, ...' with a name of up to " +
+                    String(PAGER_GROUP_NAME_MAX) + " letters, digits, '-' or '_'";
+            return false;
+        }
+        if (count >= PAGER_GROUP_MAX) {
+            error = "At most " + String(PAGER_GROUP_MAX) + " groups";
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            if (strcasecmp(parsed[i].name, name.c_str()) == 0) {
+                error = "Line " + String(line_number) + ": duplicate group '" + name + "'";
+                return false;
+            }
+        }
+
+        PagerGroup* group = &parsed[count];
+        strlcpy(group->name, name.c_str(), sizeof(group->name));
+
+        String members = line.substring(colon + 1);
+        members.replace(',', ' ');
+        const char* cursor = members.c_str();
+        while (true) {
+            while (*cursor == ' ' || *cursor == '\t') cursor++;
+            if (*cursor == '\0') break;
+
+            char* number_end;
+            unsigned long long capcode = strtoull(cursor, &number_end, 10);
+            if (number_end == cursor || capcode == 0 || capcode > UINT32_MAX ||
+                (*number_end != '\0' && *number_end != ' ' && *number_end != '\t')) {
+                error = "Line " + String(line_number) + ": invalid capcode in group '" + name + "'";
+                return false;
+            }
+            if (group->count >= PAGER_GROUP_MEMBERS_MAX) {
+                error = "Line " + String(line_number) + ": at most " + String(PAGER_GROUP_MEMBERS_MAX) + " capcodes per group";
+                return false;
+            }
+            group->capcodes[group->count++] = (uint32_t)capcode;
+            cursor = number_end;
+        }
 
-    for (int i = 0; replacements[i].unicode != nullptr; i++) {
-        message.replace(replacements[i].unicode, replacements[i].ascii);
+        if (group->count == 0) {
+            error = "Line " + String(line_number) + ": group '" + name + "' has no capcodes";
+            return false;
+        }
+        count++;
     }
 
-    return message;
+    memcpy(groups, parsed, sizeof(parsed));
+    return true;
 }
 
-String json_escape_string(String input) {
-    String output = "";
-    output.reserve(input.length() + 20);
-
-    for (unsigned int i = 0; i < input.length(); i++) {
-        char c = input.charAt(i);
-        switch (c) {
-            case '"':  output += "\\\""; break;
-            case '\\': output += "\\\\"; break;
-            case '/':  output += "\\/"; break;
-            case '\b': output += "\\b"; break;
-            case '\f': output += "\\f"; break;
-            case '\n': output += "\\n"; break;
-            case '\r': output += "\\r"; break;
-            case '\t': output += "\\t"; break;
-            default:
-                if (c < 32) {
-                    output += "\\u00";
-                    if (c < 16) output += "0";
-                    output += String(c, HEX);
-                } else {
-                    output += c;
-                }
-                break;
+void pager_groups_to_json(const PagerGroup* groups, JsonObject out) {
+    for (int i = 0; i < PAGER_GROUP_MAX; i++) {
+        if (groups[i].name[0] == '\0') continue;
+        JsonArray members = out.createNestedArray(groups[i].name);
+        for (uint8_t j = 0; j < groups[i].count; j++) {
+            members.add(groups[i].capcodes[j]);
         }
     }
-    return output;
 }
 
-String sanitize_chatgpt_prompt(String input) {
-    String output = input;
+// Loads {"name": [capcode, ...]}; invalid names, zero capcodes and overflow are skipped
+void pager_groups_from_json(JsonObject in, PagerGroup* groups) {
+    memset(groups, 0, sizeof(PagerGroup) * PAGER_GROUP_MAX);
+    int count = 0;
+    for (JsonPair entry : in) {
+        if (count >= PAGER_GROUP_MAX || !pager_group_name_valid(entry.key().c_str())) continue;
+
+        PagerGroup* group = &groups[count];
+        strlcpy(group->name, entry.key().c_str(), sizeof(group->name));
+        for (JsonVariant member : entry.value().as<JsonArray>()) {
+            uint32_t capcode = member.as<uint32_t>();
+            if (capcode != 0 && group->count < PAGER_GROUP_MEMBERS_MAX) {
+                group->capcodes[group->count++] = capcode;
+            }
+        }
+        if (group->count > 0) {
+            count++;
+        } else {
+            memset(group, 0, sizeof(PagerGroup));
+        }
+    }
+}
 
-    output.trim();
+// Prepends the EMR burst to the encoded frame in tx_data_buffer so it goes out in the same
+// FIFO stream as the page, costing only its airtime. Returns the EMR bytes added (0 if none).
+bool emr_due() {
+    if (settings.emr_interval_s == 0 || settings.emr_pattern_length == 0) {
+        return false;
+    }
 
-    output.replace("\r\n", "\n");
-    output.replace("\r", "\n");
+    return !first_message_sent ||
+           (millis() - last_emr_transmission) >= (unsigned long)settings.emr_interval_s * 1000UL;
+}
 
-    while (output.indexOf("  ") >= 0) {
-        output.replace("  ", " ");
+size_t prepend_emr_if_needed() {
+    if (!emr_due()) {
+        return 0;
     }
 
-    while (output.indexOf("\n\n\n") >= 0) {
-        output.replace("\n\n\n", "\n\n");
+    size_t emr_length = settings.emr_pattern_length;
+    if (current_tx_total_length + emr_length > sizeof(tx_data_buffer)) {
+        return 0;
     }
 
-    if (output.length() > 250) {
-        output = output.substring(0, 250);
-    }
+    memmove(tx_data_buffer + emr_length, tx_data_buffer, current_tx_total_length);
+    memcpy(tx_data_buffer, settings.emr_pattern, emr_length);
+    current_tx_total_length += emr_length;
+    current_tx_remaining_length = current_tx_total_length;
 
-    return output;
+    last_emr_transmission = millis();
+    first_message_sent = true;
+    return emr_length;
 }
 
-String chatgpt_encode_api_key(String api_key) {
-    return base64_encode_string(api_key);
+// Milliseconds until the next frame the capcode's pager listens to, so that the FLEX sync
+// starts on the frame boundary lead_ms after this call (see flex_frame_next()). *cycle and
+// *frame receive the FLEX time to write into that frame's FIW.
+uint32_t flex_frame_wait_ms(uint64_t capcode, uint32_t lead_ms, uint8_t* cycle, uint8_t* frame) {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    uint64_t now_ms = (uint64_t)now.tv_sec * 1000ULL + now.tv_usec / 1000;
+    return flex_frame_next(now_ms, lead_ms, capcode, settings.flex_frame_collapse, cycle, frame);
 }
 
-String chatgpt_decode_api_key(String encoded_key) {
-    return base64_decode_string(encoded_key);
+// =============================================================================
+// AIRTIME LEDGER - Utilisation accounting and duty-cycle budgets
+// =============================================================================
+
+const char* tx_source_name(uint8_t source) {
+    return (source < TX_SOURCE_COUNT) ? tx_source_names[source] : "unknown";
 }
 
-String chatgpt_mask_api_key(String api_key) {
-    if (api_key.length() < 10) return "Invalid";
+static void airtime_window_roll(struct AirtimeWindow* window, uint32_t period_ms, uint32_t now) {
+    uint32_t elapsed = now - window->period_start_ms;
+    if (elapsed >= 2 * period_ms) {
+        window->previous_ms = 0;
+        window->current_ms = 0;
+        window->period_start_ms = now;
+    } else if (elapsed >= period_ms) {
+        window->previous_ms = window->current_ms;
+        window->current_ms = 0;
+        window->period_start_ms += period_ms;
+    }
+}
 
-    String masked = api_key.substring(0, 3);
-    masked += "***...***";
-    masked += api_key.substring(api_key.length() - 3);
-    return masked;
+static uint32_t airtime_window_used(struct AirtimeWindow* window, uint32_t period_ms, uint32_t now) {
+    airtime_window_roll(window, period_ms, now);
+    uint32_t elapsed = now - window->period_start_ms;
+    return window->current_ms + (uint32_t)((uint64_t)window->previous_ms * (period_ms - elapsed) / period_ms);
 }
 
-bool validate_flex_capcode(uint32_t capcode) {
-    if (capcode < 1 || capcode > 4291000000UL) {
-        return false;
+static void airtime_bucket_refill(struct AirtimeBucket* bucket, float capacity_ms, uint32_t window_ms, uint32_t now) {
+    if (bucket->last_refill_ms == 0) {
+        bucket->tokens_ms = capacity_ms;
+    } else {
+        bucket->tokens_ms += (float)(now - bucket->last_refill_ms) * capacity_ms / window_ms;
+        if (bucket->tokens_ms > capacity_ms) {
+            bucket->tokens_ms = capacity_ms;
+        }
     }
+    bucket->last_refill_ms = now;
+}
 
-    if (capcode >= 1933313UL && capcode <= 1998848UL) {
-        return false;
+// Seconds until the bucket holds needed_ms again
+static uint32_t airtime_bucket_wait_s(struct AirtimeBucket* bucket, float capacity_ms, uint32_t window_ms, float needed_ms) {
+    if (bucket->tokens_ms >= needed_ms) {
+        return 0;
     }
+    float wait_ms = (needed_ms - bucket->tokens_ms) * window_ms / capacity_ms;
+    return (uint32_t)(wait_ms / 1000.0f) + 1;
+}
 
-    if (capcode >= 2031615UL && capcode <= 2101248UL) {
-        return false;
+// Caller holds airtime_mux. Evicts the least recently used slot when the table is full.
+static struct AirtimeLedgerEntry* airtime_frequency_entry(float frequency, uint32_t now) {
+    int free_slot = -1;
+    int oldest_slot = 0;
+
+    for (int i = 0; i < AIRTIME_MAX_FREQUENCIES; i++) {
+        if (airtime_frequencies[i].frequency == 0.0f) {
+            if (free_slot < 0) free_slot = i;
+            continue;
+        }
+        if (fabsf(airtime_frequencies[i].frequency - frequency) < 0.0001f) {
+            return &airtime_frequencies[i];
+        }
+        if ((now - airtime_frequencies[i].last_activity_ms) > (now - airtime_frequencies[oldest_slot].last_activity_ms)) {
+            oldest_slot = i;
+        }
     }
 
-    return true;
+    int slot = (free_slot >= 0) ? free_slot : oldest_slot;
+    memset(&airtime_frequencies[slot], 0, sizeof(AirtimeLedgerEntry));
+    airtime_frequencies[slot].frequency = frequency;
+    airtime_frequencies[slot].minute.period_start_ms = now;
+    airtime_frequencies[slot].hour.period_start_ms = now;
+    airtime_frequencies[slot].last_activity_ms = now;
+    return &airtime_frequencies[slot];
 }
 
-bool chatgpt_validate_api_key(String api_key) {
-    return api_key.startsWith("sk-") && api_key.length() >= 20 && api_key.length() <= 200;
+static void airtime_charge_budgets(struct AirtimeLedgerEntry* entry, float delta_ms, uint32_t now) {
+    if (settings.airtime_budget_minute_s > 0) {
+        airtime_bucket_refill(&entry->minute_budget, settings.airtime_budget_minute_s * 1000.0f, AIRTIME_MINUTE_MS, now);
+        entry->minute_budget.tokens_ms -= delta_ms;
+    }
+    if (settings.airtime_budget_hour_s > 0) {
+        airtime_bucket_refill(&entry->hour_budget, settings.airtime_budget_hour_s * 1000.0f, AIRTIME_HOUR_MS, now);
+        entry->hour_budget.tokens_ms -= delta_ms;
+    }
 }
 
+// Caller holds airtime_mux. Seconds until entry's budgets hold needed_ms, 0 if they do now.
+// A request larger than a whole bucket is admitted once that bucket is full.
+static uint32_t airtime_budget_wait_s(struct AirtimeLedgerEntry* entry, float needed_ms, uint32_t now) {
+    uint32_t wait_s = 0;
+    if (settings.airtime_budget_minute_s > 0) {
+        float capacity_ms = settings.airtime_budget_minute_s * 1000.0f;
+        airtime_bucket_refill(&entry->minute_budget, capacity_ms, AIRTIME_MINUTE_MS, now);
+        wait_s = max(wait_s, airtime_bucket_wait_s(&entry->minute_budget, capacity_ms, AIRTIME_MINUTE_MS,
+                                                   min(needed_ms, capacity_ms)));
+    }
+    if (settings.airtime_budget_hour_s > 0) {
+        float capacity_ms = settings.airtime_budget_hour_s * 1000.0f;
+        airtime_bucket_refill(&entry->hour_budget, capacity_ms, AIRTIME_HOUR_MS, now);
+        wait_s = max(wait_s, airtime_bucket_wait_s(&entry->hour_budget, capacity_ms, AIRTIME_HOUR_MS,
+                                                   min(needed_ms, capacity_ms)));
+    }
+    return wait_s;
+}
 
-bool chatgpt_load_config() {
-    File file = SPIFFS.open("/chatgpt_settings.json", "r");
-    if (!file) {
-        logMessage("CHATGPT: No configuration file found, using defaults");
-        chatgpt_config.enabled = false;
-        chatgpt_config.chatgpt_notify_failures = true;
-        chatgpt_config.prompts.clear();
-        chatgpt_config.prompt_count = 0;
-        strncpy(chatgpt_config.api_key_b64, "", sizeof(chatgpt_config.api_key_b64) - 1);
-    chatgpt_config.api_key_b64[sizeof(chatgpt_config.api_key_b64) - 1] = '\0';
-        return false;
+// Admission check for transmissions more pages on frequency without reserving anything (repeat
+// copies, one per group member); sets *retry_after_s when the budget is exhausted
+bool airtime_admit(float frequency, uint8_t transmissions, uint32_t* retry_after_s) {
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&airtime_mux);
+    AirtimeLedgerEntry* entry = airtime_frequency_entry(frequency, now);
+    uint32_t wait_s = airtime_budget_wait_s(entry, (float)airtime_estimate_ms * transmissions, now);
+    if (wait_s > 0) {
+        airtime_rejections++;
     }
+    portEXIT_CRITICAL(&airtime_mux);
 
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    if (retry_after_s != nullptr) {
+        *retry_after_s = wait_s;
+    }
+    return wait_s == 0;
+}
 
-    if (error) {
-        logMessage("CHATGPT: Failed to parse configuration file");
-        return false;
+// Checks and charges transmissions pages of the current estimate in one critical section, so
+// concurrent producers cannot all pass on the last of the budget. With enforce false the charge
+// is made unconditionally (sources without admission control still count against the budget).
+// *reserved_ms receives the amount charged (0 when rejected), *retry_after_s the wait.
+bool airtime_admit_reserve(float frequency, uint8_t transmissions, bool enforce,
+                           uint16_t* reserved_ms, uint32_t* retry_after_s) {
+    uint32_t now = millis();
+    uint32_t wait_s = 0;
+
+    portENTER_CRITICAL(&airtime_mux);
+    AirtimeLedgerEntry* entry = airtime_frequency_entry(frequency, now);
+    uint32_t needed_ms = min(airtime_estimate_ms * transmissions, (uint32_t)UINT16_MAX);
+    if (enforce) {
+        wait_s = airtime_budget_wait_s(entry, (float)needed_ms, now);
+    }
+    if (wait_s > 0) {
+        airtime_rejections++;
+        *reserved_ms = 0;
+    } else {
+        airtime_charge_budgets(entry, (float)needed_ms, now);
+        *reserved_ms = (uint16_t)needed_ms;
     }
+    portEXIT_CRITICAL(&airtime_mux);
 
-    chatgpt_config.enabled = doc["enabled"] | false;
+    *retry_after_s = wait_s;
+    return wait_s == 0;
+}
+
+void airtime_refund(float frequency, uint16_t reserved_ms) {
+    if (reserved_ms == 0) {
+        return;
+    }
+
+    uint32_t now = millis();
+    portENTER_CRITICAL(&airtime_mux);
+    AirtimeLedgerEntry* entry = airtime_frequency_entry(frequency, now);
+    airtime_charge_budgets(entry, -(float)reserved_ms, now);
+    portEXIT_CRITICAL(&airtime_mux);
+}
+
+// Called by the TX task once a page has left the FIFO
+void airtime_record_transmission(float frequency, uint8_t source, uint32_t encoded_ms,
+                                 uint32_t measured_ms, uint16_t reserved_ms) {
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&airtime_mux);
+    AirtimeLedgerEntry* entry = airtime_frequency_entry(frequency, now);
+    AirtimeLedgerEntry* source_entry = &airtime_sources[(source < TX_SOURCE_COUNT) ? source : TX_SOURCE_SYSTEM];
+
+    AirtimeLedgerEntry* entries[2] = { entry, source_entry };
+    for (AirtimeLedgerEntry* e : entries) {
+        e->airtime_ms += measured_ms;
+        e->encoded_ms += encoded_ms;
+        e->transmissions++;
+        e->last_activity_ms = now;
+        airtime_window_roll(&e->minute, AIRTIME_MINUTE_MS, now);
+        airtime_window_roll(&e->hour, AIRTIME_HOUR_MS, now);
+        e->minute.current_ms += measured_ms;
+        e->hour.current_ms += measured_ms;
+    }
+
+    airtime_charge_budgets(entry, (float)measured_ms - (float)reserved_ms, now);
+    airtime_estimate_ms = (airtime_estimate_ms * 7 + measured_ms) / 8;
+    portEXIT_CRITICAL(&airtime_mux);
+}
+
+// Copies the ledger out of the critical section for reporting
+static void airtime_snapshot(struct AirtimeLedgerEntry* frequencies, struct AirtimeLedgerEntry* sources) {
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&airtime_mux);
+    for (int i = 0; i < AIRTIME_MAX_FREQUENCIES; i++) {
+        if (airtime_frequencies[i].frequency == 0.0f) continue;
+        airtime_window_roll(&airtime_frequencies[i].minute, AIRTIME_MINUTE_MS, now);
+        airtime_window_roll(&airtime_frequencies[i].hour, AIRTIME_HOUR_MS, now);
+        if (settings.airtime_budget_minute_s > 0) {
+            airtime_bucket_refill(&airtime_frequencies[i].minute_budget, settings.airtime_budget_minute_s * 1000.0f, AIRTIME_MINUTE_MS, now);
+        }
+        if (settings.airtime_budget_hour_s > 0) {
+            airtime_bucket_refill(&airtime_frequencies[i].hour_budget, settings.airtime_budget_hour_s * 1000.0f, AIRTIME_HOUR_MS, now);
+        }
+    }
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        airtime_window_roll(&airtime_sources[i].hour, AIRTIME_HOUR_MS, now);
+    }
+    memcpy(frequencies, airtime_frequencies, sizeof(airtime_frequencies));
+    memcpy(sources, airtime_sources, sizeof(airtime_sources));
+    portEXIT_CRITICAL(&airtime_mux);
+}
+
+String airtime_status_html() {
+    AirtimeLedgerEntry frequencies[AIRTIME_MAX_FREQUENCIES];
+    AirtimeLedgerEntry sources[TX_SOURCE_COUNT];
+    airtime_snapshot(frequencies, sources);
+    uint32_t now = millis();
+
+    String html = "<p><strong>Airtime Budget:</strong> ";
+    html += (settings.airtime_budget_minute_s > 0) ? String(settings.airtime_budget_minute_s) + " s/min" : String("unlimited/min");
+    html += ", ";
+    html += (settings.airtime_budget_hour_s > 0) ? String(settings.airtime_budget_hour_s) + " s/hour" : String("unlimited/hour");
+    html += " (" + String(airtime_rejections) + " rejected)</p>";
+
+    for (int i = 0; i < AIRTIME_MAX_FREQUENCIES; i++) {
+        AirtimeLedgerEntry& e = frequencies[i];
+        if (e.frequency == 0.0f) continue;
+        uint32_t minute_used = airtime_window_used(&e.minute, AIRTIME_MINUTE_MS, now);
+        uint32_t hour_used = airtime_window_used(&e.hour, AIRTIME_HOUR_MS, now);
+        html += "<p><strong>" + String(e.frequency, 4) + " MHz:</strong> " +
+                String(minute_used * 100.0f / AIRTIME_MINUTE_MS, 1) + "% last min, " +
+                String(hour_used * 100.0f / AIRTIME_HOUR_MS, 1) + "% last hour, " +
+                String((uint32_t)(e.airtime_ms / 1000)) + " s total (" + String(e.transmissions) + " pages)</p>";
+    }
+
+    String by_source = "";
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        if (sources[i].transmissions == 0) continue;
+        if (by_source.length() > 0) by_source += ", ";
+        by_source += String(tx_source_names[i]) + " " + String((uint32_t)(sources[i].airtime_ms / 1000)) + " s";
+    }
+    if (by_source.length() > 0) {
+        html += "<p><strong>Airtime by Source:</strong> " + by_source + "</p>";
+    }
+    return html;
+}
+
+void airtime_fill_json(JsonObject airtime) {
+    AirtimeLedgerEntry frequencies[AIRTIME_MAX_FREQUENCIES];
+    AirtimeLedgerEntry sources[TX_SOURCE_COUNT];
+    airtime_snapshot(frequencies, sources);
+    uint32_t now = millis();
+
+    airtime["estimate_ms"] = airtime_estimate_ms;
+    airtime["rejections"] = airtime_rejections;
+
+    JsonArray freq_array = airtime.createNestedArray("frequencies");
+    for (int i = 0; i < AIRTIME_MAX_FREQUENCIES; i++) {
+        AirtimeLedgerEntry& e = frequencies[i];
+        if (e.frequency == 0.0f) continue;
+        JsonObject f = freq_array.createNestedObject();
+        f["frequency"] = e.frequency;
+        f["minute_pct"] = airtime_window_used(&e.minute, AIRTIME_MINUTE_MS, now) * 100.0f / AIRTIME_MINUTE_MS;
+        f["hour_pct"] = airtime_window_used(&e.hour, AIRTIME_HOUR_MS, now) * 100.0f / AIRTIME_HOUR_MS;
+        f["total_ms"] = e.airtime_ms;
+        f["encoded_ms"] = e.encoded_ms;
+        f["pages"] = e.transmissions;
+    }
+
+    JsonObject source_obj = airtime.createNestedObject("sources");
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        if (sources[i].transmissions == 0) continue;
+        source_obj[tx_source_names[i]] = sources[i].airtime_ms;
+    }
+}
+
+// =============================================================================
+// METRICS - Prometheus text exposition (/metrics)
+// =============================================================================
+
+void metrics_observe(struct MetricHistogram* histogram, uint32_t value) {
+    uint8_t bucket = 0;
+    while (bucket < histogram->bound_count && value > histogram->bounds[bucket]) {
+        bucket++;
+    }
+    histogram->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram->sum.fetch_add(value, std::memory_order_relaxed);
+    histogram->count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void web_handle_client(struct WebLane* lane) {
+    lane->server->handleClient();
+
+    uint32_t start_us = lane->timing->start_us;
+    if (start_us != 0) {
+        lane->timing->start_us = 0;
+        metrics_observe(&metric_web_handler, (micros() - start_us) / 1000);
+    }
+}
+
+// True on loopTask (setup() included) or on the web task inside a web_route() handler
+bool service_lock_held() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (self == loop_task_handle) {
+        return true;
+    }
+    return service_lock != NULL && xSemaphoreGetMutexHolder(service_lock) == self;
+}
+
+static void web_send_busy() {
+    webServer.sendHeader("Retry-After", String(WEB_BUSY_RETRY_AFTER_S));
+    webServer.send(503, "text/plain", "Device busy, retry shortly");
+}
+
+static WebServer::THandlerFunction web_locked(WebServer::THandlerFunction handler, bool upload) {
+    return [handler, upload]() {
+        if (xSemaphoreTakeRecursive(service_lock, pdMS_TO_TICKS(WEB_SERVICE_LOCK_TIMEOUT_MS)) != pdTRUE) {
+            web_busy_rejections.fetch_add(1, std::memory_order_relaxed);
+            if (!upload) {
+                web_send_busy();
+            }
+            return;
+        }
+        handler();
+        ingest_settings_publish();
+        xSemaphoreGiveRecursive(service_lock);
+    };
+}
+
+void web_route(const char* uri, WebServer::THandlerFunction handler) {
+    webServer.on(uri, web_locked(handler, false));
+}
+
+void web_route(const char* uri, HTTPMethod method, WebServer::THandlerFunction handler) {
+    webServer.on(uri, method, web_locked(handler, false));
+}
+
+void web_route(const char* uri, HTTPMethod method, WebServer::THandlerFunction handler,
+               WebServer::THandlerFunction upload_handler) {
+    webServer.on(uri, method, web_locked(handler, false), web_locked(upload_handler, true));
+}
+
+// Message ingest routes. Port 80 keeps them for existing clients; the optional ingest listener
+// serves nothing else, so UI pages, log downloads and long-polls never hold it.
+void ingest_routes(class IngestWebServer& server) {
+    IngestWebServer* target = &server;
+    server.on("/api", HTTP_POST, [target]() { handle_api_message(*target); });
+    server.on("/api/batch", HTTP_POST, [target]() { handle_api_batch(*target); });
+    server.on("/api/v1/alerts", HTTP_POST, [target]() { handle_grafana_webhook(*target); });
+}
+
+void web_server_task(void* parameter) {
+    WebLane* lane = (WebLane*)parameter;
+    while (true) {
+        if (wifi_connected || ap_mode_active) {
+            web_handle_client(lane);
+        }
+        vTaskDelay(pdMS_TO_TICKS(WEB_TASK_POLL_MS));
+    }
+}
+
+void init_web_task() {
+    for (WebLane* lane : { &web_lane, &ingest_lane }) {
+        if (lane == &ingest_lane && settings.api_ingest_port == 0) {
+            continue;
+        }
+        xTaskCreatePinnedToCore(
+            web_server_task,
+            lane->task_name,
+            WEB_TASK_STACK_SIZE,
+            lane,
+            WEB_TASK_PRIORITY,
+            &lane->task,
+            1
+        );
+    }
+
+    logMessage("WEB: HTTP tasks created (UI port " + String(WEB_SERVER_PORT) + ", ingest port " +
+               (settings.api_ingest_port != 0 ? String(settings.api_ingest_port) : String("off")) + ")");
+}
+
+static void metrics_append_header(String& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+static void metrics_append_value(String& out, const char* name, const char* labels, double value) {
+    char line[160];
+    snprintf(line, sizeof(line), "%s%s %.10g\n", name, labels, value);
+    out += line;
+}
+
+static void metrics_append_histogram(String& out, struct MetricHistogram* histogram) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s_seconds", histogram->name);
+    metrics_append_header(out, name, "histogram", histogram->help);
+
+    double unit_s = histogram->unit_us / 1000000.0;
+    uint32_t cumulative = 0;
+    char line[160];
+    for (uint8_t i = 0; i <= histogram->bound_count; i++) {
+        cumulative += histogram->buckets[i].load(std::memory_order_relaxed);
+        if (i < histogram->bound_count) {
+            snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %lu\n", name,
+                     histogram->bounds[i] * unit_s, (unsigned long)cumulative);
+        } else {
+            snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %lu\n", name, (unsigned long)cumulative);
+        }
+        out += line;
+    }
+
+    snprintf(line, sizeof(line), "%s_sum %.6f\n%s_count %lu\n", name,
+             (double)histogram->sum.load(std::memory_order_relaxed) * unit_s, name,
+             (unsigned long)histogram->count.load(std::memory_order_relaxed));
+    out += line;
+}
+
+void handle_metrics() {
+    webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    webServer.send(200, "text/plain; version=0.0.4; charset=utf-8", "");
+
+    String chunk;
+    chunk.reserve(2048);
+
+    char labels[96];
+    snprintf(labels, sizeof(labels), "{version=\"%s\",device=\"%s\"}", CURRENT_VERSION, settings.mqtt_thing_name);
+    metrics_append_header(chunk, "flex_build_info", "gauge", "Firmware version");
+    metrics_append_value(chunk, "flex_build_info", labels, 1);
+
+    metrics_append_header(chunk, "flex_uptime_seconds", "counter", "Seconds since boot");
+    metrics_append_value(chunk, "flex_uptime_seconds", "", millis() / 1000.0);
+
+    metrics_append_header(chunk, "flex_transmissions_total", "counter", "Pages transmitted");
+    metrics_append_value(chunk, "flex_transmissions_total", "", tx_metrics.transmissions);
+    metrics_append_header(chunk, "flex_emr_bursts_total", "counter", "Transmissions preceded by an EMR preamble");
+    metrics_append_value(chunk, "flex_emr_bursts_total", "", tx_metrics.emr_bursts);
+    metrics_append_header(chunk, "flex_group_pages_total", "counter", "Pages sent to a pager group, counted once per group");
+    metrics_append_value(chunk, "flex_group_pages_total", "", tx_metrics.group_pages);
+    metrics_append_header(chunk, "flex_repeats_sent_total", "counter", "Repeat copies transmitted");
+    metrics_append_value(chunk, "flex_repeats_sent_total", "", tx_metrics.repeats_sent);
+    metrics_append_header(chunk, "flex_repeats_skipped_total", "counter", "Repeat copies dropped (no slot or memory, airtime budget, radio error)");
+    metrics_append_value(chunk, "flex_repeats_skipped_total", "", tx_metrics.repeats_skipped);
+    metrics_append_header(chunk, "flex_rf_amp_hot_starts_total", "counter", "Pages keyed up with the RF amplifier already powered");
+    metrics_append_value(chunk, "flex_rf_amp_hot_starts_total", "", tx_metrics.hot_starts);
+    metrics_append_header(chunk, "flex_radio_profile_hits_total", "counter", "Channel switches served from a cached register profile");
+    metrics_append_value(chunk, "flex_radio_profile_hits_total", "", tx_metrics.profile_hits);
+    metrics_append_header(chunk, "flex_radio_profile_misses_total", "counter", "Channel switches that went through RadioLib");
+    metrics_append_value(chunk, "flex_radio_profile_misses_total", "", tx_metrics.profile_misses);
+    metrics_append_header(chunk, "flex_airtime_rejections_total", "counter", "Pages refused by the airtime budget");
+    metrics_append_value(chunk, "flex_airtime_rejections_total", "", airtime_rejections);
+
+    metrics_append_header(chunk, "flex_dedup_suppressed_total", "counter", "Duplicate pages suppressed per source");
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "{source=\"%s\"}", tx_source_names[i]);
+        metrics_append_value(chunk, "flex_dedup_suppressed_total", labels, dedup_suppressed[i]);
+    }
+
+    AirtimeLedgerEntry frequencies[AIRTIME_MAX_FREQUENCIES];
+    AirtimeLedgerEntry sources[TX_SOURCE_COUNT];
+    airtime_snapshot(frequencies, sources);
+    metrics_append_header(chunk, "flex_airtime_used_seconds_total", "counter", "Measured airtime per frequency");
+    for (int i = 0; i < AIRTIME_MAX_FREQUENCIES; i++) {
+        if (frequencies[i].frequency == 0.0f) continue;
+        snprintf(labels, sizeof(labels), "{frequency=\"%.4f\"}", frequencies[i].frequency);
+        metrics_append_value(chunk, "flex_airtime_used_seconds_total", labels, frequencies[i].airtime_ms / 1000.0);
+    }
+
+    metrics_append_header(chunk, "flex_queue_messages", "gauge", "Pages waiting in the transmit queue");
+    metrics_append_value(chunk, "flex_queue_messages", "", queue_count.load());
+    metrics_append_header(chunk, "flex_queue_bytes", "gauge", "Transmit queue arena usage");
+    metrics_append_value(chunk, "flex_queue_bytes", "{state=\"used\"}", queue_bytes_used());
+    metrics_append_value(chunk, "flex_queue_bytes", "{state=\"capacity\"}", queue_arena_capacity);
+
+    metrics_append_header(chunk, "flex_mqtt_outbox_depth", "gauge", "MQTT publishes waiting in the outbox");
+    metrics_append_value(chunk, "flex_mqtt_outbox_depth", "", mqtt_outbox_count);
+    metrics_append_header(chunk, "flex_mqtt_outbox_published_total", "counter", "MQTT publishes sent");
+    metrics_append_value(chunk, "flex_mqtt_outbox_published_total", "", mqtt_outbox_published);
+    metrics_append_header(chunk, "flex_mqtt_outbox_dropped_total", "counter", "MQTT publishes dropped by outbox policy");
+    metrics_append_value(chunk, "flex_mqtt_outbox_dropped_total", "{policy=\"oldest\"}", mqtt_outbox_dropped_oldest);
+    metrics_append_value(chunk, "flex_mqtt_outbox_dropped_total", "{policy=\"newest\"}", mqtt_outbox_dropped_newest);
+    metrics_append_header(chunk, "flex_delivery_events_dropped_total", "counter", "Delivery events lost to a full event ring");
+    metrics_append_value(chunk, "flex_delivery_events_dropped_total", "", delivery_events_dropped_total);
+    metrics_append_header(chunk, "flex_web_busy_rejections_total", "counter", "UI requests answered 503 while loop() held the service lock");
+    metrics_append_value(chunk, "flex_web_busy_rejections_total", "", web_busy_rejections.load());
+    metrics_append_header(chunk, "flex_log_rotations_total", "counter", "Log segment rotations since boot");
+    metrics_append_value(chunk, "flex_log_rotations_total", "", log_store_rotations);
+    metrics_append_header(chunk, "flex_log_stored_bytes", "gauge", "Bytes held in the persistent log segments");
+    metrics_append_value(chunk, "flex_log_stored_bytes", "", log_store_total_bytes());
+    metrics_append_header(chunk, "flex_syslog_records_total", "counter", "Remote syslog records by outcome");
+    metrics_append_value(chunk, "flex_syslog_records_total", "{result=\"sent\"}", syslog_sent);
+    metrics_append_value(chunk, "flex_syslog_records_total", "{result=\"dropped\"}", syslog_dropped);
+    metrics_append_header(chunk, "flex_syslog_queue_depth", "gauge", "Remote syslog records waiting to be shipped");
+    metrics_append_value(chunk, "flex_syslog_queue_depth", "", syslog_ring_count);
+    metrics_append_header(chunk, "flex_syslog_reconnects_total", "counter", "Remote syslog TCP connections opened");
+    metrics_append_value(chunk, "flex_syslog_reconnects_total", "", syslog_reconnects);
+    metrics_append_header(chunk, "flex_grafana_heap_peak_bytes", "gauge", "Heap used by a Grafana webhook request");
+    metrics_append_value(chunk, "flex_grafana_heap_peak_bytes", "{request=\"last\"}", grafana_heap_peak_last);
+    metrics_append_value(chunk, "flex_grafana_heap_peak_bytes", "{request=\"max\"}", grafana_heap_peak_max);
+
+    metrics_append_header(chunk, "flex_heap_free_bytes", "gauge", "Free internal heap");
+    metrics_append_value(chunk, "flex_heap_free_bytes", "", ESP.getFreeHeap());
+    metrics_append_header(chunk, "flex_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+    metrics_append_value(chunk, "flex_heap_min_free_bytes", "", ESP.getMinFreeHeap());
+    metrics_append_header(chunk, "flex_heap_largest_free_block_bytes", "gauge", "Largest allocatable heap block");
+    metrics_append_value(chunk, "flex_heap_largest_free_block_bytes", "", ESP.getMaxAllocHeap());
+    if (psramFound()) {
+        metrics_append_header(chunk, "flex_psram_free_bytes", "gauge", "Free PSRAM");
+        metrics_append_value(chunk, "flex_psram_free_bytes", "", ESP.getFreePsram());
+    }
+
+    metrics_append_header(chunk, "flex_task_stack_high_water_bytes", "gauge", "Minimum free stack seen per task");
+    if (tx_task_handle != NULL) {
+        metrics_append_value(chunk, "flex_task_stack_high_water_bytes", "{task=\"tx\"}",
+                             uxTaskGetStackHighWaterMark(tx_task_handle));
+    }
+    if (loop_task_handle != NULL) {
+        metrics_append_value(chunk, "flex_task_stack_high_water_bytes", "{task=\"loop\"}",
+                             uxTaskGetStackHighWaterMark(loop_task_handle));
+    }
+    if (web_lane.task != NULL) {
+        metrics_append_value(chunk, "flex_task_stack_high_water_bytes", "{task=\"web\"}",
+                             uxTaskGetStackHighWaterMark(web_lane.task));
+    }
+    if (ingest_lane.task != NULL) {
+        metrics_append_value(chunk, "flex_task_stack_high_water_bytes", "{task=\"ingest\"}",
+                             uxTaskGetStackHighWaterMark(ingest_lane.task));
+    }
+    if (syslog_task_handle != NULL) {
+        metrics_append_value(chunk, "flex_task_stack_high_water_bytes", "{task=\"syslog\"}",
+                             uxTaskGetStackHighWaterMark(syslog_task_handle));
+    }
+
+    if (WiFi.status() == WL_CONNECTED) {
+        metrics_append_header(chunk, "flex_wifi_rssi_dbm", "gauge", "WiFi signal strength");
+        metrics_append_value(chunk, "flex_wifi_rssi_dbm", "", WiFi.RSSI());
+    }
+
+    webServer.sendContent(chunk);
+    chunk = "";
+
+    struct MetricHistogram* histograms[] = {
+        &metric_queue_wait, &metric_encode, &metric_radio_switch, &metric_fifo_refill, &metric_airtime,
+        &metric_turnaround, &metric_web_handler, &metric_api_auth, &metric_log_flush, &metric_mqtt_connect, &metric_mqtt_publish, &metric_imap_check, &metric_chatgpt_request
+    };
+    for (struct MetricHistogram* histogram : histograms) {
+        metrics_append_histogram(chunk, histogram);
+        webServer.sendContent(chunk);
+        chunk = "";
+    }
+
+    webServer.sendContent("");
+}
+
+String truncate_message_with_ellipsis(String message) {
+    if (message.length() <= MAX_FLEX_MESSAGE_LENGTH) {
+        return message;
+    }
+    return message.substring(0, 245) + "...";
+}
+
+String json_escape_string(String input) {
+    String output = "";
+    output.reserve(input.length() + 20);
+
+    for (unsigned int i = 0; i < input.length(); i++) {
+        char c = input.charAt(i);
+        switch (c) {
+            case '"':  output += "\\\""; break;
+            case '\\': output += "\\\\"; break;
+            case '/':  output += "\\/"; break;
+            case '\b': output += "\\b"; break;
+            case '\f': output += "\\f"; break;
+            case '\n': output += "\\n"; break;
+            case '\r': output += "\\r"; break;
+            case '\t': output += "\\t"; break;
+            default:
+                if (c < 32) {
+                    output += "\\u00";
+                    if (c < 16) output += "0";
+                    output += String(c, HEX);
+                } else {
+                    output += c;
+                }
+                break;
+        }
+    }
+    return output;
+}
+
+String sanitize_chatgpt_prompt(String input) {
+    String output = input;
+
+    output.trim();
+
+    output.replace("\r\n", "\n");
+    output.replace("\r", "\n");
+
+    while (output.indexOf("  ") >= 0) {
+        output.replace("  ", " ");
+    }
+
+    while (output.indexOf("\n\n\n") >= 0) {
+        output.replace("\n\n\n", "\n\n");
+    }
+
+    if (output.length() > 250) {
+        output = output.substring(0, 250);
+    }
+
+    return output;
+}
+
+String chatgpt_encode_api_key(String api_key) {
+    return base64_encode_string(api_key);
+}
+
+String chatgpt_decode_api_key(String encoded_key) {
+    return base64_decode_string(encoded_key);
+}
+
+String chatgpt_mask_api_key(String api_key) {
+    if (api_key.length() < 10) return "Invalid";
+
+    String masked = api_key.substring(0, 3);
+    masked += "***...***";
+    masked += api_key.substring(api_key.length() - 3);
+    return masked;
+}
+
+bool validate_flex_capcode(uint32_t capcode) {
+    if (capcode < 1 || capcode > 4291000000UL) {
+        return false;
+    }
+
+    if (capcode >= 1933313UL && capcode <= 1998848UL) {
+        return false;
+    }
+
+    if (capcode >= 2031615UL && capcode <= 2101248UL) {
+        return false;
+    }
+
+    return true;
+}
+
+bool chatgpt_validate_api_key(String api_key) {
+    return api_key.startsWith("sk-") && api_key.length() >= 20 && api_key.length() <= 200;
+}
+
+
+bool chatgpt_load_config() {
+    File file = SPIFFS.open("/chatgpt_settings.json", "r");
+    if (!file) {
+        logMessage("CHATGPT: No configuration file found, using defaults");
+        chatgpt_config.enabled = false;
+        chatgpt_config.chatgpt_notify_failures = true;
+        chatgpt_config.prompts.clear();
+        chatgpt_config.prompt_count = 0;
+        strncpy(chatgpt_config.api_key_b64, "", sizeof(chatgpt_config.api_key_b64) - 1);
+    chatgpt_config.api_key_b64[sizeof(chatgpt_config.api_key_b64) - 1] = '\0';
+        return false;
+    }
+
+    DynamicJsonDocument doc(4096);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+
+    if (error) {
+        logMessage("CHATGPT: Failed to parse configuration file");
+        return false;
+    }
+
+    chatgpt_config.enabled = doc["enabled"] | false;
     chatgpt_config.chatgpt_notify_failures = doc["chatgpt_notify_failures"] | true;
     strlcpy(chatgpt_config.api_key_b64, doc["api_key_b64"] | "", sizeof(chatgpt_config.api_key_b64));
 
@@ -4076,7 +6100,7 @@ bool chatgpt_execute_prompt(ChatGPTPrompt& prompt, int prompt_index) {
 
             if (chatgpt_config.chatgpt_notify_failures) {
                 String failure_msg = "ChatGPT Failed: " + String(prompt.name) + " - All 3 attempts failed";
-                bool failure_queued = queue_add_message(prompt.capcode, prompt.frequency, settings.default_txpower, prompt.mail_drop, failure_msg.c_str());
+                bool failure_queued = queue_add_message(prompt.capcode, prompt.frequency, settings.default_txpower, prompt.mail_drop, failure_msg.c_str(), TX_SOURCE_CHATGPT);
                 if (failure_queued) {
                     logMessage("CHATGPT: Failure notification sent for '" + String(prompt.name) + "'");
                 }
@@ -4095,7 +6119,7 @@ bool chatgpt_execute_prompt(ChatGPTPrompt& prompt, int prompt_index) {
 
     response = truncate_message_with_ellipsis(response);
 
-    bool queued = queue_add_message(prompt.capcode, prompt.frequency, settings.default_txpower, prompt.mail_drop, response.c_str());
+    bool queued = queue_add_message(prompt.capcode, prompt.frequency, settings.default_txpower, prompt.mail_drop, response.c_str(), TX_SOURCE_CHATGPT);
 
     if (queued) {
         logMessage("CHATGPT: Response queued for transmission to " + String(prompt.capcode));
@@ -4113,7 +6137,7 @@ bool chatgpt_execute_prompt(ChatGPTPrompt& prompt, int prompt_index) {
 
             if (chatgpt_config.chatgpt_notify_failures) {
                 String failure_msg = "ChatGPT Failed: " + String(prompt.name) + " - Queue full after 3 attempts";
-                queue_add_message(prompt.capcode, prompt.frequency, settings.default_txpower, prompt.mail_drop, failure_msg.c_str());
+                queue_add_message(prompt.capcode, prompt.frequency, settings.default_txpower, prompt.mail_drop, failure_msg.c_str(), TX_SOURCE_CHATGPT);
             }
 
             prompt.retry_count = 0;
@@ -4164,7 +6188,9 @@ String chatgpt_query(String prompt, String api_key) {
 
     logMessage("CHATGPT: Sending query to OpenAI API");
     logMessage("CHATGPT: Query payload: " + json_request);
+    unsigned long request_start = millis();
     int httpCode = http.POST(json_request);
+    metrics_observe(&metric_chatgpt_request, millis() - request_start);
     chatgpt_last_http_code = httpCode;
 
     String response = "";
@@ -4560,278 +6586,49 @@ void check_wifi_connection() {
 }
 
 
+void web_asset_append_url(String& out, const WebAsset& asset) {
+    out += asset.path;
+    out += "?v=";
+    for (const char* p = asset.etag; *p; p++) {
+        if (*p != '"') out += *p;
+    }
+}
+
+void handle_web_asset(const WebAsset& asset) {
+    // If-None-Match may hold a list or a W/ prefix; containment of our strong tag is enough.
+    if (webServer.hasHeader("If-None-Match") && webServer.header("If-None-Match").indexOf(asset.etag) >= 0) {
+        webServer.sendHeader("ETag", asset.etag);
+        webServer.sendHeader("Cache-Control", "public, max-age=31536000, immutable");
+        webServer.send(304);
+        return;
+    }
+
+    webServer.sendHeader("ETag", asset.etag);
+    webServer.sendHeader("Cache-Control", "public, max-age=31536000, immutable");
+    webServer.sendHeader("Content-Encoding", "gzip");
+    webServer.send_P(200, asset.content_type, (const char*)asset.data, asset.length);
+}
+
 String get_html_header(String title) {
-    String theme_bg = "#FFFFFF";
-    String theme_card = "#F2F2F2";
-    String theme_text = "#222222";
-    String theme_accent = "#222222";
-    String theme_button = "#222222";
-    String theme_button_hover = "#000000";
-    String theme_input = "#FFFFFF";
-    String theme_border = "#E0E0E0";
-    String theme_nav_active = "#222222";
-    String theme_nav_inactive = "#999999";
-    String theme_background = "#FFFFFF";
-    String theme_nav_hover = "#F0F0F0";
-
-    if (settings.theme == 0) {
-        theme_bg = "#FFFFFF";
-        theme_card = "#F8F9FA";
-        theme_text = "#222222";
-        theme_accent = "#333333";
-        theme_button = "#333333";
-        theme_button_hover = "#000000";
-        theme_input = "#FFFFFF";
-        theme_border = "#E0E0E0";
-        theme_nav_active = "#333333";
-        theme_nav_inactive = "#999999";
-        theme_background = "#FFFFFF";
-        theme_nav_hover = "#F0F0F0";
-    } else if (settings.theme == 1) {
-        theme_bg = "#121212";
-        theme_card = "#1E1E1E";
-        theme_text = "#E0E0E0";
-        theme_accent = "#FFFFFF";
-        theme_button = "#404040";
-        theme_button_hover = "#555555";
-        theme_input = "#2A2A2A";
-        theme_border = "#404040";
-        theme_nav_active = "#404040";
-        theme_nav_inactive = "#888888";
-        theme_background = "#2A2A2A";
-        theme_nav_hover = "#3A3A3A";
-    }
-
-    return "<!DOCTYPE html><html><head><title>" + title + "</title>"
-           "<meta charset='utf-8'>"
-           "<meta name='viewport' content='width=device-width, initial-scale=1'>"
-           "<style>"
-           ":root {"
-           "  --theme-bg: " + theme_bg + ";"
-           "  --theme-card: " + theme_card + ";"
-           "  --theme-text: " + theme_text + ";"
-           "  --theme-accent: " + theme_accent + ";"
-           "  --theme-button: " + theme_button + ";"
-           "  --theme-button-hover: " + theme_button_hover + ";"
-           "  --theme-input: " + theme_input + ";"
-           "  --theme-border: " + theme_border + ";"
-           "  --theme-nav-active: " + theme_nav_active + ";"
-           "  --theme-nav-inactive: " + theme_nav_inactive + ";"
-           "  --theme-background: " + theme_background + ";"
-           "  --theme-nav-hover: " + theme_nav_hover + ";"
-           "}"
-           "body { font-family: 'Segoe UI', Arial, sans-serif; margin: 0; padding: 20px; background-color: var(--theme-bg); color: var(--theme-text); line-height: 1.6; transition: all 0.3s ease; }"
-           ".container { max-width: 800px; margin: 0 auto; background-color: var(--theme-card); padding: 30px; border-radius: 16px; box-shadow: 0 8px 32px rgba(0,0,0,0.1); border: 1px solid var(--theme-border); transition: all 0.3s ease; }"
-           ".header { text-align: center; margin-bottom: 30px; }"
-           ".header h1 { color: var(--theme-accent); margin: 0; font-size: 2.2em; font-weight: 300; letter-spacing: -0.5px; transition: color 0.3s ease; }"
-           ".header p { color: var(--theme-text); margin: 10px 0 0 0; opacity: 0.8; transition: color 0.3s ease; }"
-           ".form-group { margin-bottom: 24px; }"
-           ".form-group label { display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text); font-size: 14px; transition: color 0.3s ease; }"
-           ".form-group input, .form-group select, .form-group textarea, .input-std { width: 100%; padding: 14px 16px; border: 2px solid var(--theme-border); border-radius: 12px; font-size: 16px; box-sizing: border-box; background-color: var(--theme-input); color: var(--theme-text); transition: all 0.3s ease; }"
-           ".form-group input:focus, .form-group select:focus, .form-group textarea:focus, .input-std:focus { outline: none; border-color: var(--theme-accent); box-shadow: 0 0 0 3px var(--theme-accent)20; transform: translateY(-1px); }"
-           ".button { background-color: var(--theme-button); color: white; padding: 14px 28px; border: none; border-radius: 12px; cursor: pointer; font-size: 16px; font-weight: 500; text-decoration: none; display: inline-block; margin: 8px 6px; transition: all 0.3s ease; }"
-           ".button:hover { background-color: var(--theme-button-hover); transform: translateY(-2px); box-shadow: 0 4px 12px rgba(0,0,0,0.15); }"
-           ".button.secondary { background-color: var(--theme-nav-inactive); color: var(--theme-text); }"
-           ".button.secondary:hover { background-color: var(--theme-nav-active); color: white; }"
-           ".button.success { background-color: #28a745 !important; color: white !important; }"
-           ".button.success:hover { background-color: #1e7e34 !important; }"
-           ".button.edit { background-color: #007bff !important; color: white !important; }"
-           ".button.edit:hover { background-color: #0056b3 !important; }"
-           ".button.danger { background-color: #dc3545 !important; color: white !important; }"
-           ".button.danger:hover { background-color: #c82333 !important; }"
-           ".nav { display: flex; justify-content: center; margin-bottom: 30px; background-color: transparent; border-bottom: 2px solid var(--theme-border); }"
-           ".nav a { flex: 1; max-width: 150px; padding: 14px 8px; text-decoration: none; font-weight: 500; font-size: 13px; text-align: center; border-bottom: 3px solid transparent; transition: all 0.3s ease; color: var(--theme-nav-inactive); position: relative; }"
-           ".nav a.tab-active { color: var(--theme-accent); border-bottom-color: var(--theme-accent); background-color: var(--theme-input); }"
-           ".nav a.tab-inactive { color: var(--theme-nav-inactive); }"
-           ".nav a.tab-inactive:hover { color: var(--theme-text); background-color: var(--theme-nav-hover); }"
-           ".status { padding: 16px 20px; border-radius: 12px; margin: 24px 0; font-weight: 500; border: none; }"
-           ".status.success { background-color: #10B981; color: white; box-shadow: 0 4px 12px rgba(16, 185, 129, 0.3); }"
-           ".status.error { background-color: #EF4444; color: white; box-shadow: 0 4px 12px rgba(239, 68, 68, 0.3); }"
-           ".char-counter { font-size: 13px; color: var(--theme-nav-inactive); margin-top: 8px; font-weight: 500; transition: color 0.3s ease; }"
-           ".progress-bar { width: 100%; height: 8px; background-color: var(--theme-border); border-radius: 6px; margin-top: 8px; overflow: hidden; transition: background-color 0.3s ease; }"
-           ".progress-fill { height: 100%; background: linear-gradient(90deg, var(--theme-accent), var(--theme-button)); border-radius: 6px; transition: all 0.4s ease; }"
-           "h3 { color: var(--theme-accent); font-weight: 500; font-size: 1.3em; margin-bottom: 16px; transition: color 0.3s ease; }"
-           "p { margin-bottom: 12px; color: var(--theme-text); transition: color 0.3s ease; }"
-           ".serial-log { background-color: var(--theme-input); border: 2px solid var(--theme-border); border-radius: 12px; padding: 20px; max-height: 300px; overflow-y: auto; font-family: 'Courier New', monospace; font-size: 13px; line-height: 1.4; transition: all 0.3s ease; }"
-           ".serial-log div { margin-bottom: 6px; }"
-           ".serial-log .timestamp { color: var(--theme-nav-inactive); font-weight: bold; transition: color 0.3s ease; }"
-           "#temp-message { position: fixed; top: 20px; right: 20px; z-index: 1000; max-width: 400px; padding: 16px 20px; border-radius: 12px; font-weight: 500; box-shadow: 0 8px 32px rgba(0,0,0,0.2); transform: translateX(calc(100% + 50px)); transition: transform 0.4s ease; }"
-           "#temp-message.show { transform: translateX(0); }"
-           "#temp-message.success { background-color: #10B981; color: white; }"
-           "#temp-message.error { background-color: #EF4444; color: white; }"
-           "#temp-message.warning { background-color: #F59E0B; color: white; }"
-           "#temp-message.info { background-color: #3B82F6; color: white; }"
-           "input:-webkit-autofill, input:-webkit-autofill:hover, input:-webkit-autofill:focus, input:-webkit-autofill:active { -webkit-box-shadow: 0 0 0 1000px var(--theme-input) inset !important; -webkit-text-fill-color: var(--theme-text) !important; background-color: var(--theme-input) !important; }"
-           "input:-moz-autofill { background-color: var(--theme-input) !important; color: var(--theme-text) !important; }"
-           "input[type='text'] { background-color: var(--theme-input) !important; }"
-           "select { background-color: var(--theme-input) !important; }"
-           ".toggle-switch { position: relative; width: 50px; height: 24px; border-radius: 12px; cursor: pointer; transition: background-color 0.3s; display: inline-block; }"
-           ".toggle-slider { position: absolute; top: 2px; width: 20px; height: 20px; background-color: white; border-radius: 50%; transition: left 0.3s; }"
-           ".nav-status-enabled { color: #28a745 !important; }"
-           ".nav-status-disabled { color: #dc3545 !important; }"
-           ".flex-row { display: flex; gap: 12px; }"
-           ".flex-row-wrap { display: flex; gap: 15px; flex-wrap: wrap; }"
-           ".flex-space-between { display: flex; justify-content: space-between; align-items: center; }"
-           ".flex-center { display: flex; align-items: center; gap: 12px; }"
-           ".form-section { margin: 20px 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card); }"
-           ".form-row { display: flex; gap: 15px; margin-bottom: 20px; }"
-           ".form-col { flex: 1; margin-bottom: 0; }"
-           ".text-large { font-size: 1.1em; font-weight: 500; }"
-           ".mb-20 { margin-bottom: 20px; }"
-           ".mb-0 { margin-bottom: 0; }"
-           ".text-success { color: #28a745; }"
-           ".text-danger { color: #dc3545; }"
-           ".text-warning { color: #F59E0B; }"
-           ".text-info { color: #3B82F6; }"
-           ".text-muted { color: var(--theme-nav-inactive); }"
-           ".toggle-switch.is-active { background-color: #28a745; }"
-           ".toggle-switch.is-inactive { background-color: #ccc; }"
-           ".toggle-slider.is-active { left: 26px; }"
-           ".toggle-slider.is-inactive { left: 2px; }"
-           ".button-compact { padding: 8px 12px; font-size: 0.85em; }"
-           ".button-medium { padding: 10px 20px; font-size: 14px; }"
-           ".button-large { padding: 15px 30px; font-size: 16px; font-weight: 500; }"
-           ".modal { display: none; position: fixed; z-index: 1000; left: 0; top: 0; width: 100%; height: 100%; background-color: rgba(0,0,0,0.7); }"
-           ".modal.show { display: block; }"
-           ".modal-content { background-color: var(--theme-card); margin: 15% auto; padding: 25px; border-radius: 12px; width: 400px; max-width: 90%; border: 2px solid var(--theme-border); box-shadow: 0 10px 30px rgba(0,0,0,0.3); }"
-           ".grid-three { display: grid; grid-template-columns: 1fr 1fr 1fr; gap: 12px; margin-bottom: 12px; font-size: 0.9em; }"
-           ".grid-two { display: grid; grid-template-columns: 1fr 1fr; gap: 12px; }"
-           ".alert { padding: 15px; margin: 20px; border-radius: 8px; border: 2px solid; }"
-           ".alert-danger { background-color: var(--theme-card); color: #dc3545; border-color: #dc3545; }"
-           ".card { background-color: var(--theme-card); border: 1px solid var(--theme-border); border-radius: 12px; padding: 20px; margin-bottom: 15px; position: relative; }"
-           ".card-header { display: flex; justify-content: space-between; align-items: flex-start; margin-bottom: 12px; }"
-           ".mt-20 { margin-top: 20px; }"
-           ".text-right { text-align: right; }"
-           ".flex-col { display: flex; flex-direction: column; gap: 6px; }"
-           ".flex-align-center { display: flex; align-items: center; gap: 6px; }"
-           ".grid-span-2 { grid-column: 1 / span 2; }"
-           "</style>"
-           "<script>"
-           "function showTempMessage(message, type, duration) {"
-           "  var msgDiv = document.getElementById('temp-message');"
-           "  if (!msgDiv) {"
-           "    msgDiv = document.createElement('div');"
-           "    msgDiv.id = 'temp-message';"
-           "    document.body.appendChild(msgDiv);"
-           "  }"
-           "  msgDiv.textContent = message;"
-           "  msgDiv.className = type + ' show';"
-           "  setTimeout(function() {"
-           "    msgDiv.classList.remove('show');"
-           "  }, duration || 5000);"
-           "}"
-           "var themes = ["
-           "  {bg:'#FFFFFF',card:'#F8F9FA',text:'#222222',accent:'#333333',button:'#333333',buttonHover:'#000000',input:'#FFFFFF',border:'#E0E0E0',navActive:'#333333',navInactive:'#999999'},"
-           "  {bg:'#121212',card:'#1E1E1E',text:'#E0E0E0',accent:'#FFFFFF',button:'#404040',buttonHover:'#555555',input:'#2A2A2A',border:'#404040',navActive:'#404040',navInactive:'#888888'}"
-           "];"
-           "function applyTheme(themeIndex) {"
-           "  var theme = themes[themeIndex];"
-           "  var root = document.documentElement;"
-           "  root.style.setProperty('--theme-bg', theme.bg);"
-           "  root.style.setProperty('--theme-card', theme.card);"
-           "  root.style.setProperty('--theme-text', theme.text);"
-           "  root.style.setProperty('--theme-accent', theme.accent);"
-           "  root.style.setProperty('--theme-button', theme.button);"
-           "  root.style.setProperty('--theme-button-hover', theme.buttonHover);"
-           "  root.style.setProperty('--theme-input', theme.input);"
-           "  root.style.setProperty('--theme-border', theme.border);"
-           "  root.style.setProperty('--theme-nav-active', theme.navActive);"
-           "  root.style.setProperty('--theme-nav-inactive', theme.navInactive);"
-           "}"
-           "function onThemeChange() {"
-           "  var themeSelect = document.getElementById('theme');"
-           "  if (themeSelect) {"
-           "    applyTheme(parseInt(themeSelect.value));"
-           "  }"
-           "}"
-           "function submitFormAjax(form, successMsg, restartMsg) {"
-           "  var formData = new FormData(form);"
-           "  fetch(form.action, { method: 'POST', body: formData })"
-           "  .then(response => response.json())"
-           "  .then(data => {"
-           "    if (data.success) {"
-           "      if (data.restart) {"
-           "        showTempMessage(restartMsg || 'Settings saved, restarting in 5 seconds...', 'info', 5000);"
-           "        setTimeout(() => location.reload(), 5000);"
-           "      } else {"
-           "        showTempMessage(successMsg || 'Settings saved successfully!', 'success', 5000);"
-           "      }"
-           "    } else {"
-           "      showTempMessage('Error: ' + (data.error || 'Failed to save settings'), 'error', 5000);"
-           "    }"
-           "  })"
-           "  .catch(() => showTempMessage('Network error occurred', 'error', 5000));"
-           "  return false;"
-           "}"
-           "function pollLogs() {"
-           "  fetch('/logs')"
-           "    .then(response => response.json())"
-           "    .then(data => {"
-           "      if (data.logs && data.logs.length > 0) {"
-           "        data.logs.forEach(log => {"
-           "          if (log.timestamp > lastLogTimestamp) {"
-           "            lastLogTimestamp = Math.max(lastLogTimestamp, log.timestamp);"
-           "          }"
-           "        });"
-           "      }"
-           "    })"
-           "    .catch(() => {});"
-           "}"
-           "function updateServerSettings() {"
-           "  var serverInput = document.getElementById('imap_server');"
-           "  var portField = document.getElementById('imap_port');"
-           "  var sslField = document.getElementById('imap_use_ssl');"
-           "  "
-           "  if (serverInput.value === 'imap.gmail.com' || serverInput.value === 'outlook.office365.com' || serverInput.value === 'imap.mail.yahoo.com') {"
-           "    portField.value = '993';"
-           "    sslField.value = '1';"
-           "  }"
-           "}"
-           "function updateToggleVisual(checkbox) {"
-           "  var toggle = checkbox.parentElement;"
-           "  var slider = toggle.querySelector('.toggle-slider');"
-           "  if (checkbox.checked) {"
-           "    toggle.classList.add('is-active');"
-           "    toggle.classList.remove('is-inactive');"
-           "    slider.classList.add('is-active');"
-           "    slider.classList.remove('is-inactive');"
-           "  } else {"
-           "    toggle.classList.add('is-inactive');"
-           "    toggle.classList.remove('is-active');"
-           "    slider.classList.add('is-inactive');"
-           "    slider.classList.remove('is-active');"
-           "  }"
-           "}"
-           "function universalToggleSwitch(switchElement, hiddenInputId, callback) {"
-           "  var slider = switchElement.querySelector('.toggle-slider');"
-           "  var hiddenInput = hiddenInputId ? document.getElementById(hiddenInputId) : null;"
-           "  var currentEnabled = switchElement.classList.contains('is-active');"
-           "  var newEnabled = !currentEnabled;"
-           "  if (newEnabled) {"
-           "    switchElement.classList.add('is-active');"
-           "    switchElement.classList.remove('is-inactive');"
-           "    slider.classList.add('is-active');"
-           "    slider.classList.remove('is-inactive');"
-           "  } else {"
-           "    switchElement.classList.add('is-inactive');"
-           "    switchElement.classList.remove('is-active');"
-           "    slider.classList.add('is-inactive');"
-           "    slider.classList.remove('is-active');"
-           "  }"
-           "  if (hiddenInput) hiddenInput.value = newEnabled ? '1' : '0';"
-           "  if (callback) callback(newEnabled);"
-           "  return newEnabled;"
-           "}"
-           "document.addEventListener('DOMContentLoaded', function() {"
-           "  var toggles = document.querySelectorAll('.toggle-switch input[type=\"checkbox\"]');"
-           "  toggles.forEach(function(toggle) {"
-           "    toggle.addEventListener('change', function() {"
-           "      updateToggleVisual(this);"
-           "    });"
-           "  });"
-           "});"
-           "</script>"
-           "</head><body><div class='container'>";
+    // Shared CSS/JS live in web_assets.h as gzipped, ETag'd blobs served by handle_web_asset();
+    // pages only carry a reference, versioned by ETag so browsers can cache them indefinitely.
+    const WebAsset& theme_css = web_assets[settings.theme == 1 ? WEB_ASSET_THEME_DARK_CSS : WEB_ASSET_THEME_LIGHT_CSS];
+    const WebAsset& app_js = web_assets[WEB_ASSET_APP_JS];
+
+    String header;
+    header.reserve(320 + title.length());
+    header += "<!DOCTYPE html><html><head><title>";
+    header += title;
+    header += "</title>"
+              "<meta charset='utf-8'>"
+              "<meta name='viewport' content='width=device-width, initial-scale=1'>"
+              "<link rel='stylesheet' href='";
+    web_asset_append_url(header, theme_css);
+    header += "'><script src='";
+    web_asset_append_url(header, app_js);
+    header += "'></script>"
+              "</head><body><div class='container'>";
+    return header;
 }
 
 String get_html_footer() {
@@ -5022,19 +6819,19 @@ void handle_send_message() {
         message_was_truncated = true;
     }
 
-    if (queue_add_message(capcode, frequency, power, mail_drop, message.c_str())) {
+    if (queue_add_message(capcode, frequency, power, mail_drop, message.c_str(), TX_SOURCE_WEB)) {
         String response_message;
         if (message_was_truncated) {
             if (device_state == STATE_IDLE) {
                 response_message = "Message truncated to 248 chars and queued for immediate transmission";
             } else {
-                response_message = "Message truncated to 248 chars and queued for transmission (position " + String(queue_count) + ")";
+                response_message = "Message truncated to 248 chars and queued for transmission (position " + String(queue_count.load()) + ")";
             }
         } else {
             if (device_state == STATE_IDLE) {
                 response_message = "Message queued for immediate transmission";
             } else {
-                response_message = "Message queued for transmission (position " + String(queue_count) + ")";
+                response_message = "Message queued for transmission (position " + String(queue_count.load()) + ")";
             }
         }
 
@@ -6654,6 +8451,14 @@ void handle_configuration() {
     String rsyslog_hidden = "<input type='hidden' id='rsyslog_enabled' name='rsyslog_enabled' value='" + String(settings.rsyslog_enabled ? "1" : "0") + "'>";
     webServer.sendContent(rsyslog_hidden);
 
+    String log_storage_section = "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
+                                 "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>💾 Local Log Storage</h4>"
+                                 "<label for='log_storage_kb' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Log Size (KB):</label>"
+                                 "<input type='number' id='log_storage_kb' name='log_storage_kb' value='" + String(settings.log_storage_kb) + "' min='" + String(LOG_STORAGE_KB_MIN) + "' max='" + String(log_store_max_kb()) + "' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+                                 "<small style='display: block; margin-top: 5px; color: #666;'>Flash used by the persistent log, kept as " + String(LOG_SEGMENT_COUNT) + " segments; the oldest segment is dropped when full. Up to " + String(log_store_max_kb()) + " KB on this device (a quarter of SPIFFS), currently using " + String(log_segment_limit * LOG_SEGMENT_COUNT / 1024) + " KB</small>"
+                                 "</div>";
+    webServer.sendContent(log_storage_section);
+
     String alerts_section = "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
                            "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>🚨 System Alerts</h4>"
                            "<div style='display: flex; align-items: center; gap: 12px;'>"
@@ -6802,20 +8607,86 @@ void handle_flex_config() {
             "</div>"
 
             "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
-            "<div style='display: flex; justify-content: space-between; align-items: center; margin-bottom: 15px;'>"
-            "<h4 style='margin: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>📡 External RF Amplifier</h4>"
-            "<div id='toggle_rf_enable' class='toggle-switch " + String(settings.enable_rf_amplifier ? "is-active" : "is-inactive") + "' onclick='toggleRFAmplifier()'>"
-            "<div class='toggle-slider " + String(settings.enable_rf_amplifier ? "is-active" : "is-inactive") + "'></div>"
-            "</div>"
-            "</div>"
+            "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>🔁 EMR Preamble</h4>"
             "<div style='margin-bottom: 16px;'>"
-            "<label for='rf_amplifier_power_pin' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Power Pin (GPIO):</label>"
-            "<input type='number' id='rf_amplifier_power_pin' name='rf_amplifier_power_pin' value='" + String((settings.rf_amplifier_power_pin == 0) ? RFAMP_PWR_PIN : settings.rf_amplifier_power_pin) + "' min='0' max='39' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<label for='emr_interval_s' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Interval (seconds):</label>"
+            "<input type='number' id='emr_interval_s' name='emr_interval_s' value='" + String(settings.emr_interval_s) + "' min='0' max='3600' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Send EMR before a page after this much idle time, 0 = never</small>"
+            "</div>"
+            "<div>"
+            "<label for='emr_pattern' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Pattern (hex):</label>"
+            "<input type='text' id='emr_pattern' name='emr_pattern' value='" + emr_pattern_to_hex(settings.emr_pattern, settings.emr_pattern_length) + "' maxlength='16' pattern='([0-9A-Fa-f]{2}){1,8}' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>1-8 bytes, sent in the same FIFO stream as the page</small>"
+            "</div>"
+            "</div>"
+
+            "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
+            "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>🕐 Frame Alignment</h4>"
+            "<label for='frame_alignment' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Collapse:</label>"
+            "<select id='frame_alignment' name='frame_alignment' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);'>"
+            "<option value='off'" + String(settings.flex_frame_alignment ? "" : " selected") + ">Off (send immediately)</option>";
+    for (int c = 0; c <= FLEX_COLLAPSE_MAX; c++) {
+        bool selected = settings.flex_frame_alignment && settings.flex_frame_collapse == c;
+        chunk += "<option value='" + String(c) + "'" + String(selected ? " selected" : "") + ">" + String(c) +
+                 " - every " + String((1 << c) * FLEX_FRAME_MS / 1000.0, 2) + " s</option>";
+    }
+    chunk += "</select>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Hold each page for its capcode's FLEX frame (home frame = capcode mod 128). Needs RTC or NTP time</small>"
+            "</div>"
+
+            "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
+            "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>⏱️ Airtime Budget</h4>"
+            "<div style='margin-bottom: 16px;'>"
+            "<label for='airtime_budget_minute_s' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Per Minute (seconds):</label>"
+            "<input type='number' id='airtime_budget_minute_s' name='airtime_budget_minute_s' value='" + String(settings.airtime_budget_minute_s) + "' min='0' max='60' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "</div>"
+            "<div>"
+            "<label for='airtime_budget_hour_s' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Per Hour (seconds):</label>"
+            "<input type='number' id='airtime_budget_hour_s' name='airtime_budget_hour_s' value='" + String(settings.airtime_budget_hour_s) + "' min='0' max='3600' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>TX time allowed per frequency, 0 = unlimited. API/Grafana return 429 when exhausted</small>"
+            "</div>"
+            "</div>"
+
+            "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
+            "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>🧹 Duplicate Suppression</h4>"
+            "<div style='display: grid; grid-template-columns: 1fr 1fr; gap: 10px;'>";
+
+    for (int i = TX_SOURCE_API; i <= TX_SOURCE_IMAP; i++) {
+        chunk += "<div><label for='dedup_" + String(tx_source_names[i]) + "' style='display: block; margin-bottom: 4px; font-weight: 500; color: var(--theme-text);'>" + String(tx_source_names[i]) + " (s):</label>"
+                 "<input type='number' id='dedup_" + String(tx_source_names[i]) + "' name='dedup_" + String(tx_source_names[i]) + "' value='" + String(settings.dedup_window_s[i]) + "' min='0' max='3600' style='width:100%;padding:8px 12px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);'></div>";
+    }
+
+    chunk += "</div>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Identical capcode + text queued or sent within the window is not transmitted again, 0 = off</small>"
+            "</div>"
+
+            "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
+            "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>👥 Pager Groups</h4>"
+            "<textarea id='pager_groups' name='pager_groups' rows='5' placeholder='oncall: 1234567, 1234568' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-family:monospace;font-size:14px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);resize:vertical;'>" +
+            pager_groups_to_text(settings.pager_groups) + "</textarea>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>One group per line, up to " + String(PAGER_GROUP_MAX) + " groups of " + String(PAGER_GROUP_MEMBERS_MAX) + " capcodes. Send to a group with \"group\" in API/MQTT messages or a group label in Grafana alerts</small>"
+            "</div>"
+
+            "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
+            "<div style='display: flex; justify-content: space-between; align-items: center; margin-bottom: 15px;'>"
+            "<h4 style='margin: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>📡 External RF Amplifier</h4>"
+            "<div id='toggle_rf_enable' class='toggle-switch " + String(settings.enable_rf_amplifier ? "is-active" : "is-inactive") + "' onclick='toggleRFAmplifier()'>"
+            "<div class='toggle-slider " + String(settings.enable_rf_amplifier ? "is-active" : "is-inactive") + "'></div>"
+            "</div>"
+            "</div>"
+            "<div style='margin-bottom: 16px;'>"
+            "<label for='rf_amplifier_power_pin' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Power Pin (GPIO):</label>"
+            "<input type='number' id='rf_amplifier_power_pin' name='rf_amplifier_power_pin' value='" + String((settings.rf_amplifier_power_pin == 0) ? RFAMP_PWR_PIN : settings.rf_amplifier_power_pin) + "' min='0' max='39' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
             "</div>"
             "<div>"
             "<label for='rf_amplifier_delay_ms' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Stabilization Delay (ms):</label>"
             "<input type='number' id='rf_amplifier_delay_ms' name='rf_amplifier_delay_ms' value='" + String(settings.rf_amplifier_delay_ms) + "' min='20' max='5000' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
             "</div>"
+            "<div style='margin-top: 16px;'>"
+            "<label for='rf_amplifier_hold_ms' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Idle Hold (ms):</label>"
+            "<input type='number' id='rf_amplifier_hold_ms' name='rf_amplifier_hold_ms' value='" + String(settings.rf_amplifier_hold_ms) + "' min='0' max='60000' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Amplifier stays powered this long after the last page, so follow-up pages skip the stabilization delay</small>"
+            "</div>"
             "<div id='rf_amp_polarity_section' style='margin-top: 20px; margin-bottom: 16px;'>"
             "<label style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Amplifier Control Logic:</label>"
             "<div style='display: flex; align-items: center; gap: 12px; margin-bottom: 8px;'>"
@@ -6868,6 +8739,7 @@ void handle_flex_config() {
             "function updateRFAmpFieldsState(enabled) {"
             "  var powerPinInput = document.getElementById('rf_amplifier_power_pin');"
             "  var delayInput = document.getElementById('rf_amplifier_delay_ms');"
+            "  var holdInput = document.getElementById('rf_amplifier_hold_ms');"
             "  var polarityToggle = document.getElementById('toggle_rf_polarity');"
             "  var polaritySection = document.getElementById('rf_amp_polarity_section');"
             "  if (enabled) {"
@@ -6877,6 +8749,9 @@ void handle_flex_config() {
             "    delayInput.disabled = false;"
             "    delayInput.style.opacity = '1';"
             "    delayInput.style.cursor = 'text';"
+            "    holdInput.disabled = false;"
+            "    holdInput.style.opacity = '1';"
+            "    holdInput.style.cursor = 'text';"
             "    polarityToggle.style.pointerEvents = 'auto';"
             "    polaritySection.style.opacity = '1';"
             "  } else {"
@@ -6886,6 +8761,9 @@ void handle_flex_config() {
             "    delayInput.disabled = true;"
             "    delayInput.style.opacity = '0.5';"
             "    delayInput.style.cursor = 'not-allowed';"
+            "    holdInput.disabled = true;"
+            "    holdInput.style.opacity = '0.5';"
+            "    holdInput.style.cursor = 'not-allowed';"
             "    polarityToggle.style.pointerEvents = 'none';"
             "    polaritySection.style.opacity = '0.5';"
             "  }"
@@ -7043,6 +8921,14 @@ void handle_mqtt() {
             "</div>"
             "</div>"
             "</div>"
+            "<div class='flex-space-between mb-20'>"
+            "<div class='flex-center'>"
+            "<span style='text-large'>Keep unsent messages across reboots</span>"
+            "<div id='mqtt_outbox_persist_toggle' class='toggle-switch " + String(settings.mqtt_outbox_persist ? "is-active" : "is-inactive") + "' onclick='toggleMQTTOutboxPersist()'>"
+            "<div class='toggle-slider " + String(settings.mqtt_outbox_persist ? "is-active" : "is-inactive") + "'></div>"
+            "</div>"
+            "</div>"
+            "</div>"
             "</div>";
 
     webServer.sendContent(chunk);
@@ -7052,6 +8938,7 @@ void handle_mqtt() {
 
             "<input type='hidden' id='mqtt_enabled' name='mqtt_enabled' value='" + String(settings.mqtt_enabled ? "1" : "0") + "'>"
             "<input type='hidden' id='mqtt_notify_failures' name='mqtt_notify_failures' value='" + String(settings.mqtt_notify_failures ? "1" : "0") + "'>"
+            "<input type='hidden' id='mqtt_outbox_persist' name='mqtt_outbox_persist' value='" + String(settings.mqtt_outbox_persist ? "1" : "0") + "'>"
 
             "<div class='form-section' style='margin: 20px 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
             "<h4 style='margin-top: 0; color: var(--theme-text); display: flex; align-items: center; gap: 8px; font-size: 1.1em;'>🌐 AWS IoT Core Configuration</h4>"
@@ -7222,6 +9109,15 @@ void handle_mqtt() {
             "    hiddenInput.value = '0';"
             "  }"
             "}"
+            "function toggleMQTTOutboxPersist() {"
+            "  const toggleSwitch = document.getElementById('mqtt_outbox_persist_toggle');"
+            "  const toggleSlider = toggleSwitch.querySelector('.toggle-slider');"
+            "  const hiddenInput = document.getElementById('mqtt_outbox_persist');"
+            "  const newEnabled = hiddenInput.value !== '1';"
+            "  toggleSwitch.style.backgroundColor = newEnabled ? '#28a745' : '#ccc';"
+            "  toggleSlider.style.left = newEnabled ? '26px' : '2px';"
+            "  hiddenInput.value = newEnabled ? '1' : '0';"
+            "}"
             "function uploadCertificateAuto(certType) {"
             "  console.log('uploadCertificateAuto called with:', certType);"
             "  const fileInput = document.getElementById(certType + '_file');"
@@ -7694,6 +9590,9 @@ void handle_api_config() {
             "<label for='http_port' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>HTTP Port:</label>"
             "<input type='number' id='http_port' name='http_port' value='" + String(settings.http_port) + "' min='1' max='65535' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
             "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Port for HTTP API access (default: 80)</small>"
+            "<label for='api_ingest_port' style='display: block; margin: 16px 0 8px; font-weight: 500; color: var(--theme-text);'>Ingest Port:</label>"
+            "<input type='number' id='api_ingest_port' name='api_ingest_port' value='" + String(settings.api_ingest_port) + "' min='0' max='65535' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Extra listener serving only /api, /api/batch and /api/v1/alerts, e.g. 8080 (0 = off, default)</small>"
             "</div>"
 
             "<div class='form-section' style='margin: 0; border: 2px solid var(--theme-border); border-radius: 8px; padding: 20px; background-color: var(--theme-card);'>"
@@ -7707,6 +9606,11 @@ void handle_api_config() {
             "<input type='password' id='api_password' name='api_password' value='" + htmlEscape(String(settings.api_password)) + "' maxlength='64' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
             "</div>"
             "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>HTTP Basic Auth credentials for all API endpoints</small>"
+            "<div style='margin-top: 16px;'>"
+            "<label for='api_token' style='display: block; margin-bottom: 8px; font-weight: 500; color: var(--theme-text);'>Bearer Token (optional):</label>"
+            "<input type='password' id='api_token' name='api_token' value='" + htmlEscape(String(settings.api_token)) + "' maxlength='64' autocomplete='off' style='width:100%;padding:12px 16px;border:2px solid var(--theme-border);border-radius:8px;font-size:16px;box-sizing:border-box;background-color:var(--theme-input);color:var(--theme-text);transition:all 0.3s ease;'>"
+            "<small style='color: var(--theme-secondary); display: block; margin-top: 5px;'>Accepted as <code>Authorization: Bearer &lt;token&gt;</code> in place of Basic Auth. 16-64 characters, no spaces; leave empty to disable</small>"
+            "</div>"
             "</div>"
 
             "</div>";
@@ -7867,6 +9771,19 @@ void handle_save_api() {
         settings.api_enabled = (webServer.arg("api_enabled") == "1");
     }
 
+    if (webServer.hasArg("api_ingest_port")) {
+        long ingest_port = webServer.arg("api_ingest_port").toInt();
+        if (ingest_port < 0 || ingest_port > 65535) {
+            webServer.send(400, "text/plain", "Invalid ingest port range (must be 0-65535)");
+            return;
+        }
+        if (ingest_port == WEB_SERVER_PORT || ingest_port == http_port) {
+            webServer.send(400, "text/plain", "Ingest port must differ from the HTTP port");
+            return;
+        }
+        settings.api_ingest_port = (uint16_t)ingest_port;
+    }
+
     settings.http_port = http_port;
 
     if (webServer.hasArg("api_username")) {
@@ -7903,6 +9820,26 @@ void handle_save_api() {
         settings.api_password[sizeof(settings.api_password) - 1] = '\0';
     }
 
+    if (webServer.hasArg("api_token")) {
+        String token = webServer.arg("api_token");
+        token.trim();
+
+        if (token.length() > sizeof(settings.api_token) - 1) {
+            webServer.send(400, "text/plain", "Bearer token too long (max 64 chars)");
+            return;
+        }
+        if (token.length() > 0 && token.length() < API_TOKEN_MIN_LENGTH) {
+            webServer.send(400, "text/plain", "Bearer token too short (min 16 chars)");
+            return;
+        }
+        if (token.indexOf(' ') >= 0) {
+            webServer.send(400, "text/plain", "Bearer token cannot contain spaces");
+            return;
+        }
+
+        strlcpy(settings.api_token, token.c_str(), sizeof(settings.api_token));
+    }
+
     if (save_runtime_settings()) {
         webServer.send(200, "application/json", "{\"success\":true,\"message\":\"API settings saved successfully!\"}");
         logMessage("CONFIG: API settings saved - HTTP:" + String(http_port));
@@ -8158,78 +10095,136 @@ void handle_grafana_toggle() {
     }
 }
 
+static void log_json_append(String& out, const char* text, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = text[i];
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((uint8_t)c >= 32) out += c;
+                break;
+        }
+    }
+}
+
 void handle_logs() {
     reset_oled_timeout();
 
-    int numLines = 20;
+    LogQuery query = { 20, 0, 7, NULL };
+
     if (webServer.hasArg("lines")) {
-        numLines = webServer.arg("lines").toInt();
-        if (numLines <= 0) numLines = 20;
+        int numLines = webServer.arg("lines").toInt();
+        query.lines = (numLines > 0) ? numLines : 20;
+    }
+
+    // Device-local "YYYY-MM-DD HH:MM:SS" as shown in the log, or Unix seconds
+    if (webServer.hasArg("since")) {
+        String since = webServer.arg("since");
+        since.trim();
+        if (since.indexOf('-') > 0) {
+            query.since = log_line_time(since.c_str(), since.length());
+        } else if (since.toInt() > 0) {
+            query.since = since.toInt() + (long)(settings.timezone_offset_hours * 3600);
+        }
+        if (query.since == 0) {
+            webServer.send(400, "application/json", "{\"error\":\"Invalid since, use YYYY-MM-DD HH:MM:SS or Unix seconds\"}");
+            return;
+        }
+        if (!webServer.hasArg("lines")) {
+            query.lines = 0;
+        }
     }
 
-    String logs = read_log_tail(numLines);
-    String response = "{\"logs\":[";
-
-    int lineStart = 0;
-    int lineCount = 0;
-
-    for (int i = 0; i < logs.length(); i++) {
-        if (logs[i] == '\n') {
-            String line = logs.substring(lineStart, i);
-            lineStart = i + 1;
+    if (webServer.hasArg("severity")) {
+        int severity = webServer.arg("severity").toInt();
+        if (severity < 0 || severity > 7) {
+            webServer.send(400, "application/json", "{\"error\":\"severity must be 0-7\"}");
+            return;
+        }
+        query.max_severity = severity;
+    }
 
-            if (lineCount > 0) response += ",";
+    String prefix = webServer.arg("prefix");
+    if (prefix.length() > 0) {
+        query.prefix = prefix.c_str();
+    }
 
-            String timestamp = "";
-            String message = line;
+    webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    webServer.send(200, "application/json", "");
 
-            if (line.length() > 20) {
-                timestamp = line.substring(0, 19);
-                message = line.substring(20);
-            }
+    String chunk = "{\"logs\":[";
+    chunk.reserve(1280);
+    uint32_t count = 0;
 
-            response += "{";
-            response += "\"timestamp\":\"" + timestamp + "\",";
-            response += "\"message\":\"" + message + "\"";
-            response += "}";
+    log_store_query(&query, [&chunk, &count](const char* line, size_t len) {
+        if (count > 0) chunk += ",";
 
-            lineCount++;
+        chunk += "{\"timestamp\":\"";
+        if (len > 20) {
+            log_json_append(chunk, line, 19);
+            chunk += "\",\"message\":\"";
+            log_json_append(chunk, line + 20, len - 20);
+        } else {
+            chunk += "\",\"message\":\"";
+            log_json_append(chunk, line, len);
         }
-    }
+        chunk += "\"}";
+        count++;
 
-    response += "]}";
+        if (chunk.length() >= 1024) {
+            webServer.sendContent(chunk);
+            chunk = "";
+        }
+        return webServer.client().connected();
+    });
 
-    webServer.send(200, "application/json", response);
+    chunk += "],\"count\":" + String(count) + "}";
+    webServer.sendContent(chunk);
+    webServer.sendContent("");
 }
 
 void handle_download_logs() {
     reset_oled_timeout();
 
-    if (!SPIFFS.exists("/serial.log")) {
+    if (log_store_total_bytes() == 0) {
         webServer.send(404, "text/plain", "Log file not found");
         return;
     }
 
-    File file = SPIFFS.open("/serial.log", "r");
-    if (!file) {
-        webServer.send(500, "text/plain", "Failed to open log file");
-        return;
-    }
-
-    webServer.sendHeader("Content-Type", "text/plain");
+    // Chunked: the oldest segment may be rotated away while the download is in progress
     webServer.sendHeader("Content-Disposition", "attachment; filename=\"serial.log\"");
-    webServer.sendHeader("Content-Length", String(file.size()));
-
-    webServer.setContentLength(file.size());
+    webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
     webServer.send(200, "text/plain", "");
 
-    uint8_t buffer[512];
-    while (file.available()) {
-        size_t len = file.readBytes((char*)buffer, 512);
-        webServer.client().write(buffer, len);
+    if (log_lock != NULL) xSemaphoreTakeRecursive(log_lock, portMAX_DELAY);
+    uint8_t head = log_store_head;
+    uint32_t generation = log_store_generation;
+    if (log_lock != NULL) xSemaphoreGiveRecursive(log_lock);
+
+    char path[24];
+    char buffer[1024];
+    for (uint8_t age = 0; age < LOG_SEGMENT_COUNT; age++) {
+        if (log_store_generation - generation > age) continue;
+
+        log_segment_path((head + 1 + age) % LOG_SEGMENT_COUNT, path, sizeof(path));
+        File file = SPIFFS.open(path, "r");
+        if (!file) continue;
+
+        while (file.available()) {
+            size_t len = file.readBytes(buffer, sizeof(buffer));
+            if (len == 0 || log_store_generation - generation > age) break;
+            webServer.sendContent(buffer, len);
+            if (!webServer.client().connected()) {
+                file.close();
+                return;
+            }
+        }
+        file.close();
     }
-
-    file.close();
+    webServer.sendContent("");
 }
 
 void handle_device_status() {
@@ -8298,6 +10293,48 @@ void handle_device_status() {
     chunk += "<p><strong>Frequency:</strong> " + String(current_tx_frequency, 4) + " MHz</p>";
     chunk += "<p><strong>TX Power:</strong> " + String(tx_power, 1) + " dBm</p>";
     chunk += "<p><strong>Default Capcode:</strong> " + String(settings.default_capcode) + "</p>";
+    if (settings.emr_interval_s > 0) {
+        chunk += "<p><strong>EMR Preamble:</strong> " + emr_pattern_to_hex(settings.emr_pattern, settings.emr_pattern_length) +
+                 " every " + String(settings.emr_interval_s) + " s</p>";
+    } else {
+        chunk += "<p><strong>EMR Preamble:</strong> ❌ Disabled</p>";
+    }
+    if (settings.flex_frame_alignment) {
+        chunk += "<p><strong>Frame Alignment:</strong> collapse " + String(settings.flex_frame_collapse) +
+                 (system_time_initialized ? "" : " (⚠️ waiting for RTC/NTP time)") + ", " + String(tx_metrics.frame_aligned) + " frames";
+        if (tx_metrics.frame_aligned > 0) {
+            chunk += ", last cycle " + String(tx_metrics.last_cycle) + " frame " + String(tx_metrics.last_frame) + " after " +
+                     String(tx_metrics.last_frame_wait_ms) + " ms";
+        }
+        if (tx_metrics.fiw_unpatched > 0) {
+            chunk += ", ⚠️ " + String(tx_metrics.fiw_unpatched) + " sent without FIW update";
+        }
+        chunk += "</p>";
+    }
+    chunk += "<p><strong>Transmissions:</strong> " + String(tx_metrics.transmissions) + " (" + String(tx_metrics.emr_bursts) + " with EMR)";
+    if (tx_metrics.group_pages > 0) {
+        chunk += ", " + String(tx_metrics.group_pages) + " to groups";
+    }
+    if (tx_metrics.repeats_sent > 0 || tx_metrics.repeats_skipped > 0) {
+        chunk += ", " + String(tx_metrics.repeats_sent) + " repeats sent, " + String(tx_metrics.repeats_skipped) + " skipped";
+    }
+    chunk += "</p>";
+    if (tx_metrics.transmissions > 0) {
+        chunk += "<p><strong>Last TX Timing:</strong> setup " + String(tx_metrics.last_setup_ms) + " ms, airtime " +
+                 String(tx_metrics.last_airtime_ms) + " ms (EMR " + String(tx_metrics.last_emr_ms) + " ms)</p>";
+        chunk += "<p><strong>Channel Switching:</strong> last " + String(tx_metrics.last_switch_us) + " us, " +
+                 String(tx_metrics.profile_hits) + " cached / " + String(tx_metrics.profile_misses) + " full</p>";
+        chunk += "<p><strong>Back-to-Back:</strong> last turnaround " + String(tx_metrics.last_turnaround_ms) + " ms, " +
+                 String(tx_metrics.hot_starts) + " hot amplifier starts</p>";
+    }
+    chunk += airtime_status_html();
+    chunk += "<p><strong>Deduplicated Pages:</strong> " + String(dedup_suppressed_total());
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        if (dedup_suppressed[i] > 0) {
+            chunk += " · " + String(tx_source_names[i]) + " " + String(dedup_suppressed[i]);
+        }
+    }
+    chunk += "</p>";
     chunk += "</div>";
 
     chunk += "</div>";
@@ -8449,6 +10486,9 @@ void handle_device_status() {
         chunk += "<p><strong>Min Severity:</strong> " + severity_name + " (" + String(settings.rsyslog_min_severity) + ")</p>";
         chunk += "<p><strong>Hostname:</strong> " + String(settings.banner_message) + "</p>";
         chunk += "<p><strong>Facility:</strong> local0 (16)</p>";
+        chunk += "<p><strong>Shipper:</strong> " + String(syslog_connected ? "✅ Connected" : "⏳ Waiting") +
+                 " (" + String(syslog_sent) + " sent, " + String(syslog_ring_count) + " queued, " +
+                 String(syslog_dropped) + " dropped)</p>";
     }
     chunk += "</div>";
 
@@ -8481,6 +10521,13 @@ void handle_device_status() {
         chunk += "<p><strong>Subscribe Topic:</strong> " + String(settings.mqtt_subscribe_topic) + "</p>";
         chunk += "<p><strong>Publish Topic:</strong> " + String(settings.mqtt_publish_topic) + "</p>";
         chunk += "<p><strong>Initialized:</strong> " + String(mqtt_initialized ? "✅ Yes" : "❌ No") + "</p>";
+        chunk += "<p><strong>Outbox:</strong> " + String(mqtt_outbox_count) + "/" + String(MQTT_OUTBOX_SIZE) +
+                 " pending (peak " + String(mqtt_outbox_high_water) + "), " + String(mqtt_outbox_published) + " published";
+        uint32_t outbox_dropped = mqtt_outbox_dropped_oldest + mqtt_outbox_dropped_newest + delivery_events_dropped_total;
+        if (outbox_dropped > 0) {
+            chunk += ", <span style='color:#dc3545;'>" + String(outbox_dropped) + " dropped</span>";
+        }
+        chunk += "</p>";
 
         bool has_certs = (certificateExistsInSPIFFS(MQTT_CA_CERT_FILE) && certificateExistsInSPIFFS(MQTT_DEVICE_CERT_FILE) && certificateExistsInSPIFFS(MQTT_DEVICE_KEY_FILE));
         chunk += "<p><strong>SSL Certificates:</strong> " + String(has_certs ? "✅ Configured" : "⚠️ Using Insecure Connection") + "</p>";
@@ -8523,7 +10570,8 @@ void handle_device_status() {
         chunk += "<p><strong>Alert Mode:</strong> 📢 All Unread Emails</p>";
 
         if (queue_count > 0) {
-            chunk += "<p><strong>Queue:</strong> " + String(queue_count) + " message(s) pending</p>";
+            chunk += "<p><strong>Queue:</strong> " + String(queue_count.load()) + " message(s) pending (" +
+                     String(queue_bytes_used()) + "/" + String(queue_arena_capacity) + " bytes)</p>";
         }
 
         if (last_imap_check > 0) {
@@ -9162,6 +11210,11 @@ void handle_save_config() {
         }
     }
 
+    if (webServer.hasArg("log_storage_kb")) {
+        settings.log_storage_kb = constrain(webServer.arg("log_storage_kb").toInt(), LOG_STORAGE_KB_MIN, log_store_max_kb());
+        log_store_apply_size();
+    }
+
 
     if (webServer.hasArg("tx_power")) {
         float power = webServer.arg("tx_power").toFloat();
@@ -9262,6 +11315,74 @@ void handle_save_flex() {
         }
     }
 
+    if (webServer.hasArg("frame_alignment")) {
+        String alignment = webServer.arg("frame_alignment");
+        long collapse = alignment.toInt();
+        if (alignment == "off") {
+            settings.flex_frame_alignment = false;
+        } else if (collapse >= 0 && collapse <= FLEX_COLLAPSE_MAX) {
+            settings.flex_frame_alignment = true;
+            settings.flex_frame_collapse = (uint8_t)collapse;
+        }
+    }
+
+    if (webServer.hasArg("emr_interval_s")) {
+        long interval = webServer.arg("emr_interval_s").toInt();
+        if (interval >= 0 && interval <= 3600) {
+            settings.emr_interval_s = (uint16_t)interval;
+        }
+    }
+
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        String arg_name = "dedup_" + String(tx_source_names[i]);
+        if (webServer.hasArg(arg_name)) {
+            long window = webServer.arg(arg_name).toInt();
+            if (window >= 0 && window <= 3600) {
+                settings.dedup_window_s[i] = (uint16_t)window;
+            }
+        }
+    }
+
+    if (webServer.hasArg("pager_groups")) {
+        String error;
+        if (!pager_groups_parse(webServer.arg("pager_groups"), settings.pager_groups, error)) {
+            settings = old_settings;
+            JsonDocument response;
+            response["success"] = false;
+            response["message"] = "Pager groups: " + error;
+            String response_str;
+            serializeJson(response, response_str);
+            webServer.send(400, "application/json", response_str);
+            return;
+        }
+    }
+
+    if (webServer.hasArg("airtime_budget_minute_s")) {
+        long budget = webServer.arg("airtime_budget_minute_s").toInt();
+        if (budget >= 0 && budget <= 60) {
+            settings.airtime_budget_minute_s = (uint16_t)budget;
+        }
+    }
+
+    if (webServer.hasArg("airtime_budget_hour_s")) {
+        long budget = webServer.arg("airtime_budget_hour_s").toInt();
+        if (budget >= 0 && budget <= 3600) {
+            settings.airtime_budget_hour_s = (uint16_t)budget;
+        }
+    }
+
+    if (webServer.hasArg("emr_pattern") &&
+        !parse_emr_pattern(webServer.arg("emr_pattern").c_str(), settings.emr_pattern, &settings.emr_pattern_length)) {
+        settings = old_settings;
+        JsonDocument response;
+        response["success"] = false;
+        response["message"] = "EMR pattern must be 1 to " + String(EMR_PATTERN_MAX_LENGTH) + " bytes of hex";
+        String response_str;
+        serializeJson(response, response_str);
+        webServer.send(400, "application/json", response_str);
+        return;
+    }
+
     if (webServer.hasArg("enable_rf_amplifier")) {
         settings.enable_rf_amplifier = (webServer.arg("enable_rf_amplifier") == "1");
     } else {
@@ -9292,6 +11413,13 @@ void handle_save_flex() {
         }
     }
 
+    if (webServer.hasArg("rf_amplifier_hold_ms")) {
+        long hold_ms = webServer.arg("rf_amplifier_hold_ms").toInt();
+        if (hold_ms >= 0 && hold_ms <= 60000) {
+            settings.rf_amplifier_hold_ms = (uint16_t)hold_ms;
+        }
+    }
+
     if (webServer.hasArg("rf_amplifier_active_high")) {
         settings.rf_amplifier_active_high = (webServer.arg("rf_amplifier_active_high") == "1");
     } else {
@@ -9360,6 +11488,10 @@ void handle_save_mqtt() {
         settings.mqtt_publish_topic[sizeof(settings.mqtt_publish_topic) - 1] = '\0';
     }
 
+    if (webServer.hasArg("mqtt_outbox_persist")) {
+        settings.mqtt_outbox_persist = (webServer.arg("mqtt_outbox_persist") == "1");
+    }
+
     if (webServer.hasArg("ntp_server")) {
         String server = webServer.arg("ntp_server");
         server.trim();
@@ -9625,67 +11757,366 @@ void handle_upload_certificate() {
     uploaded_cert_data = "";
 }
 
-void flush_log_buffer_to_spiffs() {
-    if (log_buffer_len == 0) return;
+void log_segment_path(uint8_t segment, char* path, size_t size) {
+    snprintf(path, size, "/serial.%u.log", segment);
+}
 
-    File file = SPIFFS.open("/serial.log", "a");
-    if (file) {
-        file.write((const uint8_t*)log_buffer, log_buffer_len);
-        file.close();
+static void log_store_remove(const char* path) {
+    if (SPIFFS.exists(path)) {
+        SPIFFS.remove(path);
+    }
+}
 
-        File rf = SPIFFS.open("/serial.log", "r");
-        if (rf) {
-            size_t fileSize = rf.size();
-            rf.close();
-            if (fileSize > MAX_LOG_FILE_SIZE) {
-                trim_log_file();
-            }
+void log_index_line(uint8_t segment, uint32_t offset, const char* line, size_t len) {
+    LogSegmentLines* index = &log_segment_lines[segment];
+    if (index->lines % LOG_LINE_INDEX_STRIDE == 0 && index->points < LOG_LINE_INDEX_POINTS) {
+        index->point[index->points].offset = offset;
+        index->point[index->points].time = log_line_time(line, len);
+        index->points++;
+    }
+    if (index->lines < UINT16_MAX) {
+        index->lines++;
+    }
+}
+
+// Written to a temporary file and renamed into place, so a power cut leaves either the old or
+// the new index readable (SPIFFS cannot rename over an existing file, hence the remove first)
+static void log_store_write_index() {
+    LogStoreIndex index = { LOG_INDEX_MAGIC, LOG_INDEX_VERSION, LOG_SEGMENT_COUNT, log_store_head, 0, log_store_generation };
+    File file = SPIFFS.open(LOG_INDEX_TMP_FILE, "w");
+    if (!file) {
+        return;
+    }
+    size_t written = file.write((const uint8_t*)&index, sizeof(index));
+    file.close();
+    if (written != sizeof(index)) {
+        log_store_remove(LOG_INDEX_TMP_FILE);
+        return;
+    }
+    log_store_remove(LOG_INDEX_FILE);
+    SPIFFS.rename(LOG_INDEX_TMP_FILE, LOG_INDEX_FILE);
+}
+
+static bool log_store_read_index(const char* path, struct LogStoreIndex* index) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) {
+        return false;
+    }
+    size_t read = file.read((uint8_t*)index, sizeof(*index));
+    file.close();
+    return read == sizeof(*index) && index->magic == LOG_INDEX_MAGIC && index->version == LOG_INDEX_VERSION &&
+           index->segment_count == LOG_SEGMENT_COUNT && index->head < LOG_SEGMENT_COUNT;
+}
+
+// Without a readable index the head is the segment with the newest first line; with no clock
+// stamps to compare, it is the non-empty segment followed by an empty one (or else the smallest)
+static uint8_t log_store_recover_head() {
+    uint32_t newest_time = 0;
+    int newest = -1;
+    int before_empty = -1;
+    int smallest = 0;
+    size_t sizes[LOG_SEGMENT_COUNT];
+    char path[24];
+    char line[LOG_LINE_MAX];
+
+    for (uint8_t i = 0; i < LOG_SEGMENT_COUNT; i++) {
+        log_segment_path(i, path, sizeof(path));
+        sizes[i] = 0;
+        File segment = SPIFFS.open(path, "r");
+        if (!segment) continue;
+        segment.setTimeout(0);
+        sizes[i] = segment.size();
+        size_t len = segment.readBytesUntil('\n', line, sizeof(line) - 1);
+        segment.close();
+
+        uint32_t time = log_line_time(line, len);
+        if (time > newest_time) {
+            newest_time = time;
+            newest = i;
         }
     }
 
-    log_buffer_len    = 0;
-    log_last_flush_ms = millis();
+    for (uint8_t i = 0; i < LOG_SEGMENT_COUNT; i++) {
+        if (sizes[i] > 0 && sizes[(i + 1) % LOG_SEGMENT_COUNT] == 0) {
+            before_empty = i;
+        }
+        if (sizes[i] < sizes[smallest]) {
+            smallest = i;
+        }
+    }
+
+    if (newest >= 0) return (uint8_t)newest;
+    if (before_empty >= 0) return (uint8_t)before_empty;
+    return (uint8_t)smallest;
 }
 
-void flush_log_buffer_if_due() {
-    if (log_buffer_len > 0 && (millis() - log_last_flush_ms) >= LOG_FLUSH_INTERVAL_MS) {
-        flush_log_buffer_to_spiffs();
+// Largest log the filesystem allows: LOG_STORAGE_KB_MAX, capped at a quarter of SPIFFS
+uint16_t log_store_max_kb() {
+    uint32_t fs_quarter_kb = SPIFFS.totalBytes() / 4 / 1024;
+    if (fs_quarter_kb == 0 || fs_quarter_kb >= LOG_STORAGE_KB_MAX) {
+        return LOG_STORAGE_KB_MAX;
+    }
+    return (uint16_t)max(fs_quarter_kb, (uint32_t)LOG_STORAGE_KB_MIN);
+}
+
+// Segment size follows the configured total, capped by log_store_max_kb(). A change takes
+// effect at the next rotation; segments already larger than the new limit simply rotate.
+void log_store_apply_size() {
+    uint32_t total = (uint32_t)constrain(settings.log_storage_kb, LOG_STORAGE_KB_MIN, log_store_max_kb()) * 1024;
+    log_segment_limit = total / LOG_SEGMENT_COUNT;
+}
+
+void log_store_init() {
+    if (log_lock != NULL) xSemaphoreTakeRecursive(log_lock, portMAX_DELAY);
+
+    log_store_apply_size();
+
+    // A power cut between remove and rename leaves only the temporary index
+    LogStoreIndex index = {};
+    if (log_store_read_index(LOG_INDEX_FILE, &index) || log_store_read_index(LOG_INDEX_TMP_FILE, &index)) {
+        log_store_head = index.head;
+        log_store_generation = index.generation;
+    } else {
+        log_store_head = log_store_recover_head();
+        log_store_generation = 0;
+    }
+    log_store_write_index();
+
+    // Single-file log from earlier firmware
+    log_store_remove("/serial.log");
+    log_store_remove("/serial.tmp");
+
+    char path[24];
+    char line[LOG_LINE_MAX];
+    for (uint8_t i = 0; i < LOG_SEGMENT_COUNT; i++) {
+        log_segment_path(i, path, sizeof(path));
+        memset(&log_segment_lines[i], 0, sizeof(log_segment_lines[i]));
+        log_segment_bytes[i] = 0;
+
+        File segment = SPIFFS.open(path, "r");
+        if (!segment) continue;
+        segment.setTimeout(0);
+        uint32_t offset = 0;
+        while (segment.available()) {
+            size_t len = segment.readBytesUntil('\n', line, sizeof(line) - 1);
+            line[len] = '\0';
+            log_index_line(i, offset, line, len);
+            offset += len + 1;
+        }
+        log_segment_bytes[i] = segment.size();
+        segment.close();
+    }
+
+    log_store_ready = true;
+    if (log_lock != NULL) xSemaphoreGiveRecursive(log_lock);
+}
+
+static void log_store_rotate() {
+    char path[24];
+    log_store_head = (log_store_head + 1) % LOG_SEGMENT_COUNT;
+    log_segment_path(log_store_head, path, sizeof(path));
+    log_store_remove(path);
+    log_segment_bytes[log_store_head] = 0;
+    memset(&log_segment_lines[log_store_head], 0, sizeof(log_segment_lines[log_store_head]));
+    log_store_generation++;
+    log_store_rotations++;
+    log_store_write_index();
+}
+
+// Segments in age order: 0 is the oldest, LOG_SEGMENT_COUNT - 1 the head
+uint8_t log_store_segment_at(uint8_t age) {
+    return (log_store_head + 1 + age) % LOG_SEGMENT_COUNT;
+}
+
+uint32_t log_store_total_bytes() {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < LOG_SEGMENT_COUNT; i++) {
+        total += log_segment_bytes[i];
+    }
+    return total;
+}
+
+void log_store_clear() {
+    if (log_lock != NULL) xSemaphoreTakeRecursive(log_lock, portMAX_DELAY);
+    char path[24];
+    for (uint8_t i = 0; i < LOG_SEGMENT_COUNT; i++) {
+        log_segment_path(i, path, sizeof(path));
+        log_store_remove(path);
+        log_segment_bytes[i] = 0;
+        memset(&log_segment_lines[i], 0, sizeof(log_segment_lines[i]));
+    }
+    log_buffer_len = 0;
+    // Every segment is recycled, so queries in flight stop reading
+    log_store_generation += LOG_SEGMENT_COUNT;
+    log_store_write_index();
+    if (log_lock != NULL) xSemaphoreGiveRecursive(log_lock);
+}
+
+struct LogCursor {
+    uint8_t head;                   // Head segment when the query was planned
+    uint32_t generation;
+    uint8_t age;                    // First segment to read
+    uint32_t offset;
+    uint16_t skip;                  // Lines to skip after seeking
+};
+
+static bool log_cursor_before(const struct LogCursor* a, const struct LogCursor* b) {
+    return a->age < b->age || (a->age == b->age && a->offset < b->offset);
+}
+
+// Turns a query into a start position using only the in-RAM index
+static void log_store_plan(const struct LogQuery* query, struct LogCursor* cursor) {
+    if (log_lock != NULL) xSemaphoreTakeRecursive(log_lock, portMAX_DELAY);
+
+    cursor->head = log_store_head;
+    cursor->generation = log_store_generation;
+    cursor->age = 0;
+    cursor->offset = 0;
+    cursor->skip = 0;
+
+    if (query->lines > 0) {
+        uint32_t remaining = query->lines;
+        for (int age = LOG_SEGMENT_COUNT - 1; age >= 0; age--) {
+            const LogSegmentLines* index = &log_segment_lines[log_store_segment_at(age)];
+            if (index->lines >= remaining) {
+                uint16_t first_line = index->lines - remaining;
+                uint8_t point = min(first_line / LOG_LINE_INDEX_STRIDE, index->points - 1);
+                cursor->age = age;
+                cursor->offset = index->point[point].offset;
+                cursor->skip = first_line - point * LOG_LINE_INDEX_STRIDE;
+                break;
+            }
+            remaining -= index->lines;
+        }
+    }
+
+    if (query->since > 0) {
+        // Last checkpoint older than the requested time; lines are read forward from there
+        LogCursor since_cursor = *cursor;
+        since_cursor.age = 0;
+        since_cursor.offset = 0;
+        since_cursor.skip = 0;
+        bool found = false;
+        for (uint8_t age = 0; age < LOG_SEGMENT_COUNT && !found; age++) {
+            const LogSegmentLines* index = &log_segment_lines[log_store_segment_at(age)];
+            for (uint8_t point = 0; point < index->points; point++) {
+                if (index->point[point].time >= query->since) {
+                    found = true;
+                    break;
+                }
+                since_cursor.age = age;
+                since_cursor.offset = index->point[point].offset;
+            }
+        }
+        if (log_cursor_before(cursor, &since_cursor)) {
+            *cursor = since_cursor;
+        }
     }
+
+    if (log_lock != NULL) xSemaphoreGiveRecursive(log_lock);
+}
+
+static bool log_line_matches(const struct LogQuery* query, const char* line, size_t len) {
+    if (query->since > 0 && log_line_time(line, len) < query->since) return false;
+
+    const char* message = (len > 20) ? line + 20 : line;
+    if (query->max_severity < 7 && detectSeverity(message) > query->max_severity) return false;
+    if (query->prefix != NULL && query->prefix[0] != '\0' &&
+        strncmp(message, query->prefix, strlen(query->prefix)) != 0) return false;
+
+    return true;
 }
 
-void trim_log_file() {
-    File file = SPIFFS.open("/serial.log", "r");
-    if (!file) return;
+// True once the segment that had the given age at planning time has been rotated away and reused
+static bool log_cursor_recycled(const struct LogCursor* cursor, uint8_t age) {
+    return log_store_generation - cursor->generation > age;
+}
+
+// Streams matching lines oldest first. Only planning holds log_lock, so a slow consumer never
+// blocks logging. The generation is re-checked after every line read: once the segment being
+// read has been recycled the line is dropped and the query moves on to the next segment.
+// Emitting stops as soon as emit returns false.
+void log_store_query(const struct LogQuery* query, std::function<bool(const char*, size_t)> emit) {
+    LogCursor cursor;
+    log_store_plan(query, &cursor);
+
+    char path[24];
+    char line[LOG_LINE_MAX];
+    for (uint8_t age = cursor.age; age < LOG_SEGMENT_COUNT; age++) {
+        if (log_cursor_recycled(&cursor, age)) continue;
+
+        log_segment_path((cursor.head + 1 + age) % LOG_SEGMENT_COUNT, path, sizeof(path));
+        File file = SPIFFS.open(path, "r");
+        if (!file) continue;
+        file.setTimeout(0);
+
+        uint16_t skip = 0;
+        if (age == cursor.age) {
+            file.seek(cursor.offset);
+            skip = cursor.skip;
+        }
 
-    size_t fileSize = file.size();
-    if (fileSize <= MAX_LOG_FILE_SIZE) {
+        while (file.available()) {
+            size_t len = file.readBytesUntil('\n', line, sizeof(line) - 1);
+            line[len] = '\0';
+            if (log_cursor_recycled(&cursor, age)) break;
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            if (!log_line_matches(query, line, len)) continue;
+            if (!emit(line, len)) {
+                file.close();
+                return;
+            }
+        }
         file.close();
-        return;
     }
+}
 
-    size_t keepPosition = fileSize - LOG_TRUNCATE_SIZE;
-    file.seek(keepPosition);
+void flush_log_buffer_to_spiffs() {
+    if (log_buffer_len == 0 || !log_store_ready) return;
 
-    while (file.available() && file.read() != '\n');
+    uint32_t start_us = micros();
+    if (log_segment_bytes[log_store_head] > 0 &&
+        log_segment_bytes[log_store_head] + log_buffer_len > log_segment_limit) {
+        log_store_rotate();
+    }
 
-    File tmpFile = SPIFFS.open("/serial.tmp", "w");
-    uint8_t buffer[512];
+    char path[24];
+    log_segment_path(log_store_head, path, sizeof(path));
+    File file = SPIFFS.open(path, "a");
+    if (file) {
+        size_t written = file.write((const uint8_t*)log_buffer, log_buffer_len);
+        file.close();
 
-    while (file.available()) {
-        size_t len = file.readBytes((char*)buffer, 512);
-        tmpFile.write(buffer, len);
-        yield();
+        // The buffer only ever holds whole lines
+        uint32_t offset = log_segment_bytes[log_store_head];
+        size_t line_start = 0;
+        for (size_t i = 0; i < written; i++) {
+            if (log_buffer[i] == '\n') {
+                log_index_line(log_store_head, offset + line_start, log_buffer + line_start, i - line_start);
+                line_start = i + 1;
+            }
+        }
+        log_segment_bytes[log_store_head] += written;
     }
+    metrics_observe(&metric_log_flush, micros() - start_us);
 
-    file.close();
-    tmpFile.close();
+    log_buffer_len    = 0;
+    log_last_flush_ms = millis();
+}
 
-    SPIFFS.remove("/serial.log");
-    SPIFFS.rename("/serial.tmp", "/serial.log");
+void flush_log_buffer_if_due() {
+    if (log_buffer_len > 0 && (millis() - log_last_flush_ms) >= LOG_FLUSH_INTERVAL_MS) {
+        if (log_lock != NULL) xSemaphoreTakeRecursive(log_lock, portMAX_DELAY);
+        flush_log_buffer_to_spiffs();
+        if (log_lock != NULL) xSemaphoreGiveRecursive(log_lock);
+    }
 }
 
 void append_to_log_file(const char* message) {
-    char logLine[256];
+    char logLine[LOG_LINE_MAX];
 
     if (!system_time_initialized) {
         unsigned long uptime_seconds = millis() / 1000;
@@ -9704,11 +12135,15 @@ void append_to_log_file(const char* message) {
     }
 
     size_t lineLen = strlen(logLine);
+    if (lineLen == sizeof(logLine) - 1 && logLine[lineLen - 1] != '\n') {
+        logLine[lineLen - 1] = '\n';
+    }
     if (log_buffer_len + lineLen >= LOG_BUFFER_SIZE) {
         flush_log_buffer_to_spiffs();
     }
 
-    if (lineLen < LOG_BUFFER_SIZE) {
+    // Until the store is mounted lines stay buffered; once the buffer is full they are dropped
+    if (log_buffer_len + lineLen < LOG_BUFFER_SIZE) {
         memcpy(log_buffer + log_buffer_len, logLine, lineLen);
         log_buffer_len += lineLen;
     }
@@ -9719,43 +12154,16 @@ void append_to_log_file(const char* message) {
 }
 
 String read_log_tail(int max_lines) {
-    File file = SPIFFS.open("/serial.log", "r");
-    if (!file) return "";
-
-    size_t fileSize = file.size();
-    if (fileSize == 0) {
-        file.close();
-        return "";
-    }
-
-    size_t readSize = min((size_t)(max_lines * 100), fileSize);
-    size_t startPos = fileSize - readSize;
-
-    file.seek(startPos);
-    if (startPos > 0) {
-        while (file.available() && file.read() != '\n');
-    }
-
-    String content = "";
-    while (file.available()) {
-        content += file.readStringUntil('\n') + "\n";
-    }
-    file.close();
-
-    int lineCount = 0;
-    int lastNewline = content.length();
-
-    for (int i = content.length() - 1; i >= 0; i--) {
-        if (content[i] == '\n') {
-            lineCount++;
-            if (lineCount == max_lines) {
-                return content.substring(i + 1);
-            }
-        }
-    }
-
-    return content;
-}
+    LogQuery query = { (uint32_t)max_lines, 0, 7, NULL };
+    String content;
+    content.reserve(max_lines * 80);
+    log_store_query(&query, [&content](const char* line, size_t len) {
+        content.concat(line, len);
+        content += '\n';
+        return true;
+    });
+    return content;
+}
 
 
 
@@ -9793,71 +12201,160 @@ bool has_valid_certificate(const char* cert) {
 
 
 
-static unsigned long last_auth_attempt = 0;
+static unsigned long last_auth_attempt = 0;     // Lockout state, shared by both listeners
 static int auth_failures = 0;
+static portMUX_TYPE auth_mux = portMUX_INITIALIZER_UNLOCKED;
 const int MAX_AUTH_FAILURES = 5;
 const unsigned long AUTH_LOCKOUT_TIME = 300000;
 
-bool authenticate_api_request() {
-    unsigned long now = millis();
-
+// The expected credentials are hashed once and a new credentials token is hashed and compared
+// against them, so there is no base64 decoding or substring copying and the comparison takes
+// the same time wherever the first mismatch is. A token that passed is kept in the listener's
+// ApiAuthCache, and a client sending the same header again is matched against that in constant
+// time without the SHA-256 (host/tests/bench_api_auth.cpp compares the three paths).
+// Basic credentials are hashed without their base64 padding so padded and unpadded clients
+// match. The digests travel in IngestSettings and are rebuilt when the credentials change.
+static void api_auth_digest(const char* value, size_t length, uint8_t* digest) {
+    mbedtls_sha256((const unsigned char*)value, length, digest, 0);
+}
 
-    if (auth_failures >= MAX_AUTH_FAILURES) {
-        if (now - last_auth_attempt < AUTH_LOCKOUT_TIME) {
-            return false;
-        } else {
-            auth_failures = 0;
-        }
+static bool api_auth_digest_equals(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < 32; i++) {
+        diff |= a[i] ^ b[i];
     }
+    return diff == 0;
+}
 
-    last_auth_attempt = now;
+static void api_auth_build_digests(struct IngestSettings* config) {
+    static unsigned int generation = 0;
+    config->api_auth_generation = ++generation;
 
-    if (!webServer.hasHeader("Authorization")) {
-        auth_failures++;
-        return false;
-    }
+    String credentials = base64_encode_string(String(settings.api_username) + ":" + String(settings.api_password));
+    api_auth_digest(credentials.c_str(), api_auth_base64_unpadded_length(credentials.c_str(), credentials.length()),
+                    config->api_basic_digest);
 
-    String auth_header = webServer.header("Authorization");
-    if (!auth_header.startsWith("Basic ")) {
-        return false;
+    config->api_bearer_enabled = (settings.api_token[0] != '\0');
+    memset(config->api_bearer_digest, 0, sizeof(config->api_bearer_digest));
+    if (config->api_bearer_enabled) {
+        api_auth_digest(settings.api_token, strlen(settings.api_token), config->api_bearer_digest);
     }
+}
 
-    String encoded_credentials = auth_header.substring(6);
-    String decoded_credentials = base64_decode(encoded_credentials);
+// Publishes the ingest fields of settings for the Web and Ingest tasks. Runs with service_lock
+// held, before loop() and web_route() handlers release it and in setup() before the listeners
+// start, so there is a single writer and every change to settings is published, rolled-back
+// edits included. The fields are written into a slot no request has pinned and only made
+// current when something differs; digests are only recomputed when the credentials changed.
+// With every other slot pinned the publish is left to the next call.
+void ingest_settings_publish() {
+    static char published_username[sizeof(settings.api_username)];
+    static char published_password[sizeof(settings.api_password)];
+    static char published_token[sizeof(settings.api_token)];
+    static bool published_valid = false;
+
+    uint8_t current = ingest_settings_current.load();
+    uint8_t slot = current;
+    for (uint8_t i = 1; i < INGEST_SETTINGS_SLOTS; i++) {
+        uint8_t candidate = (current + i) % INGEST_SETTINGS_SLOTS;
+        if (ingest_settings_readers[candidate].load() == 0) {
+            slot = candidate;
+            break;
+        }
+    }
+    if (slot == current) {
+        return;
+    }
 
-    int colon_index = decoded_credentials.indexOf(':');
-    if (colon_index == -1) {
-        return false;
+    const IngestSettings* published = &ingest_settings_slots[current];
+    IngestSettings* next = &ingest_settings_slots[slot];
+    memcpy(next, published, sizeof(*next));     // Padding included, for the memcmp() below
+    next->api_enabled = settings.api_enabled;
+    next->grafana_enabled = settings.grafana_enabled;
+    next->default_capcode = settings.default_capcode;
+    next->default_frequency = settings.default_frequency;
+    next->default_txpower = settings.default_txpower;
+    memcpy(next->dedup_window_s, settings.dedup_window_s, sizeof(next->dedup_window_s));
+    memcpy(next->pager_groups, settings.pager_groups, sizeof(next->pager_groups));
+
+    if (!published_valid || strcmp(published_username, settings.api_username) != 0 ||
+        strcmp(published_password, settings.api_password) != 0 || strcmp(published_token, settings.api_token) != 0) {
+        api_auth_build_digests(next);
+        strlcpy(published_username, settings.api_username, sizeof(published_username));
+        strlcpy(published_password, settings.api_password, sizeof(published_password));
+        strlcpy(published_token, settings.api_token, sizeof(published_token));
+    } else if (memcmp(next, published, sizeof(*next)) == 0) {
+        return;
     }
 
-    String username = decoded_credentials.substring(0, colon_index);
-    String password = decoded_credentials.substring(colon_index + 1);
+    ingest_settings_current.store(slot);
+    published_valid = true;
+}
+
+uint16_t ingest_dedup_window_s(uint8_t source) {
+    if (source >= TX_SOURCE_COUNT) {
+        return 0;
+    }
+    IngestSettingsSnapshot snapshot;
+    return snapshot.settings().dedup_window_s[source];
+}
 
-    bool username_valid = (username.length() == strlen(settings.api_username));
-    bool password_valid = (password.length() == strlen(settings.api_password));
+bool authenticate_api_request(class IngestWebServer& server, const struct IngestSettings* config) {
+    unsigned long now = millis();
 
-    if (username_valid) {
-        for (size_t i = 0; i < username.length(); i++) {
-            if (username[i] != settings.api_username[i]) {
-                username_valid = false;
-            }
+    portENTER_CRITICAL(&auth_mux);
+    bool locked_out = false;
+    if (auth_failures >= MAX_AUTH_FAILURES) {
+        if (now - last_auth_attempt < AUTH_LOCKOUT_TIME) {
+            locked_out = true;
+        } else {
+            auth_failures = 0;
         }
     }
+    if (!locked_out) {
+        last_auth_attempt = now;
+    }
+    portEXIT_CRITICAL(&auth_mux);
+    if (locked_out) {
+        return false;
+    }
+
+    bool authenticated = false;
+    if (server.hasHeader("Authorization")) {
+        uint32_t start_us = micros();
+        String auth_header = server.header("Authorization");
+        const char* credentials = nullptr;
+        size_t credentials_length = 0;
+        int scheme = api_auth_parse_header(auth_header.c_str(), &credentials, &credentials_length);
+        if (scheme == API_AUTH_SCHEME_NONE) {
+            return false;
+        }
 
-    if (password_valid) {
-        for (size_t i = 0; i < password.length(); i++) {
-            if (password[i] != settings.api_password[i]) {
-                password_valid = false;
+        if (api_auth_cache_match(&server.auth_cache, config->api_auth_generation, scheme, credentials,
+                                 credentials_length)) {
+            authenticated = true;
+        } else {
+            uint8_t digest[32];
+            api_auth_digest(credentials, credentials_length, digest);
+
+            authenticated = (scheme == API_AUTH_SCHEME_BEARER)
+                                ? (config->api_bearer_enabled && api_auth_digest_equals(digest, config->api_bearer_digest))
+                                : api_auth_digest_equals(digest, config->api_basic_digest);
+            if (authenticated) {
+                api_auth_cache_store(&server.auth_cache, config->api_auth_generation, scheme, credentials,
+                                     credentials_length);
             }
         }
+        metrics_observe(&metric_api_auth, micros() - start_us);
     }
 
-    bool authenticated = username_valid && password_valid;
+    portENTER_CRITICAL(&auth_mux);
     if (!authenticated) {
         auth_failures++;
     } else {
         auth_failures = 0;
     }
+    portEXIT_CRITICAL(&auth_mux);
 
     return authenticated;
 }
@@ -10015,51 +12512,26 @@ void handle_api_wifi_add() {
     }
 }
 
-void handle_api_message() {
-    reset_oled_timeout();
-
-    if (!settings.api_enabled) {
-        webServer.send(503, "application/json", "{\"error\":\"API service is disabled\"}");
-        return;
-    }
-
-    if (!authenticate_api_request()) {
-        webServer.sendHeader("WWW-Authenticate", "Basic realm=\"FLEX API\"");
-        webServer.send(401, "application/json", "{\"error\":\"Authentication required\"}");
-        return;
-    }
-
-    if (webServer.method() != HTTP_POST) {
-        webServer.send(405, "application/json", "{\"error\":\"Method not allowed\"}");
-        return;
-    }
-
-    if (!webServer.hasArg("plain")) {
-        webServer.send(400, "application/json", "{\"error\":\"No JSON payload\"}");
-        return;
-    }
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, webServer.arg("plain"));
-
-    if (error) {
-        webServer.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-        return;
-    }
-
+// Validates one /api message object and maps it onto a batch item (text prepared, message
+// type resolved from the text). message receives the text as sent back in responses (truncated with "..." past
+// MAX_FLEX_MESSAGE_LENGTH). Returns false with error set when a field is missing or out of range.
+bool api_message_to_item(JsonObject doc, const struct IngestSettings* config, struct QueueBatchItem* item, String& message,
+                         bool* truncated, String& error) {
     if (!doc["message"].is<String>()) {
-        webServer.send(400, "application/json", "{\"error\":\"Missing required field: message\"}");
-        return;
+        error = "Missing required field: message";
+        return false;
     }
 
-    uint64_t capcode = settings.default_capcode;
+    memset(item, 0, sizeof(*item));
+
+    uint64_t capcode = config->default_capcode;
     if (doc["capcode"].is<uint64_t>()) {
         capcode = doc["capcode"];
     } else if (doc["capcode"].is<String>()) {
         capcode = strtoul(doc["capcode"].as<String>().c_str(), nullptr, 10);
     }
 
-    float frequency = settings.default_frequency;
+    float frequency = config->default_frequency;
     if (doc["frequency"].is<float>()) {
         frequency = doc["frequency"];
     } else if (doc["frequency"].is<double>()) {
@@ -10068,9 +12540,9 @@ void handle_api_message() {
         frequency = atof(doc["frequency"].as<String>().c_str());
     }
 
-    String message = doc["message"].as<String>();
+    message = doc["message"].as<String>();
 
-    int power = settings.default_txpower;
+    int power = config->default_txpower;
     if (doc["power"].is<int>()) {
         power = doc["power"];
     } else if (doc["power"].is<String>()) {
@@ -10090,40 +12562,176 @@ void handle_api_message() {
         mail_drop = (mail_drop_str == "true" || mail_drop_str == "1");
     }
 
+    if (doc["id"].is<String>()) {
+        strlcpy(item->message_id, doc["id"].as<String>().c_str(), sizeof(item->message_id));
+    } else if (doc["id"].is<uint64_t>()) {
+        snprintf(item->message_id, sizeof(item->message_id), "%llu", doc["id"].as<uint64_t>());
+    }
+
+    if (doc["group"].is<String>()) {
+        item->group = pager_group_find(config->pager_groups, doc["group"].as<String>().c_str());
+        if (item->group == nullptr) {
+            error = "Unknown group";
+            return false;
+        }
+        capcode = item->group->capcodes[0];
+    }
+
+    int repeat = doc["repeat"] | 0;
+    int repeat_interval_s = doc["repeat_interval"] | 0;
+    if (repeat < 0 || repeat > TX_REPEAT_MAX) {
+        error = "repeat must be between 0 and " + String(TX_REPEAT_MAX);
+        return false;
+    }
+    if (repeat_interval_s != 0 && (repeat_interval_s < TX_REPEAT_INTERVAL_MIN_S || repeat_interval_s > TX_REPEAT_INTERVAL_MAX_S)) {
+        error = "repeat_interval must be between " + String(TX_REPEAT_INTERVAL_MIN_S) + " and " +
+                String(TX_REPEAT_INTERVAL_MAX_S) + " seconds";
+        return false;
+    }
+
     if (frequency > 1000.0) {
         frequency = frequency / 1000000.0;
     }
 
     if (frequency < 400.0 || frequency > 1000.0) {
-        webServer.send(400, "application/json", "{\"error\":\"Frequency must be between 400.0-1000.0 MHz or 400000000-1000000000 Hz\"}");
-        return;
+        error = "Frequency must be between 400.0-1000.0 MHz or 400000000-1000000000 Hz";
+        return false;
     }
 
     if (power < 0 || power > 20) {
-        webServer.send(400, "application/json", "{\"error\":\"TX Power must be between 0 and 20 dBm\"}");
-        return;
+        error = "TX Power must be between 0 and 20 dBm";
+        return false;
     }
 
     if (message.length() == 0) {
-        webServer.send(400, "application/json", "{\"error\":\"Message cannot be empty\"}");
-        return;
+        error = "Message cannot be empty";
+        return false;
     }
 
-    bool message_was_truncated = false;
+    *truncated = false;
     if (message.length() > MAX_FLEX_MESSAGE_LENGTH) {
         message = truncate_message_with_ellipsis(message);
-        message_was_truncated = true;
+        *truncated = true;
+    }
+
+    item->capcode = (uint32_t)capcode;
+    item->frequency = frequency;
+    item->power = (int8_t)power;
+    item->mail_drop = mail_drop;
+    item->repeat = (uint8_t)repeat;
+    item->repeat_interval_s = (uint16_t)repeat_interval_s;
+    queue_batch_prepare(item, message.c_str());
+    return true;
+}
+
+static void api_send_error(WebServer& server, int code, const String& error) {
+    JsonDocument response;
+    response["error"] = error;
+    String response_str;
+    serializeJson(response, response_str);
+    server.send(code, "application/json", response_str);
+}
+
+void handle_api_message(class IngestWebServer& server) {
+    reset_oled_timeout();
+
+    IngestSettingsSnapshot snapshot;
+    const IngestSettings& config = snapshot.settings();
+
+    if (!config.api_enabled) {
+        server.send(503, "application/json", "{\"error\":\"API service is disabled\"}");
+        return;
+    }
+
+    if (!authenticate_api_request(server, &config)) {
+        server.sendHeader("WWW-Authenticate", "Basic realm=\"FLEX API\"");
+        server.send(401, "application/json", "{\"error\":\"Authentication required\"}");
+        return;
+    }
+
+    if (server.method() != HTTP_POST) {
+        server.send(405, "application/json", "{\"error\":\"Method not allowed\"}");
+        return;
+    }
+
+    if (!server.hasArg("plain")) {
+        server.send(400, "application/json", "{\"error\":\"No JSON payload\"}");
+        return;
+    }
+
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, server.body());
+
+    if (error) {
+        server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
     }
 
-    if (queue_add_message(capcode, frequency, power, mail_drop, message.c_str())) {
+    QueueBatchItem item;
+    String message;
+    bool message_was_truncated = false;
+    String validation_error;
+    if (!api_message_to_item(doc.as<JsonObject>(), &config, &item, message, &message_was_truncated, validation_error)) {
+        api_send_error(server, 400, validation_error);
+        return;
+    }
+
+    int wait_s = 0;
+    if (doc["wait"].is<bool>()) {
+        wait_s = doc["wait"].as<bool>() ? API_WAIT_MAX_S : 0;
+    } else if (doc["wait"].is<int>()) {
+        wait_s = doc["wait"];
+    } else if (server.hasArg("wait")) {
+        wait_s = server.arg("wait").toInt();
+    }
+    wait_s = constrain(wait_s, 0, API_WAIT_MAX_S);
+    if (&server == &ingestServer) {
+        wait_s = 0;                 // The ingest listener never holds a connection open
+    }
+
+    queue_submit_batch(&item, 1, TX_SOURCE_API, true);
+    if (item.result == QUEUE_BATCH_RATE_LIMITED) {
+        JsonDocument response;
+        response["status"] = "error";
+        response["message"] = "Airtime budget exhausted for this frequency. Please retry later.";
+        response["frequency"] = item.frequency;
+        response["retry_after"] = item.retry_after_s;
+
+        String response_str;
+        serializeJson(response, response_str);
+        server.sendHeader("Retry-After", String(item.retry_after_s));
+        server.send(429, "application/json", response_str);
+        return;
+    }
+    if (item.result != QUEUE_BATCH_FULL) {
+        bool deduplicated = (item.result == QUEUE_BATCH_DEDUPLICATED);
         JsonDocument response;
-        response["frequency"] = frequency;
-        response["power"] = power;
-        response["capcode"] = capcode;
+        if (item.message_id[0] != '\0') {
+            response["message_id"] = item.message_id;
+        }
+        if (item.repeat > 0) {
+            response["repeat"] = item.repeat;
+            response["repeat_interval"] = item.repeat_interval_s;
+        }
+        response["frequency"] = item.frequency;
+        response["power"] = item.power;
+        if (item.group != nullptr) {
+            response["group"] = item.group->name;
+            JsonArray members = response["capcodes"].to<JsonArray>();
+            for (uint8_t i = 0; i < item.group->count; i++) {
+                members.add(item.group->capcodes[i]);
+            }
+        } else {
+            response["capcode"] = item.capcode;
+        }
         response["text"] = message;
         response["truncated"] = message_was_truncated;
 
-        if (device_state == STATE_IDLE) {
+        if (deduplicated) {
+            response["status"] = "deduplicated";
+            response["message"] = "Identical page already queued or sent within " +
+                                  String(config.dedup_window_s[TX_SOURCE_API]) + " s, not transmitted again";
+        } else if (device_state == STATE_IDLE) {
             response["status"] = "queued";
             if (message_was_truncated) {
                 response["message"] = "Message truncated to 248 chars and queued for immediate transmission";
@@ -10137,225 +12745,728 @@ void handle_api_message() {
             } else {
                 response["message"] = "Message queued for transmission";
             }
-            response["queue_position"] = queue_count;
+            response["queue_position"] = queue_count.load();
+        }
+
+        if (!deduplicated && wait_s > 0) {
+            DeliveryEvent delivery = {};
+            bool settled = api_wait_for_delivery(item.seq, (uint32_t)wait_s * 1000UL, &delivery);
+            JsonObject result = response["delivery"].to<JsonObject>();
+            result["status"] = delivery_status_names[delivery.status];
+            result["timed_out"] = !settled;
+            if (delivery.timestamp != 0) {
+                result["timestamp"] = delivery.timestamp;
+            }
+            if (delivery.status == DELIVERY_TRANSMITTED) {
+                result["airtime_ms"] = delivery.airtime_ms;
+                response["status"] = "transmitted";
+                response["message"] = "Message transmitted";
+            } else if (delivery.status == DELIVERY_FAILED) {
+                response["status"] = "failed";
+                response["message"] = "Message was queued but the transmission failed";
+            }
         }
 
         String response_str;
         serializeJson(response, response_str);
-        webServer.send(200, "application/json", response_str);
+        server.send(200, "application/json", response_str);
     } else {
         JsonDocument response;
         response["status"] = "error";
         response["message"] = "Queue is full. Please try again later.";
-        response["max_queue_size"] = MAX_QUEUE_SIZE;
+        response["queue_capacity_bytes"] = queue_arena_capacity;
+        response["queue_bytes_free"] = queue_bytes_free();
+        response["retry_after"] = QUEUE_FULL_RETRY_AFTER_S;
 
         String response_str;
         serializeJson(response, response_str);
-        webServer.send(503, "application/json", response_str);
+        server.sendHeader("Retry-After", String(QUEUE_FULL_RETRY_AFTER_S));
+        server.send(503, "application/json", response_str);
+    }
+}
+
+static void api_message_filter(JsonDocument& filter) {
+    static const char* const keys[] = {
+        "message", "capcode", "frequency", "power", "tx_power", "mail_drop", "id", "group",
+        "repeat", "repeat_interval"
+    };
+    for (const char* key : keys) {
+        filter[key] = true;
     }
 }
 
-void handle_grafana_webhook() {
+// POST /api/batch: a JSON array of /api message objects. Every item is validated before anything
+// is queued, then the valid ones go through one queue_submit_batch() call, which deduplicates,
+// admits against the airtime budget and queues them. ?atomic=true makes the batch all-or-nothing:
+// any invalid or rate-limited item, or a queue without room for all of them, queues none.
+void handle_api_batch(class IngestWebServer& server) {
     reset_oled_timeout();
 
-    if (!settings.grafana_enabled) {
-        webServer.send(503, "application/json", "{\"error\":\"Grafana webhook service is disabled\"}");
+    IngestSettingsSnapshot snapshot;
+    const IngestSettings& config = snapshot.settings();
+
+    if (!config.api_enabled) {
+        server.send(503, "application/json", "{\"error\":\"API service is disabled\"}");
         return;
     }
 
-    if (!authenticate_api_request()) {
-        webServer.sendHeader("WWW-Authenticate", "Basic realm=\"FLEX API\"");
-        webServer.send(401, "application/json", "{\"error\":\"Authentication required\"}");
+    if (!authenticate_api_request(server, &config)) {
+        server.sendHeader("WWW-Authenticate", "Basic realm=\"FLEX API\"");
+        server.send(401, "application/json", "{\"error\":\"Authentication required\"}");
         return;
     }
 
-    if (webServer.method() != HTTP_POST) {
-        webServer.send(405, "application/json", "{\"error\":\"Method not allowed\"}");
+    if (!server.hasArg("plain")) {
+        server.send(400, "application/json", "{\"error\":\"No JSON payload\"}");
         return;
     }
 
-    if (!webServer.hasArg("plain")) {
-        webServer.send(400, "application/json", "{\"error\":\"No JSON payload\"}");
+    String atomic_arg = server.arg("atomic");
+    atomic_arg.toLowerCase();
+    bool atomic = (atomic_arg == "true" || atomic_arg == "1");
+
+    const String& body = server.body();
+    JsonDocument filter;
+    api_message_filter(filter);
+    JsonDocument message_doc;
+
+    // One pass: items are validated as they are parsed; elements past API_BATCH_MAX are only counted
+    std::vector<QueueBatchItem> items;
+    std::vector<String> errors;
+    int total = 0;
+    int invalid = 0;
+    if (!json_walk_array(body, message_doc, filter, [&](int index, JsonObject message) {
+            total = index + 1;
+            if (index >= API_BATCH_MAX) {
+                return;
+            }
+            items.emplace_back();
+            errors.emplace_back();
+            QueueBatchItem* item = &items.back();
+            String text;
+            bool truncated = false;
+            if (!api_message_to_item(message, &config, item, text, &truncated, errors.back())) {
+                item->result = QUEUE_BATCH_SKIPPED;
+                invalid++;
+            }
+        })) {
+        server.send(400, "application/json", "{\"error\":\"Expected JSON array of messages\"}");
         return;
     }
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, webServer.arg("plain"));
-
-    if (error) {
-        webServer.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    if (total == 0) {
+        server.send(400, "application/json", "{\"error\":\"Batch is empty\"}");
         return;
     }
-
-    if (!doc.is<JsonArray>()) {
-        webServer.send(400, "application/json", "{\"error\":\"Expected JSON array of alerts\"}");
+    if (total > API_BATCH_MAX) {
+        api_send_error(server, 413, "Batch exceeds " + String(API_BATCH_MAX) + " messages");
         return;
     }
 
-    JsonArray alerts = doc.as<JsonArray>();
-    int total_alerts = alerts.size();
-    int successful = 0;
-    int failed = 0;
+    std::vector<uint32_t> retry_after(total, 0);
+    int rate_limited = 0;
+    uint32_t max_retry_after_s = 0;
 
-    logMessage("GRAFANA: Processing " + String(total_alerts) + " alerts");
+    int queue_depth = queue_count.load();
+    if (atomic && invalid > 0) {
+        for (int i = 0; i < total; i++) {
+            items[i].result = QUEUE_BATCH_SKIPPED;
+        }
+    } else {
+        queue_submit_batch(items.data(), total, TX_SOURCE_API, atomic);
+    }
 
-    JsonDocument response;
-    response["status"] = "completed";
-    response["total_alerts"] = total_alerts;
+    for (int i = 0; i < total; i++) {
+        if (items[i].result == QUEUE_BATCH_RATE_LIMITED) {
+            errors[i] = "Airtime budget exhausted";
+            retry_after[i] = items[i].retry_after_s;
+            max_retry_after_s = max(max_retry_after_s, retry_after[i]);
+            rate_limited++;
+        }
+    }
 
+    int queued = 0;
+    int deduplicated = 0;
+    int queue_full = 0;
+    JsonDocument response;
+    response["atomic"] = atomic;
+    response["total"] = total;
     JsonArray results = response["results"].to<JsonArray>();
 
-    for (int i = 0; i < total_alerts; i++) {
-        JsonObject alert = alerts[i];
-        JsonObject result = results.createNestedObject();
-
-        result["alert_index"] = i + 1;
-
-        JsonObject labels = alert["labels"];
-        JsonObject annotations = alert["annotations"];
-
-        String ends_at = alert["endsAt"].as<String>();
-        String status = (ends_at == "0001-01-01T00:00:00Z") ? "FIRING" : "RESOLVED";
-
-        String alert_name = labels["alertname"].as<String>();
-        if (alert_name.isEmpty()) {
-            alert_name = "Unknown Alert";
-        }
-        result["alert_name"] = alert_name;
-
-        uint64_t capcode = settings.default_capcode;
-        if (labels["capcode"].is<uint64_t>()) {
-            capcode = labels["capcode"];
-        } else if (labels["capcode"].is<String>()) {
-            capcode = strtoul(labels["capcode"].as<String>().c_str(), nullptr, 10);
-        } else if (labels["pager_capcode"].is<uint64_t>()) {
-            capcode = labels["pager_capcode"];
-        } else if (labels["pager_capcode"].is<String>()) {
-            capcode = strtoul(labels["pager_capcode"].as<String>().c_str(), nullptr, 10);
-        }
-        result["capcode"] = capcode;
-
-        float frequency = settings.default_frequency;
-        if (labels["frequency"].is<float>()) {
-            frequency = labels["frequency"];
-        } else if (labels["frequency"].is<String>()) {
-            frequency = atof(labels["frequency"].as<String>().c_str());
-        } else if (labels["pager_frequency"].is<float>()) {
-            frequency = labels["pager_frequency"];
-        } else if (labels["pager_frequency"].is<String>()) {
-            frequency = atof(labels["pager_frequency"].as<String>().c_str());
-        }
-
-        if (frequency > 1000.0) {
-            frequency = frequency / 1000000.0;
-        }
-        result["frequency"] = frequency;
-
-        bool mail_drop = false;
-        if (labels["mail_drop"].is<bool>()) {
-            mail_drop = labels["mail_drop"];
-        } else if (labels["mail_drop"].is<String>()) {
-            String mail_drop_str = labels["mail_drop"].as<String>();
-            mail_drop = (mail_drop_str == "true" || mail_drop_str == "1");
-        } else if (labels["pager_mail_drop"].is<bool>()) {
-            mail_drop = labels["pager_mail_drop"];
-        } else if (labels["pager_mail_drop"].is<String>()) {
-            String mail_drop_str = labels["pager_mail_drop"].as<String>();
-            mail_drop = (mail_drop_str == "true" || mail_drop_str == "1");
-        }
-
-        String message_content = "";
-        if (annotations["summary"].is<String>() && !annotations["summary"].as<String>().isEmpty()) {
-            message_content = annotations["summary"].as<String>();
-        } else if (annotations["description"].is<String>() && !annotations["description"].as<String>().isEmpty()) {
-            message_content = annotations["description"].as<String>();
-        } else if (annotations["message"].is<String>() && !annotations["message"].as<String>().isEmpty()) {
-            message_content = annotations["message"].as<String>();
-        } else {
-            message_content = "Alert triggered";
-        }
-
-        String final_message = "[" + status + "] " + alert_name + ": " + message_content;
+    for (int i = 0; i < total; i++) {
+        const QueueBatchItem& item = items[i];
+        JsonObject result = results.add<JsonObject>();
+        result["index"] = i;
 
-        bool message_was_truncated = false;
-        if (final_message.length() > MAX_FLEX_MESSAGE_LENGTH) {
-            final_message = truncate_message_with_ellipsis(final_message);
-            message_was_truncated = true;
+        if (item.result == QUEUE_BATCH_QUEUED || item.result == QUEUE_BATCH_DEDUPLICATED) {
+            if (item.message_id[0] != '\0') {
+                result["message_id"] = item.message_id;
+            }
+            if (item.group != nullptr) {
+                result["group"] = item.group->name;
+            } else {
+                result["capcode"] = item.capcode;
+            }
         }
 
-        result["message"] = final_message;
-        result["truncated"] = message_was_truncated;
-
-        if (queue_add_message(capcode, frequency, settings.default_txpower, mail_drop, final_message.c_str())) {
-            result["success"] = true;
-            successful++;
-            logMessage("GRAFANA: Alert " + String(i + 1) + " queued - " + alert_name + " (capcode=" + String(capcode) + ")");
-        } else {
-            result["success"] = false;
-            result["error"] = "Queue is full";
-            failed++;
-            logMessage("GRAFANA: Alert " + String(i + 1) + " failed - Queue full");
+        switch (item.result) {
+            case QUEUE_BATCH_QUEUED:
+                queued++;
+                result["status"] = "queued";
+                result["queue_position"] = queue_depth + queued;
+                break;
+            case QUEUE_BATCH_DEDUPLICATED:
+                deduplicated++;
+                result["status"] = "deduplicated";
+                break;
+            case QUEUE_BATCH_FULL:
+                queue_full++;
+                result["status"] = "queue_full";
+                break;
+            case QUEUE_BATCH_RATE_LIMITED:
+                result["status"] = "rate_limited";
+                result["error"] = errors[i];
+                result["retry_after"] = retry_after[i];
+                break;
+            default:
+                if (errors[i].length() == 0) {
+                    result["status"] = "not_queued";         // Valid, but the atomic batch was rejected
+                } else {
+                    result["status"] = "invalid";
+                    result["error"] = errors[i];
+                }
+                break;
         }
     }
 
-    response["successful"] = successful;
+    int failed = total - queued - deduplicated;
+    response["queued"] = queued;
+    response["deduplicated"] = deduplicated;
     response["failed"] = failed;
+    response["status"] = (failed == 0) ? "queued" : (queued + deduplicated > 0) ? "partial" : "rejected";
+
+    int status_code = (failed == 0) ? 200 : 207;
+    if (queued + deduplicated == 0) {
+        if (invalid > 0) {
+            status_code = 400;
+        } else if (rate_limited > 0) {
+            status_code = 429;
+        } else if (queue_full > 0) {
+            status_code = 503;
+        }
+    }
+    if (queue_full > 0 && max_retry_after_s < QUEUE_FULL_RETRY_AFTER_S) {
+        max_retry_after_s = QUEUE_FULL_RETRY_AFTER_S;
+    }
+    if (max_retry_after_s > 0 && invalid == 0) {
+        server.sendHeader("Retry-After", String(max_retry_after_s));
+    }
 
     String response_str;
     serializeJson(response, response_str);
+    server.send(status_code, "application/json", response_str);
 
-    int status_code = (failed == 0) ? 200 : 207;
-    webServer.send(status_code, "application/json", response_str);
-
-    logMessage("GRAFANA: Completed processing - " + String(successful) + " successful, " + String(failed) + " failed");
+    logMessagef("API: Batch of %d%s - %d queued, %d deduplicated, %d failed",
+                total, atomic ? " (atomic)" : "", queued, deduplicated, failed);
 }
 
+// Long-poll for /api "wait" on port 80: blocks this request, and with it the Web task (not the
+// TX task or the ingest listener), until the page is transmitted or failed, or timeout_ms
+// elapses. The calling task sleeps on its notification, which delivery_event() gives when seq
+// settles. Returns true when a final status was reached.
+bool api_wait_for_delivery(uint32_t seq, uint32_t timeout_ms, struct DeliveryEvent* out) {
+    unsigned long start = millis();
+    out->status = DELIVERY_QUEUED;
+
+    int waiter = -1;
+    portENTER_CRITICAL(&delivery_mux);
+    for (int i = 0; i < DELIVERY_WAITERS_MAX; i++) {
+        if (delivery_waiters[i].seq == 0) {
+            delivery_waiters[i].seq = seq;
+            delivery_waiters[i].task = xTaskGetCurrentTaskHandle();
+            waiter = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&delivery_mux);
 
-void at_send_ok() {
-    Serial.print("OK\r\n");
-    Serial.flush();
-    delay(AT_INTER_CMD_DELAY);
+    bool settled = false;
+    while (true) {
+        if (delivery_lookup(seq, out) &&
+            (out->status == DELIVERY_TRANSMITTED || out->status == DELIVERY_FAILED)) {
+            settled = true;
+            break;
+        }
+        uint32_t elapsed_ms = millis() - start;
+        if (elapsed_ms >= timeout_ms) {
+            break;
+        }
+        feed_watchdog();
+        // Without a free waiter slot fall back to polling every 250 ms
+        uint32_t slice_ms = min(timeout_ms - elapsed_ms, (uint32_t)((waiter >= 0) ? 1000 : 250));
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(slice_ms));
+    }
+
+    if (waiter >= 0) {
+        portENTER_CRITICAL(&delivery_mux);
+        delivery_waiters[waiter].seq = 0;
+        delivery_waiters[waiter].task = NULL;
+        portEXIT_CRITICAL(&delivery_mux);
+    }
+    return settled;
 }
 
-void at_send_error() {
-    Serial.print("ERROR\r\n");
-    Serial.flush();
-    delay(AT_INTER_CMD_DELAY);
+static int json_stream_next(Stream& in) {
+    int c;
+    do {
+        c = in.read();
+    } while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+    return c;
 }
 
-void at_send_response(const char* cmd, const char* value) {
-    Serial.print("+");
-    Serial.print(cmd);
-    Serial.print(": ");
-    Serial.print(value);
-    Serial.print("\r\n");
-    at_send_ok();
+static int json_stream_peek(Stream& in) {
+    int c;
+    while ((c = in.peek()) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        in.read();
+    }
+    return c;
 }
 
-void at_send_response_float(const char* cmd, float value, int decimals) {
-    Serial.print("+");
-    Serial.print(cmd);
-    Serial.print(": ");
-    Serial.print(value, decimals);
-    Serial.print("\r\n");
-    at_send_ok();
+// Walks a JSON array body one element at a time: each element is deserialized through filter
+// into doc (cleared first) and handed to visit with its index. Returns false when the body is not
+// an array or is malformed; elements before the error have already been visited.
+bool json_walk_array(const String& body, JsonDocument& doc, JsonDocument& filter,
+                     std::function<void(int, JsonObject)> visit) {
+    BufferReadStream in(body.c_str(), body.length());
+    if (json_stream_next(in) != '[') {
+        return false;
+    }
+    if (json_stream_peek(in) == ']') {
+        return true;
+    }
+
+    for (int index = 0; ; index++) {
+        doc.clear();
+        DeserializationError error = deserializeJson(doc, in, DeserializationOption::Filter(filter));
+        if (error) {
+            return false;
+        }
+        visit(index, doc.as<JsonObject>());
+
+        int c = json_stream_next(in);
+        if (c == ']') {
+            return true;
+        }
+        if (c != ',') {
+            return false;
+        }
+    }
 }
 
-void at_send_response_int(const char* cmd, int value) {
-    Serial.print("+");
-    Serial.print(cmd);
-    Serial.print(": ");
-    Serial.print(value);
-    Serial.print("\r\n");
-    at_send_ok();
+static void grafana_alert_filter(JsonDocument& filter) {
+    static const char* const label_keys[] = {
+        "alertname", "capcode", "pager_capcode", "group", "pager_group", "frequency", "pager_frequency",
+        "mail_drop", "pager_mail_drop", "repeat", "repeat_interval"
+    };
+    filter["endsAt"] = true;
+    filter["fingerprint"] = true;
+    JsonObject labels = filter["labels"].to<JsonObject>();
+    for (const char* key : label_keys) {
+        labels[key] = true;
+    }
+    JsonObject annotations = filter["annotations"].to<JsonObject>();
+    annotations["summary"] = true;
+    annotations["description"] = true;
+    annotations["message"] = true;
 }
 
-void at_reset_state() {
-    if (device_state != STATE_WIFI_CONNECTING && device_state != STATE_WIFI_AP_MODE) {
-        device_state = STATE_IDLE;
+// Maps one Alertmanager alert onto a batch item (capcode/group, frequency, mail drop, repeat,
+// "[FIRING|RESOLVED] name: summary" text, fingerprint as message ID). Returns false when the
+// alert names a pager group that does not exist; group_name then holds the requested name.
+bool grafana_alert_to_item(JsonObject alert, const struct IngestSettings* config, struct QueueBatchItem* item,
+                           String& alert_name, String& group_name, bool* truncated) {
+    JsonObject labels = alert["labels"];
+    JsonObject annotations = alert["annotations"];
+
+    String ends_at = alert["endsAt"].as<String>();
+    String status = (ends_at == "0001-01-01T00:00:00Z") ? "FIRING" : "RESOLVED";
+
+    alert_name = labels["alertname"].as<String>();
+    if (alert_name.isEmpty()) {
+        alert_name = "Unknown Alert";
     }
-    current_tx_total_length = 0;
-    current_tx_remaining_length = 0;
+
+    memset(item, 0, sizeof(*item));
+
+    uint64_t capcode = config->default_capcode;
+    if (labels["capcode"].is<uint64_t>()) {
+        capcode = labels["capcode"];
+    } else if (labels["capcode"].is<String>()) {
+        capcode = strtoul(labels["capcode"].as<String>().c_str(), nullptr, 10);
+    } else if (labels["pager_capcode"].is<uint64_t>()) {
+        capcode = labels["pager_capcode"];
+    } else if (labels["pager_capcode"].is<String>()) {
+        capcode = strtoul(labels["pager_capcode"].as<String>().c_str(), nullptr, 10);
+    }
+    item->capcode = (uint32_t)capcode;
+
+    group_name = labels["group"] | "";
+    if (group_name.isEmpty()) {
+        group_name = labels["pager_group"] | "";
+    }
+    if (group_name.length() > 0) {
+        item->group = pager_group_find(config->pager_groups, group_name.c_str());
+        if (item->group == nullptr) {
+            return false;
+        }
+        item->capcode = item->group->capcodes[0];
+    }
+
+    float frequency = config->default_frequency;
+    if (labels["frequency"].is<float>()) {
+        frequency = labels["frequency"];
+    } else if (labels["frequency"].is<String>()) {
+        frequency = atof(labels["frequency"].as<String>().c_str());
+    } else if (labels["pager_frequency"].is<float>()) {
+        frequency = labels["pager_frequency"];
+    } else if (labels["pager_frequency"].is<String>()) {
+        frequency = atof(labels["pager_frequency"].as<String>().c_str());
+    }
+    if (frequency > 1000.0) {
+        frequency = frequency / 1000000.0;
+    }
+    item->frequency = frequency;
+    item->power = config->default_txpower;
+
+    if (labels["mail_drop"].is<bool>()) {
+        item->mail_drop = labels["mail_drop"];
+    } else if (labels["mail_drop"].is<String>()) {
+        String mail_drop_str = labels["mail_drop"].as<String>();
+        item->mail_drop = (mail_drop_str == "true" || mail_drop_str == "1");
+    } else if (labels["pager_mail_drop"].is<bool>()) {
+        item->mail_drop = labels["pager_mail_drop"];
+    } else if (labels["pager_mail_drop"].is<String>()) {
+        String mail_drop_str = labels["pager_mail_drop"].as<String>();
+        item->mail_drop = (mail_drop_str == "true" || mail_drop_str == "1");
+    }
+
+    int repeat = labels["repeat"].is<String>() ? labels["repeat"].as<String>().toInt() : (labels["repeat"] | 0);
+    int repeat_interval_s = labels["repeat_interval"].is<String>() ? labels["repeat_interval"].as<String>().toInt()
+                                                                   : (labels["repeat_interval"] | 0);
+    item->repeat = constrain(repeat, 0, TX_REPEAT_MAX);
+    item->repeat_interval_s = constrain(repeat_interval_s, 0, TX_REPEAT_INTERVAL_MAX_S);
+
+    const char* message_content = "Alert triggered";
+    for (const char* key : { "summary", "description", "message" }) {
+        const char* value = annotations[key] | "";
+        if (value[0] != '\0') {
+            message_content = value;
+            break;
+        }
+    }
+
+    String final_message = "[" + status + "] " + alert_name + ": " + message_content;
+    *truncated = final_message.length() > MAX_FLEX_MESSAGE_LENGTH;
+    if (*truncated) {
+        final_message = truncate_message_with_ellipsis(final_message);
+    }
+
+    strlcpy(item->message_id, alert["fingerprint"] | "", sizeof(item->message_id));
+    queue_batch_prepare(item, final_message.c_str());
+    return true;
+}
+
+void handle_grafana_webhook(class IngestWebServer& server) {
+    reset_oled_timeout();
+
+    IngestSettingsSnapshot snapshot;
+    const IngestSettings& config = snapshot.settings();
+
+    if (!config.grafana_enabled) {
+        server.send(503, "application/json", "{\"error\":\"Grafana webhook service is disabled\"}");
+        return;
+    }
+
+    if (!authenticate_api_request(server, &config)) {
+        server.sendHeader("WWW-Authenticate", "Basic realm=\"FLEX API\"");
+        server.send(401, "application/json", "{\"error\":\"Authentication required\"}");
+        return;
+    }
+
+    if (server.method() != HTTP_POST) {
+        server.send(405, "application/json", "{\"error\":\"Method not allowed\"}");
+        return;
+    }
+
+    if (!server.hasArg("plain")) {
+        server.send(400, "application/json", "{\"error\":\"No JSON payload\"}");
+        return;
+    }
+
+    uint32_t heap_start = ESP.getFreeHeap();
+    uint32_t heap_low = heap_start;
+    auto sample_heap = [&heap_low]() {
+        heap_low = min(heap_low, (uint32_t)ESP.getFreeHeap());
+    };
+
+    const String& body = server.body();
+    JsonDocument filter;
+    grafana_alert_filter(filter);
+    JsonDocument alert_doc;
+
+    // One pass over the body: each alert is mapped onto its item as it is parsed, and nothing is
+    // queued until the whole array has parsed, so a malformed body queues nothing
+    std::deque<GrafanaAlert> alerts;        // Grows without moving the alerts already parsed
+    std::vector<String> refused_names;
+    std::vector<QueueBatchItem> batch(GRAFANA_BATCH_SIZE);
+    int total_alerts = 0;
+    bool valid = json_walk_array(body, alert_doc, filter, [&](int index, JsonObject alert) {
+        total_alerts = index + 1;
+        if (index >= GRAFANA_MAX_ALERTS) {
+            String alert_name;
+            String group_name;
+            bool truncated = false;
+            grafana_alert_to_item(alert, &config, &batch[0], alert_name, group_name, &truncated);
+            refused_names.push_back(alert_name);
+            sample_heap();
+            return;
+        }
+        alerts.emplace_back();
+        GrafanaAlert& entry = alerts.back();
+        entry.outcome = { GRAFANA_OUTCOME_QUEUED, 0 };
+        if (!grafana_alert_to_item(alert, &config, &entry.item, entry.alert_name, entry.group_name, &entry.truncated)) {
+            entry.outcome = { GRAFANA_OUTCOME_UNKNOWN_GROUP, 0 };
+        }
+        sample_heap();
+    });
+    if (!valid) {
+        size_t first = 0;
+        while (first < body.length() && isspace((unsigned char)body[first])) {
+            first++;
+        }
+        bool is_array = first < body.length() && body[first] == '[';
+        server.send(400, "application/json", is_array ? "{\"error\":\"Invalid JSON\"}"
+                                                         : "{\"error\":\"Expected JSON array of alerts\"}");
+        return;
+    }
+
+    logMessage("GRAFANA: Processing " + String(total_alerts) + " alerts");
+
+    int kept_alerts = (int)alerts.size();
+    int batch_index[GRAFANA_BATCH_SIZE];
+    uint16_t batch_count = 0;
+
+    int successful = 0;
+    int failed = total_alerts - kept_alerts;
+    int rate_limited = 0;
+    int queue_full = 0;
+    int deduplicated_count = 0;
+    uint32_t max_retry_after_s = 0;
+
+    auto flush_batch = [&]() {
+        if (batch_count == 0) {
+            return;
+        }
+        queue_submit_batch(batch.data(), batch_count, TX_SOURCE_GRAFANA, false);
+        for (uint16_t i = 0; i < batch_count; i++) {
+            const QueueBatchItem& item = batch[i];
+            GrafanaAlert& entry = alerts[batch_index[i]];
+            entry.item = item;
+            if (item.result == QUEUE_BATCH_RATE_LIMITED) {
+                entry.outcome = { GRAFANA_OUTCOME_RATE_LIMITED, item.retry_after_s };
+                max_retry_after_s = max(max_retry_after_s, item.retry_after_s);
+                rate_limited++;
+                failed++;
+                logMessage("GRAFANA: Alert " + String(batch_index[i] + 1) + " rejected - Airtime budget exhausted");
+                continue;
+            }
+            if (item.result == QUEUE_BATCH_FULL) {
+                entry.outcome = { GRAFANA_OUTCOME_QUEUE_FULL, 0 };
+                failed++;
+                queue_full++;
+                logMessage("GRAFANA: Alert " + String(batch_index[i] + 1) + " failed - Queue full");
+                continue;
+            }
+            successful++;
+            if (item.result == QUEUE_BATCH_DEDUPLICATED) {
+                entry.outcome = { GRAFANA_OUTCOME_DEDUPLICATED, 0 };
+                deduplicated_count++;
+                logMessage("GRAFANA: Alert " + String(batch_index[i] + 1) + " deduplicated (capcode=" + String(item.capcode) + ")");
+            } else {
+                entry.outcome = { GRAFANA_OUTCOME_QUEUED, item.seq };
+                logMessage("GRAFANA: Alert " + String(batch_index[i] + 1) + " queued as " + String(item.message_id) +
+                           " (capcode=" + String(item.capcode) + ")");
+            }
+        }
+        batch_count = 0;
+        sample_heap();
+    };
+
+    // Queue in batches; queue_submit_batch() admits each alert against the airtime budget
+    for (int index = 0; index < kept_alerts; index++) {
+        GrafanaAlert& entry = alerts[index];
+        if (entry.outcome.code == GRAFANA_OUTCOME_UNKNOWN_GROUP) {
+            failed++;
+            logMessage("GRAFANA: Alert " + String(index + 1) + " failed - Unknown group '" + entry.group_name + "'");
+            continue;
+        }
+
+        batch[batch_count] = entry.item;
+        batch_index[batch_count++] = index;
+        if (batch_count == GRAFANA_BATCH_SIZE) {
+            flush_batch();
+        }
+    }
+    flush_batch();
+
+    int status_code = (failed == 0) ? 200 : 207;
+    if (queue_full > 0 && max_retry_after_s < QUEUE_FULL_RETRY_AFTER_S) {
+        max_retry_after_s = QUEUE_FULL_RETRY_AFTER_S;
+    }
+    if (rate_limited > 0 || queue_full > 0) {
+        server.sendHeader("Retry-After", String(max_retry_after_s));
+        if (successful == 0 && rate_limited == failed) {
+            status_code = 429;
+        } else if (successful == 0 && queue_full == failed) {
+            status_code = 503;
+        }
+    }
+
+    // Stream the per-alert results from the kept items
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(status_code, "application/json", "");
+
+    String chunk;
+    chunk.reserve(GRAFANA_RESPONSE_CHUNK + 512);
+    chunk = "{\"status\":\"completed\",\"total_alerts\":" + String(total_alerts) +
+            ",\"successful\":" + String(successful) + ",\"failed\":" + String(failed) +
+            ",\"deduplicated\":" + String(deduplicated_count);
+    if (rate_limited > 0) {
+        chunk += ",\"rate_limited\":" + String(rate_limited);
+    }
+    chunk += ",\"results\":[";
+
+    JsonDocument result;
+    for (int index = 0; index < total_alerts; index++) {
+        result.clear();
+        result["alert_index"] = index + 1;
+
+        if (index >= kept_alerts) {
+            result["alert_name"] = refused_names[index - kept_alerts];
+            result["success"] = false;
+            result["error"] = "Too many alerts (max " + String(GRAFANA_MAX_ALERTS) + " per request)";
+        } else {
+            GrafanaAlert& entry = alerts[index];
+            QueueBatchItem* item = &entry.item;
+            const GrafanaOutcome& outcome = entry.outcome;
+            result["alert_name"] = entry.alert_name;
+
+            if (outcome.code == GRAFANA_OUTCOME_UNKNOWN_GROUP) {
+                result["success"] = false;
+                result["error"] = "Unknown group '" + entry.group_name + "'";
+            } else {
+                if (item->group != nullptr) {
+                    result["group"] = item->group->name;
+                } else {
+                    result["capcode"] = item->capcode;
+                }
+                result["frequency"] = item->frequency;
+                if (item->repeat > 0) {
+                    result["repeat"] = item->repeat;
+                }
+                result["message"] = item->text;
+                result["truncated"] = entry.truncated;
+
+                switch (outcome.code) {
+                    case GRAFANA_OUTCOME_QUEUED:
+                        result["success"] = true;
+                        result["message_id"] = item->message_id;
+                        break;
+                    case GRAFANA_OUTCOME_DEDUPLICATED:
+                        result["success"] = true;
+                        result["message_id"] = item->message_id;
+                        result["deduplicated"] = true;
+                        break;
+                    case GRAFANA_OUTCOME_RATE_LIMITED:
+                        result["success"] = false;
+                        result["error"] = "Airtime budget exhausted";
+                        result["retry_after"] = outcome.value;
+                        break;
+                    default:
+                        result["success"] = false;
+                        result["error"] = "Queue is full";
+                        break;
+                }
+            }
+        }
+
+        if (index > 0) {
+            chunk += ',';
+        }
+        serializeJson(result, chunk);
+        sample_heap();
+        if (chunk.length() >= GRAFANA_RESPONSE_CHUNK) {
+            server.sendContent(chunk);
+            chunk = "";
+        }
+    }
+
+    grafana_heap_peak_last = heap_start - heap_low;
+    grafana_heap_peak_max = max(grafana_heap_peak_max, grafana_heap_peak_last);
+
+    chunk += "],\"heap_peak_bytes\":" + String(grafana_heap_peak_last) + "}";
+    server.sendContent(chunk);
+    server.sendContent("");
+
+    logMessage("GRAFANA: Completed processing - " + String(successful) + " successful, " + String(failed) +
+               " failed, heap peak " + String(grafana_heap_peak_last) + " bytes");
+}
+
+
+void at_send_ok() {
+    Serial.print("OK\r\n");
+    Serial.flush();
+    delay(AT_INTER_CMD_DELAY);
+}
+
+void at_send_error() {
+    Serial.print("ERROR\r\n");
+    Serial.flush();
+    delay(AT_INTER_CMD_DELAY);
+}
+
+void at_send_response(const char* cmd, const char* value) {
+    Serial.print("+");
+    Serial.print(cmd);
+    Serial.print(": ");
+    Serial.print(value);
+    Serial.print("\r\n");
+    at_send_ok();
+}
+
+void at_send_response_float(const char* cmd, float value, int decimals) {
+    Serial.print("+");
+    Serial.print(cmd);
+    Serial.print(": ");
+    Serial.print(value, decimals);
+    Serial.print("\r\n");
+    at_send_ok();
+}
+
+void at_send_response_int(const char* cmd, int value) {
+    Serial.print("+");
+    Serial.print(cmd);
+    Serial.print(": ");
+    Serial.print(value);
+    Serial.print("\r\n");
+    at_send_ok();
+}
+
+void at_reset_state() {
+    if (device_state != STATE_WIFI_CONNECTING && device_state != STATE_WIFI_AP_MODE) {
+        device_state = STATE_IDLE;
+    }
+    current_tx_total_length = 0;
+    current_tx_remaining_length = 0;
     expected_data_length = 0;
     data_receive_timeout = 0;
     state_timeout = 0;
@@ -10832,7 +13943,7 @@ bool at_parse_command(char* cmd_buffer) {
     }
 
     else if (strcmp(cmd_name, "LOGS") == 0) {
-        if (!SPIFFS.exists("/serial.log")) {
+        if (log_store_total_bytes() == 0) {
             Serial.println("ERROR: No log file found");
             at_send_ok();
             return true;
@@ -10851,19 +13962,15 @@ bool at_parse_command(char* cmd_buffer) {
     }
 
     else if (strcmp(cmd_name, "RMLOG") == 0) {
-        if (!SPIFFS.exists("/serial.log")) {
+        if (log_store_total_bytes() == 0) {
             Serial.println("ERROR: No log file found");
             at_send_ok();
             return true;
         }
 
-        if (SPIFFS.remove("/serial.log")) {
-            Serial.println("LOG: File deleted");
-            at_send_ok();
-        } else {
-            Serial.println("ERROR: Failed to delete");
-            at_send_ok();
-        }
+        log_store_clear();
+        Serial.println("LOG: File deleted");
+        at_send_ok();
         return true;
     }
 
@@ -10897,330 +14004,1989 @@ void at_handle_binary_data() {
         current_tx_remaining_length = current_tx_total_length;
         radio_start_transmit_status = radio.startTransmit(tx_data_buffer, current_tx_total_length);
 
-        display_status();
+        display_status();
+    }
+}
+
+void at_handle_flex_message() {
+    reset_oled_timeout();
+
+    if (device_state != STATE_WAITING_FOR_MSG) {
+        return;
+    }
+
+    if (millis() > flex_message_timeout) {
+        at_reset_state();
+        display_status();
+        at_send_error();
+        return;
+    }
+
+    while (Serial.available() && flex_message_pos < MAX_FLEX_MESSAGE_LENGTH) {
+        char c = Serial.read();
+
+        if (c == '\r' || c == '\n') {
+            flex_message_buffer[flex_message_pos] = '\0';
+
+            if (queue_add_message(flex_capcode, current_tx_frequency, tx_power, flex_mail_drop, flex_message_buffer, TX_SOURCE_AT)) {
+                at_reset_state();
+                at_send_ok();
+                display_status();
+            } else {
+                device_state = STATE_ERROR;
+                at_send_error();
+                at_reset_state();
+                display_status();
+            }
+            return;
+        }
+
+        if (c >= 32 && c <= 126) {
+            flex_message_buffer[flex_message_pos++] = c;
+            flex_message_timeout = millis() + FLEX_MSG_TIMEOUT;
+        }
+    }
+
+    if (flex_message_pos >= MAX_FLEX_MESSAGE_LENGTH) {
+        String truncated_message = truncate_message_with_ellipsis(String(flex_message_buffer));
+        strncpy(flex_message_buffer, truncated_message.c_str(), MAX_FLEX_MESSAGE_LENGTH);
+        flex_message_buffer[MAX_FLEX_MESSAGE_LENGTH] = '\0';
+
+        if (queue_add_message(flex_capcode, current_tx_frequency, tx_power, flex_mail_drop, flex_message_buffer, TX_SOURCE_AT)) {
+            at_reset_state();
+            at_send_ok();
+            display_status();
+        } else {
+            device_state = STATE_ERROR;
+            at_send_error();
+            at_reset_state();
+            display_status();
+        }
+    }
+}
+
+void at_process_serial() {
+    if (device_state == STATE_WAITING_FOR_DATA) {
+        at_handle_binary_data();
+        return;
+    }
+
+    if (device_state == STATE_WAITING_FOR_MSG) {
+        at_handle_flex_message();
+        return;
+    }
+
+    while (Serial.available()) {
+        char c = Serial.read();
+
+        if (at_buffer_pos >= AT_BUFFER_SIZE - 1) {
+            at_buffer_pos = 0;
+            at_send_error();
+            continue;
+        }
+
+        at_buffer[at_buffer_pos++] = c;
+
+        if (c == '\n' || (c == '\r' && at_buffer_pos > 1)) {
+            at_buffer[at_buffer_pos] = '\0';
+            at_command_ready = true;
+            break;
+        }
+    }
+
+    if (at_command_ready) {
+        if (!at_parse_command(at_buffer)) {
+            at_send_error();
+        }
+
+        at_buffer_pos = 0;
+        at_command_ready = false;
+    }
+}
+
+
+void panic() {
+    display_panic();
+    Serial.print("ERROR\r\n");
+    while (true) {
+        delay(100000);
+    }
+}
+
+
+#if defined(ESP8266) || defined(ESP32)
+  ICACHE_RAM_ATTR
+#endif
+void on_interrupt_fifo_has_space() {
+    fifo_empty_us = micros();
+    fifo_empty = true;
+}
+
+void transmission_task(void* parameter);
+void init_transmission_core();
+
+bool queue_init() {
+    if (psramFound()) {
+        queue_arena = (uint8_t*)heap_caps_calloc(1, QUEUE_ARENA_SIZE_PSRAM, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (queue_arena != nullptr) {
+            queue_arena_capacity = QUEUE_ARENA_SIZE_PSRAM;
+            queue_arena_in_psram = true;
+        }
+    }
+
+    if (queue_arena == nullptr) {
+        queue_arena = (uint8_t*)heap_caps_calloc(1, QUEUE_ARENA_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (queue_arena == nullptr) {
+            logMessage("QUEUE: Failed to allocate message arena");
+            return false;
+        }
+        queue_arena_capacity = QUEUE_ARENA_SIZE;
+        queue_arena_in_psram = false;
+    }
+
+    queue_head.store(0);
+    queue_tail.store(0);
+    queue_count.store(0);
+
+    logMessagef("QUEUE: %u byte message arena allocated in %s",
+                (unsigned)queue_arena_capacity, queue_arena_in_psram ? "PSRAM" : "internal RAM");
+    return true;
+}
+
+static inline std::atomic<uint32_t>* queue_record_header(uint32_t offset) {
+    return &((QueuedMessage*)(queue_arena + offset))->header;
+}
+
+bool queue_is_empty() {
+    return queue_count.load(std::memory_order_relaxed) == 0;
+}
+
+size_t queue_bytes_used() {
+    uint32_t head = queue_head.load(std::memory_order_acquire);
+    uint32_t tail = queue_tail.load(std::memory_order_acquire);
+    return (tail >= head) ? tail - head : queue_arena_capacity - head + tail;
+}
+
+size_t queue_bytes_free() {
+    if (queue_arena_capacity == 0) {
+        return 0;
+    }
+    return queue_arena_capacity - QUEUE_RECORD_ALIGN - queue_bytes_used();
+}
+
+// True when a record_size record could not be reserved right now, counting the gap a wrap to
+// offset 0 would skip (see queue_arena_reserve)
+bool queue_is_full(uint16_t record_size) {
+    if (queue_arena_capacity == 0) {
+        return true;
+    }
+    uint32_t tail = queue_tail.load(std::memory_order_acquire);
+    size_t needed = record_size;
+    if (tail + record_size > queue_arena_capacity) {
+        needed += queue_arena_capacity - tail;
+    }
+    return queue_bytes_free() < needed;
+}
+
+// Reserves a contiguous record by advancing queue_tail with CAS, wrapping to offset 0 when
+// the tail segment is too short (a WRAP record covers the gap). One alignment unit is always
+// left free so head == tail unambiguously means empty. The header is stamped with the size
+// (not yet committed) so journal compaction can step over it. Returns the record offset or -1.
+static int queue_arena_reserve(uint16_t record_size) {
+    if (queue_arena == nullptr) {
+        return -1;
+    }
+
+    uint32_t tail = queue_tail.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t head = queue_head.load(std::memory_order_acquire);
+        size_t used = (tail >= head) ? tail - head : queue_arena_capacity - head + tail;
+        size_t available = queue_arena_capacity - QUEUE_RECORD_ALIGN - used;
+
+        uint32_t offset = tail;
+        size_t needed = record_size;
+        if (tail + record_size > queue_arena_capacity) {
+            offset = 0;
+            needed += queue_arena_capacity - tail;
+        }
+
+        if (needed > available) {
+            return -1;
+        }
+
+        uint32_t new_tail = offset + record_size;
+        if (new_tail == queue_arena_capacity) {
+            new_tail = 0;
+        }
+
+        if (queue_tail.compare_exchange_weak(tail, new_tail, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+            if (offset != tail) {
+                queue_record_header(tail)->store(QUEUE_RECORD_COMMITTED | QUEUE_RECORD_WRAP |
+                                                 (uint32_t)(queue_arena_capacity - tail),
+                                                 std::memory_order_release);
+            }
+            queue_record_header(offset)->store(record_size, std::memory_order_release);
+            return (int)offset;
+        }
+    }
+}
+
+uint32_t dedup_hash(uint32_t capcode, float frequency, const char* message, size_t message_length) {
+    uint32_t hash = 2166136261UL;
+    const uint8_t* parts[3] = { (const uint8_t*)&capcode, (const uint8_t*)&frequency, (const uint8_t*)message };
+    size_t lengths[3] = { sizeof(capcode), sizeof(frequency), message_length };
+
+    for (int p = 0; p < 3; p++) {
+        for (size_t i = 0; i < lengths[p]; i++) {
+            hash ^= parts[p][i];
+            hash *= 16777619UL;
+        }
+    }
+    return (hash == 0) ? 1 : hash;
+}
+
+// Returns true if a page with hash is still queued or was last seen within window_ms; otherwise
+// records it as queued (an idle slot is reused first, then the least recently seen one)
+static bool dedup_check_and_insert(uint32_t hash, uint32_t window_ms) {
+    uint32_t now = millis();
+    int oldest = -1;
+
+    portENTER_CRITICAL(&dedup_mux);
+    for (int i = 0; i < DEDUP_INDEX_SIZE; i++) {
+        DedupEntry* entry = &dedup_index[i];
+        if (entry->hash == hash) {
+            bool duplicate = entry->queued > 0 || (now - entry->last_seen_ms) < window_ms;
+            if (!duplicate) {
+                entry->last_seen_ms = now;
+                entry->queued = 1;
+            }
+            portEXIT_CRITICAL(&dedup_mux);
+            return duplicate;
+        }
+        DedupEntry* candidate = (oldest >= 0) ? &dedup_index[oldest] : nullptr;
+        if (candidate != nullptr && candidate->hash == 0) {
+            continue;
+        }
+        if (candidate == nullptr || entry->hash == 0) {
+            oldest = i;
+            continue;
+        }
+        bool idle = (entry->queued == 0);
+        bool candidate_idle = (candidate->queued == 0);
+        if ((idle && !candidate_idle) ||
+            (idle == candidate_idle && (now - entry->last_seen_ms) > (now - candidate->last_seen_ms))) {
+            oldest = i;
+        }
+    }
+
+    dedup_index[oldest].hash = hash;
+    dedup_index[oldest].last_seen_ms = now;
+    dedup_index[oldest].queued = 1;
+    portEXIT_CRITICAL(&dedup_mux);
+    return false;
+}
+
+static void dedup_forget(uint32_t hash) {
+    portENTER_CRITICAL(&dedup_mux);
+    for (int i = 0; i < DEDUP_INDEX_SIZE; i++) {
+        if (dedup_index[i].hash == hash) {
+            dedup_index[i].hash = 0;
+            dedup_index[i].queued = 0;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&dedup_mux);
+}
+
+// Called by the TX task when a tracked record leaves the queue. A sent page restarts the window
+// from now, so it counts from the last transmission; a page that failed is forgotten so an
+// identical retry is accepted.
+void dedup_release(uint32_t hash, bool sent) {
+    if (hash == 0) {
+        return;
+    }
+    if (!sent) {
+        dedup_forget(hash);
+        return;
+    }
+
+    uint32_t now = millis();
+    portENTER_CRITICAL(&dedup_mux);
+    for (int i = 0; i < DEDUP_INDEX_SIZE; i++) {
+        if (dedup_index[i].hash == hash) {
+            dedup_index[i].last_seen_ms = now;
+            if (dedup_index[i].queued > 0) {
+                dedup_index[i].queued--;
+            }
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&dedup_mux);
+}
+
+uint32_t dedup_suppressed_total() {
+    uint32_t total = 0;
+    for (int i = 0; i < TX_SOURCE_COUNT; i++) {
+        total += dedup_suppressed[i];
+    }
+    return total;
+}
+
+// Records a lifecycle transition for the MQTT ack ring and the /api long-poll history. Called
+// from the TX task as well as producers, so it only copies into RAM under delivery_mux.
+void delivery_event(uint32_t seq, const char* message_id, uint8_t source, uint8_t status, uint32_t airtime_ms) {
+    if (message_id == nullptr || message_id[0] == '\0') {
+        return;
+    }
+
+    DeliveryEvent event = {};
+    event.seq = seq;
+    event.timestamp = getUnixTimestamp();
+    event.airtime_ms = airtime_ms;
+    event.status = status;
+    event.source = source;
+    strlcpy(event.message_id, message_id, sizeof(event.message_id));
+
+    portENTER_CRITICAL(&delivery_mux);
+    if (delivery_events_count < DELIVERY_EVENT_QUEUE_SIZE) {
+        delivery_events[(delivery_events_head + delivery_events_count) % DELIVERY_EVENT_QUEUE_SIZE] = event;
+        delivery_events_count++;
+    } else {
+        delivery_events_dropped++;
+        delivery_events_dropped_total++;
+    }
+
+    // Repeat copies are reported but leave the long-poll history on the message's final status
+    if (seq != 0 && status != DELIVERY_REPEATED) {
+        int slot = -1;
+        for (int i = 0; i < DELIVERY_HISTORY_SIZE; i++) {
+            if (delivery_history[i].seq == seq) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) {
+            slot = delivery_history_next;
+            delivery_history_next = (delivery_history_next + 1) % DELIVERY_HISTORY_SIZE;
+        }
+        delivery_history[slot] = event;
+    }
+
+    TaskHandle_t waiter = NULL;
+    if (seq != 0 && (status == DELIVERY_TRANSMITTED || status == DELIVERY_FAILED)) {
+        for (int i = 0; i < DELIVERY_WAITERS_MAX; i++) {
+            if (delivery_waiters[i].seq == seq) {
+                waiter = delivery_waiters[i].task;
+                break;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&delivery_mux);
+
+    if (waiter != NULL) {
+        xTaskNotifyGive(waiter);
+    }
+}
+
+bool delivery_lookup(uint32_t seq, struct DeliveryEvent* out) {
+    bool found = false;
+    portENTER_CRITICAL(&delivery_mux);
+    for (int i = 0; i < DELIVERY_HISTORY_SIZE; i++) {
+        if (seq != 0 && delivery_history[i].seq == seq) {
+            *out = delivery_history[i];
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&delivery_mux);
+    return found;
+}
+
+static void delivery_fill_json(JsonObject ack, const struct DeliveryEvent* event) {
+    ack["message_id"] = event->message_id;
+    ack["status"] = delivery_status_names[event->status];
+    ack["timestamp"] = event->timestamp;
+    ack["source"] = tx_source_name(event->source);
+    if (event->seq != 0) {
+        ack["seq"] = event->seq;
+    }
+    if (event->status == DELIVERY_TRANSMITTED || event->status == DELIVERY_REPEATED) {
+        ack["airtime_ms"] = event->airtime_ms;
+    }
+}
+
+// Moves up to DELIVERY_PUBLISH_BATCH events per call into one MQTT outbox entry; runs from
+// loop() so the TX task never waits on the broker. Events stay in the ring while the outbox is full.
+void delivery_publish_pending() {
+    if (delivery_events_dropped > 0) {
+        portENTER_CRITICAL(&delivery_mux);
+        uint32_t dropped = delivery_events_dropped;
+        delivery_events_dropped = 0;
+        portEXIT_CRITICAL(&delivery_mux);
+        logMessagef("MQTT: %lu delivery event(s) dropped, ack ring full", (unsigned long)dropped);
+    }
+
+    if (delivery_events_count == 0) {
+        return;
+    }
+
+    if (!settings.mqtt_enabled || strlen(settings.mqtt_publish_topic) == 0) {
+        portENTER_CRITICAL(&delivery_mux);
+        delivery_events_head = 0;
+        delivery_events_count = 0;
+        portEXIT_CRITICAL(&delivery_mux);
+        return;
+    }
+
+    if (mqtt_outbox_count >= MQTT_OUTBOX_SIZE) {
+        return;
+    }
+
+    DeliveryEvent batch[DELIVERY_PUBLISH_BATCH];
+    uint8_t count = 0;
+    portENTER_CRITICAL(&delivery_mux);
+    while (count < DELIVERY_PUBLISH_BATCH && count < delivery_events_count) {
+        batch[count] = delivery_events[(delivery_events_head + count) % DELIVERY_EVENT_QUEUE_SIZE];
+        count++;
+    }
+    portEXIT_CRITICAL(&delivery_mux);
+
+    DynamicJsonDocument doc(2048);
+    String label;
+    if (count == 1) {
+        doc["type"] = "delivery_ack";
+        delivery_fill_json(doc.as<JsonObject>(), &batch[0]);
+        label = "Delivery ACK sent for " + String(batch[0].message_id) + " (" +
+                delivery_status_names[batch[0].status] + ")";
+    } else {
+        doc["type"] = "delivery_ack_batch";
+        JsonArray acks = doc.createNestedArray("acks");
+        for (uint8_t i = 0; i < count; i++) {
+            delivery_fill_json(acks.createNestedObject(), &batch[i]);
+        }
+        label = String(count) + " delivery ACKs sent in one batch";
+    }
+    doc["device"] = String(settings.mqtt_thing_name);
+
+    String payload;
+    serializeJson(doc, payload);
+    mqtt_outbox_push(MQTT_OUTBOX_ACK, label, payload, MQTT_OUTBOX_DROP_NEWEST);
+
+    portENTER_CRITICAL(&delivery_mux);
+    delivery_events_head = (delivery_events_head + count) % DELIVERY_EVENT_QUEUE_SIZE;
+    delivery_events_count -= count;
+    portEXIT_CRITICAL(&delivery_mux);
+}
+
+// Copies a prepared message into the arena. A zero *seq is assigned the next journal
+// sequence number; a non-zero *seq (journal replay) is kept as-is.
+// Fills and publishes a record in space already reserved with queue_arena_reserve()
+static void queue_write_record(uint32_t offset, uint16_t record_size,
+                               uint32_t capcode, const uint32_t* group_capcodes, uint8_t group_count,
+                               float frequency, int power, bool mail_drop,
+                               uint8_t repeat, uint16_t repeat_interval_s,
+                               uint8_t source, uint16_t airtime_reserved_ms, uint32_t dedup_key,
+                               const char* message, size_t message_length,
+                               const char* message_id, size_t id_length, uint32_t* seq) {
+    if (*seq == 0) {
+        *seq = queue_next_seq.fetch_add(1, std::memory_order_relaxed);
+    } else if (*seq >= queue_next_seq.load(std::memory_order_relaxed)) {
+        queue_next_seq.store(*seq + 1, std::memory_order_relaxed);
+    }
+
+    QueuedMessage* msg = (QueuedMessage*)(queue_arena + offset);
+    msg->message_length = (uint8_t)message_length;
+    msg->power = (int8_t)power;
+    msg->mail_drop = mail_drop;
+    msg->source = source;
+    msg->capcode = capcode;
+    msg->frequency = frequency;
+    msg->seq = *seq;
+    msg->dedup_key = dedup_key;
+    msg->airtime_reserved_ms = airtime_reserved_ms;
+    msg->enqueued_ms = millis();
+    msg->repeat = repeat;
+    msg->repeat_interval_s = repeat_interval_s;
+    msg->id_length = (uint8_t)id_length;
+    msg->group_count = group_count;
+    memcpy(msg->message, message, message_length);
+    msg->message[message_length] = '\0';
+    memcpy(msg->message + message_length + 1, message_id, id_length);
+    msg->message[message_length + 1 + id_length] = '\0';
+    if (group_count > 0) {
+        memcpy(msg->message + message_length + 1 + id_length + 1, group_capcodes, group_count * sizeof(uint32_t));
+    }
+
+    queue_count.fetch_add(1, std::memory_order_relaxed);
+    msg->header.store(QUEUE_RECORD_COMMITTED | record_size, std::memory_order_release);
+}
+
+static bool queue_push_record(uint32_t capcode, const uint32_t* group_capcodes, uint8_t group_count,
+                              float frequency, int power, bool mail_drop,
+                              uint8_t repeat, uint16_t repeat_interval_s,
+                              uint8_t source, uint16_t airtime_reserved_ms,
+                              const char* message, size_t message_length,
+                              const char* message_id, size_t id_length, uint32_t* seq) {
+    uint16_t record_size = QUEUE_RECORD_SIZE(message_length, id_length, group_count);
+
+    int offset = queue_arena_reserve(record_size);
+    if (offset < 0) {
+        return false;
+    }
+
+    queue_write_record(offset, record_size, capcode, group_capcodes, group_count, frequency, power, mail_drop,
+                       repeat, repeat_interval_s, source, airtime_reserved_ms, 0,
+                       message, message_length, message_id, id_length, seq);
+    return true;
+}
+
+const char* queue_message_id(const struct QueuedMessage* msg) {
+    return msg->message + msg->message_length + 1;
+}
+
+// Capcodes a record addresses: the group members, or just msg->capcode
+uint8_t queue_message_capcode_count(const struct QueuedMessage* msg) {
+    return (msg->group_count > 0) ? msg->group_count : 1;
+}
+
+uint32_t queue_message_capcode(const struct QueuedMessage* msg, uint8_t index) {
+    if (msg->group_count == 0) {
+        return msg->capcode;
+    }
+    uint32_t capcode;
+    memcpy(&capcode, msg->message + msg->message_length + 1 + msg->id_length + 1 + index * sizeof(uint32_t), sizeof(capcode));
+    return capcode;
+}
+
+// Transliterates message into item->text (truncated with "..." past MAX_FLEX_MESSAGE_LENGTH).
+// Returns true when the text had to be truncated.
+bool queue_batch_prepare(struct QueueBatchItem* item, const char* message) {
+    // Worst case every output char came from a 4-byte sequence; anything beyond is truncated anyway
+    char scratch[MAX_FLEX_MESSAGE_LENGTH * 4 + 1];
+    int truncated = 0;
+    item->text_length = (uint8_t)utf8_prepare_page(item->text, MAX_FLEX_MESSAGE_LENGTH, message, scratch, &truncated);
+
+    item->result = QUEUE_BATCH_PENDING;
+    return truncated != 0;
+}
+
+static void queue_batch_rollback(struct QueueBatchItem* item, uint8_t source) {
+    airtime_refund(item->frequency, item->airtime_reserved_ms);
+    if (item->hash != 0) {
+        dedup_forget(item->hash);
+    }
+    delivery_event(item->seq, item->message_id, source, DELIVERY_FAILED, 0);
+    item->result = QUEUE_BATCH_FULL;
+}
+
+// Ingest paths that answer "retry later" when the airtime budget is exhausted; pages from the
+// other sources are still charged against it but never refused
+static bool tx_source_budgeted(uint8_t source) {
+    return source == TX_SOURCE_API || source == TX_SOURCE_GRAFANA || source == TX_SOURCE_MQTT;
+}
+
+// Queues prepared pages from one ingest source. Duplicates within the source's dedup window are
+// suppressed per item (QUEUE_BATCH_DEDUPLICATED) before any airtime is charged. Each remaining
+// item is then admitted and reserved against the airtime budget in one step; a rejected one is
+// QUEUE_BATCH_RATE_LIMITED (with all_or_nothing, every item is then rolled back and the others
+// are QUEUE_BATCH_SKIPPED). The admitted ones share one arena reservation, so they land
+// contiguously and in order, and the TX task is woken once. When that reservation does not
+// fit: all_or_nothing fails every remaining item, otherwise each is retried on its own and only
+// the ones that still do not fit are QUEUE_BATCH_FULL. Returns the number of items queued.
+uint16_t queue_submit_batch(struct QueueBatchItem* items, uint16_t count, uint8_t source, bool all_or_nothing) {
+    uint16_t window_s = ingest_dedup_window_s(source);
+    bool enforce_budget = tx_source_budgeted(source);
+    uint32_t total_size = 0;
+    uint16_t pending = 0;
+    bool rate_limited = false;
+
+    for (uint16_t i = 0; i < count; i++) {
+        QueueBatchItem* item = &items[i];
+        if (item->result != QUEUE_BATCH_PENDING) {
+            continue;
+        }
+        if (item->group != nullptr) {
+            item->capcode = item->group->capcodes[0];
+        }
+        item->repeat = min(item->repeat, (uint8_t)TX_REPEAT_MAX);
+        if (item->repeat_interval_s == 0) {
+            item->repeat_interval_s = TX_REPEAT_INTERVAL_DEFAULT_S;
+        }
+        item->repeat_interval_s = constrain(item->repeat_interval_s, (uint16_t)TX_REPEAT_INTERVAL_MIN_S,
+                                            (uint16_t)TX_REPEAT_INTERVAL_MAX_S);
+
+        item->hash = 0;
+        item->seq = 0;
+        item->airtime_reserved_ms = 0;
+        item->retry_after_s = 0;
+        if (window_s > 0) {
+            item->hash = dedup_hash(item->capcode, item->frequency, item->text, item->text_length);
+            if (dedup_check_and_insert(item->hash, (uint32_t)window_s * 1000UL)) {
+                dedup_suppressed[source]++;
+                item->hash = 0;
+                item->result = QUEUE_BATCH_DEDUPLICATED;
+                logMessagef("QUEUE: Duplicate page suppressed (source=%s, capcode=%lu, window=%us)",
+                            tx_source_name(source), (unsigned long)item->capcode, (unsigned)window_s);
+                delivery_event(0, item->message_id, source, DELIVERY_DEDUPLICATED, 0);
+                continue;
+            }
+        }
+
+        uint8_t group_count = (item->group != nullptr) ? item->group->count : 0;
+        if (!airtime_admit_reserve(item->frequency, max(group_count, (uint8_t)1), enforce_budget,
+                                   &item->airtime_reserved_ms, &item->retry_after_s)) {
+            if (item->hash != 0) {
+                dedup_forget(item->hash);
+                item->hash = 0;
+            }
+            item->result = QUEUE_BATCH_RATE_LIMITED;
+            rate_limited = true;
+            logMessagef("QUEUE: Airtime budget exhausted on %.4f MHz (source=%s, retry after %lu s)",
+                        item->frequency, tx_source_name(source), (unsigned long)item->retry_after_s);
+            delivery_event(0, item->message_id, source, DELIVERY_FAILED, 0);
+            continue;
+        }
+
+        item->seq = queue_next_seq.fetch_add(1, std::memory_order_relaxed);
+        if (item->message_id[0] == '\0') {
+            snprintf(item->message_id, sizeof(item->message_id), "%s-%lu", tx_source_name(source), (unsigned long)item->seq);
+        }
+
+        item->record_size = QUEUE_RECORD_SIZE(item->text_length, strnlen(item->message_id, QUEUE_MESSAGE_ID_MAX), group_count);
+        total_size += item->record_size;
+        pending++;
+
+        // Reported before the record is published so it can never trail the TX task's events
+        delivery_event(item->seq, item->message_id, source, DELIVERY_QUEUED, 0);
+    }
+
+    if (rate_limited && all_or_nothing) {
+        for (uint16_t i = 0; i < count; i++) {
+            if (items[i].result == QUEUE_BATCH_PENDING) {
+                queue_batch_rollback(&items[i], source);
+                items[i].result = QUEUE_BATCH_SKIPPED;
+            }
+        }
+        return 0;
+    }
+
+    if (pending == 0) {
+        return 0;
+    }
+
+    int offset = (total_size <= QUEUE_RECORD_SIZE_MASK) ? queue_arena_reserve((uint16_t)total_size) : -1;
+    if (offset >= 0) {
+        // Split the shared reservation into per-record sizes before any of them is committed
+        uint32_t record_offset = (uint32_t)offset;
+        for (uint16_t i = 0; i < count; i++) {
+            if (items[i].result == QUEUE_BATCH_PENDING) {
+                queue_record_header(record_offset)->store(items[i].record_size, std::memory_order_release);
+                record_offset += items[i].record_size;
+            }
+        }
+    }
+    if (offset < 0 && all_or_nothing) {
+        for (uint16_t i = 0; i < count; i++) {
+            if (items[i].result == QUEUE_BATCH_PENDING) {
+                queue_batch_rollback(&items[i], source);
+            }
+        }
+        return 0;
+    }
+
+    uint16_t queued = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        QueueBatchItem* item = &items[i];
+        if (item->result != QUEUE_BATCH_PENDING) {
+            continue;
+        }
+
+        uint32_t record_offset;
+        if (offset >= 0) {
+            record_offset = (uint32_t)offset;
+            offset += item->record_size;
+        } else {
+            int single = queue_arena_reserve(item->record_size);
+            if (single < 0) {
+                queue_batch_rollback(item, source);
+                continue;
+            }
+            record_offset = (uint32_t)single;
+        }
+
+        const uint32_t* group_capcodes = (item->group != nullptr) ? item->group->capcodes : nullptr;
+        uint8_t group_count = (item->group != nullptr) ? item->group->count : 0;
+        size_t id_length = strnlen(item->message_id, QUEUE_MESSAGE_ID_MAX);
+#if QUEUE_JOURNAL_ENABLED
+        // Batched before the commit: once committed the TX task may send it and journal its completion
+        journal_record_enqueue(item->seq, item->capcode, group_capcodes, group_count, item->frequency, item->power,
+                               item->mail_drop, item->repeat, item->repeat_interval_s, source,
+                               item->text, item->text_length, item->message_id, id_length);
+#endif
+        queue_write_record(record_offset, item->record_size, item->capcode, group_capcodes, group_count,
+                           item->frequency, item->power, item->mail_drop,
+                           item->repeat, item->repeat_interval_s, source, item->airtime_reserved_ms, item->hash,
+                           item->text, item->text_length, item->message_id, id_length, &item->seq);
+        item->result = QUEUE_BATCH_QUEUED;
+        queued++;
+    }
+
+    if (queued > 0 && tx_task_handle != NULL) {
+        xTaskNotifyGive(tx_task_handle);
+    }
+
+    return queued;
+}
+
+// Queues a page unless an identical one (capcode + frequency + text) was queued or sent within
+// the source's dedup window; *deduplicated is set and true returned when it was suppressed.
+// message_id (QUEUE_MESSAGE_ID_MAX + 1 bytes, may be null) carries the caller's delivery ID;
+// an empty one is filled with a generated "<source>-<seq>" ID. *seq receives the queue sequence.
+// repeat extra copies (clamped to TX_REPEAT_MAX) follow the first transmission every
+// repeat_interval_s seconds; 0 uses TX_REPEAT_INTERVAL_DEFAULT_S.
+// A non-null group replaces capcode: the page is queued once and sent to every member in turn.
+bool queue_submit_message(uint32_t capcode, const struct PagerGroup* group, float frequency, int power, bool mail_drop, const char* message,
+                          uint8_t source, uint8_t repeat, uint16_t repeat_interval_s,
+                          char* message_id, bool* deduplicated, uint32_t* seq) {
+    QueueBatchItem item = {};
+    item.capcode = capcode;
+    item.group = group;
+    item.frequency = frequency;
+    item.power = (int8_t)power;
+    item.mail_drop = mail_drop;
+    item.repeat = repeat;
+    item.repeat_interval_s = repeat_interval_s;
+    if (message_id != nullptr) {
+        strlcpy(item.message_id, message_id, sizeof(item.message_id));
+    }
+    queue_batch_prepare(&item, message);
+
+    queue_submit_batch(&item, 1, source, true);
+
+    if (message_id != nullptr && item.result != QUEUE_BATCH_DEDUPLICATED) {
+        strlcpy(message_id, item.message_id, QUEUE_MESSAGE_ID_MAX + 1);
+    }
+    *deduplicated = (item.result == QUEUE_BATCH_DEDUPLICATED);
+    *seq = (item.result == QUEUE_BATCH_QUEUED) ? item.seq : 0;
+    return item.result == QUEUE_BATCH_QUEUED || item.result == QUEUE_BATCH_DEDUPLICATED;
+}
+
+bool queue_add_message(uint32_t capcode, float frequency, int power, bool mail_drop, const char* message, uint8_t source) {
+    bool deduplicated = false;
+    uint32_t seq = 0;
+    return queue_submit_message(capcode, nullptr, frequency, power, mail_drop, message, source, 0, 0, nullptr,
+                                &deduplicated, &seq);
+}
+
+// Consumer side: zeroes a released record so free space never holds a stale header, then
+// hands the bytes back to producers. Waits out a journal compaction snapshot in progress.
+static void queue_release_region(uint32_t offset, uint32_t size, uint32_t next_head) {
+    queue_release_pending.store(true);
+    while (queue_snapshot_active.load()) {
+        queue_release_pending.store(false);
+        vTaskDelay(1);
+        queue_release_pending.store(true);
+    }
+
+    memset(queue_arena + offset + sizeof(uint32_t), 0, size - sizeof(uint32_t));
+    queue_record_header(offset)->store(0, std::memory_order_relaxed);
+    queue_head.store(next_head, std::memory_order_release);
+
+    queue_release_pending.store(false, std::memory_order_release);
+}
+
+struct QueuedMessage* queue_get_next_message() {
+    if (queue_arena == nullptr) {
+        return nullptr;
+    }
+
+    while (true) {
+        uint32_t head = queue_head.load(std::memory_order_relaxed);
+        uint32_t header = queue_record_header(head)->load(std::memory_order_acquire);
+        if ((header & QUEUE_RECORD_COMMITTED) == 0) {
+            return nullptr;
+        }
+
+        if (header & QUEUE_RECORD_WRAP) {
+            queue_release_region(head, header & QUEUE_RECORD_SIZE_MASK, 0);
+            continue;
+        }
+        if (header & QUEUE_RECORD_TAKEN) {
+            uint32_t next_head = head + (header & QUEUE_RECORD_SIZE_MASK);
+            queue_release_region(head, header & QUEUE_RECORD_SIZE_MASK, (next_head >= queue_arena_capacity) ? 0 : next_head);
+            continue;
+        }
+
+        return (QueuedMessage*)(queue_arena + head);
+    }
+}
+
+// Consumer look-ahead: the committed page after prev (nullptr = the head page), stepping over
+// wrap padding and pages already taken. Stops at a record that is still being written, so
+// pages are only ever seen in the order they were published.
+struct QueuedMessage* queue_next_message_after(const struct QueuedMessage* prev) {
+    if (prev == nullptr) {
+        return queue_get_next_message();
+    }
+
+    uint32_t offset = (uint32_t)((const uint8_t*)prev - queue_arena);
+    uint32_t header = prev->header.load(std::memory_order_relaxed);
+    while (true) {
+        offset += header & QUEUE_RECORD_SIZE_MASK;
+        if (offset >= queue_arena_capacity || (header & QUEUE_RECORD_WRAP)) {
+            offset = 0;
+        }
+        if (offset == queue_tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        header = queue_record_header(offset)->load(std::memory_order_acquire);
+        if ((header & QUEUE_RECORD_COMMITTED) == 0) {
+            return nullptr;
+        }
+        if ((header & (QUEUE_RECORD_WRAP | QUEUE_RECORD_TAKEN)) == 0) {
+            return (QueuedMessage*)(queue_arena + offset);
+        }
+    }
+}
+
+void queue_remove_message() {
+    QueuedMessage* msg = queue_get_next_message();
+    if (msg == nullptr) {
+        return;
+    }
+
+    uint32_t head = (uint32_t)((uint8_t*)msg - queue_arena);
+    uint32_t size = msg->header.load(std::memory_order_relaxed) & QUEUE_RECORD_SIZE_MASK;
+    uint32_t removed_seq = msg->seq;
+
+    uint32_t next_head = head + size;
+    if (next_head >= queue_arena_capacity) {
+        next_head = 0;
+    }
+
+    queue_release_region(head, size, next_head);
+    queue_count.fetch_sub(1, std::memory_order_relaxed);
+
+#if QUEUE_JOURNAL_ENABLED
+    if (removed_seq != 0) {
+        journal_record_complete(removed_seq);
+    }
+#endif
+}
+
+// Completes a page returned by queue_next_message_after(). The head page is released at once;
+// one further back is flagged taken and keeps its bytes until the head catches up with it.
+void queue_take_message(struct QueuedMessage* msg) {
+    if (msg == queue_get_next_message()) {
+        queue_remove_message();
+        return;
+    }
+
+    uint32_t taken_seq = msg->seq;
+    msg->header.fetch_or(QUEUE_RECORD_TAKEN, std::memory_order_release);
+    queue_count.fetch_sub(1, std::memory_order_relaxed);
+
+#if QUEUE_JOURNAL_ENABLED
+    if (taken_seq != 0) {
+        journal_record_complete(taken_seq);
+    }
+#endif
+}
+
+// =============================================================================
+// QUEUE JOURNAL - Crash-safe persistence of pending messages (/qjournalN.bin)
+// =============================================================================
+
+static void journal_segment_path(uint8_t segment, char* path, size_t path_size) {
+    snprintf(path, path_size, "/qjournal%u.bin", (unsigned)segment);
+}
+
+// Hot path: only a CRC and a memcpy into the RAM batch, flash I/O happens in loop()
+static void journal_append(uint8_t type, uint32_t seq, const void* head, size_t head_len,
+                           const void* tail, size_t tail_len) {
+    if (!journal_ready) {
+        return;
+    }
+
+    JournalEntryHeader entry;
+    journal_build_entry(&entry, type, seq, head, head_len, tail, tail_len);
+    size_t total = sizeof(entry) + head_len + tail_len;
+
+    portENTER_CRITICAL(&journal_mux);
+    if (journal_buffer_len + total > JOURNAL_BUFFER_SIZE) {
+        journal_overflow = true;
+    } else {
+        memcpy(journal_buffer + journal_buffer_len, &entry, sizeof(entry));
+        memcpy(journal_buffer + journal_buffer_len + sizeof(entry), head, head_len);
+        memcpy(journal_buffer + journal_buffer_len + sizeof(entry) + head_len, tail, tail_len);
+        journal_buffer_len += total;
+    }
+    portEXIT_CRITICAL(&journal_mux);
+}
+
+void journal_record_enqueue(uint32_t seq, uint32_t capcode, const uint32_t* group_capcodes, uint8_t group_count,
+                            float frequency, int power, bool mail_drop,
+                            uint8_t repeat, uint16_t repeat_interval_s, uint8_t source,
+                            const char* message, size_t message_length, const char* message_id, size_t id_length) {
+    JournalEnqueuePayload payload = {};
+    payload.capcode = capcode;
+    payload.frequency = frequency;
+    payload.power = (int8_t)power;
+    payload.flags = mail_drop ? JOURNAL_FLAG_MAIL_DROP : 0;
+    payload.source = source;
+    payload.id_length = (uint8_t)id_length;
+    payload.repeat = repeat;
+    payload.repeat_interval_s = repeat_interval_s;
+
+    // Same text NUL id [NUL capcodes] layout as the queue record, so compaction can write records verbatim
+    char tail[JOURNAL_TAIL_MAX];
+    memcpy(tail, message, message_length);
+    tail[message_length] = '\0';
+    memcpy(tail + message_length + 1, message_id, id_length);
+    size_t tail_length = message_length + 1 + id_length;
+    if (group_count > 0) {
+        tail[tail_length++] = '\0';
+        memcpy(tail + tail_length, group_capcodes, group_count * sizeof(uint32_t));
+        tail_length += group_count * sizeof(uint32_t);
+    }
+    journal_append(JOURNAL_ENTRY_ENQUEUE, seq, &payload, sizeof(payload), tail, tail_length);
+}
+
+void journal_record_complete(uint32_t seq) {
+    journal_append(JOURNAL_ENTRY_COMPLETE, seq, nullptr, 0, nullptr, 0);
+}
+
+static size_t journal_write_entry(File& file, uint8_t type, uint32_t seq, const void* head, size_t head_len,
+                                  const void* tail, size_t tail_len) {
+    JournalEntryHeader entry;
+    journal_build_entry(&entry, type, seq, head, head_len, tail, tail_len);
+
+    size_t written = file.write((const uint8_t*)&entry, sizeof(entry));
+    if (head_len > 0) written += file.write((const uint8_t*)head, head_len);
+    if (tail_len > 0) written += file.write((const uint8_t*)tail, tail_len);
+    return written;
+}
+
+// Copies the live part of the arena, [head, tail) unwrapped, into a fresh buffer while the consumer
+// is held off; *length receives its size. Waits for a release in progress by yielding a few ticks
+// rather than spinning, and returns nullptr if it does not finish or memory is short.
+static uint8_t* journal_snapshot_queue(size_t* length) {
+    queue_snapshot_active.store(true);
+    for (int i = 0; i < JOURNAL_SNAPSHOT_WAIT_TICKS && queue_release_pending.load(); i++) {
+        vTaskDelay(1);
+    }
+    if (queue_release_pending.load()) {
+        queue_snapshot_active.store(false, std::memory_order_release);
+        return nullptr;
+    }
+
+    uint32_t head = queue_head.load(std::memory_order_acquire);
+    uint32_t tail = queue_tail.load(std::memory_order_acquire);
+    size_t first = (tail >= head) ? tail - head : queue_arena_capacity - head;
+    size_t second = (tail >= head) ? 0 : tail;
+
+    uint32_t caps = queue_arena_in_psram ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : MALLOC_CAP_8BIT;
+    uint8_t* snapshot = (uint8_t*)heap_caps_malloc(max(first + second, (size_t)1), caps);
+    if (snapshot != nullptr) {
+        memcpy(snapshot, queue_arena + head, first);
+        memcpy(snapshot + first, queue_arena, second);
+        *length = first + second;
+    }
+    queue_snapshot_active.store(false, std::memory_order_release);
+    return snapshot;
+}
+
+// Rewrites the live queue into the next segment (round-robin) and drops the old ones,
+// so segments never grow past JOURNAL_SEGMENT_SIZE and completed entries are discarded.
+// Every committed record in the snapshot is written, except pages already sent out of order.
+// Batch entries appended before the snapshot are covered by it and dropped, later ones stay for
+// the next flush. That holds because a record's enqueue entry is batched before the record is
+// committed, so its complete entry can never precede it; a record still uncommitted in the
+// snapshot defers the compaction, since its enqueue entry may be in the covered part.
+static void journal_compact() {
+    portENTER_CRITICAL(&journal_mux);
+    size_t covered = journal_buffer_len;
+    journal_overflow = false;
+    portEXIT_CRITICAL(&journal_mux);
+
+    size_t length = 0;
+    uint8_t* snapshot = journal_snapshot_queue(&length);
+    if (snapshot == nullptr) {
+        logMessage("JOURNAL: Compaction deferred - queue snapshot unavailable");
+        journal_overflow = true;
+        journal_last_flush_ms = millis();
+        return;
+    }
+
+    uint8_t next_segment = (journal_active_segment + 1) % JOURNAL_SEGMENT_COUNT;
+    char path[24];
+    journal_segment_path(next_segment, path, sizeof(path));
+
+    File file = SPIFFS.open(path, "w");
+    if (!file) {
+        free(snapshot);
+        logMessagef("JOURNAL: Failed to open %s for compaction", path);
+        journal_overflow = true;
+        journal_last_flush_ms = millis();
+        return;
+    }
+
+    JournalSegmentHeader header = { JOURNAL_MAGIC, journal_generation + 1 };
+    size_t bytes = file.write((const uint8_t*)&header, sizeof(header));
+
+    int count = 0;
+    bool complete = true;
+    size_t offset = 0;
+    while (offset < length) {
+        QueuedMessage* msg = (QueuedMessage*)(snapshot + offset);
+        uint32_t record_header = msg->header.load(std::memory_order_relaxed);
+        uint32_t record_size = record_header & QUEUE_RECORD_SIZE_MASK;
+        if (record_size == 0) {
+            // A producer between its reservation and the size stamp: the rest cannot be walked
+            complete = false;
+            break;
+        }
+        if ((record_header & QUEUE_RECORD_COMMITTED) == 0) {
+            // Its enqueue entry may already be in the covered part of the batch
+            complete = false;
+            break;
+        }
+        offset += record_size;
+        if (record_header & (QUEUE_RECORD_WRAP | QUEUE_RECORD_TAKEN)) {
+            continue;
+        }
+
+        JournalEnqueuePayload payload = {};
+        payload.capcode = msg->capcode;
+        payload.frequency = msg->frequency;
+        payload.power = msg->power;
+        payload.flags = msg->mail_drop ? JOURNAL_FLAG_MAIL_DROP : 0;
+        payload.source = msg->source;
+        payload.id_length = msg->id_length;
+        payload.repeat = msg->repeat;
+        payload.repeat_interval_s = msg->repeat_interval_s;
+        size_t tail_length = msg->message_length + 1 + msg->id_length;
+        if (msg->group_count > 0) {
+            tail_length += 1 + msg->group_count * sizeof(uint32_t);
+        }
+        bytes += journal_write_entry(file, JOURNAL_ENTRY_ENQUEUE, msg->seq, &payload, sizeof(payload),
+                                     msg->message, tail_length);
+        count++;
+    }
+
+    file.flush();
+    file.close();
+    free(snapshot);
+
+    if (!complete) {
+        // The old segments are untouched and the batch is intact, so nothing is lost
+        SPIFFS.remove(path);
+        logMessage("JOURNAL: Compaction deferred - record write in progress");
+        journal_overflow = true;
+        journal_last_flush_ms = millis();
+        return;
+    }
+
+    for (uint8_t i = 0; i < JOURNAL_SEGMENT_COUNT; i++) {
+        if (i == next_segment) continue;
+        char old_path[24];
+        journal_segment_path(i, old_path, sizeof(old_path));
+        if (SPIFFS.exists(old_path)) {
+            SPIFFS.remove(old_path);
+        }
+    }
+
+    portENTER_CRITICAL(&journal_mux);
+    memmove(journal_buffer, journal_buffer + covered, journal_buffer_len - covered);
+    journal_buffer_len -= covered;
+    portEXIT_CRITICAL(&journal_mux);
+
+    journal_active_segment = next_segment;
+    journal_generation++;
+    journal_segment_bytes = bytes;
+    journal_last_flush_ms = millis();
+
+    logMessagef("JOURNAL: Compacted to segment %u (%d pending, %u bytes)",
+                (unsigned)next_segment, count, (unsigned)bytes);
+}
+
+static void journal_flush() {
+    static uint8_t flush_buffer[JOURNAL_BUFFER_SIZE];
+
+    portENTER_CRITICAL(&journal_mux);
+    size_t len = journal_buffer_len;
+    memcpy(flush_buffer, journal_buffer, len);
+    journal_buffer_len = 0;
+    portEXIT_CRITICAL(&journal_mux);
+
+    journal_last_flush_ms = millis();
+    if (len == 0) {
+        return;
+    }
+
+    char path[24];
+    journal_segment_path(journal_active_segment, path, sizeof(path));
+
+    File file = SPIFFS.open(path, "a");
+    if (!file) {
+        logMessagef("JOURNAL: Failed to open %s for append", path);
+        journal_overflow = true;
+        return;
+    }
+
+    size_t written = file.write(flush_buffer, len);
+    file.close();
+    journal_segment_bytes += written;
+
+    if (written != len) {
+        logMessagef("JOURNAL: Short write (%u of %u bytes), forcing compaction", (unsigned)written, (unsigned)len);
+        journal_overflow = true;
+        return;
+    }
+
+    if (journal_segment_bytes >= JOURNAL_SEGMENT_SIZE) {
+        journal_compact();
+    }
+}
+
+void journal_flush_if_due() {
+    if (!journal_ready) {
+        return;
+    }
+
+    if (journal_overflow) {
+        if ((millis() - journal_last_flush_ms) >= JOURNAL_FLUSH_INTERVAL_MS) {
+            journal_compact();
+        }
+        return;
+    }
+
+    if (journal_buffer_len == 0) {
+        return;
+    }
+
+    if (journal_buffer_len >= JOURNAL_FLUSH_THRESHOLD ||
+        (millis() - journal_last_flush_ms) >= JOURNAL_FLUSH_INTERVAL_MS) {
+        journal_flush();
+    }
+}
+
+struct JournalPendingEntry {
+    uint32_t seq;
+    JournalEnqueuePayload payload;
+    String message;
+    String message_id;
+    std::vector<uint32_t> group_capcodes;
+};
+
+// Boot-time recovery: re-queues every journaled message without a complete entry
+void journal_replay() {
+    struct SegmentInfo {
+        uint8_t index;
+        uint32_t generation;
+        uint32_t magic;
+    };
+
+    std::vector<SegmentInfo> segments;
+    for (uint8_t i = 0; i < JOURNAL_SEGMENT_COUNT; i++) {
+        char path[24];
+        journal_segment_path(i, path, sizeof(path));
+        if (!SPIFFS.exists(path)) continue;
+
+        File file = SPIFFS.open(path, "r");
+        if (!file) continue;
+
+        JournalSegmentHeader header;
+        if (file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            (header.magic == JOURNAL_MAGIC || header.magic == JOURNAL_MAGIC_V1)) {
+            segments.push_back({i, header.generation, header.magic});
+        }
+        file.close();
+    }
+
+    std::sort(segments.begin(), segments.end(),
+              [](const SegmentInfo& a, const SegmentInfo& b) { return a.generation < b.generation; });
+
+    std::vector<JournalPendingEntry> pending;
+    std::vector<uint32_t> completed;
+    uint32_t max_seq = 0;
+    uint8_t payload_buffer[sizeof(JournalEnqueuePayload) + JOURNAL_TAIL_MAX];
+
+    for (const SegmentInfo& segment : segments) {
+        char path[24];
+        journal_segment_path(segment.index, path, sizeof(path));
+        File file = SPIFFS.open(path, "r");
+        if (!file) continue;
+
+        file.seek(sizeof(JournalSegmentHeader));
+        journal_generation = max(journal_generation, segment.generation);
+        journal_active_segment = segment.index;
+
+        JournalEntryHeader entry;
+        while (file.read((uint8_t*)&entry, sizeof(entry)) == sizeof(entry)) {
+            if (entry.payload_length > sizeof(payload_buffer)) {
+                break;
+            }
+            if (entry.payload_length > 0 &&
+                file.read(payload_buffer, entry.payload_length) != entry.payload_length) {
+                break;
+            }
+
+            if (!journal_entry_valid(&entry, payload_buffer)) {
+                logMessagef("JOURNAL: Torn entry in %s, ignoring remainder", path);
+                break;
+            }
+
+            max_seq = max(max_seq, entry.seq);
+
+            JournalEnqueueView view;
+            if (entry.type == JOURNAL_ENTRY_ENQUEUE &&
+                journal_parse_enqueue(payload_buffer, entry.payload_length, segment.magic, MAX_FLEX_MESSAGE_LENGTH,
+                                      QUEUE_MESSAGE_ID_MAX, PAGER_GROUP_MEMBERS_MAX, &view)) {
+                JournalPendingEntry item;
+                item.seq = entry.seq;
+                item.payload = view.payload;
+                char text[MAX_FLEX_MESSAGE_LENGTH + 1];
+                memcpy(text, view.message, view.message_length);
+                text[view.message_length] = '\0';
+                item.message = String(text);
+
+                // Entries written before message IDs existed carry no NUL and no ID
+                char id[QUEUE_MESSAGE_ID_MAX + 1] = "";
+                if (view.id_length > 0) {
+                    memcpy(id, view.message_id, view.id_length);
+                    id[view.id_length] = '\0';
+                }
+                item.message_id = String(id);
+
+                if (view.group_count > 0) {
+                    item.group_capcodes.resize(view.group_count);
+                    memcpy(item.group_capcodes.data(), view.group_capcodes, view.group_count * sizeof(uint32_t));
+                }
+                pending.push_back(item);
+            } else if (entry.type == JOURNAL_ENTRY_COMPLETE) {
+                completed.push_back(entry.seq);
+            }
+        }
+        file.close();
+    }
+
+    std::sort(completed.begin(), completed.end());
+    std::sort(pending.begin(), pending.end(),
+              [](const JournalPendingEntry& a, const JournalPendingEntry& b) { return a.seq < b.seq; });
+
+    queue_next_seq = max_seq + 1;
+
+    int replayed = 0;
+    int dropped = 0;
+    uint32_t last_seq = 0;
+    for (JournalPendingEntry& item : pending) {
+        if (item.seq == last_seq || std::binary_search(completed.begin(), completed.end(), item.seq)) {
+            continue;
+        }
+        last_seq = item.seq;
+
+        uint32_t seq = item.seq;
+        if (queue_push_record(item.payload.capcode, item.group_capcodes.data(), (uint8_t)item.group_capcodes.size(),
+                              item.payload.frequency, item.payload.power,
+                              (item.payload.flags & JOURNAL_FLAG_MAIL_DROP) != 0,
+                              min(item.payload.repeat, (uint8_t)TX_REPEAT_MAX), item.payload.repeat_interval_s,
+                              item.payload.source, 0,
+                              item.message.c_str(), item.message.length(),
+                              item.message_id.c_str(), item.message_id.length(), &seq)) {
+            replayed++;
+        } else {
+            dropped++;
+        }
+    }
+
+    journal_ready = true;
+    journal_compact();
+
+    if (replayed > 0 || dropped > 0) {
+        logMessagef("JOURNAL: Replayed %d undelivered message(s) from %u segment(s), %d dropped (queue full)",
+                    replayed, (unsigned)segments.size(), dropped);
+    } else {
+        logMessage("JOURNAL: No undelivered messages to replay");
+    }
+}
+
+void rf_amplifier_power(bool on) {
+    int actual_rfamp_pin = (settings.rf_amplifier_power_pin == 0) ? RFAMP_PWR_PIN : settings.rf_amplifier_power_pin;
+    digitalWrite(actual_rfamp_pin, (on == settings.rf_amplifier_active_high) ? HIGH : LOW);
+}
+
+// Page on air member by member (TX task only). A group page stays in the queue until every
+// member has been tried, so pages for other frames can go out between its members; members
+// listening in the same frame share one multi-address frame.
+struct TxPage {
+    struct QueuedMessage* msg;      // nullptr = none in progress
+    uint32_t pending;               // Bit per member capcode not tried yet
+    bool started;                   // A member got past its frame hold: events and metrics sent
+    uint8_t sent;                   // Frames sent
+    uint8_t addressed;              // Member capcodes in the frames sent
+    uint32_t airtime_ms;
+    unsigned long dequeue_ms;
+    struct TxRepeat repeat;         // Frames kept for the page's repeat copies
+    bool repeat_ok;
+};
+
+// TX task state carried from one transmission to the next
+struct TxSession {
+    bool rf_amp_hot;
+    unsigned long last_tx_end_ms;
+    bool last_tx_pending_next;      // Another transmission was due when the last one ended
+    struct TxPage page;             // Group page with members still to send
+    uint32_t hold_ms;               // Frame hold left to the task's notify wait, 0 = none
+    bool holding;                   // Waiting for a FLEX frame since hold_start_ms
+    unsigned long hold_start_ms;
+    unsigned long hold_end_ms;      // End of the hold before the next startTransmit, 0 = none
+};
+
+// Next frame to put on air: one member of a queued page or one frame of a repeat copy
+struct TxPick {
+    struct TxRepeat* repeat;
+    struct QueuedMessage* msg;
+    uint8_t index;                  // Page member or repeat frame
+    uint32_t capcode;
+    uint32_t wait_ms;               // Until its FLEX frame, 0 without alignment
+};
+
+static bool tx_frame_aligning() {
+    return settings.flex_frame_alignment && system_time_initialized;
+}
+
+// Time from the keyup decision to the FLEX sync: amplifier warm-up and the EMR preamble when due
+static uint32_t tx_keyup_lead_ms(const struct TxSession* session) {
+    uint32_t lead_ms = FLEX_FRAME_GUARD_MS;
+    if (settings.enable_rf_amplifier && !session->rf_amp_hot) {
+        lead_ms += settings.rf_amplifier_delay_ms;
+    }
+    if (emr_due()) {
+        lead_ms += (uint32_t)(settings.emr_pattern_length * 8 / TX_BITRATE);
+    }
+    return lead_ms;
+}
+
+// Leaves a frame hold longer than FLEX_HOLD_INLINE_MS to the task's notify wait, so new pages
+// and due repeats are weighed again while it runs; the rest is held inline before keyup
+static void tx_hold(struct TxSession* session, uint32_t wait_ms) {
+    if (!session->holding) {
+        session->holding = true;
+        session->hold_start_ms = millis();
+    }
+    session->hold_ms = wait_ms - FLEX_HOLD_INLINE_MS / 2;
+}
+
+// Holds for the capcode's FLEX frame and writes that frame's cycle/frame into the FIW of the
+// frame in tx_data_buffer. Returns false, with the hold left to the notify wait, when the frame
+// has moved further off than FLEX_HOLD_INLINE_MS (encoding ran past it).
+static bool tx_frame_hold(struct TxSession* session, uint32_t capcode) {
+    uint8_t cycle = 0;
+    uint8_t frame = 0;
+    uint32_t wait_ms = flex_frame_wait_ms(capcode, tx_keyup_lead_ms(session), &cycle, &frame);
+    if (wait_ms > FLEX_HOLD_INLINE_MS) {
+        tx_hold(session, wait_ms);
+        return false;
+    }
+
+    if (flex_frame_set_fiw(tx_data_buffer, current_tx_total_length, cycle, frame)) {
+        tx_metrics.fiw_patched++;
+    } else {
+        tx_metrics.fiw_unpatched++;
+    }
+
+    tx_metrics.last_frame_wait_ms = wait_ms + (session->holding ? millis() - session->hold_start_ms : 0);
+    if (wait_ms > 0) {
+        vTaskDelay(pdMS_TO_TICKS(wait_ms));
     }
-}
+    if (wait_ms > 0 || session->holding) {
+        session->hold_end_ms = millis();
+    }
+    session->holding = false;
 
-void at_handle_flex_message() {
-    reset_oled_timeout();
+    tx_metrics.frame_aligned++;
+    tx_metrics.last_cycle = cycle;
+    tx_metrics.last_frame = frame;
+    return true;
+}
 
-    if (device_state != STATE_WAITING_FOR_MSG) {
-        return;
+// Retunes for the next frame, powering the RF amplifier down first when the channel changes
+static bool tx_select_channel(struct TxSession* session, float frequency, int8_t power) {
+    if (session->rf_amp_hot && fabs(frequency - current_tx_frequency) > 0.0001) {
+        rf_amplifier_power(false);
+        session->rf_amp_hot = false;
     }
+    return radio_select_channel(frequency, power);
+}
 
-    if (millis() > flex_message_timeout) {
-        at_reset_state();
-        display_status();
-        at_send_error();
-        return;
+// Powers the RF amplifier (or counts a hot start when it is still up from the previous transmission)
+static void tx_prepare_keyup(struct TxSession* session) {
+    if (session->rf_amp_hot && !settings.enable_rf_amplifier) {
+        rf_amplifier_power(false);
+        session->rf_amp_hot = false;
     }
+    if (settings.enable_rf_amplifier) {
+        if (session->rf_amp_hot) {
+            tx_metrics.hot_starts++;
+        } else {
+            rf_amplifier_power(true);
+            delay(settings.rf_amplifier_delay_ms);
+            session->rf_amp_hot = true;
+        }
+    }
+}
 
-    while (Serial.available() && flex_message_pos < MAX_FLEX_MESSAGE_LENGTH) {
-        char c = Serial.read();
-
-        if (c == '\r' || c == '\n') {
-            flex_message_buffer[flex_message_pos] = '\0';
+// Sends tx_data_buffer (EMR prepended when due) and blocks until the FIFO drains, leaving the
+// radio in standby. Returns false if the radio refused to start.
+static bool tx_send_buffer(struct TxSession* session, size_t* emr_bytes, unsigned long* tx_start_ms) {
+    device_state = STATE_TRANSMITTING;
+    LED_ON();
+    display_update_requested = true;
 
-            if (queue_add_message(flex_capcode, current_tx_frequency, tx_power, flex_mail_drop, flex_message_buffer)) {
-                at_reset_state();
-                at_send_ok();
-                display_status();
-            } else {
-                device_state = STATE_ERROR;
-                at_send_error();
-                at_reset_state();
-                display_status();
-            }
-            return;
-        }
+    *emr_bytes = prepend_emr_if_needed();
 
-        if (c >= 32 && c <= 126) {
-            flex_message_buffer[flex_message_pos++] = c;
-            flex_message_timeout = millis() + FLEX_MSG_TIMEOUT;
+    fifo_empty = true;
+    current_tx_remaining_length = current_tx_total_length;
+    *tx_start_ms = millis();
+    radio_start_transmit_status = radio.startTransmit(tx_data_buffer, current_tx_total_length);
+    if (session->last_tx_pending_next) {
+        // A frame alignment hold is scheduling, not turnaround: count from the end of the hold
+        unsigned long from_ms = session->last_tx_end_ms;
+        if (session->hold_end_ms != 0 && (long)(session->hold_end_ms - from_ms) > 0) {
+            from_ms = session->hold_end_ms;
         }
+        tx_metrics.last_turnaround_ms = *tx_start_ms - from_ms;
+        metrics_observe(&metric_turnaround, tx_metrics.last_turnaround_ms);
     }
+    session->hold_end_ms = 0;
 
-    if (flex_message_pos >= MAX_FLEX_MESSAGE_LENGTH) {
-        String truncated_message = truncate_message_with_ellipsis(String(flex_message_buffer));
-        strncpy(flex_message_buffer, truncated_message.c_str(), MAX_FLEX_MESSAGE_LENGTH);
-        flex_message_buffer[MAX_FLEX_MESSAGE_LENGTH] = '\0';
+    if (radio_start_transmit_status != RADIOLIB_ERR_NONE) {
+        device_state = STATE_IDLE;
+        LED_OFF();
+        display_update_requested = true;
+        return false;
+    }
 
-        if (queue_add_message(flex_capcode, current_tx_frequency, tx_power, flex_mail_drop, flex_message_buffer)) {
-            at_reset_state();
-            at_send_ok();
-            display_status();
-        } else {
-            device_state = STATE_ERROR;
-            at_send_error();
-            at_reset_state();
-            display_status();
+    // The first refill follows the fifo_empty set above, not the ISR, so it is not a latency sample
+    bool isr_refill = false;
+    bool transmission_complete = false;
+    while (!transmission_complete) {
+        if (fifo_empty && current_tx_remaining_length > 0) {
+            fifo_empty = false;
+            if (isr_refill) {
+                metrics_observe(&metric_fifo_refill, micros() - fifo_empty_us);
+            }
+            isr_refill = true;
+            transmission_complete = radio.fifoAdd(tx_data_buffer, current_tx_total_length, &current_tx_remaining_length);
         }
+        delay(1);
+    }
+
+    tx_metrics.last_airtime_ms = millis() - *tx_start_ms;
+    metrics_observe(&metric_airtime, tx_metrics.last_airtime_ms);
+    tx_metrics.last_emr_ms = (uint32_t)(*emr_bytes * 8 / TX_BITRATE);
+    if (*emr_bytes > 0) {
+        tx_metrics.emr_bursts++;
     }
+
+    radio.standby();
+    session->last_tx_end_ms = millis();
+
+    device_state = STATE_IDLE;
+    LED_OFF();
+    return true;
 }
 
-void at_process_serial() {
-    if (device_state == STATE_WAITING_FOR_DATA) {
-        at_handle_binary_data();
-        return;
+// Appends the frame just sent for capcode (tx_data_buffer past the EMR preamble) to a repeat
+// being built for the current page. On allocation failure the copies built so far are freed.
+static bool tx_repeat_append(struct TxRepeat* pending, uint32_t capcode, size_t emr_bytes) {
+    TxRepeatFrame header = { capcode, (uint16_t)(current_tx_total_length - emr_bytes) };
+    size_t grown_length = pending->frames_length + sizeof(header) + header.length;
+    uint32_t caps = psramFound() ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : MALLOC_CAP_8BIT;
+    uint8_t* frames = (uint8_t*)heap_caps_realloc(pending->frames, grown_length, caps);
+    if (frames == nullptr) {
+        free(pending->frames);
+        pending->frames = nullptr;
+        pending->frames_length = 0;
+        return false;
     }
 
-    if (device_state == STATE_WAITING_FOR_MSG) {
-        at_handle_flex_message();
+    memcpy(frames + pending->frames_length, &header, sizeof(header));
+    memcpy(frames + pending->frames_length + sizeof(header), tx_data_buffer + emr_bytes, header.length);
+    pending->frames = frames;
+    pending->frames_length = grown_length;
+    pending->frame_count++;
+    return true;
+}
+
+// Moves the frames built for msg into a free repeat slot, due msg->repeat_interval_s from now
+static void tx_repeat_schedule(struct TxRepeat* pending, const struct QueuedMessage* msg) {
+    TxRepeat* slot = nullptr;
+    for (int i = 0; pending->frames != nullptr && i < TX_REPEAT_SLOTS; i++) {
+        if (tx_repeats[i].frames == nullptr) {
+            slot = &tx_repeats[i];
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        free(pending->frames);
+        tx_metrics.repeats_skipped += msg->repeat;
+        logMessagef("FLEX: No room to hold repeats for %s, %u copies dropped",
+                    queue_message_id(msg), (unsigned)msg->repeat);
         return;
     }
 
-    while (Serial.available()) {
-        char c = Serial.read();
+    *slot = *pending;
+    slot->remaining = msg->repeat;
+    slot->sent = 1;
+    slot->source = msg->source;
+    slot->power = msg->power;
+    slot->interval_s = msg->repeat_interval_s;
+    slot->capcode = msg->capcode;
+    slot->frequency = msg->frequency;
+    slot->seq = msg->seq;
+    slot->due_ms = millis() + (uint32_t)msg->repeat_interval_s * 1000UL;
+    strlcpy(slot->message_id, queue_message_id(msg), sizeof(slot->message_id));
+}
 
-        if (at_buffer_pos >= AT_BUFFER_SIZE - 1) {
-            at_buffer_pos = 0;
-            at_send_error();
+static void tx_repeat_release(struct TxRepeat* slot) {
+    free(slot->frames);
+    slot->frames = nullptr;
+}
+
+// Earliest repeat that is due now, or nullptr; a copy already on air is not due. *next_due_ms
+// receives the time until the next pending one (UINT32_MAX if none) so the task can sleep no
+// longer than that.
+static struct TxRepeat* tx_repeat_next_due(uint32_t* next_due_ms) {
+    uint32_t now = millis();
+    TxRepeat* due = nullptr;
+    *next_due_ms = UINT32_MAX;
+
+    for (int i = 0; i < TX_REPEAT_SLOTS; i++) {
+        TxRepeat* slot = &tx_repeats[i];
+        if (slot->frames == nullptr || slot->copy_pending != 0) {
             continue;
         }
+        int32_t until_ms = (int32_t)(slot->due_ms - now);
+        if (until_ms <= 0) {
+            if (due == nullptr || (int32_t)(slot->due_ms - due->due_ms) < 0) {
+                due = slot;
+            }
+        } else {
+            *next_due_ms = min(*next_due_ms, (uint32_t)until_ms);
+        }
+    }
+    return due;
+}
 
-        at_buffer[at_buffer_pos++] = c;
+// Stored frame index of a repeat copy; *header receives its capcode and length
+static const uint8_t* tx_repeat_frame(const struct TxRepeat* slot, uint8_t index, struct TxRepeatFrame* header) {
+    size_t offset = 0;
+    for (uint8_t i = 0; i < index; i++) {
+        memcpy(header, slot->frames + offset, sizeof(*header));
+        offset += sizeof(*header) + header->length;
+    }
+    memcpy(header, slot->frames + offset, sizeof(*header));
+    return slot->frames + offset + sizeof(*header);
+}
 
-        if (c == '\n' || (c == '\r' && at_buffer_pos > 1)) {
-            at_buffer[at_buffer_pos] = '\0';
-            at_command_ready = true;
-            break;
+// Puts one frame of a repeat copy on air from its stored frames (one per group member). A copy
+// goes through the airtime budget like any page when its first frame is picked, charged for
+// every member frame, but reserves nothing up front; an over-budget copy is dropped, not delayed.
+// Returns false when the frame's FLEX frame moved on and it has to be picked again.
+static bool tx_repeat_send_frame(struct TxSession* session, struct TxRepeat* slot, uint8_t index) {
+    if (slot->copy_pending == 0) {
+        slot->remaining--;
+        slot->due_ms = millis() + (uint32_t)slot->interval_s * 1000UL;
+
+        uint32_t retry_after_s = 0;
+        if (!airtime_admit(slot->frequency, slot->frame_count, &retry_after_s)) {
+            tx_metrics.repeats_skipped++;
+            logMessagef("FLEX: Repeat %u of %s skipped (airtime budget)", (unsigned)slot->sent, slot->message_id);
+            if (slot->remaining == 0) {
+                tx_repeat_release(slot);
+            }
+            return true;
         }
+        slot->copy_pending = (1UL << slot->frame_count) - 1;
+        slot->copy_airtime_ms = 0;
     }
 
-    if (at_command_ready) {
-        if (!at_parse_command(at_buffer)) {
-            at_send_error();
+    TxRepeatFrame header;
+    const uint8_t* frame = tx_repeat_frame(slot, index, &header);
+    if (tx_select_channel(session, slot->frequency, slot->power)) {
+        memcpy(tx_data_buffer, frame, header.length);
+        current_tx_total_length = header.length;
+        current_tx_capcode = header.capcode;
+        if (tx_frame_aligning() && !tx_frame_hold(session, header.capcode)) {
+            return false;
+        }
+        tx_prepare_keyup(session);
+
+        size_t emr_bytes = 0;
+        unsigned long tx_start_ms = 0;
+        if (tx_send_buffer(session, &emr_bytes, &tx_start_ms)) {
+            slot->copy_airtime_ms += tx_metrics.last_airtime_ms;
+            airtime_record_transmission(slot->frequency, slot->source, (uint32_t)(current_tx_total_length * 8 / TX_BITRATE),
+                                        tx_metrics.last_airtime_ms, 0);
         }
-
-        at_buffer_pos = 0;
-        at_command_ready = false;
     }
-}
+    slot->copy_pending &= ~(1UL << index);
+    if (slot->copy_pending != 0) {
+        return true;
+    }
 
+    if (slot->copy_airtime_ms > 0) {
+        tx_metrics.repeats_sent++;
+        delivery_event(slot->seq, slot->message_id, slot->source, DELIVERY_REPEATED, slot->copy_airtime_ms);
+        logMessagef("FLEX: Repeat %u of %s sent (capcodes=%u, freq=%.4f MHz, airtime=%lu ms)",
+                    (unsigned)slot->sent, slot->message_id, (unsigned)slot->frame_count, slot->frequency,
+                    (unsigned long)slot->copy_airtime_ms);
+        slot->sent++;
+    } else {
+        tx_metrics.repeats_skipped++;
+        logMessagef("FLEX: Repeat %u of %s skipped (channel switch or transmit failed)", (unsigned)slot->sent, slot->message_id);
+    }
 
-void panic() {
-    display_panic();
-    Serial.print("ERROR\r\n");
-    while (true) {
-        delay(100000);
+    if (slot->remaining == 0) {
+        tx_repeat_release(slot);
     }
+    return true;
 }
 
-
-#if defined(ESP8266) || defined(ESP32)
-  ICACHE_RAM_ATTR
-#endif
-void on_interrupt_fifo_has_space() {
-    fifo_empty = true;
+// Sets page up to go out member by member; nothing is reported until a member is keyed up
+static void tx_page_init(struct TxPage* page, struct QueuedMessage* msg) {
+    memset(page, 0, sizeof(*page));
+    page->msg = msg;
+    page->pending = (1UL << queue_message_capcode_count(msg)) - 1;
+    page->repeat_ok = (msg->repeat > 0);
 }
 
-void transmission_task(void* parameter);
-void init_transmission_core();
+// Adds the page's other pending members that listen in capcode's FLEX frame (any member without
+// frame alignment) to the frame in tx_data_buffer, up to what its idle words hold. Returns the
+// member bits now addressed by the frame besides capcode's own.
+static uint32_t tx_page_share_frame(const struct TxSession* session, const struct TxPage* page, uint32_t capcode,
+                                    uint32_t member) {
+    QueuedMessage* msg = page->msg;
+    uint32_t shared[PAGER_GROUP_MEMBERS_MAX];
+    uint8_t shared_index[PAGER_GROUP_MEMBERS_MAX];
+    int shared_count = 0;
+
+    bool aligning = tx_frame_aligning();
+    uint32_t lead_ms = aligning ? tx_keyup_lead_ms(session) : 0;
+    uint8_t cycle = 0;
+    uint8_t frame = 0;
+    if (aligning) {
+        flex_frame_wait_ms(capcode, lead_ms, &cycle, &frame);
+    }
+
+    for (uint8_t i = 0; i < queue_message_capcode_count(msg) && shared_count < PAGER_GROUP_MEMBERS_MAX; i++) {
+        uint32_t other = queue_message_capcode(msg, i);
+        if ((page->pending & ~member & (1UL << i)) == 0 || other > FLEX_SHORT_CAPCODE_MAX) {
+            continue;
+        }
+        if (aligning) {
+            uint8_t other_cycle = 0;
+            uint8_t other_frame = 0;
+            flex_frame_wait_ms(other, lead_ms, &other_cycle, &other_frame);
+            if (other_cycle != cycle || other_frame != frame) {
+                continue;
+            }
+        }
+        shared[shared_count] = other;
+        shared_index[shared_count++] = i;
+    }
 
-bool queue_is_empty() {
-    return queue_count == 0;
+    int added = flex_frame_add_addresses(tx_data_buffer, current_tx_total_length, shared, shared_count);
+    uint32_t members = 0;
+    for (int i = 0; i < added; i++) {
+        members |= 1UL << shared_index[i];
+    }
+    return members;
 }
 
-bool queue_is_full() {
-    return queue_count >= MAX_QUEUE_SIZE;
-}
+// Encodes and sends one member of page, together with the members sharing its frame. A channel
+// that cannot be selected before anything went out fails the whole page, as for a single
+// capcode. Returns false when the member's FLEX frame moved on while encoding and it has to be
+// picked again.
+static bool tx_page_send_member(struct TxSession* session, struct TxPage* page, uint8_t index) {
+    QueuedMessage* msg = page->msg;
+    uint32_t capcode = queue_message_capcode(msg, index);
+    uint32_t member = 1UL << index;
+    core0_last_heartbeat = millis();
+
+    if (!tx_select_channel(session, msg->frequency, msg->power)) {
+        page->pending = page->started ? (page->pending & ~member) : 0;
+        return true;
+    }
 
-bool queue_add_message(uint32_t capcode, float frequency, int power, bool mail_drop, const char* message) {
+    uint32_t encode_start_us = micros();
+    bool encoded = flex_encode_and_store(capcode, msg->message, msg->mail_drop);
+    metrics_observe(&metric_encode, micros() - encode_start_us);
+    if (!encoded) {
+        logMessagef("FLEX: Encoding failed for capcode %lu of %s", (unsigned long)capcode, queue_message_id(msg));
+        page->pending &= ~member;
+        return true;
+    }
 
-    portENTER_CRITICAL(&queue_mux);
+    if (msg->group_count > 0) {
+        member |= tx_page_share_frame(session, page, capcode, member);
+    }
+    uint8_t addresses = (uint8_t)__builtin_popcount(member);
 
-    if (queue_count >= MAX_QUEUE_SIZE) {
-        portEXIT_CRITICAL(&queue_mux);
+    current_tx_capcode = capcode;
+    if (tx_frame_aligning() && !tx_frame_hold(session, capcode)) {
         return false;
     }
+    page->pending &= ~member;
 
-    QueuedMessage* msg = &message_queue[queue_tail];
-    msg->capcode = capcode;
-    msg->frequency = frequency;
-    msg->power = power;
-    msg->mail_drop = mail_drop;
-
-    String converted_message = convert_unicode_to_ascii(String(message));
-    converted_message = truncate_message_with_ellipsis(converted_message);
-    strncpy(msg->message, converted_message.c_str(), MAX_FLEX_MESSAGE_LENGTH);
-    msg->message[MAX_FLEX_MESSAGE_LENGTH] = '\0';
-
-    queue_tail = (queue_tail + 1) % MAX_QUEUE_SIZE;
-    queue_count++;
+    if (!page->started) {
+        // A group page counts as one message however many frames it takes
+        page->started = true;
+        page->dequeue_ms = millis();
+        metrics_observe(&metric_queue_wait, page->dequeue_ms - msg->enqueued_ms);
+        delivery_event(msg->seq, queue_message_id(msg), msg->source, DELIVERY_TRANSMITTING, 0);
+    }
+    tx_prepare_keyup(session);
 
-    portEXIT_CRITICAL(&queue_mux);
+    size_t emr_bytes = 0;
+    unsigned long tx_start_ms = 0;
+    if (!tx_send_buffer(session, &emr_bytes, &tx_start_ms)) {
+        logMessagef("FLEX: Transmit failed for capcode %lu of %s (status %d)", (unsigned long)capcode,
+                    queue_message_id(msg), radio_start_transmit_status);
+        return true;
+    }
 
-    if (tx_task_handle != NULL) {
-        xTaskNotifyGive(tx_task_handle);
+    if (page->sent == 0) {
+        tx_metrics.last_setup_ms = tx_start_ms - page->dequeue_ms;
+    }
+    page->sent++;
+    page->addressed += addresses;
+    page->airtime_ms += tx_metrics.last_airtime_ms;
+    // The whole group's reservation settles against the first member sent
+    airtime_record_transmission(msg->frequency, msg->source, (uint32_t)(current_tx_total_length * 8 / TX_BITRATE),
+                                tx_metrics.last_airtime_ms, (page->sent == 1) ? msg->airtime_reserved_ms : 0);
+    if (page->repeat_ok) {
+        page->repeat_ok = tx_repeat_append(&page->repeat, capcode, emr_bytes);
     }
 
+    logMessagef("FLEX: Message sent successfully (capcode=%lu, addresses=%u, freq=%.4f MHz, power=%.1f dBm, airtime=%lu ms, emr=%lu ms, repeat=%u)",
+                (unsigned long)capcode, (unsigned)addresses, current_tx_frequency, tx_power,
+                (unsigned long)tx_metrics.last_airtime_ms, (unsigned long)tx_metrics.last_emr_ms,
+                (unsigned)msg->repeat);
     return true;
 }
 
-struct QueuedMessage* queue_get_next_message() {
-    portENTER_CRITICAL(&queue_mux);
-    if (queue_count == 0) {
-        portEXIT_CRITICAL(&queue_mux);
-        return nullptr;
-    }
-    QueuedMessage* msg = &message_queue[queue_head];
-    portEXIT_CRITICAL(&queue_mux);
-    return msg;
-}
+// Settles a page once every member has been tried and takes it off the queue
+static void tx_page_finish(struct TxPage* page) {
+    QueuedMessage* msg = page->msg;
+    uint8_t capcode_count = queue_message_capcode_count(msg);
 
-void queue_remove_message() {
-    portENTER_CRITICAL(&queue_mux);
-    if (queue_count > 0) {
-        queue_head = (queue_head + 1) % MAX_QUEUE_SIZE;
-        queue_count--;
+    if (page->sent == 0) {
+        free(page->repeat.frames);
+        airtime_refund(msg->frequency, msg->airtime_reserved_ms);
+        dedup_release(msg->dedup_key, false);
+        delivery_event(msg->seq, queue_message_id(msg), msg->source, DELIVERY_FAILED, 0);
+    } else {
+        tx_metrics.transmissions++;
+        if (msg->group_count > 0) {
+            tx_metrics.group_pages++;
+            logMessagef("FLEX: Group page %s sent to %u of %u capcodes in %u frame(s) (airtime=%lu ms)",
+                        queue_message_id(msg), (unsigned)page->addressed, (unsigned)capcode_count,
+                        (unsigned)page->sent, (unsigned long)page->airtime_ms);
+        }
+
+        dedup_release(msg->dedup_key, true);
+        delivery_event(msg->seq, queue_message_id(msg), msg->source, DELIVERY_TRANSMITTED, page->airtime_ms);
+        if (msg->repeat > 0) {
+            if (page->repeat_ok) {
+                tx_repeat_schedule(&page->repeat, msg);
+            } else {
+                tx_metrics.repeats_skipped += msg->repeat;
+                logMessagef("FLEX: No memory to hold repeats for %s, %u copies dropped",
+                            queue_message_id(msg), (unsigned)msg->repeat);
+            }
+        }
     }
-    portEXIT_CRITICAL(&queue_mux);
+
+    queue_take_message(msg);
+    page->msg = nullptr;
 }
 
-void queue_process_next() {
-    if (queue_is_empty() || (device_state != STATE_IDLE && device_state != STATE_IMAP_PROCESSING)) {
+// Weighs one candidate frame: without alignment (lead_ms 0) the first one offered wins, with it
+// the one whose FLEX frame comes first (a tie keeps the earlier offer)
+static void tx_pick_offer(struct TxPick* best, uint32_t lead_ms, struct TxRepeat* repeat,
+                          struct QueuedMessage* msg, uint8_t index, uint32_t capcode) {
+    bool empty = (best->repeat == nullptr && best->msg == nullptr);
+    if (!empty && lead_ms == 0) {
         return;
     }
 
-    QueuedMessage* msg = queue_get_next_message();
-    if (msg == nullptr) {
-        return;
+    uint32_t wait_ms = 0;
+    if (lead_ms > 0) {
+        uint8_t cycle = 0;
+        uint8_t frame = 0;
+        wait_ms = flex_frame_wait_ms(capcode, lead_ms, &cycle, &frame);
+    }
+    if (empty || wait_ms < best->wait_ms) {
+        best->repeat = repeat;
+        best->msg = msg;
+        best->index = index;
+        best->capcode = capcode;
+        best->wait_ms = wait_ms;
     }
+}
 
-    if (abs(msg->frequency - current_tx_frequency) > 0.0001) {
-        int state = radio.setFrequency(apply_frequency_correction(msg->frequency));
-        if (state != RADIOLIB_ERR_NONE) {
-            queue_remove_message();
-            return;
+static void tx_pick_offer_repeat(struct TxPick* best, uint32_t lead_ms, struct TxRepeat* slot, uint32_t frames) {
+    for (uint8_t i = 0; i < slot->frame_count; i++) {
+        if (frames & (1UL << i)) {
+            TxRepeatFrame header;
+            tx_repeat_frame(slot, i, &header);
+            tx_pick_offer(best, lead_ms, slot, nullptr, i, header.capcode);
         }
-        current_tx_frequency = msg->frequency;
     }
+}
 
-    if (abs(msg->power - tx_power) > 0.1) {
-        int state = radio.setOutputPower(msg->power);
-        if (state != RADIOLIB_ERR_NONE) {
-            queue_remove_message();
-            return;
+// Chooses the next frame to send. Copies and group pages already on air come first, then due
+// repeats, then queued pages in order. With frame alignment every member of the first
+// FLEX_LOOKAHEAD_PAGES pages is weighed and the one whose frame comes first wins, so a page
+// waiting for a later frame does not hold back the pages behind it. Only one group page is on
+// air at a time. Returns false when there is nothing to send.
+static bool tx_pick_next(struct TxSession* session, struct TxPick* pick) {
+    memset(pick, 0, sizeof(*pick));
+    uint32_t lead_ms = tx_frame_aligning() ? tx_keyup_lead_ms(session) : 0;
+
+    for (int i = 0; i < TX_REPEAT_SLOTS; i++) {
+        if (tx_repeats[i].frames != nullptr && tx_repeats[i].copy_pending != 0) {
+            tx_pick_offer_repeat(pick, lead_ms, &tx_repeats[i], tx_repeats[i].copy_pending);
         }
-        tx_power = msg->power;
     }
 
-    feed_watchdog();
+    TxPage* page = &session->page;
+    for (uint8_t i = 0; page->msg != nullptr && i < queue_message_capcode_count(page->msg); i++) {
+        if (page->pending & (1UL << i)) {
+            tx_pick_offer(pick, lead_ms, nullptr, page->msg, i, queue_message_capcode(page->msg, i));
+        }
+    }
 
-    if (!flex_encode_and_store(msg->capcode, msg->message, msg->mail_drop)) {
-        queue_remove_message();
-        return;
+    uint32_t repeat_due_ms;
+    TxRepeat* due = tx_repeat_next_due(&repeat_due_ms);
+    if (due != nullptr) {
+        tx_pick_offer_repeat(pick, lead_ms, due, (1UL << due->frame_count) - 1);
+        for (int i = 0; i < TX_REPEAT_SLOTS; i++) {
+            TxRepeat* slot = &tx_repeats[i];
+            if (slot != due && slot->frames != nullptr && slot->copy_pending == 0 && (int32_t)(slot->due_ms - millis()) <= 0) {
+                tx_pick_offer_repeat(pick, lead_ms, slot, (1UL << slot->frame_count) - 1);
+            }
+        }
     }
 
-    current_tx_capcode = msg->capcode;
-    device_state = STATE_TRANSMITTING;
-    LED_ON();
+    QueuedMessage* msg = queue_next_message_after(nullptr);
+    for (int n = 0; msg != nullptr && n < FLEX_LOOKAHEAD_PAGES; msg = queue_next_message_after(msg), n++) {
+        if (lead_ms == 0 && (pick->repeat != nullptr || pick->msg != nullptr)) {
+            break;
+        }
+        uint8_t capcode_count = queue_message_capcode_count(msg);
+        if (msg == page->msg || (capcode_count > 1 && page->msg != nullptr)) {
+            continue;
+        }
+        for (uint8_t i = 0; i < capcode_count; i++) {
+            tx_pick_offer(pick, lead_ms, nullptr, msg, i, queue_message_capcode(msg, i));
+        }
+    }
 
-    send_emr_if_needed();
+    return pick->repeat != nullptr || pick->msg != nullptr;
+}
 
-    int radio_start_transmit_status = radio.startTransmit(tx_data_buffer, current_tx_total_length);
-    if (radio_start_transmit_status != RADIOLIB_ERR_NONE) {
-        device_state = STATE_IDLE;
-        LED_OFF();
-        display_status();
-    } else {
-        display_status();
+// Notes whether more traffic is waiting after a transmission on sent_frequency and powers the
+// amplifier down before a channel change, keeping it hot otherwise
+static void tx_look_ahead(struct TxSession* session, float sent_frequency) {
+    TxPick next;
+    session->last_tx_pending_next = tx_pick_next(session, &next);
+    if (!session->last_tx_pending_next) {
+        return;
     }
 
-    queue_remove_message();
+    float next_frequency = (next.repeat != nullptr) ? next.repeat->frequency : next.msg->frequency;
+    if (session->rf_amp_hot && fabs(next_frequency - sent_frequency) > 0.0001) {
+        rf_amplifier_power(false);
+        session->rf_amp_hot = false;
+    }
 }
 
 void transmission_task(void* parameter) {
+    // The RF amplifier stays powered while the next frame to send is on the same channel, and for
+    // rf_amplifier_hold_ms after the queue drains; the radio itself always returns to standby.
+    // Due repeat copies go ahead of queued pages, so a busy queue cannot starve them. With frame
+    // alignment a hold for a later frame is spent in the notify wait, not in front of the queue.
+    TxSession session = {};
+    bool stack_warned = false;
+
     while (true) {
         core0_last_heartbeat = millis();
 
-        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5000));
+        if (!stack_warned && uxTaskGetStackHighWaterMark(NULL) < TX_TASK_STACK_LOW_WATER) {
+            logMessagef("TX: Stack high water down to %u of %u bytes free",
+                        (unsigned)uxTaskGetStackHighWaterMark(NULL), (unsigned)TX_TASK_STACK_SIZE);
+            stack_warned = true;
+        }
+
+        uint32_t repeat_due_ms;
+        tx_repeat_next_due(&repeat_due_ms);
+        uint32_t wait_ms = min((uint32_t)5000, repeat_due_ms);
+        if (session.hold_ms > 0) {
+            wait_ms = min(wait_ms, session.hold_ms);
+        }
+        if (session.rf_amp_hot) {
+            uint32_t idle_ms = millis() - session.last_tx_end_ms;
+            wait_ms = (idle_ms < settings.rf_amplifier_hold_ms) ? min((uint32_t)settings.rf_amplifier_hold_ms - idle_ms, wait_ms) : 0;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms));
+
+        if (session.rf_amp_hot && (queue_is_empty() || session.hold_ms > 0) &&
+            millis() - session.last_tx_end_ms >= settings.rf_amplifier_hold_ms) {
+            rf_amplifier_power(false);
+            session.rf_amp_hot = false;
+        }
 
+        session.hold_ms = 0;
         while (true) {
-            QueuedMessage* msg = queue_get_next_message();
-            if (msg == nullptr) {
+            TxPick pick;
+            if (!tx_pick_next(&session, &pick)) {
                 break;
             }
-
-            if (abs(msg->frequency - current_tx_frequency) > 0.0001) {
-                int state = radio.setFrequency(apply_frequency_correction(msg->frequency));
-                if (state != RADIOLIB_ERR_NONE) {
-                    queue_remove_message();
-                    continue;
-                }
-                current_tx_frequency = msg->frequency;
+            if (pick.wait_ms > FLEX_HOLD_INLINE_MS) {
+                tx_hold(&session, pick.wait_ms);
+                break;
             }
 
-            if (abs(msg->power - tx_power) > 0.1) {
-                int state = radio.setOutputPower(msg->power);
-                if (state != RADIOLIB_ERR_NONE) {
-                    queue_remove_message();
-                    continue;
+            float sent_frequency;
+            bool sent;
+            if (pick.repeat != nullptr) {
+                sent_frequency = pick.repeat->frequency;
+                sent = tx_repeat_send_frame(&session, pick.repeat, pick.index);
+            } else {
+                // A single capcode page is sent and settled in one go; a group page is kept in the session
+                TxPage single;
+                TxPage* page = (queue_message_capcode_count(pick.msg) > 1) ? &session.page : &single;
+                if (page != &session.page || page->msg != pick.msg) {
+                    tx_page_init(page, pick.msg);
                 }
-                tx_power = msg->power;
-            }
-
-            if (!flex_encode_and_store(msg->capcode, msg->message, msg->mail_drop)) {
-                queue_remove_message();
-                continue;
-            }
-
-            current_tx_capcode = msg->capcode;
-
-            if (settings.enable_rf_amplifier) {
-                int actual_rfamp_pin = (settings.rf_amplifier_power_pin == 0) ? RFAMP_PWR_PIN : settings.rf_amplifier_power_pin;
-                digitalWrite(actual_rfamp_pin, settings.rf_amplifier_active_high ? HIGH : LOW);
-                delay(settings.rf_amplifier_delay_ms);
-            }
-
-            device_state = STATE_TRANSMITTING;
-            LED_ON();
-
-            display_update_requested = true;
-
-            send_emr_if_needed();
-
-            fifo_empty = true;
-            current_tx_remaining_length = current_tx_total_length;
-            radio_start_transmit_status = radio.startTransmit(tx_data_buffer, current_tx_total_length);
-
-            if (radio_start_transmit_status != RADIOLIB_ERR_NONE) {
-                device_state = STATE_IDLE;
-                LED_OFF();
-                display_update_requested = true;
-                queue_remove_message();
-                continue;
-            }
-
-            display_update_requested = true;
-
-            bool transmission_complete = false;
-            while (!transmission_complete) {
-                if (fifo_empty && current_tx_remaining_length > 0) {
-                    fifo_empty = false;
-                    transmission_complete = radio.fifoAdd(tx_data_buffer, current_tx_total_length, &current_tx_remaining_length);
+                sent_frequency = pick.msg->frequency;
+                sent = tx_page_send_member(&session, page, pick.index);
+                if (page->pending == 0) {
+                    tx_page_finish(page);
                 }
-                delay(1);
-            }
-
-            if (radio_start_transmit_status == RADIOLIB_ERR_NONE) {
-                logMessagef("FLEX: Message sent successfully (capcode=%llu, freq=%.4f MHz, power=%.1f dBm)",
-                          current_tx_capcode, current_tx_frequency, tx_power);
             }
-
-            radio.standby();
-
-            device_state = STATE_IDLE;
-            LED_OFF();
-
-            if (settings.enable_rf_amplifier) {
-                int actual_rfamp_pin = (settings.rf_amplifier_power_pin == 0) ? RFAMP_PWR_PIN : settings.rf_amplifier_power_pin;
-                digitalWrite(actual_rfamp_pin, settings.rf_amplifier_active_high ? LOW : HIGH);
+            if (!sent) {
+                break;
             }
 
+            tx_look_ahead(&session, sent_frequency);
             display_update_requested = true;
-
-            queue_remove_message();
         }
     }
 }
@@ -11229,7 +15995,7 @@ void init_transmission_core() {
     xTaskCreatePinnedToCore(
         transmission_task,
         "TX_Core0",
-        4096,
+        TX_TASK_STACK_SIZE,
         NULL,
         configMAX_PRIORITIES - 1,
         &tx_task_handle,
@@ -11297,6 +16063,9 @@ void check_transmission_task_health() {
 
 void setup() {
     Serial.begin(SERIAL_BAUD);
+    loop_task_handle = xTaskGetCurrentTaskHandle();
+    service_lock = xSemaphoreCreateRecursiveMutex();
+    log_lock = xSemaphoreCreateRecursiveMutex();
 
     SPI.begin(LORA_SCK_PIN, LORA_MISO_PIN, LORA_MOSI_PIN, LORA_CS_PIN);
 
@@ -11345,6 +16114,8 @@ void setup() {
     append_to_log_file("SYSTEM: Core config loaded");
     load_runtime_settings();
     append_to_log_file("SYSTEM: Runtime settings loaded");
+    log_store_init();
+    init_syslog_task();
 
     chatgpt_load_config();
 
@@ -11417,6 +16188,17 @@ void setup() {
         panic();
     }
 
+    radio_profile_capture(current_tx_frequency, (int8_t)tx_power);
+
+    if (!queue_init()) {
+        panic();
+    }
+
+#if QUEUE_JOURNAL_ENABLED
+    journal_replay();
+#endif
+    mqtt_outbox_restore();
+
     at_reset_state();
 
     reset_oled_timeout();
@@ -11424,81 +16206,98 @@ void setup() {
     WiFi.mode(WIFI_STA);
     network_boot();
 
-    webServer.on("/", handle_root);
-        webServer.on("/send", HTTP_POST, handle_send_message);
-        webServer.on("/config", handle_configuration);
-        webServer.on("/save_config", HTTP_POST, handle_save_config);
-        webServer.on("/flex", handle_flex_config);
-        webServer.on("/save_flex", HTTP_POST, handle_save_flex);
-        webServer.on("/mqtt", handle_mqtt);
-        webServer.on("/save_mqtt", HTTP_POST, handle_save_mqtt);
-        webServer.on("/imap", handle_imap_config);
-        webServer.on("/imap_toggle", HTTP_POST, handle_imap_toggle);
-        webServer.on("/imap_add", HTTP_POST, handle_imap_add);
-        webServer.on("/imap_edit/0", handle_imap_edit);
-        webServer.on("/imap_edit/1", handle_imap_edit);
-        webServer.on("/imap_edit/2", handle_imap_edit);
-        webServer.on("/imap_edit/3", handle_imap_edit);
-        webServer.on("/imap_edit/4", handle_imap_edit);
-        webServer.on("/imap_delete/0", HTTP_POST, handle_imap_delete);
-        webServer.on("/imap_delete/1", HTTP_POST, handle_imap_delete);
-        webServer.on("/imap_delete/2", HTTP_POST, handle_imap_delete);
-        webServer.on("/imap_delete/3", HTTP_POST, handle_imap_delete);
-        webServer.on("/imap_delete/4", HTTP_POST, handle_imap_delete);
-        webServer.on("/imap_account_data/0", handle_imap_account_data);
-        webServer.on("/imap_account_data/1", handle_imap_account_data);
-        webServer.on("/imap_account_data/2", handle_imap_account_data);
-        webServer.on("/imap_account_data/3", handle_imap_account_data);
-        webServer.on("/imap_account_data/4", handle_imap_account_data);
-        webServer.on("/imap_update/0", HTTP_POST, handle_imap_update);
-        webServer.on("/imap_update/1", HTTP_POST, handle_imap_update);
-        webServer.on("/imap_update/2", HTTP_POST, handle_imap_update);
-        webServer.on("/imap_update/3", HTTP_POST, handle_imap_update);
-        webServer.on("/imap_update/4", HTTP_POST, handle_imap_update);
-        webServer.on("/upload_certificate", HTTP_POST, handle_upload_certificate, handle_file_upload);
-        webServer.on("/status", handle_device_status);
+    web_lane.timing = new WebTimingHandler();
+    webServer.addHandler(web_lane.timing);
+    web_route("/", handle_root);
+        web_route("/send", HTTP_POST, handle_send_message);
+        web_route("/config", handle_configuration);
+        web_route("/save_config", HTTP_POST, handle_save_config);
+        web_route("/flex", handle_flex_config);
+        web_route("/save_flex", HTTP_POST, handle_save_flex);
+        web_route("/mqtt", handle_mqtt);
+        web_route("/save_mqtt", HTTP_POST, handle_save_mqtt);
+        web_route("/imap", handle_imap_config);
+        web_route("/imap_toggle", HTTP_POST, handle_imap_toggle);
+        web_route("/imap_add", HTTP_POST, handle_imap_add);
+        web_route("/imap_edit/0", handle_imap_edit);
+        web_route("/imap_edit/1", handle_imap_edit);
+        web_route("/imap_edit/2", handle_imap_edit);
+        web_route("/imap_edit/3", handle_imap_edit);
+        web_route("/imap_edit/4", handle_imap_edit);
+        web_route("/imap_delete/0", HTTP_POST, handle_imap_delete);
+        web_route("/imap_delete/1", HTTP_POST, handle_imap_delete);
+        web_route("/imap_delete/2", HTTP_POST, handle_imap_delete);
+        web_route("/imap_delete/3", HTTP_POST, handle_imap_delete);
+        web_route("/imap_delete/4", HTTP_POST, handle_imap_delete);
+        web_route("/imap_account_data/0", handle_imap_account_data);
+        web_route("/imap_account_data/1", handle_imap_account_data);
+        web_route("/imap_account_data/2", handle_imap_account_data);
+        web_route("/imap_account_data/3", handle_imap_account_data);
+        web_route("/imap_account_data/4", handle_imap_account_data);
+        web_route("/imap_update/0", HTTP_POST, handle_imap_update);
+        web_route("/imap_update/1", HTTP_POST, handle_imap_update);
+        web_route("/imap_update/2", HTTP_POST, handle_imap_update);
+        web_route("/imap_update/3", HTTP_POST, handle_imap_update);
+        web_route("/imap_update/4", HTTP_POST, handle_imap_update);
+        web_route("/upload_certificate", HTTP_POST, handle_upload_certificate, handle_file_upload);
+        web_route("/status", handle_device_status);
+        web_route("/metrics", HTTP_GET, handle_metrics);
+        web_route("/factory_reset", HTTP_POST, handle_web_factory_reset);
+        web_route("/backup_settings", handle_backup_settings);
+        web_route("/restore_settings", handle_restore_settings);
+        web_route("/upload_restore", HTTP_POST, handle_upload_restore, handle_upload_restore);
+
+        ingest_routes(webServer);
         webServer.on("/logs", handle_logs);
         webServer.on("/download_logs", handle_download_logs);
-        webServer.on("/factory_reset", HTTP_POST, handle_web_factory_reset);
-        webServer.on("/backup_settings", handle_backup_settings);
-        webServer.on("/restore_settings", handle_restore_settings);
-        webServer.on("/upload_restore", HTTP_POST, handle_upload_restore, handle_upload_restore);
-
-        webServer.on("/api", HTTP_POST, handle_api_message);
-        webServer.on("/api/v1/alerts", HTTP_POST, handle_grafana_webhook);
-        webServer.on("/api/wifi/scan", HTTP_GET, handle_api_wifi_scan);
-        webServer.on("/api/wifi/delete", HTTP_POST, handle_api_wifi_delete);
-        webServer.on("/api/wifi/add", HTTP_POST, handle_api_wifi_add);
-        webServer.on("/api_config", handle_api_config);
-        webServer.on("/grafana", handle_grafana);
-        webServer.on("/save_api", HTTP_POST, handle_save_api);
-        webServer.on("/grafana_toggle", HTTP_POST, handle_grafana_toggle);
-
-        webServer.on("/chatgpt", handle_chatgpt);
-        webServer.on("/chatgpt/config", HTTP_POST, handle_chatgpt_config);
-        webServer.on("/chatgpt/notifications", HTTP_POST, handle_chatgpt_notifications);
-        webServer.on("/chatgpt/api_key", HTTP_POST, handle_chatgpt_api_key);
-        webServer.on("/chatgpt/add_prompt", HTTP_POST, handle_chatgpt_add_prompt);
-        webServer.on("/chatgpt/get_prompt/0", handle_chatgpt_get_prompt);
-        webServer.on("/chatgpt/get_prompt/1", handle_chatgpt_get_prompt);
-        webServer.on("/chatgpt/get_prompt/2", handle_chatgpt_get_prompt);
-        webServer.on("/chatgpt/get_prompt/3", handle_chatgpt_get_prompt);
-        webServer.on("/chatgpt/get_prompt/4", handle_chatgpt_get_prompt);
-        webServer.on("/chatgpt/edit_prompt/0", HTTP_POST, handle_chatgpt_edit_prompt);
-        webServer.on("/chatgpt/edit_prompt/1", HTTP_POST, handle_chatgpt_edit_prompt);
-        webServer.on("/chatgpt/edit_prompt/2", HTTP_POST, handle_chatgpt_edit_prompt);
-        webServer.on("/chatgpt/edit_prompt/3", HTTP_POST, handle_chatgpt_edit_prompt);
-        webServer.on("/chatgpt/edit_prompt/4", HTTP_POST, handle_chatgpt_edit_prompt);
-        webServer.on("/chatgpt/toggle/0", HTTP_POST, handle_chatgpt_toggle);
-        webServer.on("/chatgpt/toggle/1", HTTP_POST, handle_chatgpt_toggle);
-        webServer.on("/chatgpt/toggle/2", HTTP_POST, handle_chatgpt_toggle);
-        webServer.on("/chatgpt/toggle/3", HTTP_POST, handle_chatgpt_toggle);
-        webServer.on("/chatgpt/toggle/4", HTTP_POST, handle_chatgpt_toggle);
-        webServer.on("/chatgpt/delete/0", handle_chatgpt_delete);
-        webServer.on("/chatgpt/delete/1", handle_chatgpt_delete);
-        webServer.on("/chatgpt/delete/2", handle_chatgpt_delete);
-        webServer.on("/chatgpt/delete/3", handle_chatgpt_delete);
-        webServer.on("/chatgpt/delete/4", handle_chatgpt_delete);
+        web_route("/api/wifi/scan", HTTP_GET, handle_api_wifi_scan);
+        web_route("/api/wifi/delete", HTTP_POST, handle_api_wifi_delete);
+        web_route("/api/wifi/add", HTTP_POST, handle_api_wifi_add);
+        web_route("/api_config", handle_api_config);
+        web_route("/grafana", handle_grafana);
+        web_route("/save_api", HTTP_POST, handle_save_api);
+        web_route("/grafana_toggle", HTTP_POST, handle_grafana_toggle);
+
+        web_route("/chatgpt", handle_chatgpt);
+        web_route("/chatgpt/config", HTTP_POST, handle_chatgpt_config);
+        web_route("/chatgpt/notifications", HTTP_POST, handle_chatgpt_notifications);
+        web_route("/chatgpt/api_key", HTTP_POST, handle_chatgpt_api_key);
+        web_route("/chatgpt/add_prompt", HTTP_POST, handle_chatgpt_add_prompt);
+        web_route("/chatgpt/get_prompt/0", handle_chatgpt_get_prompt);
+        web_route("/chatgpt/get_prompt/1", handle_chatgpt_get_prompt);
+        web_route("/chatgpt/get_prompt/2", handle_chatgpt_get_prompt);
+        web_route("/chatgpt/get_prompt/3", handle_chatgpt_get_prompt);
+        web_route("/chatgpt/get_prompt/4", handle_chatgpt_get_prompt);
+        web_route("/chatgpt/edit_prompt/0", HTTP_POST, handle_chatgpt_edit_prompt);
+        web_route("/chatgpt/edit_prompt/1", HTTP_POST, handle_chatgpt_edit_prompt);
+        web_route("/chatgpt/edit_prompt/2", HTTP_POST, handle_chatgpt_edit_prompt);
+        web_route("/chatgpt/edit_prompt/3", HTTP_POST, handle_chatgpt_edit_prompt);
+        web_route("/chatgpt/edit_prompt/4", HTTP_POST, handle_chatgpt_edit_prompt);
+        web_route("/chatgpt/toggle/0", HTTP_POST, handle_chatgpt_toggle);
+        web_route("/chatgpt/toggle/1", HTTP_POST, handle_chatgpt_toggle);
+        web_route("/chatgpt/toggle/2", HTTP_POST, handle_chatgpt_toggle);
+        web_route("/chatgpt/toggle/3", HTTP_POST, handle_chatgpt_toggle);
+        web_route("/chatgpt/toggle/4", HTTP_POST, handle_chatgpt_toggle);
+        web_route("/chatgpt/delete/0", handle_chatgpt_delete);
+        web_route("/chatgpt/delete/1", handle_chatgpt_delete);
+        web_route("/chatgpt/delete/2", handle_chatgpt_delete);
+        web_route("/chatgpt/delete/3", handle_chatgpt_delete);
+        web_route("/chatgpt/delete/4", handle_chatgpt_delete);
+        for (size_t i = 0; i < WEB_ASSET_COUNT; i++) {
+            const WebAsset* asset = &web_assets[i];
+            webServer.on(asset->path, HTTP_GET, [asset]() { handle_web_asset(*asset); });
+        }
+        const char* collected_headers[] = { "If-None-Match" };
+        webServer.collectHeaders(collected_headers, 1);
+        // The web task already sleeps between polls; skip the server's own idle delay
+        webServer.enableDelay(false);
+
+        ingest_lane.timing = new WebTimingHandler();
+        ingestServer.addHandler(ingest_lane.timing);
+        ingest_routes(ingestServer);
+        const char* ingest_headers[] = { "Authorization" };
+        ingestServer.collectHeaders(ingest_headers, 1);
+        ingestServer.enableDelay(false);
 
     // Boot failure detection
     check_boot_failure_history();
@@ -11510,8 +16309,13 @@ void setup() {
     boot_phase = BOOT_NETWORK_PENDING;
     boot_phase_start = millis();
 
+    ingest_settings_publish();      // Before the listeners accept their first request
     webServer.begin();
+    if (settings.api_ingest_port != 0) {
+        ingestServer.begin(settings.api_ingest_port);
+    }
     logMessage("STARTUP: HTTP server started on port " + String(settings.http_port));
+    init_web_task();
 
     String startup_msg = "STARTUP: FLEX Paging Message Transmitter " + String(CURRENT_VERSION);
     logMessage(startup_msg.c_str());
@@ -11535,7 +16339,8 @@ void check_low_battery_alert(int battery_pct) {
             settings.default_frequency,
             settings.default_txpower,
             false,
-            alert_msg.c_str()
+            alert_msg.c_str(),
+            TX_SOURCE_SYSTEM
         )) {
             low_battery_alert_sent = true;
             logMessage("ALERT: Low battery warning queued (" + String(battery_pct) + "%)");
@@ -11558,7 +16363,8 @@ void check_power_disconnect_alert(bool power_connected, bool charging_active) {
                 settings.default_frequency,
                 settings.default_txpower,
                 false,
-                "POWER DISCONNECTED: Battery discharging"
+                "POWER DISCONNECTED: Battery discharging",
+                TX_SOURCE_SYSTEM
             )) {
                 power_disconnect_alert_sent = true;
                 logMessage("ALERT: Power disconnect warning queued");
@@ -11575,6 +16381,12 @@ void check_power_disconnect_alert(bool power_connected, bool charging_active) {
 
 void loop() {
 
+    // Held for the whole iteration; web_route() handlers run in the gaps. Feed while waiting
+    // so a long UI request (backup, log download) cannot trip the loop watchdog.
+    while (xSemaphoreTakeRecursive(service_lock, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        feed_watchdog();
+    }
+
     unsigned long now = millis();
 
     flush_log_buffer_if_due();
@@ -11695,8 +16507,16 @@ void loop() {
 
 
     bool guard_active = transmission_guard_active();
-    if (!guard_active && (mqtt_deferred_ack_payload.length() > 0 || mqtt_deferred_status_payload.length() > 0)) {
-        mqtt_flush_deferred();
+
+#if QUEUE_JOURNAL_ENABLED
+    if (!guard_active) {
+        journal_flush_if_due();
+    }
+#endif
+    if (!guard_active) {
+        delivery_publish_pending();
+        mqtt_outbox_flush();
+        mqtt_outbox_persist_if_due();
     }
 
     if ((boot_phase >= BOOT_WATCHDOG_ACTIVE || boot_phase == BOOT_AP_COMPLETE) && !guard_active) {
@@ -11752,14 +16572,6 @@ void loop() {
         }
     }
 
-    static unsigned long last_web_handle = 0;
-    if (wifi_connected || ap_mode_active) {
-        if ((unsigned long)(millis() - last_web_handle) >= 20) {
-            webServer.handleClient();
-            last_web_handle = millis();
-        }
-    }
-
     if (boot_phase >= BOOT_MQTT_READY &&
         settings.mqtt_enabled &&
         network_available_cached &&
@@ -11873,5 +16685,7 @@ void loop() {
         check_transmission_task_health();
     }
 
+    ingest_settings_publish();
+    xSemaphoreGiveRecursive(service_lock);
     delay(1);
 }
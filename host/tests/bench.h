@@ -0,0 +1,34 @@
+/*
+ * Timing helper for the host microbenchmarks of code shared with the v3.6
+ * firmware. Host numbers compare implementations against each other; they
+ * are not ESP32 timings.
+ */
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Keeps the optimizer from dropping a result */
+static volatile uint64_t bench_sink;
+
+#define BENCH(name, iterations, body) do { \
+    uint64_t _start = bench_now_ns(); \
+    for (long _i = 0; _i < (long)(iterations); _i++) { \
+        body; \
+    } \
+    uint64_t _elapsed = bench_now_ns() - _start; \
+    printf("  %-36s %10.1f ns/op\n", name, (double)_elapsed / (double)(iterations)); \
+} while (0)
+
+#endif /* HOST_BENCH_H */
@@ -0,0 +1,131 @@
+/*
+ * Host microbenchmark of the API Authorization check: the pre-v3.6.130 path
+ * (base64 decode, split on ':', compare both fields) against the digest path
+ * in authenticate_api_request() (parse, SHA-256 of the credentials token,
+ * constant-time digest compare) and its cached path (parse, constant-time
+ * compare with the last verified token, SHA-256 only on a miss). OpenSSL
+ * stands in for the ESP32's mbedtls.
+ */
+#include "api_auth/api_auth.h"
+#include "bench.h"
+
+#include <openssl/sha.h>
+#include <string>
+
+static const char *api_username = "username";
+static const char *api_password = "password";
+
+/* Firmware base64_decode() as it was, on std::string instead of Arduino String */
+static std::string legacy_base64_decode(const std::string &input)
+{
+    const char *chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+    int val = 0, valb = -8;
+
+    for (char c : input) {
+        if (c == '=')
+            break;
+        const char *pos = strchr(chars, c);
+        if (!pos)
+            continue;
+        val = (val << 6) + (int)(pos - chars);
+        valb += 6;
+        if (valb >= 0) {
+            result += (char)((val >> valb) & 0xFF);
+            valb -= 8;
+        }
+    }
+    return result;
+}
+
+static bool legacy_check(const std::string &auth_header)
+{
+    if (auth_header.compare(0, 6, "Basic ") != 0)
+        return false;
+
+    std::string decoded = legacy_base64_decode(auth_header.substr(6));
+    size_t colon = decoded.find(':');
+    if (colon == std::string::npos)
+        return false;
+
+    std::string username = decoded.substr(0, colon);
+    std::string password = decoded.substr(colon + 1);
+    bool username_valid = username.length() == strlen(api_username);
+    bool password_valid = password.length() == strlen(api_password);
+    for (size_t i = 0; username_valid && i < username.length(); i++) {
+        if (username[i] != api_username[i])
+            username_valid = false;
+    }
+    for (size_t i = 0; password_valid && i < password.length(); i++) {
+        if (password[i] != api_password[i])
+            password_valid = false;
+    }
+    return username_valid && password_valid;
+}
+
+static uint8_t expected_digest[32];
+
+static bool digest_check(const std::string &auth_header)
+{
+    const char *credentials;
+    size_t length;
+
+    if (api_auth_parse_header(auth_header.c_str(), &credentials, &length) != API_AUTH_SCHEME_BASIC)
+        return false;
+
+    uint8_t digest[32];
+    SHA256((const unsigned char *)credentials, length, digest);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < 32; i++)
+        diff |= digest[i] ^ expected_digest[i];
+    return diff == 0;
+}
+
+static struct ApiAuthCache cache;
+
+static bool cached_check(const std::string &auth_header)
+{
+    const char *credentials;
+    size_t length;
+
+    int scheme = api_auth_parse_header(auth_header.c_str(), &credentials, &length);
+    if (scheme != API_AUTH_SCHEME_BASIC)
+        return false;
+    if (api_auth_cache_match(&cache, 1, scheme, credentials, length))
+        return true;
+
+    uint8_t digest[32];
+    SHA256((const unsigned char *)credentials, length, digest);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < 32; i++)
+        diff |= digest[i] ^ expected_digest[i];
+    if (diff != 0)
+        return false;
+    api_auth_cache_store(&cache, 1, scheme, credentials, length);
+    return true;
+}
+
+int main()
+{
+    const long iterations = 1000000;
+    const char *token = "dXNlcm5hbWU6cGFzc3dvcmQ=";   /* username:password */
+    std::string good = std::string("Basic ") + token;
+    std::string bad = "Basic dXNlcm5hbWU6d3JvbmdwYXNz";
+
+    SHA256((const unsigned char *)token, api_auth_base64_unpadded_length(token, strlen(token)),
+        expected_digest);
+    if (!legacy_check(good) || !digest_check(good) || !cached_check(good) ||
+        legacy_check(bad) || digest_check(bad) || cached_check(bad)) {
+        fprintf(stderr, "bench_api_auth: paths disagree\n");
+        return 1;
+    }
+
+    printf("api_auth (%ld iterations)\n", iterations);
+    BENCH("legacy decode+split, valid", iterations, bench_sink += legacy_check(good));
+    BENCH("digest, valid", iterations, bench_sink += digest_check(good));
+    BENCH("cached, valid (repeat client)", iterations, bench_sink += cached_check(good));
+    BENCH("legacy decode+split, wrong password", iterations, bench_sink += legacy_check(bad));
+    BENCH("digest, wrong password", iterations, bench_sink += digest_check(bad));
+    BENCH("cached, wrong password (miss)", iterations, bench_sink += cached_check(bad));
+    return 0;
+}
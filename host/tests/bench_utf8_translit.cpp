@@ -0,0 +1,87 @@
+/*
+ * Host microbenchmark of the page transliteration: utf8_transliterate() as
+ * used by queue_batch_prepare() against the pre-v3.6.119 converter (one
+ * String::replace() pass per table entry, emulated with std::string).
+ */
+#include "utf8_translit/utf8_translit.h"
+#include "bench.h"
+
+#include <string>
+
+static const struct {
+    const char *unicode;
+    const char *ascii;
+} legacy_replacements[] = {
+    {"\xC3\xA1", "a"}, {"\xC3\xA9", "e"}, {"\xC3\xAD", "i"}, {"\xC3\xB3", "o"}, {"\xC3\xBA", "u"},
+    {"\xC3\xBC", "u"}, {"\xC3\x81", "A"}, {"\xC3\x89", "E"}, {"\xC3\x8D", "I"}, {"\xC3\x93", "O"},
+    {"\xC3\x9A", "U"}, {"\xC3\x9C", "U"}, {"\xC3\xB1", "n"}, {"\xC3\x91", "N"}, {"\xC3\xA0", "a"},
+    {"\xC3\xA8", "e"}, {"\xC3\xAC", "i"}, {"\xC3\xB2", "o"}, {"\xC3\xB9", "u"}, {"\xC3\x80", "A"},
+    {"\xC3\x88", "E"}, {"\xC3\x8C", "I"}, {"\xC3\x92", "O"}, {"\xC3\x99", "U"}, {"\xC3\xA2", "a"},
+    {"\xC3\xAA", "e"}, {"\xC3\xAE", "i"}, {"\xC3\xB4", "o"}, {"\xC3\xBB", "u"}, {"\xC3\x82", "A"},
+    {"\xC3\x8A", "E"}, {"\xC3\x8E", "I"}, {"\xC3\x94", "O"}, {"\xC3\x9B", "U"}, {"\xC2\xBF", "?"},
+    {"\xC2\xA1", "!"}, {"\xC2\xB0", "^"}
+};
+
+/* Arduino String::replace() semantics: replace every occurrence, left to right */
+static void legacy_replace(std::string &message, const char *find, const char *replace)
+{
+    size_t find_length = strlen(find);
+    size_t replace_length = strlen(replace);
+    size_t pos = 0;
+
+    while ((pos = message.find(find, pos, find_length)) != std::string::npos) {
+        message.replace(pos, find_length, replace, replace_length);
+        pos += replace_length;
+    }
+}
+
+static size_t legacy_convert(const std::string &input)
+{
+    std::string message = input;
+
+    for (size_t i = 0; i < sizeof(legacy_replacements) / sizeof(legacy_replacements[0]); i++)
+        legacy_replace(message, legacy_replacements[i].unicode, legacy_replacements[i].ascii);
+    return message.length();
+}
+
+static size_t current_convert(const std::string &input)
+{
+    /* queue_batch_prepare() copies into a stack buffer and converts in place */
+    char text[248 * 4 + 1];
+    size_t length = input.length() < sizeof(text) - 1 ? input.length() : sizeof(text) - 1;
+
+    memcpy(text, input.data(), length);
+    return utf8_transliterate(text, length);
+}
+
+static std::string repeat_to(const char *unit, size_t bytes)
+{
+    std::string out;
+
+    while (out.length() < bytes)
+        out += unit;
+    return out;
+}
+
+static void run(const char *name, const std::string &page, long iterations)
+{
+    char label[64];
+
+    printf("%s (%zu bytes, %ld iterations)\n", name, page.length(), iterations);
+    snprintf(label, sizeof label, "legacy 37-pass replace");
+    BENCH(label, iterations, bench_sink += legacy_convert(page));
+    snprintf(label, sizeof label, "utf8_transliterate");
+    BENCH(label, iterations, bench_sink += current_convert(page));
+}
+
+int main()
+{
+    const long iterations = 200000;
+
+    run("ASCII page", repeat_to("Server db01 disk usage 91% on /var ", 240), iterations);
+    run("Spanish page", repeat_to("Se\xC3\xB1or Garc\xC3\xAD" "a, reuni\xC3\xB3n ma\xC3\xB1" "ana ", 240),
+        iterations);
+    run("Punctuation page", repeat_to("\xE2\x80\x9C" "Alert\xE2\x80\x9D \xE2\x80\x94 5\xE2\x82\xAC\xE2\x80\xA6 ", 240),
+        iterations);
+    return 0;
+}
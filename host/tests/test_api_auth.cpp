@@ -0,0 +1,93 @@
+/*
+ * Host checks for include/api_auth/api_auth.h (firmware authenticate_api_request()).
+ */
+#include "api_auth/api_auth.h"
+#include "test.h"
+
+/* Returns the credentials token as a string (empty when rejected) */
+static const char *parse(const char *header, int *scheme)
+{
+    static char token[128];
+    const char *credentials = NULL;
+    size_t length = 0;
+
+    *scheme = api_auth_parse_header(header, &credentials, &length);
+    if (*scheme == API_AUTH_SCHEME_NONE)
+        length = 0;
+    if (length > 0)
+        memcpy(token, credentials, length);
+    token[length] = '\0';
+    return token;
+}
+
+int main()
+{
+    int scheme;
+
+    /* "username:password" with and without padding hash the same token */
+    CHECK_STR(parse("Basic dXNlcm5hbWU6cGFzc3dvcmQ=", &scheme), "dXNlcm5hbWU6cGFzc3dvcmQ");
+    CHECK_EQ(scheme, API_AUTH_SCHEME_BASIC);
+    CHECK_STR(parse("Basic dXNlcm5hbWU6cGFzc3dvcmQ", &scheme), "dXNlcm5hbWU6cGFzc3dvcmQ");
+    CHECK_STR(parse("Basic dXNlcjpwYXNzd29yZA==", &scheme), "dXNlcjpwYXNzd29yZA");
+
+    /* Scheme is case-insensitive, whitespace around the token is ignored */
+    CHECK_STR(parse("basic dXNlcjpwYXNzd29yZA==", &scheme), "dXNlcjpwYXNzd29yZA");
+    CHECK_EQ(scheme, API_AUTH_SCHEME_BASIC);
+    CHECK_STR(parse("BASIC   dXNlcjpwYXNzd29yZA  ", &scheme), "dXNlcjpwYXNzd29yZA");
+    CHECK_STR(parse("  bAsIc\tdXNlcjpwYXNzd29yZA=", &scheme), "dXNlcjpwYXNzd29yZA");
+
+    /* Bearer tokens keep trailing '=' (they are not base64 by contract) */
+    CHECK_STR(parse("Bearer abcdefghijklmnop", &scheme), "abcdefghijklmnop");
+    CHECK_EQ(scheme, API_AUTH_SCHEME_BEARER);
+    CHECK_STR(parse("bearer abcdefghijklmno=", &scheme), "abcdefghijklmno=");
+    CHECK_EQ(scheme, API_AUTH_SCHEME_BEARER);
+
+    /* Unknown schemes, prefixes of known ones and missing tokens are rejected */
+    parse("Digest username=\"x\"", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+    parse("Basicx dXNlcg==", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+    parse("Bas dXNlcg==", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+    parse("Basic", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+    parse("Basic    ", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+    parse("Basic ==", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+    parse("", &scheme);
+    CHECK_EQ(scheme, API_AUTH_SCHEME_NONE);
+
+    CHECK_EQ(api_auth_base64_unpadded_length("YQ==", 4), 2);
+    CHECK_EQ(api_auth_base64_unpadded_length("YWI=", 4), 3);
+    CHECK_EQ(api_auth_base64_unpadded_length("YWJj", 4), 4);
+    CHECK_EQ(api_auth_base64_unpadded_length("", 0), 0);
+
+    /* The verified-token cache only matches the same scheme, token and generation */
+    struct ApiAuthCache cache;
+    memset(&cache, 0, sizeof(cache));
+    const char *token = "dXNlcm5hbWU6cGFzc3dvcmQ";
+    CHECK(!api_auth_cache_match(&cache, 0, API_AUTH_SCHEME_NONE, "", 0));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BASIC, token, strlen(token)));
+    api_auth_cache_store(&cache, 1, API_AUTH_SCHEME_BASIC, token, strlen(token));
+    CHECK(api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BASIC, token, strlen(token)));
+    CHECK(!api_auth_cache_match(&cache, 2, API_AUTH_SCHEME_BASIC, token, strlen(token)));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BEARER, token, strlen(token)));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BASIC, token, strlen(token) - 1));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BASIC, "dXNlcm5hbWU6cGFzc3dvcmR", strlen(token)));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BASIC, "eXNlcm5hbWU6cGFzc3dvcmQ", strlen(token)));
+
+    /* A shorter token stored later leaves no stale bytes behind */
+    api_auth_cache_store(&cache, 1, API_AUTH_SCHEME_BEARER, "abc", 3);
+    CHECK(api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BEARER, "abc", 3));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BASIC, token, strlen(token)));
+
+    /* Tokens past API_AUTH_CACHE_MAX are not cached */
+    char long_token[API_AUTH_CACHE_MAX + 2];
+    memset(long_token, 'a', sizeof(long_token));
+    api_auth_cache_store(&cache, 1, API_AUTH_SCHEME_BEARER, long_token, sizeof(long_token));
+    CHECK(!api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BEARER, long_token, sizeof(long_token)));
+    CHECK(api_auth_cache_match(&cache, 1, API_AUTH_SCHEME_BEARER, "abc", 3));
+
+    return test_report("api_auth");
+}
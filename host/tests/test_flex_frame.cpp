@@ -0,0 +1,309 @@
+/*
+ * Host checks for include/flex_frame/flex_frame.h (firmware frame alignment and FIW patching).
+ */
+#include "flex_frame/flex_frame.h"
+#include "test.h"
+
+/* POCSAG uses the same BCH(31,21) code in air order, so its fixed codewords are known vectors */
+#define POCSAG_IDLE_WORD  0x7A89C197UL
+#define POCSAG_SYNC_WORD  0x7CD215D8UL
+
+#define SYNC_A_1600_2     0x870CU
+
+static uint32_t reverse31(uint32_t value)
+{
+    uint32_t reversed = 0;
+
+    for (int i = 0; i < 31; i++)
+        reversed = (reversed << 1) | ((value >> i) & 1);
+    return reversed;
+}
+
+/*
+ * Lays out a frame the way the encoder does: prefix_bits of padding, 32 bits of bit sync,
+ * sync 1 and the FIW word, then filler. Returns the bit offset of the FIW.
+ */
+static size_t build_frame(uint8_t *buf, size_t length, size_t prefix_bits, uint32_t fiw_word, int inverted)
+{
+    size_t bit = prefix_bits;
+    uint32_t words[5] = {
+        0xAAAAAAAAUL,
+        ((uint32_t)SYNC_A_1600_2 << 16) | (FLEX_SYNC_MARKER >> 16),
+        ((FLEX_SYNC_MARKER & 0xFFFF) << 16) | (uint16_t)~SYNC_A_1600_2,
+        fiw_word,
+        0x5A5A5A5AUL,
+    };
+
+    memset(buf, inverted ? 0xFF : 0x00, length);
+    for (int i = 0; i < 5; i++) {
+        flex_frame_write_word(buf, bit, inverted ? ~words[i] : words[i]);
+        bit += 32;
+    }
+    return prefix_bits + 96;
+}
+
+/*
+ * A whole 1600/2 page laid out as multimon-ng reads one: after the FIW, 40 bits of sync 2 and
+ * 88 interleaved words. Word 0 is the BIW (address field at 1, vector field at 2), then the
+ * short address, an alpha vector for the message at word 3, the message header (fragment 3),
+ * text words of three 7-bit characters, the first slot holding the signature, and idle words.
+ */
+static void build_page(uint8_t *buf, size_t length, size_t prefix_bits, uint32_t capcode, const char *text,
+                       uint16_t generator, int inverted)
+{
+    uint32_t words[FLEX_FRAME_WORDS];
+    uint32_t slots[256];
+    int slot_count = 0, count = 0;
+
+    build_frame(buf, length, prefix_bits, flex_fiw_word(flex_fiw_build(3, 40), generator), inverted);
+
+    slots[slot_count++] = 0x55;
+    for (; *text; text++)
+        slots[slot_count++] = (uint8_t)*text;
+    while (slot_count % 3)
+        slots[slot_count++] = 0x03;
+
+    words[count++] = flex_word_build(flex_checksum_set((2UL << 10) | (0UL << 8)), generator);
+    words[count++] = flex_word_build(capcode + FLEX_SHORT_ADDRESS_OFFSET, generator);
+    uint32_t message_words = 1 + (uint32_t)slot_count / 3;
+    words[count++] = flex_word_build(flex_checksum_set((message_words << 14) | (3UL << 7) |
+                                                       ((uint32_t)FLEX_VECTOR_ALPHA << 4)), generator);
+    words[count++] = flex_word_build((3UL << 11) | 0x2A5, generator);
+    for (int i = 0; i < slot_count; i += 3)
+        words[count++] = flex_word_build(slots[i] | (slots[i + 1] << 7) | (slots[i + 2] << 14), generator);
+    while (count < FLEX_FRAME_WORDS)
+        words[count++] = flex_word_build(0x1FFFFF, generator);
+
+    size_t fiw_bit = prefix_bits + 96;
+    for (int i = 0; i < FLEX_FRAME_WORDS; i++)
+        flex_frame_write_data_word(buf, fiw_bit, i, inverted, words[i]);
+}
+
+struct DecodedPage {
+    uint32_t capcode;
+    int message_start;
+    char text[256];
+};
+
+/*
+ * Decodes every address of a page the way multimon-ng's decode_phase() does. Returns the
+ * number of pages, -1 when a word fails its BCH check or the BIW or a vector its checksum.
+ */
+static int decode_page(const uint8_t *buf, size_t length, uint16_t generator, struct DecodedPage *pages, int max)
+{
+    uint32_t info[FLEX_FRAME_WORDS];
+    int inverted = 0, count = 0;
+    long fiw_bit = flex_frame_find_fiw(buf, length, &inverted);
+
+    if (fiw_bit < 0)
+        return -1;
+    for (int i = 0; i < FLEX_FRAME_WORDS; i++) {
+        uint32_t word = flex_frame_read_data_word(buf, (size_t)fiw_bit, i, inverted);
+        if (!flex_bch_valid(word, generator))
+            return -1;
+        info[i] = flex_word_info(word);
+    }
+    if (!flex_fiw_checksum_ok(info[0]))
+        return -1;
+
+    int address_start = (int)((info[0] >> 8) & 0x3) + 1;
+    int vector_start = (int)((info[0] >> 10) & 0x3F);
+    for (int i = address_start; i < vector_start && count < max; i++) {
+        uint32_t vector = info[vector_start + i - address_start];
+        int start = (int)((vector >> 7) & 0x7F);
+        int words = (int)((vector >> 14) & 0x7F);
+        int frag = (int)((info[start] >> 11) & 0x3);
+        int length_out = 0;
+
+        if (!flex_fiw_checksum_ok(vector) || ((vector >> 4) & 0x7) != FLEX_VECTOR_ALPHA)
+            return -1;
+        pages[count].capcode = info[i] - FLEX_SHORT_ADDRESS_OFFSET;
+        pages[count].message_start = start;
+        for (int w = start + 1; w < start + words; w++) {
+            for (int slot = (w == start + 1 && frag == 3) ? 1 : 0; slot < 3; slot++) {
+                char ch = (char)((info[w] >> (7 * slot)) & 0x7F);
+                if (ch != 0x03)
+                    pages[count].text[length_out++] = ch;
+            }
+        }
+        pages[count].text[length_out] = '\0';
+        count++;
+    }
+    return count;
+}
+
+static void check_group(size_t prefix_bits, uint16_t generator, int inverted)
+{
+    uint8_t buf[400];
+    struct DecodedPage pages[20];
+    uint32_t members[3] = { 1234567, 42, 1933312 };
+
+    build_page(buf, sizeof(buf), prefix_bits, 200001, "Disk full on db1", generator, inverted);
+    CHECK_EQ(decode_page(buf, sizeof(buf), generator, pages, 20), 1);
+    CHECK_EQ(pages[0].capcode, 200001);
+    CHECK_STR(pages[0].text, "Disk full on db1");
+
+    CHECK_EQ(flex_frame_add_addresses(buf, sizeof(buf), members, 3), 3);
+    CHECK_EQ(decode_page(buf, sizeof(buf), generator, pages, 20), 4);
+    CHECK_EQ(pages[0].capcode, 200001);
+    CHECK_EQ(pages[1].capcode, 1234567);
+    CHECK_EQ(pages[2].capcode, 42);
+    CHECK_EQ(pages[3].capcode, 1933312);
+    for (int i = 0; i < 4; i++) {
+        CHECK_STR(pages[i].text, "Disk full on db1");
+        CHECK_EQ(pages[i].message_start, 9);
+    }
+
+    /* The FIW is left as it was */
+    uint8_t cycle = 0, frame = 0;
+    CHECK(flex_frame_get_fiw(buf, sizeof(buf), &cycle, &frame));
+    CHECK_EQ(cycle, 3);
+    CHECK_EQ(frame, 40);
+}
+
+static void check_patch(size_t prefix_bits, uint16_t generator, int inverted)
+{
+    uint8_t buf[40];
+    uint8_t cycle = 0xFF, frame = 0xFF;
+    size_t fiw_bit = build_frame(buf, sizeof(buf), prefix_bits, flex_fiw_word(flex_fiw_build(0, 0), generator), inverted);
+
+    CHECK(flex_frame_get_fiw(buf, sizeof(buf), &cycle, &frame));
+    CHECK_EQ(cycle, 0);
+    CHECK_EQ(frame, 0);
+
+    CHECK(flex_frame_set_fiw(buf, sizeof(buf), 9, 113));
+    CHECK(flex_frame_get_fiw(buf, sizeof(buf), &cycle, &frame));
+    CHECK_EQ(cycle, 9);
+    CHECK_EQ(frame, 113);
+
+    /* Same bit order and polarity as the encoder's word, and nothing after the FIW moved */
+    uint32_t word = flex_frame_read_word(buf, fiw_bit);
+    CHECK(flex_bch_valid(inverted ? ~word : word, generator));
+    CHECK_EQ(flex_frame_read_word(buf, fiw_bit + 32), (uint32_t)(inverted ? ~0x5A5A5A5AUL : 0x5A5A5A5AUL));
+}
+
+int main()
+{
+    /* BCH(31,21) against POCSAG's idle and sync codewords */
+    CHECK(flex_bch_valid(POCSAG_IDLE_WORD, FLEX_BCH_GENERATOR));
+    CHECK(flex_bch_valid(POCSAG_SYNC_WORD, FLEX_BCH_GENERATOR));
+    CHECK_EQ(flex_bch_encode(POCSAG_IDLE_WORD >> 11, FLEX_BCH_GENERATOR), POCSAG_IDLE_WORD);
+    CHECK_EQ(flex_bch_encode(POCSAG_SYNC_WORD >> 11, FLEX_BCH_GENERATOR), POCSAG_SYNC_WORD);
+    CHECK(!flex_bch_valid(POCSAG_IDLE_WORD ^ 0x100, FLEX_BCH_GENERATOR));
+    CHECK(!flex_bch_valid(POCSAG_IDLE_WORD ^ 0x1, FLEX_BCH_GENERATOR));
+
+    /* The reciprocal generator accepts exactly the bit-reversed codewords */
+    CHECK_EQ(reverse31(FLEX_BCH_GENERATOR) >> 20, FLEX_BCH_GENERATOR_RECIPROCAL);
+    CHECK_EQ(flex_bch_remainder(reverse31(POCSAG_IDLE_WORD >> 1), FLEX_BCH_GENERATOR_RECIPROCAL), 0);
+    CHECK_EQ(flex_bch_remainder(reverse31(POCSAG_SYNC_WORD >> 1), FLEX_BCH_GENERATOR_RECIPROCAL), 0);
+
+    /* Every FIW value carries a valid checksum and codeword; one flipped field bit breaks it */
+    int fiw_failures = 0;
+    for (int cycle = 0; cycle < FLEX_CYCLES_PER_HOUR; cycle++) {
+        for (int frame = 0; frame < FLEX_FRAMES_PER_CYCLE; frame++) {
+            uint32_t fiw = flex_fiw_build((uint8_t)cycle, (uint8_t)frame);
+            uint32_t word = flex_fiw_word(fiw, FLEX_BCH_GENERATOR);
+            if (!flex_fiw_checksum_ok(fiw) || ((fiw >> 4) & 0xF) != (uint32_t)cycle ||
+                ((fiw >> 8) & 0x7F) != (uint32_t)frame || !flex_bch_valid(word, FLEX_BCH_GENERATOR) ||
+                (flex_bit_reverse32(word) & 0x1FFFFF) != fiw || flex_fiw_checksum_ok(fiw ^ 0x100))
+                fiw_failures++;
+        }
+    }
+    CHECK_EQ(fiw_failures, 0);
+
+    /* Frame timing: capcode 100 with collapse 4 listens on frames 4, 20, 36, ... */
+    uint8_t cycle = 0, frame = 0;
+    CHECK_EQ(flex_frame_next(0, 0, 100, 4, &cycle, &frame), 4 * FLEX_FRAME_MS);
+    CHECK_EQ(cycle, 0);
+    CHECK_EQ(frame, 4);
+    CHECK_EQ(flex_frame_next(4 * FLEX_FRAME_MS - 10, 5, 100, 4, &cycle, &frame), 5);
+    CHECK_EQ(frame, 4);
+    CHECK_EQ(flex_frame_next(4 * FLEX_FRAME_MS - 3, 5, 100, 4, &cycle, &frame), 16 * FLEX_FRAME_MS - 2);
+    CHECK_EQ(frame, 20);
+
+    /* Collapse 7 waits for the home frame, into the next cycle and across the hour */
+    CHECK_EQ(flex_frame_next((uint64_t)FLEX_CYCLE_MS * 3 + 101 * FLEX_FRAME_MS, 0, 100, 7, &cycle, &frame),
+             127 * FLEX_FRAME_MS);
+    CHECK_EQ(cycle, 4);
+    CHECK_EQ(frame, 100);
+    CHECK_EQ(flex_frame_next(3600000ULL * 500 - 1000, 0, 5, 7, &cycle, &frame), 1000 + 5 * FLEX_FRAME_MS);
+    CHECK_EQ(cycle, 0);
+    CHECK_EQ(frame, 5);
+    CHECK_EQ(flex_frame_next(0, 0, 100, 9, &cycle, &frame), 100 * FLEX_FRAME_MS);
+
+    /* Patching at byte and bit offsets, both polarities, both BCH bit orders */
+    check_patch(0, FLEX_BCH_GENERATOR, 0);
+    check_patch(13, FLEX_BCH_GENERATOR, 0);
+    check_patch(8, FLEX_BCH_GENERATOR, 1);
+    check_patch(5, FLEX_BCH_GENERATOR_RECIPROCAL, 0);
+    check_patch(21, FLEX_BCH_GENERATOR_RECIPROCAL, 1);
+
+    /* A word that fails its check, or no sync at all, leaves the frame as it was */
+    uint8_t buf[40], before[40];
+    build_frame(buf, sizeof(buf), 3, flex_fiw_word(flex_fiw_build(2, 7), FLEX_BCH_GENERATOR) ^ 0x400, 0);
+    memcpy(before, buf, sizeof(buf));
+    CHECK(!flex_frame_set_fiw(buf, sizeof(buf), 9, 113));
+    CHECK(memcmp(buf, before, sizeof(buf)) == 0);
+
+    build_frame(buf, sizeof(buf), 3, flex_bch_encode(0x12345, FLEX_BCH_GENERATOR), 0);
+    memcpy(before, buf, sizeof(buf));
+    CHECK(!flex_frame_set_fiw(buf, sizeof(buf), 9, 113));
+    CHECK(memcmp(buf, before, sizeof(buf)) == 0);
+
+    memset(buf, 0xAA, sizeof(buf));
+    CHECK_EQ(flex_frame_find_fiw(buf, sizeof(buf), &fiw_failures), -1);
+    CHECK(!flex_frame_set_fiw(buf, sizeof(buf), 9, 113));
+
+    /* The FIW must fit: a frame cut inside it is not patched */
+    build_frame(buf, sizeof(buf), 0, flex_fiw_word(flex_fiw_build(0, 0), FLEX_BCH_GENERATOR), 0);
+    CHECK(!flex_frame_set_fiw(buf, 15, 9, 113));
+    CHECK(flex_frame_set_fiw(buf, 16, 9, 113));
+
+    /* Multi-address pages: every address decodes to the one message */
+    check_group(0, FLEX_BCH_GENERATOR, 0);
+    check_group(13, FLEX_BCH_GENERATOR, 1);
+    check_group(5, FLEX_BCH_GENERATOR_RECIPROCAL, 0);
+
+    uint8_t page[400], page_before[400];
+    struct DecodedPage pages[20];
+    uint32_t members[16];
+    char text[201];
+
+    /* 200 characters take 68 message words, leaving room for 8 more addresses */
+    memset(text, 'x', 200);
+    text[200] = '\0';
+    for (int i = 0; i < 16; i++)
+        members[i] = 1000 + (uint32_t)i;
+    build_page(page, sizeof(page), 0, 999, text, FLEX_BCH_GENERATOR, 0);
+    CHECK_EQ(flex_frame_add_addresses(page, sizeof(page), members, 16), 8);
+    CHECK_EQ(decode_page(page, sizeof(page), FLEX_BCH_GENERATOR, pages, 20), 9);
+    CHECK_EQ(pages[8].capcode, 1007);
+    CHECK_STR(pages[8].text, text);
+
+    /* Adding stops at the first capcode that needs a long address */
+    uint32_t mixed[3] = { 300, 2000000, 301 };
+    build_page(page, sizeof(page), 0, 999, "short", FLEX_BCH_GENERATOR, 0);
+    CHECK_EQ(flex_frame_add_addresses(page, sizeof(page), mixed, 3), 1);
+    CHECK_EQ(decode_page(page, sizeof(page), FLEX_BCH_GENERATOR, pages, 20), 2);
+    CHECK_EQ(pages[1].capcode, 300);
+
+    /* A BIW failing its checksum, a non-alpha vector or a cut frame is left untouched */
+    build_page(page, sizeof(page), 0, 999, "short", FLEX_BCH_GENERATOR, 0);
+    flex_frame_write_data_word(page, 96, 0, 0, flex_word_build(2UL << 10, FLEX_BCH_GENERATOR));
+    memcpy(page_before, page, sizeof(page));
+    CHECK_EQ(flex_frame_add_addresses(page, sizeof(page), members, 2), 0);
+    CHECK(memcmp(page, page_before, sizeof(page)) == 0);
+
+    build_page(page, sizeof(page), 0, 999, "short", FLEX_BCH_GENERATOR, 0);
+    flex_frame_write_data_word(page, 96, 2, 0,
+                               flex_word_build(flex_checksum_set((2UL << 14) | (3UL << 7) | (3UL << 4)), FLEX_BCH_GENERATOR));
+    memcpy(page_before, page, sizeof(page));
+    CHECK_EQ(flex_frame_add_addresses(page, sizeof(page), members, 2), 0);
+    CHECK(memcmp(page, page_before, sizeof(page)) == 0);
+
+    build_page(page, sizeof(page), 0, 999, "short", FLEX_BCH_GENERATOR, 0);
+    CHECK_EQ(flex_frame_add_addresses(page, 372, members, 2), 0);
+    CHECK_EQ(flex_frame_add_addresses(page, 373, members, 2), 2);
+
+    return test_report("flex_frame");
+}
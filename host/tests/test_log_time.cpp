@@ -0,0 +1,72 @@
+/*
+ * Host checks for include/log_time/log_time.h (firmware log index and /logs?since=).
+ */
+#include "log_time/log_time.h"
+#include "test.h"
+
+#include <time.h>
+
+static uint32_t parse(const char *line)
+{
+    return log_line_time(line, strlen(line));
+}
+
+/* Reference: the C library's UTC conversion of the same broken-down time */
+static uint32_t reference(int year, int month, int day, int hour, int minute, int second)
+{
+    struct tm when;
+
+    memset(&when, 0, sizeof(when));
+    when.tm_year = year - 1900;
+    when.tm_mon = month - 1;
+    when.tm_mday = day;
+    when.tm_hour = hour;
+    when.tm_min = minute;
+    when.tm_sec = second;
+    return (uint32_t)timegm(&when);
+}
+
+int main()
+{
+    CHECK_EQ(parse("1970-01-01 00:00:00"), 0);
+    CHECK_EQ(parse("1970-01-02 00:00:01"), 86401);
+    CHECK_EQ(parse("2000-02-29 12:00:00"), 951825600);
+    CHECK_EQ(parse("2026-10-18 09:05:07 WIFI: Connected"), 1792314307);
+    CHECK_EQ(parse("2026-10-18T09:05:07"), 1792314307);
+    CHECK_EQ(parse("2106-02-07 06:28:15"), 4294967295u);
+
+    /* Every month start and leap day across the uint32_t range agrees with timegm() */
+    int mismatches = 0;
+    for (int year = 1970; year <= 2105; year++) {
+        for (int month = 1; month <= 12; month++) {
+            char line[32];
+            snprintf(line, sizeof line, "%04d-%02d-01 23:59:58", year, month);
+            if (parse(line) != reference(year, month, 1, 23, 59, 58))
+                mismatches++;
+        }
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        if (leap) {
+            char line[32];
+            snprintf(line, sizeof line, "%04d-02-29 00:00:00", year);
+            if (parse(line) != reference(year, 2, 29, 0, 0, 0))
+                mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    /* Uptime stamps, short lines and out-of-range fields are "no time" */
+    CHECK_EQ(parse("[00:01:23] SYSTEM: Boot"), 0);
+    CHECK_EQ(parse("2026-10-18 09:05"), 0);
+    CHECK_EQ(parse("2026/10/18 09:05:07"), 0);
+    CHECK_EQ(parse("1969-12-31 23:59:59"), 0);
+    CHECK_EQ(parse("2026-13-01 00:00:00"), 0);
+    CHECK_EQ(parse("2026-00-01 00:00:00"), 0);
+    CHECK_EQ(parse("2026-10-00 00:00:00"), 0);
+    CHECK_EQ(parse("2026-10-32 00:00:00"), 0);
+    CHECK_EQ(parse(""), 0);
+
+    /* Only len bytes are looked at */
+    CHECK_EQ(log_line_time("2026-10-18 09:05:07", 18), 0);
+
+    return test_report("log_time");
+}
@@ -0,0 +1,216 @@
+/*
+ * Host checks for include/queue_journal/queue_journal.h (firmware journal_replay() and
+ * journal_compact()).
+ */
+#include "queue_journal/queue_journal.h"
+#include "test.h"
+
+#define MESSAGE_MAX 248
+#define ID_MAX 40
+#define MEMBERS_MAX 16
+
+struct Segment {
+    uint8_t bytes[2048];
+    size_t length;
+};
+
+static void segment_begin(struct Segment *segment, uint32_t magic)
+{
+    struct JournalSegmentHeader header = { magic, 1 };
+
+    memcpy(segment->bytes, &header, sizeof(header));
+    segment->length = sizeof(header);
+}
+
+static void segment_append(struct Segment *segment, uint8_t type, uint32_t seq,
+                           const void *head, size_t head_len, const void *tail, size_t tail_len)
+{
+    struct JournalEntryHeader entry;
+
+    journal_build_entry(&entry, type, seq, head, head_len, tail, tail_len);
+    memcpy(segment->bytes + segment->length, &entry, sizeof(entry));
+    memcpy(segment->bytes + segment->length + sizeof(entry), head, head_len);
+    memcpy(segment->bytes + segment->length + sizeof(entry) + head_len, tail, tail_len);
+    segment->length += sizeof(entry) + head_len + tail_len;
+}
+
+/* Text NUL id [NUL capcodes], as journal_record_enqueue() lays out the tail */
+static size_t build_tail(char *tail, const char *text, const char *id, const uint32_t *members, size_t count)
+{
+    size_t length = strlen(text) + 1 + strlen(id);
+
+    memcpy(tail, text, strlen(text) + 1);
+    memcpy(tail + strlen(text) + 1, id, strlen(id));
+    if (count > 0) {
+        tail[length++] = '\0';
+        memcpy(tail + length, members, count * sizeof(uint32_t));
+        length += count * sizeof(uint32_t);
+    }
+    return length;
+}
+
+/*
+ * Walks a segment the way journal_replay() does and keeps the last ENQUEUE without a
+ * COMPLETE entry. Returns the number of pending pages, -1 on a torn entry.
+ */
+static int replay(const struct Segment *segment, struct JournalEnqueueView *last, uint32_t *last_seq)
+{
+    struct JournalSegmentHeader header;
+    uint32_t enqueued[8], completed[8];
+    struct JournalEnqueueView views[8];
+    int enqueue_count = 0, complete_count = 0, pending = 0;
+    size_t offset = sizeof(header);
+
+    memcpy(&header, segment->bytes, sizeof(header));
+    while (offset + sizeof(struct JournalEntryHeader) <= segment->length) {
+        struct JournalEntryHeader entry;
+        memcpy(&entry, segment->bytes + offset, sizeof(entry));
+        const uint8_t *payload = segment->bytes + offset + sizeof(entry);
+        if (offset + sizeof(entry) + entry.payload_length > segment->length || !journal_entry_valid(&entry, payload))
+            return -1;
+        offset += sizeof(entry) + entry.payload_length;
+
+        if (entry.type == JOURNAL_ENTRY_ENQUEUE && enqueue_count < 8 &&
+            journal_parse_enqueue(payload, entry.payload_length, header.magic, MESSAGE_MAX, ID_MAX, MEMBERS_MAX,
+                                  &views[enqueue_count])) {
+            enqueued[enqueue_count++] = entry.seq;
+        } else if (entry.type == JOURNAL_ENTRY_COMPLETE && complete_count < 8) {
+            completed[complete_count++] = entry.seq;
+        }
+    }
+
+    for (int i = 0; i < enqueue_count; i++) {
+        int done = 0;
+        for (int j = 0; j < complete_count; j++)
+            done |= (completed[j] == enqueued[i]);
+        if (!done) {
+            *last = views[i];
+            *last_seq = enqueued[i];
+            pending++;
+        }
+    }
+    return pending;
+}
+
+static void test_repeat_round_trip(void)
+{
+    struct Segment segment;
+    struct JournalEnqueuePayload payload;
+    struct JournalEnqueueView view;
+    uint32_t members[3] = { 1234567, 2000001, 42 };
+    char tail[512];
+    uint32_t seq = 0;
+
+    memset(&payload, 0, sizeof(payload));
+    payload.capcode = members[0];
+    payload.frequency = 929.6625f;
+    payload.power = 10;
+    payload.flags = JOURNAL_FLAG_MAIL_DROP;
+    payload.source = 3;
+    payload.id_length = 6;
+    payload.repeat = 3;
+    payload.repeat_interval_s = 90;
+
+    segment_begin(&segment, JOURNAL_MAGIC);
+    segment_append(&segment, JOURNAL_ENTRY_ENQUEUE, 5, &payload, sizeof(payload), tail,
+                   build_tail(tail, "sent already", "api-05", NULL, 0));
+    segment_append(&segment, JOURNAL_ENTRY_COMPLETE, 5, NULL, 0, NULL, 0);
+    segment_append(&segment, JOURNAL_ENTRY_ENQUEUE, 6, &payload, sizeof(payload), tail,
+                   build_tail(tail, "Disk full on db1", "api-06", members, 3));
+
+    CHECK_EQ(replay(&segment, &view, &seq), 1);
+    CHECK_EQ(seq, 6);
+    CHECK_EQ(view.payload.repeat, 3);
+    CHECK_EQ(view.payload.repeat_interval_s, 90);
+    CHECK_EQ(view.payload.capcode, 1234567);
+    CHECK_EQ(view.payload.power, 10);
+    CHECK_EQ(view.payload.flags & JOURNAL_FLAG_MAIL_DROP, JOURNAL_FLAG_MAIL_DROP);
+    CHECK_EQ(view.payload.source, 3);
+    CHECK_EQ(view.message_length, 16);
+    CHECK(memcmp(view.message, "Disk full on db1", 16) == 0);
+    CHECK_EQ(view.id_length, 6);
+    CHECK(memcmp(view.message_id, "api-06", 6) == 0);
+    CHECK_EQ(view.group_count, 3);
+    uint32_t member;
+    memcpy(&member, view.group_capcodes + 2 * sizeof(uint32_t), sizeof(member));
+    CHECK_EQ(member, 42);
+
+    /* A torn last entry stops the walk */
+    segment.bytes[segment.length - 1] ^= 0xFF;
+    CHECK_EQ(replay(&segment, &view, &seq), -1);
+}
+
+static void test_v1_reads_no_repeat(void)
+{
+    struct Segment segment;
+    struct JournalEnqueuePayload payload;
+    struct JournalEnqueueView view;
+    char tail[512];
+    uint32_t seq = 0;
+
+    memset(&payload, 0xAA, sizeof(payload));
+    payload.capcode = 777;
+    payload.frequency = 931.9375f;
+    payload.power = 2;
+    payload.flags = 0;
+    payload.source = 1;
+    payload.id_length = 5;
+
+    /* v1 entries end the fixed part at id_length; the text follows directly */
+    segment_begin(&segment, JOURNAL_MAGIC_V1);
+    segment_append(&segment, JOURNAL_ENTRY_ENQUEUE, 9, &payload, JOURNAL_ENQUEUE_HEAD_V1, tail,
+                   build_tail(tail, "old page", "mqtt9", NULL, 0));
+
+    CHECK_EQ(replay(&segment, &view, &seq), 1);
+    CHECK_EQ(seq, 9);
+    CHECK_EQ(view.payload.capcode, 777);
+    CHECK_EQ(view.payload.repeat, 0);
+    CHECK_EQ(view.payload.repeat_interval_s, 0);
+    CHECK_EQ(view.message_length, 8);
+    CHECK(memcmp(view.message, "old page", 8) == 0);
+    CHECK_EQ(view.id_length, 5);
+    CHECK(memcmp(view.message_id, "mqtt9", 5) == 0);
+    CHECK_EQ(view.group_count, 0);
+
+    /* The same bytes read as v2 would take text bytes for the repeat fields */
+    uint8_t entry_payload[JOURNAL_ENQUEUE_HEAD_V1 + 3];
+    memcpy(entry_payload, &payload, JOURNAL_ENQUEUE_HEAD_V1);
+    memcpy(entry_payload + JOURNAL_ENQUEUE_HEAD_V1, "ab", 3);
+    CHECK(!journal_parse_enqueue(entry_payload, JOURNAL_ENQUEUE_HEAD_V1 + 3, JOURNAL_MAGIC,
+                                 MESSAGE_MAX, ID_MAX, MEMBERS_MAX, &view));
+    CHECK(journal_parse_enqueue(entry_payload, JOURNAL_ENQUEUE_HEAD_V1 + 3, JOURNAL_MAGIC_V1,
+                                MESSAGE_MAX, ID_MAX, MEMBERS_MAX, &view));
+    CHECK_EQ(view.message_length, 2);
+}
+
+static void test_malformed_tail(void)
+{
+    struct JournalEnqueuePayload payload;
+    struct JournalEnqueueView view;
+    uint8_t entry_payload[sizeof(payload) + 8];
+
+    /* Pre-ID entry: the text runs to the end of the payload without a NUL */
+    memset(&payload, 0, sizeof(payload));
+    payload.id_length = 12;
+    memcpy(entry_payload, &payload, sizeof(payload));
+    memcpy(entry_payload + sizeof(payload), "pagetext", 8);
+    CHECK(journal_parse_enqueue(entry_payload, sizeof(entry_payload), JOURNAL_MAGIC,
+                                MESSAGE_MAX, ID_MAX, MEMBERS_MAX, &view));
+    CHECK_EQ(view.message_length, 8);
+    CHECK_EQ(view.id_length, 0);
+    CHECK(view.message_id == NULL);
+    CHECK_EQ(view.group_count, 0);
+
+    /* The text is cut at message_max */
+    CHECK(journal_parse_enqueue(entry_payload, sizeof(entry_payload), JOURNAL_MAGIC, 4, ID_MAX, MEMBERS_MAX, &view));
+    CHECK_EQ(view.message_length, 4);
+}
+
+int main(void)
+{
+    CHECK_EQ(sizeof(struct JournalEnqueuePayload), 16);
+    test_repeat_round_trip();
+    test_v1_reads_no_repeat();
+    test_malformed_tail();
+    return test_report("queue_journal");
+}
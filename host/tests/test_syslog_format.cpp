@@ -0,0 +1,98 @@
+/*
+ * Host checks for include/syslog_format/syslog_format.h (firmware syslog_task()).
+ */
+#include "syslog_format/syslog_format.h"
+#include "test.h"
+
+#include <stdlib.h>
+
+static struct tm make_tm(int month, int day, int hour, int minute, int second)
+{
+    struct tm when;
+
+    memset(&when, 0, sizeof(when));
+    when.tm_year = 2026 - 1900;
+    when.tm_mon = month - 1;
+    when.tm_mday = day;
+    when.tm_hour = hour;
+    when.tm_min = minute;
+    when.tm_sec = second;
+    return when;
+}
+
+/* Parses octet-counted frames back; returns the number of frames, -1 on a framing error */
+static int parse_frames(const char *stream, size_t length, char lines[][128], int max_lines)
+{
+    size_t pos = 0;
+    int count = 0;
+
+    while (pos < length) {
+        char *end;
+        unsigned long octets = strtoul(stream + pos, &end, 10);
+        if (end == stream + pos || *end != ' ' || count >= max_lines)
+            return -1;
+        pos = (size_t)(end - stream) + 1;
+        if (pos + octets > length || octets >= 128)
+            return -1;
+        memcpy(lines[count], stream + pos, octets);
+        lines[count][octets] = '\0';
+        pos += octets;
+        count++;
+    }
+    return count;
+}
+
+int main()
+{
+    char line[128];
+    struct tm when = make_tm(10, 18, 9, 5, 7);
+
+    /* local0 facility (16): PRI = 128 + severity */
+    size_t length = syslog_format_line(line, sizeof(line), 6, &when, "FLEX", "A1B2", "WIFI: Connected");
+    CHECK_STR(line, "<134>Oct 18 09:05:07 FLEX A1B2: WIFI: Connected");
+    CHECK_EQ(length, strlen(line));
+
+    /* Single-digit days are space padded (RFC 3164 4.1.2) */
+    when = make_tm(3, 4, 23, 59, 0);
+    syslog_format_line(line, sizeof(line), 3, &when, "FLEX", "A1B2", "ERROR: x");
+    CHECK_STR(line, "<131>Mar  4 23:59:00 FLEX A1B2: ERROR: x");
+
+    /* A banner with spaces must not split the HOSTNAME field */
+    syslog_format_line(line, sizeof(line), 7, &when, "Pager Tx 1", "A1B2", "DEBUG: y");
+    CHECK_STR(line, "<135>Mar  4 23:59:00 Pager-Tx-1 A1B2: DEBUG: y");
+
+    /* Truncation reports the bytes actually written */
+    char small[24];
+    length = syslog_format_line(small, sizeof(small), 6, &when, "FLEX", "A1B2", "a long message body");
+    CHECK_EQ(length, sizeof(small) - 1);
+    CHECK_EQ(strlen(small), length);
+    CHECK_EQ(syslog_format_line(small, 0, 6, &when, "FLEX", "A1B2", "x"), 0);
+
+    /* Octet counting: the count is the exact byte length of what follows */
+    char stream[512];
+    size_t used = 0;
+    const char *messages[] = { "first", "second line with spaces", "", "12 looks like a count" };
+    char lines[8][128];
+    for (int i = 0; i < 4; i++) {
+        length = syslog_format_line(line, sizeof(line), 6, &when, "FLEX", "A1B2", messages[i]);
+        size_t framed = syslog_frame_octets(stream + used, sizeof(stream) - used, line, length);
+        CHECK(framed > length);
+        used += framed;
+    }
+    CHECK_EQ(parse_frames(stream, used, lines, 8), 4);
+    CHECK_STR(lines[1], "<134>Mar  4 23:59:00 FLEX A1B2: second line with spaces");
+    CHECK_STR(lines[3], "<134>Mar  4 23:59:00 FLEX A1B2: 12 looks like a count");
+
+    CHECK_EQ(syslog_frame_octets(stream, sizeof(stream), "abc", 3), 5);
+    CHECK(memcmp(stream, "3 abc", 5) == 0);
+    CHECK_EQ(syslog_frame_octets(stream, sizeof(stream), "0123456789", 10), 13);
+    CHECK(memcmp(stream, "10 0123456789", 13) == 0);
+
+    /* A frame that does not fit is not written at all */
+    memset(stream, 'x', sizeof(stream));
+    CHECK_EQ(syslog_frame_octets(stream, 5, "abcd", 4), 0);
+    CHECK_EQ(stream[0], 'x');
+    CHECK_EQ(syslog_frame_octets(stream, 6, "abcd", 4), 6);
+
+    return test_report("syslog_format");
+}
@@ -0,0 +1,132 @@
+/*
+ * Host checks for include/utf8_translit/utf8_translit.h (firmware queue_batch_prepare()).
+ */
+#include "utf8_translit/utf8_translit.h"
+#include "test.h"
+
+static const char *translit(const char *input)
+{
+    static char text[256];
+    size_t length = strlen(input);
+
+    memcpy(text, input, length + 1);
+    size_t out = utf8_transliterate(text, length);
+    CHECK(out <= length);
+    CHECK_EQ(strlen(text), out);
+    return text;
+}
+
+/* Encodes one code point as UTF-8; returns the sequence length */
+static size_t utf8_encode(uint32_t code_point, char *out)
+{
+    if (code_point < 0x80) {
+        out[0] = (char)code_point;
+        return 1;
+    }
+    if (code_point < 0x800) {
+        out[0] = (char)(0xC0 | (code_point >> 6));
+        out[1] = (char)(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        out[0] = (char)(0xE0 | (code_point >> 12));
+        out[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code_point >> 18));
+    out[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+static void check_table(void)
+{
+    const size_t latin_count = sizeof(utf8_latin_map) / sizeof(utf8_latin_map[0]);
+    const size_t punctuation_count = sizeof(utf8_punctuation_map) / sizeof(utf8_punctuation_map[0]);
+
+    /* The Latin table covers U+00A0..U+017F exactly, every entry fits its 2-byte source */
+    CHECK_EQ(latin_count, 0x17F - 0xA0 + 1);
+    for (size_t i = 0; i < latin_count; i++) {
+        CHECK(strlen(utf8_latin_map[i]) <= 2);
+        for (const char *c = utf8_latin_map[i]; *c; c++)
+            CHECK((unsigned char)*c >= 0x20 && (unsigned char)*c < 0x7F);
+    }
+
+    /* Punctuation is sorted for the binary search, 3-byte sources, at most 3 chars out */
+    for (size_t i = 0; i < punctuation_count; i++) {
+        CHECK(utf8_punctuation_map[i].code_point >= 0x800);
+        CHECK(strlen(utf8_punctuation_map[i].ascii) <= 3);
+        if (i > 0)
+            CHECK(utf8_punctuation_map[i - 1].code_point < utf8_punctuation_map[i].code_point);
+    }
+
+    /* Every table entry is found by the lookup and round-trips through the converter */
+    for (uint32_t cp = 0xA0; cp <= 0x17F; cp++) {
+        char text[8];
+        size_t length = utf8_encode(cp, text);
+        text[length] = '\0';
+        CHECK_STR(translit(text), utf8_latin_map[cp - 0xA0]);
+    }
+    for (size_t i = 0; i < punctuation_count; i++) {
+        char text[8];
+        size_t length = utf8_encode(utf8_punctuation_map[i].code_point, text);
+        text[length] = '\0';
+        CHECK_STR(translit(text), utf8_punctuation_map[i].ascii);
+    }
+}
+
+int main()
+{
+    check_table();
+
+    CHECK_STR(translit("plain ASCII 123 ~"), "plain ASCII 123 ~");
+    CHECK_STR(translit(""), "");
+    CHECK_STR(translit("Se\xC3\xB1or \xC3\x81lvarez \xC2\xBF" "Qu\xC3\xA9?"), "Senor Alvarez ?Que?");
+    CHECK_STR(translit("Stra\xC3\x9F" "e \xC3\x86gir \xC5\x92uvre \xC5\x81\xC3\xB3" "d\xC5\xBA"),
+        "Strasse AEgir OEuvre Lodz");
+    CHECK_STR(translit("\xE2\x80\x9Cquoted\xE2\x80\x9D \xE2\x80\x94 it\xE2\x80\x99s\xE2\x80\xA6"),
+        "\"quoted\" - it's...");
+    CHECK_STR(translit("5\xE2\x82\xAC Brand\xE2\x84\xA2"), "5EUR BrandTM");
+    CHECK_STR(translit("\xEF\xBB\xBFno BOM, zero\xE2\x80\x8Bwidth"), "no BOM, zerowidth");
+
+    /* Unmapped code points and malformed input become a single '?' per sequence */
+    CHECK_STR(translit("\xE4\xB8\xAD\xE6\x96\x87"), "??");           /* CJK */
+    CHECK_STR(translit("\xF0\x9F\x93\x9F pager"), "? pager");         /* emoji, 4 bytes */
+    CHECK_STR(translit("a\x80" "b"), "a?b");                          /* stray continuation */
+    CHECK_STR(translit("a\xFF" "b"), "a?b");                          /* invalid lead byte */
+    CHECK_STR(translit("a\xC3" "b"), "a?b");                          /* truncated 2-byte */
+    CHECK_STR(translit("a\xE2\x80"), "a?");                           /* truncated at end */
+    CHECK_STR(translit("\xC1\x81"), "?");                             /* overlong 'A' */
+
+    /* Only length bytes are converted; the result is terminated in place */
+    char text[16] = "\xC3\xA9t\xC3\xA9";
+    CHECK_EQ(utf8_transliterate(text, 3), 2);
+    CHECK_STR(text, "et");
+
+    /* Page preparation: long text is cut to 248 with "..." at the end */
+    static char message[2048], scratch[248 * 4 + 1], page[249];
+    int truncated = 0;
+    memset(message, 'x', 300);
+    message[300] = '\0';
+    CHECK_EQ(utf8_prepare_page(page, 248, message, scratch, &truncated), 248);
+    CHECK(truncated);
+    CHECK_STR(page + 245, "...");
+
+    CHECK_EQ(utf8_prepare_page(page, 248, "short", scratch, &truncated), 5);
+    CHECK(!truncated);
+    CHECK_STR(page, "short");
+
+    /* 990 bytes of U+200B convert to nothing; the input past the 992-byte window is cut, and
+     * the ellipsis follows the converted text instead of leaving raw bytes before it */
+    size_t length = 0;
+    for (int i = 0; i < 330; i++, length += 3)
+        memcpy(message + length, "\xE2\x80\x8B", 3);
+    strcpy(message + length, "hello pager");
+    CHECK_EQ(utf8_prepare_page(page, 248, message, scratch, &truncated), 5);
+    CHECK(truncated);
+    CHECK_STR(page, "he...");
+
+    return test_report("utf8_translit");
+}
@@ -0,0 +1,118 @@
+#ifndef API_AUTH_H
+#define API_AUTH_H
+
+/* Authorization header parsing shared by the v3.6 firmware and the host tests */
+
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+
+enum ApiAuthScheme {
+    API_AUTH_SCHEME_NONE = 0,
+    API_AUTH_SCHEME_BASIC,
+    API_AUTH_SCHEME_BEARER
+};
+
+static inline int api_auth_is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+/* Length of a base64 value without its trailing '=' padding, so "dXNlcg" and "dXNlcg==" compare equal */
+static inline size_t api_auth_base64_unpadded_length(const char* value, size_t length) {
+    while (length > 0 && value[length - 1] == '=') {
+        length--;
+    }
+    return length;
+}
+
+/*
+ * Splits an Authorization header value into its scheme (matched case-insensitively, RFC 7235)
+ * and the credentials token. *credentials and *length cover the token with surrounding
+ * whitespace removed and, for Basic, the base64 padding removed. Returns API_AUTH_SCHEME_NONE
+ * for an unknown scheme or a missing token.
+ */
+static inline int api_auth_parse_header(const char* header, const char** credentials, size_t* length) {
+    while (api_auth_is_space(*header)) {
+        header++;
+    }
+    const char* scheme_end = header;
+    while (*scheme_end != '\0' && !api_auth_is_space(*scheme_end)) {
+        scheme_end++;
+    }
+
+    size_t scheme_length = (size_t)(scheme_end - header);
+    int scheme = API_AUTH_SCHEME_NONE;
+    if (scheme_length == 5 && strncasecmp(header, "basic", 5) == 0) {
+        scheme = API_AUTH_SCHEME_BASIC;
+    } else if (scheme_length == 6 && strncasecmp(header, "bearer", 6) == 0) {
+        scheme = API_AUTH_SCHEME_BEARER;
+    } else {
+        return API_AUTH_SCHEME_NONE;
+    }
+
+    const char* token = scheme_end;
+    while (api_auth_is_space(*token)) {
+        token++;
+    }
+    size_t token_length = strlen(token);
+    while (token_length > 0 && api_auth_is_space(token[token_length - 1])) {
+        token_length--;
+    }
+    if (scheme == API_AUTH_SCHEME_BASIC) {
+        token_length = api_auth_base64_unpadded_length(token, token_length);
+    }
+    if (token_length == 0) {
+        return API_AUTH_SCHEME_NONE;
+    }
+
+    *credentials = token;
+    *length = token_length;
+    return scheme;
+}
+
+/*
+ * The last credentials token that passed the digest check, so a client repeating the same
+ * header skips the SHA-256. generation ties it to the expected credentials it was checked
+ * against; tokens longer than API_AUTH_CACHE_MAX are never cached. One cache per listener
+ * task, so it needs no lock.
+ */
+#define API_AUTH_CACHE_MAX 128
+
+struct ApiAuthCache {
+    unsigned int generation;
+    int scheme;                     /* API_AUTH_SCHEME_NONE = empty */
+    size_t length;
+    char token[API_AUTH_CACHE_MAX];
+};
+
+/*
+ * True when token is the cached one. Every byte of the cache is compared whatever the
+ * first difference, so the time depends only on the presented token's length.
+ */
+static inline int api_auth_cache_match(const struct ApiAuthCache* cache, unsigned int generation, int scheme,
+                                       const char* token, size_t length) {
+    if (cache->scheme == API_AUTH_SCHEME_NONE || length > API_AUTH_CACHE_MAX) {
+        return 0;
+    }
+    unsigned int diff = (cache->generation ^ generation) | (unsigned int)(cache->scheme ^ scheme) |
+                        (unsigned int)(cache->length ^ length);
+    for (size_t i = 0; i < API_AUTH_CACHE_MAX; i++) {
+        unsigned char presented = (i < length) ? (unsigned char)token[i] : 0;
+        diff |= presented ^ (unsigned char)cache->token[i];
+    }
+    return diff == 0;
+}
+
+static inline void api_auth_cache_store(struct ApiAuthCache* cache, unsigned int generation, int scheme,
+                                        const char* token, size_t length) {
+    if (length > API_AUTH_CACHE_MAX) {
+        return;
+    }
+    memset(cache->token, 0, sizeof(cache->token));
+    memcpy(cache->token, token, length);
+    cache->length = length;
+    cache->generation = generation;
+    cache->scheme = scheme;
+}
+
+#endif /* API_AUTH_H */
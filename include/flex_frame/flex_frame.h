@@ -0,0 +1,343 @@
+#ifndef FLEX_FRAME_H
+#define FLEX_FRAME_H
+
+/* FLEX frame timing, Frame Information Word (FIW) patching and multi-address frames, shared
+ * by the v3.6 firmware and the host tests */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 128 frames of 1.875 s per 4-minute cycle, 15 cycles per hour starting on the hour */
+#define FLEX_FRAME_MS           1875
+#define FLEX_FRAMES_PER_CYCLE   128
+#define FLEX_CYCLES_PER_HOUR    15
+#define FLEX_CYCLE_MS           ((uint32_t)FLEX_FRAME_MS * FLEX_FRAMES_PER_CYCLE)
+#define FLEX_COLLAPSE_MAX       7
+
+/* Sync 1 is A, 0xA6C6AAAA, ~A (64 bits); the FIW is the 32-bit word that follows it */
+#define FLEX_SYNC_MARKER        0xA6C6AAAAUL
+
+/* At 1600/2 sync 2 (25 ms) follows the FIW, then 11 blocks of 8 words. Each block sends bit 0
+ * of its 8 words, then bit 1 and so on, and every word starts with its information bit 0. */
+#define FLEX_SYNC2_BITS_1600    40
+#define FLEX_BLOCK_WORDS        8
+#define FLEX_FRAME_WORDS        88
+
+/* Short addresses carry capcode + 0x8000; the other values are long-address halves */
+#define FLEX_SHORT_ADDRESS_OFFSET   0x8000UL
+#define FLEX_SHORT_CAPCODE_MAX      0x1D8000UL
+#define FLEX_VECTOR_ALPHA           5
+
+/* BCH(31,21) generator x^10+x^9+x^8+x^6+x^5+x^3+1 (as POCSAG) and its reciprocal, which is
+ * the same code read with the bit order reversed */
+#define FLEX_BCH_GENERATOR              0x769
+#define FLEX_BCH_GENERATOR_RECIPROCAL   0x4B7
+
+/*
+ * Milliseconds from now_ms (UTC, ms since the epoch) until the next frame the capcode's pager
+ * listens to, so the frame starts lead_ms after now_ms at the earliest. The home frame is the
+ * capcode's low 7 bits; with collapse c the pager also wakes every 2^c frames after it.
+ * *cycle (0-14) and *frame (0-127) receive that frame's FLEX time.
+ */
+static inline uint32_t flex_frame_next(uint64_t now_ms, uint32_t lead_ms, uint64_t capcode, uint8_t collapse,
+                                       uint8_t* cycle, uint8_t* frame) {
+    uint64_t cycle_index = now_ms / FLEX_CYCLE_MS;
+    uint32_t cycle_offset_ms = (uint32_t)(now_ms % FLEX_CYCLE_MS);
+
+    uint32_t period = 1u << (collapse < FLEX_COLLAPSE_MAX ? collapse : FLEX_COLLAPSE_MAX);
+    uint32_t slot = (uint32_t)(capcode % FLEX_FRAMES_PER_CYCLE) % period;
+
+    uint32_t earliest_ms = cycle_offset_ms + lead_ms;
+    uint32_t next = (earliest_ms + FLEX_FRAME_MS - 1) / FLEX_FRAME_MS;
+    next += (slot + period - next % period) % period;
+
+    *cycle = (uint8_t)((cycle_index + next / FLEX_FRAMES_PER_CYCLE) % FLEX_CYCLES_PER_HOUR);
+    *frame = (uint8_t)(next % FLEX_FRAMES_PER_CYCLE);
+    return next * FLEX_FRAME_MS - earliest_ms;
+}
+
+static inline uint32_t flex_bit_reverse32(uint32_t value) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < 32; i++) {
+        reversed = (reversed << 1) | ((value >> i) & 1);
+    }
+    return reversed;
+}
+
+static inline uint32_t flex_parity32(uint32_t value) {
+    value ^= value >> 16;
+    value ^= value >> 8;
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return value & 1;
+}
+
+/* Remainder of a 31-bit codeword polynomial (bit 30 = x^30) divided by the generator */
+static inline uint32_t flex_bch_remainder(uint32_t codeword, uint16_t generator) {
+    for (int bit = 30; bit >= 10; bit--) {
+        if (codeword & (1UL << bit)) {
+            codeword ^= (uint32_t)generator << (bit - 10);
+        }
+    }
+    return codeword & 0x3FF;
+}
+
+/* Word in air order (bit 31 sent first): 21 information bits, 10 check bits, even parity */
+static inline uint32_t flex_bch_encode(uint32_t info, uint16_t generator) {
+    uint32_t codeword = (info & 0x1FFFFF) << 10;
+    codeword |= flex_bch_remainder(codeword, generator);
+    uint32_t word = codeword << 1;
+    return word | flex_parity32(word);
+}
+
+static inline int flex_bch_valid(uint32_t word, uint16_t generator) {
+    return flex_bch_remainder(word >> 1, generator) == 0 && flex_parity32(word) == 0;
+}
+
+/* FIW fields with the first bit on air as bit 0: checksum 0-3, cycle 4-7, frame 8-14 and the
+ * roaming/repeat bits 15-20 (left 0). The checksum makes the nibbles of bits 0-19 plus bit 20
+ * sum to 0xF; block information and vector words carry the same checksum in bits 0-3. */
+static inline uint32_t flex_fiw_checksum_sum(uint32_t fiw) {
+    uint32_t sum = 0;
+    for (int shift = 0; shift < 20; shift += 4) {
+        sum += (fiw >> shift) & 0xF;
+    }
+    return (sum + ((fiw >> 20) & 1)) & 0xF;
+}
+
+static inline uint32_t flex_fiw_build(uint8_t cycle, uint8_t frame) {
+    uint32_t fiw = ((uint32_t)(cycle & 0xF) << 4) | ((uint32_t)(frame & 0x7F) << 8);
+    return fiw | ((0xF - flex_fiw_checksum_sum(fiw)) & 0xF);
+}
+
+static inline int flex_fiw_checksum_ok(uint32_t fiw) {
+    return flex_fiw_checksum_sum(fiw) == 0xF;
+}
+
+/* info with its checksum bits rewritten for the other 17 */
+static inline uint32_t flex_checksum_set(uint32_t info) {
+    info &= 0x1FFFF0;
+    return info | ((0xF - flex_fiw_checksum_sum(info)) & 0xF);
+}
+
+/* The air-order word carrying 21 information bits (bit 0 first on air), and back */
+static inline uint32_t flex_word_build(uint32_t info, uint16_t generator) {
+    return flex_bch_encode(flex_bit_reverse32(info & 0x1FFFFF) >> 11, generator);
+}
+
+static inline uint32_t flex_word_info(uint32_t word) {
+    return flex_bit_reverse32(word) & 0x1FFFFF;
+}
+
+static inline uint32_t flex_fiw_word(uint32_t fiw, uint16_t generator) {
+    return flex_word_build(fiw, generator);
+}
+
+/* Bits are sent MSB first within each byte of the encoded frame */
+static inline uint32_t flex_frame_read_word(const uint8_t* buf, size_t bit) {
+    uint32_t word = 0;
+    for (int i = 0; i < 32; i++, bit++) {
+        word = (word << 1) | ((buf[bit >> 3] >> (7 - (bit & 7))) & 1);
+    }
+    return word;
+}
+
+static inline void flex_frame_write_word(uint8_t* buf, size_t bit, uint32_t word) {
+    for (int i = 31; i >= 0; i--, bit++) {
+        uint8_t mask = (uint8_t)(0x80 >> (bit & 7));
+        if ((word >> i) & 1) {
+            buf[bit >> 3] |= mask;
+        } else {
+            buf[bit >> 3] &= (uint8_t)~mask;
+        }
+    }
+}
+
+/*
+ * Bit offset of the FIW after the first sync 1 in buf (either polarity, *inverted set for
+ * the inverted one), or -1 when there is none with a whole word after it.
+ */
+static inline long flex_frame_find_fiw(const uint8_t* buf, size_t length, int* inverted) {
+    uint64_t window = 0;
+    size_t bits = length * 8;
+    for (size_t bit = 0; bit + 32 < bits; bit++) {
+        window = (window << 1) | ((buf[bit >> 3] >> (7 - (bit & 7))) & 1);
+        if (bit < 63) {
+            continue;
+        }
+        for (int polarity = 0; polarity < 2; polarity++) {
+            uint64_t sync = polarity ? ~window : window;
+            if ((uint32_t)(sync >> 16) == FLEX_SYNC_MARKER &&
+                (uint16_t)(sync >> 48) == (uint16_t)~(uint16_t)sync) {
+                *inverted = polarity;
+                return (long)(bit + 1);
+            }
+        }
+    }
+    return -1;
+}
+
+/*
+ * Reads the FIW of an encoded frame into *cycle and *frame. Returns 0 when there is no sync 1
+ * or the word fails its BCH or checksum check under both bit orders.
+ */
+static inline int flex_frame_get_fiw(const uint8_t* buf, size_t length, uint8_t* cycle, uint8_t* frame) {
+    int inverted = 0;
+    long bit = flex_frame_find_fiw(buf, length, &inverted);
+    if (bit < 0) {
+        return 0;
+    }
+
+    uint32_t word = flex_frame_read_word(buf, (size_t)bit);
+    if (inverted) {
+        word = ~word;
+    }
+    uint32_t fiw = flex_bit_reverse32(word);
+    if (!(flex_bch_valid(word, FLEX_BCH_GENERATOR) || flex_bch_valid(word, FLEX_BCH_GENERATOR_RECIPROCAL)) ||
+        !flex_fiw_checksum_ok(fiw)) {
+        return 0;
+    }
+    *cycle = (uint8_t)((fiw >> 4) & 0xF);
+    *frame = (uint8_t)((fiw >> 8) & 0x7F);
+    return 1;
+}
+
+/*
+ * Rewrites the FIW of an encoded frame for cycle/frame, keeping the encoder's polarity and
+ * BCH bit order. The frame is only touched when its FIW verifies under one of them, so an
+ * encoder layout this does not recognise is sent unchanged; returns 0 then.
+ */
+static inline int flex_frame_set_fiw(uint8_t* buf, size_t length, uint8_t cycle, uint8_t frame) {
+    int inverted = 0;
+    long bit = flex_frame_find_fiw(buf, length, &inverted);
+    if (bit < 0) {
+        return 0;
+    }
+
+    uint32_t word = flex_frame_read_word(buf, (size_t)bit);
+    if (inverted) {
+        word = ~word;
+    }
+    if (!flex_fiw_checksum_ok(flex_bit_reverse32(word))) {
+        return 0;
+    }
+
+    static const uint16_t generators[2] = { FLEX_BCH_GENERATOR, FLEX_BCH_GENERATOR_RECIPROCAL };
+    for (int i = 0; i < 2; i++) {
+        if (flex_bch_valid(word, generators[i])) {
+            uint32_t patched = flex_fiw_word(flex_fiw_build(cycle, frame), generators[i]);
+            flex_frame_write_word(buf, (size_t)bit, inverted ? ~patched : patched);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Bit offset of bit 0 of data word index (0-87) in a frame whose FIW starts at fiw_bit */
+static inline size_t flex_frame_data_bit(size_t fiw_bit, int index) {
+    return fiw_bit + 32 + FLEX_SYNC2_BITS_1600 + (size_t)(index / FLEX_BLOCK_WORDS) * FLEX_BLOCK_WORDS * 32 +
+           (size_t)(index % FLEX_BLOCK_WORDS);
+}
+
+/* Data word index in air order, undoing the block interleave (and the polarity when inverted) */
+static inline uint32_t flex_frame_read_data_word(const uint8_t* buf, size_t fiw_bit, int index, int inverted) {
+    size_t bit = flex_frame_data_bit(fiw_bit, index);
+    uint32_t word = 0;
+    for (int i = 0; i < 32; i++, bit += FLEX_BLOCK_WORDS) {
+        word = (word << 1) | ((buf[bit >> 3] >> (7 - (bit & 7))) & 1);
+    }
+    return inverted ? ~word : word;
+}
+
+static inline void flex_frame_write_data_word(uint8_t* buf, size_t fiw_bit, int index, int inverted, uint32_t word) {
+    size_t bit = flex_frame_data_bit(fiw_bit, index);
+    if (inverted) {
+        word = ~word;
+    }
+    for (int i = 31; i >= 0; i--, bit += FLEX_BLOCK_WORDS) {
+        uint8_t mask = (uint8_t)(0x80 >> (bit & 7));
+        if ((word >> i) & 1) {
+            buf[bit >> 3] |= mask;
+        } else {
+            buf[bit >> 3] &= (uint8_t)~mask;
+        }
+    }
+}
+
+/*
+ * Turns an encoded single-address alphanumeric page into one addressed to more pagers: each
+ * of capcodes gets an address word and its own copy of the vector, and every vector points at
+ * the one message. The block information word sits at word 0 with the address field from
+ * ((biw >> 8) & 3) + 1 to the vector field at (biw >> 10) & 0x3F, and vector i pairs with
+ * address i; an alpha vector holds the message start in bits 7-13 and its length in words in
+ * bits 14-20. The message and the words after the vector field move up to make room, so the
+ * number added is capped by the idle words at the end of the frame, and stops at the first
+ * capcode that needs a long address. The frame is only touched when its block information and
+ * vector words verify under the encoder's BCH bit order; returns how many capcodes were added,
+ * 0 when it was left as it was.
+ */
+static inline int flex_frame_add_addresses(uint8_t* buf, size_t length, const uint32_t* capcodes, int count) {
+    int inverted = 0;
+    long fiw_bit = flex_frame_find_fiw(buf, length, &inverted);
+    if (fiw_bit < 0 || flex_frame_data_bit((size_t)fiw_bit, 0) + FLEX_FRAME_WORDS * 32 > length * 8) {
+        return 0;
+    }
+
+    uint32_t words[FLEX_FRAME_WORDS];
+    for (int i = 0; i < FLEX_FRAME_WORDS; i++) {
+        words[i] = flex_frame_read_data_word(buf, (size_t)fiw_bit, i, inverted);
+    }
+
+    uint16_t generator = FLEX_BCH_GENERATOR;
+    if (!flex_bch_valid(words[0], generator)) {
+        generator = FLEX_BCH_GENERATOR_RECIPROCAL;
+    }
+    uint32_t biw = flex_word_info(words[0]);
+    int address_start = (int)((biw >> 8) & 0x3) + 1;
+    int vector_start = (int)((biw >> 10) & 0x3F);
+    if (!flex_bch_valid(words[0], generator) || !flex_fiw_checksum_ok(biw) || vector_start != address_start + 1) {
+        return 0;
+    }
+
+    uint32_t address = flex_word_info(words[address_start]);
+    uint32_t vector = flex_word_info(words[vector_start]);
+    int message_start = (int)((vector >> 7) & 0x7F);
+    int message_end = message_start + (int)((vector >> 14) & 0x7F);
+    if (!flex_bch_valid(words[address_start], generator) || !flex_bch_valid(words[vector_start], generator) ||
+        address <= FLEX_SHORT_ADDRESS_OFFSET || address > FLEX_SHORT_ADDRESS_OFFSET + FLEX_SHORT_CAPCODE_MAX ||
+        !flex_fiw_checksum_ok(vector) || ((vector >> 4) & 0x7) != FLEX_VECTOR_ALPHA ||
+        message_start <= vector_start || message_end > FLEX_FRAME_WORDS) {
+        return 0;
+    }
+
+    int added = 0;
+    while (added < count && capcodes[added] >= 1 && capcodes[added] <= FLEX_SHORT_CAPCODE_MAX &&
+           message_end + 2 * (added + 1) <= FLEX_FRAME_WORDS && vector_start + added + 1 <= 0x3F) {
+        added++;
+    }
+    if (added == 0) {
+        return 0;
+    }
+
+    int shift = 2 * added;
+    for (int i = FLEX_FRAME_WORDS - 1; i >= vector_start + 1 + shift; i--) {
+        words[i] = words[i - shift];
+    }
+    vector_start += added;
+    words[0] = flex_word_build(flex_checksum_set((biw & ~(0x3FUL << 10)) | ((uint32_t)vector_start << 10)), generator);
+    vector = flex_checksum_set((vector & ~(0x7FUL << 7)) | ((uint32_t)(message_start + shift) << 7));
+    for (int i = 0; i <= added; i++) {
+        if (i > 0) {
+            words[address_start + i] = flex_word_build(capcodes[i - 1] + FLEX_SHORT_ADDRESS_OFFSET, generator);
+        }
+        words[vector_start + i] = flex_word_build(vector, generator);
+    }
+
+    for (int i = 0; i < FLEX_FRAME_WORDS; i++) {
+        flex_frame_write_data_word(buf, (size_t)fiw_bit, i, inverted, words[i]);
+    }
+    return added;
+}
+
+#endif /* FLEX_FRAME_H */
@@ -0,0 +1,31 @@
+#ifndef LOG_TIME_H
+#define LOG_TIME_H
+
+/* Log line timestamp parsing for the persistent log index, shared by the v3.6 firmware and the host tests */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// "YYYY-MM-DD HH:MM:SS" (or with a 'T') as seconds since 1970 in device-local time, the clock
+// getLocalTimestamp() keeps; 0 for the uptime stamps written before the clock is set
+static inline uint32_t log_line_time(const char* line, size_t len) {
+    if (len < 19 || line[4] != '-' || line[7] != '-' || line[13] != ':' || line[16] != ':') return 0;
+
+    int year = atoi(line);
+    int month = atoi(line + 5);
+    int day = atoi(line + 8);
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+
+    // Days from civil date (proleptic Gregorian)
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days = (uint32_t)(era * 146097 + doe - 719468);
+
+    return days * 86400 + atoi(line + 11) * 3600 + atoi(line + 14) * 60 + atoi(line + 17);
+}
+
+#endif /* LOG_TIME_H */
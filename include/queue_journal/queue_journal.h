@@ -0,0 +1,139 @@
+#ifndef QUEUE_JOURNAL_H
+#define QUEUE_JOURNAL_H
+
+/* Queue journal entry format (/qjournalN.bin), shared by the v3.6 firmware and the host tests */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * A segment is a JournalSegmentHeader followed by entries: a JournalEntryHeader, then
+ * payload_length bytes. The magic doubles as the format version; v1 segments carry the
+ * shorter enqueue payload without the repeat fields and are still read back.
+ */
+#define JOURNAL_MAGIC_V1          0x4A514631UL
+#define JOURNAL_MAGIC             0x4A514632UL    /* v2: repeat/repeat_interval_s added */
+#define JOURNAL_ENTRY_ENQUEUE     1
+#define JOURNAL_ENTRY_COMPLETE    2
+
+/* Older journals stored a plain 0/1 mail drop byte in flags; the other bits are ignored on replay */
+#define JOURNAL_FLAG_MAIL_DROP    0x01
+
+struct JournalSegmentHeader {
+    uint32_t magic;
+    uint32_t generation;
+};
+
+struct JournalEntryHeader {
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t payload_length;
+    uint32_t seq;
+    uint32_t crc;
+};
+
+struct JournalEnqueuePayload {
+    uint32_t capcode;
+    float frequency;
+    int8_t power;
+    uint8_t flags;                  /* JOURNAL_FLAG_MAIL_DROP */
+    uint8_t source;
+    uint8_t id_length;              /* Tail is the text, a NUL, then id_length ID bytes; group pages add
+                                       a NUL and the member capcodes */
+    uint8_t repeat;                 /* v2: extra copies still owed, 0 in v1 entries */
+    uint8_t reserved;
+    uint16_t repeat_interval_s;     /* v2: 0 in v1 entries */
+};
+
+#define JOURNAL_ENQUEUE_HEAD_V1   12    /* sizeof(JournalEnqueuePayload) up to id_length */
+
+/* An ENQUEUE payload split into its parts; the pointers refer to the payload bytes */
+struct JournalEnqueueView {
+    struct JournalEnqueuePayload payload;
+    const char* message;
+    size_t message_length;
+    const char* message_id;
+    size_t id_length;
+    const uint8_t* group_capcodes;  /* group_count native-order uint32_t, unaligned */
+    size_t group_count;
+};
+
+static inline uint32_t journal_crc32(const void* data, size_t len, uint32_t crc) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            uint32_t mask = -(crc & 1);
+            crc = (crc >> 1) ^ (0xEDB88320 & mask);
+        }
+    }
+    return crc;
+}
+
+static inline void journal_build_entry(struct JournalEntryHeader* entry, uint8_t type, uint32_t seq,
+                                       const void* head, size_t head_len, const void* tail, size_t tail_len) {
+    memset(entry, 0, sizeof(*entry));
+    entry->type = type;
+    entry->payload_length = (uint16_t)(head_len + tail_len);
+    entry->seq = seq;
+
+    uint32_t crc = journal_crc32(entry, sizeof(*entry), 0xFFFFFFFF);
+    crc = journal_crc32(head, head_len, crc);
+    crc = journal_crc32(tail, tail_len, crc);
+    entry->crc = ~crc;
+}
+
+/* True when payload (entry->payload_length bytes) matches the entry's CRC */
+static inline int journal_entry_valid(const struct JournalEntryHeader* entry, const uint8_t* payload) {
+    struct JournalEntryHeader unsigned_entry = *entry;
+    unsigned_entry.crc = 0;
+    uint32_t crc = journal_crc32(&unsigned_entry, sizeof(unsigned_entry), 0xFFFFFFFF);
+    crc = ~journal_crc32(payload, entry->payload_length, crc);
+    return crc == entry->crc;
+}
+
+/*
+ * Splits an ENQUEUE payload from a segment with the given magic. The text is cut at message_max
+ * and the member list at members_max; an ID longer than id_max or past the payload is dropped,
+ * as are members after it (entries written before message IDs existed carry neither). Returns 0
+ * when the payload is too short for its version's fixed part.
+ */
+static inline int journal_parse_enqueue(const uint8_t* data, size_t length, uint32_t magic,
+                                        size_t message_max, size_t id_max, size_t members_max,
+                                        struct JournalEnqueueView* view) {
+    size_t head_length = (magic == JOURNAL_MAGIC_V1) ? JOURNAL_ENQUEUE_HEAD_V1 : sizeof(struct JournalEnqueuePayload);
+    if (length < head_length) {
+        return 0;
+    }
+
+    memset(view, 0, sizeof(*view));
+    memcpy(&view->payload, data, head_length);
+
+    const char* tail = (const char*)data + head_length;
+    size_t tail_length = length - head_length;
+    size_t message_length = 0;
+    size_t limit = (tail_length < message_max) ? tail_length : message_max;
+    while (message_length < limit && tail[message_length] != '\0') {
+        message_length++;
+    }
+    view->message = tail;
+    view->message_length = message_length;
+
+    size_t id_length = view->payload.id_length;
+    if (id_length > id_max || message_length + 1 + id_length > tail_length) {
+        return 1;
+    }
+    view->message_id = tail + message_length + 1;
+    view->id_length = id_length;
+
+    size_t group_offset = message_length + 1 + id_length + 1;
+    if (group_offset < tail_length) {
+        size_t members = (tail_length - group_offset) / sizeof(uint32_t);
+        view->group_capcodes = (const uint8_t*)tail + group_offset;
+        view->group_count = (members < members_max) ? members : members_max;
+    }
+    return 1;
+}
+
+#endif /* QUEUE_JOURNAL_H */
@@ -0,0 +1,66 @@
+#ifndef SYSLOG_FORMAT_H
+#define SYSLOG_FORMAT_H
+
+/* Remote syslog record formatting, shared by the v3.6 firmware and the host tests */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define SYSLOG_FACILITY_LOCAL0  16
+#define SYSLOG_HOSTNAME_MAX     32
+
+/*
+ * RFC 3164 line: <PRI>Mmm dd HH:MM:SS host tag: message. The day is space padded as the RFC
+ * requires and spaces in host become '-', since the header fields are space separated.
+ * Returns the line length, clamped to size - 1 when it had to be truncated.
+ */
+static inline size_t syslog_format_line(char* out, size_t size, uint8_t severity, const struct tm* when,
+                                        const char* host, const char* tag, const char* message) {
+    if (size == 0) {
+        return 0;
+    }
+
+    char timestamp[16];
+    if (strftime(timestamp, sizeof(timestamp), "%b %e %H:%M:%S", when) == 0) {
+        timestamp[0] = '\0';
+    }
+
+    char hostname[SYSLOG_HOSTNAME_MAX + 1];
+    size_t i = 0;
+    for (; host[i] != '\0' && i < SYSLOG_HOSTNAME_MAX; i++) {
+        hostname[i] = (host[i] == ' ') ? '-' : host[i];
+    }
+    hostname[i] = '\0';
+
+    int len = snprintf(out, size, "<%u>%s %s %s: %s", (unsigned)(SYSLOG_FACILITY_LOCAL0 * 8 + severity),
+                       timestamp, hostname, tag, message);
+    if (len < 0) {
+        out[0] = '\0';
+        return 0;
+    }
+    return ((size_t)len < size) ? (size_t)len : size - 1;
+}
+
+/*
+ * RFC 5425/6587 octet-counted frame: "<length> <line>". Returns the frame size, or 0 when the
+ * whole frame does not fit in size bytes; a cut frame would desynchronise the TCP stream, so
+ * nothing is written then.
+ */
+static inline size_t syslog_frame_octets(char* out, size_t size, const char* line, size_t length) {
+    char prefix[12];
+    int prefix_length = snprintf(prefix, sizeof(prefix), "%u ", (unsigned)length);
+    if (prefix_length < 0 || (size_t)prefix_length + length > size) {
+        return 0;
+    }
+    for (int i = 0; i < prefix_length; i++) {
+        out[i] = prefix[i];
+    }
+    for (size_t i = 0; i < length; i++) {
+        out[prefix_length + i] = line[i];
+    }
+    return (size_t)prefix_length + length;
+}
+
+#endif /* SYSLOG_FORMAT_H */
@@ -0,0 +1,147 @@
+#ifndef UTF8_TRANSLIT_H
+#define UTF8_TRANSLIT_H
+
+/* UTF-8 to ASCII transliteration for FLEX pages, shared by the v3.6 firmware and the host tests */
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ASCII transliteration of U+00A0..U+017F (Latin-1 Supplement, Latin Extended-A), indexed by
+// code point - 0xA0. Entries are at most 2 chars so a 2-byte UTF-8 sequence never grows.
+static const char utf8_latin_map[][3] = {
+    " ",  "!",  "c",  "L",  "?",  "Y",  "|",  "S",  "\"", "C",  "a",  "<<", "-",  "",   "R",  "-",    // A0
+    "^",  "+-", "2",  "3",  "'",  "u",  "P",  ".",  ",",  "1",  "o",  ">>", "?",  "?",  "?",  "?",    // B0
+    "A",  "A",  "A",  "A",  "A",  "A",  "AE", "C",  "E",  "E",  "E",  "E",  "I",  "I",  "I",  "I",    // C0
+    "D",  "N",  "O",  "O",  "O",  "O",  "O",  "x",  "O",  "U",  "U",  "U",  "U",  "Y",  "TH", "ss",   // D0
+    "a",  "a",  "a",  "a",  "a",  "a",  "ae", "c",  "e",  "e",  "e",  "e",  "i",  "i",  "i",  "i",    // E0
+    "d",  "n",  "o",  "o",  "o",  "o",  "o",  "/",  "o",  "u",  "u",  "u",  "u",  "y",  "th", "y",    // F0
+    "A",  "a",  "A",  "a",  "A",  "a",  "C",  "c",  "C",  "c",  "C",  "c",  "C",  "c",  "D",  "d",    // 100
+    "D",  "d",  "E",  "e",  "E",  "e",  "E",  "e",  "E",  "e",  "E",  "e",  "G",  "g",  "G",  "g",    // 110
+    "G",  "g",  "G",  "g",  "H",  "h",  "H",  "h",  "I",  "i",  "I",  "i",  "I",  "i",  "I",  "i",    // 120
+    "I",  "i",  "IJ", "ij", "J",  "j",  "K",  "k",  "k",  "L",  "l",  "L",  "l",  "L",  "l",  "L",    // 130
+    "l",  "L",  "l",  "N",  "n",  "N",  "n",  "N",  "n",  "n",  "N",  "n",  "O",  "o",  "O",  "o",    // 140
+    "O",  "o",  "OE", "oe", "R",  "r",  "R",  "r",  "R",  "r",  "S",  "s",  "S",  "s",  "S",  "s",    // 150
+    "S",  "s",  "T",  "t",  "T",  "t",  "T",  "t",  "U",  "u",  "U",  "u",  "U",  "u",  "U",  "u",    // 160
+    "U",  "u",  "U",  "u",  "W",  "w",  "Y",  "y",  "Y",  "Z",  "z",  "Z",  "z",  "Z",  "z",  "s"     // 170
+};
+
+// Punctuation outside the Latin blocks, sorted by code point (all 3-byte UTF-8, so <= 3 chars)
+static const struct {
+    uint16_t code_point;
+    char ascii[4];
+} utf8_punctuation_map[] = {
+    {0x2002, " "},  {0x2003, " "},  {0x2004, " "},  {0x2005, " "},  {0x2006, " "},  {0x2007, " "},
+    {0x2008, " "},  {0x2009, " "},  {0x200A, " "},  {0x200B, ""},   {0x200C, ""},   {0x200D, ""},
+    {0x2010, "-"},  {0x2011, "-"},  {0x2012, "-"},  {0x2013, "-"},  {0x2014, "-"},  {0x2015, "-"},
+    {0x2018, "'"},  {0x2019, "'"},  {0x201A, "'"},  {0x201B, "'"},  {0x201C, "\""}, {0x201D, "\""},
+    {0x201E, "\""}, {0x201F, "\""}, {0x2020, "+"},  {0x2022, "*"},  {0x2026, "..."}, {0x2030, "%"},
+    {0x2032, "'"},  {0x2033, "\""}, {0x2039, "<"},  {0x203A, ">"},  {0x2044, "/"},  {0x20AC, "EUR"},
+    {0x2122, "TM"}, {0x2212, "-"},  {0xFEFF, ""}
+};
+
+static inline const char* utf8_lookup_ascii(uint32_t code_point) {
+    if (code_point >= 0xA0 && code_point <= 0x17F) {
+        return utf8_latin_map[code_point - 0xA0];
+    }
+
+    int low = 0;
+    int high = (int)(sizeof(utf8_punctuation_map) / sizeof(utf8_punctuation_map[0])) - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (utf8_punctuation_map[mid].code_point == code_point) {
+            return utf8_punctuation_map[mid].ascii;
+        }
+        if (utf8_punctuation_map[mid].code_point < code_point) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return nullptr;
+}
+
+// Single-pass, in-place UTF-8 to ASCII transliteration. Output never outgrows the input, so
+// text is rewritten front to back; unmapped or malformed sequences become '?'. The buffer
+// must hold length + 1 bytes. Returns the new length.
+static inline size_t utf8_transliterate(char* text, size_t length) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < length) {
+        uint8_t lead = (uint8_t)text[in];
+        if (lead < 0x80) {
+            text[out++] = (char)lead;
+            in++;
+            continue;
+        }
+
+        uint32_t code_point;
+        size_t sequence_length;
+        if ((lead & 0xE0) == 0xC0) {
+            code_point = lead & 0x1F;
+            sequence_length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            code_point = lead & 0x0F;
+            sequence_length = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+            code_point = lead & 0x07;
+            sequence_length = 4;
+        } else {
+            text[out++] = '?';
+            in++;
+            continue;
+        }
+
+        size_t i = 1;
+        while (i < sequence_length && in + i < length && ((uint8_t)text[in + i] & 0xC0) == 0x80) {
+            code_point = (code_point << 6) | ((uint8_t)text[in + i] & 0x3F);
+            i++;
+        }
+        in += i;
+
+        const char* ascii = (i == sequence_length) ? utf8_lookup_ascii(code_point) : nullptr;
+        if (ascii == nullptr) {
+            text[out++] = '?';
+            continue;
+        }
+        while (*ascii != '\0') {
+            text[out++] = *ascii++;
+        }
+    }
+
+    text[out] = '\0';
+    return out;
+}
+
+// Transliterates message into out (max_length + 1 bytes) for one page. At most max_length * 4
+// input bytes are converted in scratch (max_length * 4 + 1 bytes); when the converted text is
+// longer than max_length, or input was left over, it is cut and ends in "...". The ellipsis
+// goes right after the converted text when that is short (input of dropped code points such as
+// U+200B can be long yet convert to little), so no unconverted scratch bytes are ever copied.
+// Returns the length of out; *truncated is set when the text was cut.
+static inline size_t utf8_prepare_page(char* out, size_t max_length, const char* message, char* scratch,
+                                       int* truncated) {
+    size_t input_length = 0;
+    while (message[input_length] != '\0') {
+        input_length++;
+    }
+    size_t copy_length = (input_length < max_length * 4) ? input_length : max_length * 4;
+    for (size_t i = 0; i < copy_length; i++) {
+        scratch[i] = message[i];
+    }
+    size_t length = utf8_transliterate(scratch, copy_length);
+
+    *truncated = (length > max_length || copy_length < input_length);
+    if (*truncated) {
+        size_t keep = (length < max_length - 3) ? length : max_length - 3;
+        scratch[keep] = scratch[keep + 1] = scratch[keep + 2] = '.';
+        length = keep + 3;
+    }
+    for (size_t i = 0; i < length; i++) {
+        out[i] = scratch[i];
+    }
+    out[length] = '\0';
+    return length;
+}
+
+#endif /* UTF8_TRANSLIT_H */
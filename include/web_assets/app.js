@@ -0,0 +1,123 @@
+function showTempMessage(message, type, duration) {
+  var msgDiv = document.getElementById('temp-message');
+  if (!msgDiv) {
+    msgDiv = document.createElement('div');
+    msgDiv.id = 'temp-message';
+    document.body.appendChild(msgDiv);
+  }
+  msgDiv.textContent = message;
+  msgDiv.className = type + ' show';
+  setTimeout(function() {
+    msgDiv.classList.remove('show');
+  }, duration || 5000);
+}
+var themes = [
+  {bg:'#FFFFFF',card:'#F8F9FA',text:'#222222',accent:'#333333',button:'#333333',buttonHover:'#000000',input:'#FFFFFF',border:'#E0E0E0',navActive:'#333333',navInactive:'#999999'},
+  {bg:'#121212',card:'#1E1E1E',text:'#E0E0E0',accent:'#FFFFFF',button:'#404040',buttonHover:'#555555',input:'#2A2A2A',border:'#404040',navActive:'#404040',navInactive:'#888888'}
+];
+function applyTheme(themeIndex) {
+  var theme = themes[themeIndex];
+  var root = document.documentElement;
+  root.style.setProperty('--theme-bg', theme.bg);
+  root.style.setProperty('--theme-card', theme.card);
+  root.style.setProperty('--theme-text', theme.text);
+  root.style.setProperty('--theme-accent', theme.accent);
+  root.style.setProperty('--theme-button', theme.button);
+  root.style.setProperty('--theme-button-hover', theme.buttonHover);
+  root.style.setProperty('--theme-input', theme.input);
+  root.style.setProperty('--theme-border', theme.border);
+  root.style.setProperty('--theme-nav-active', theme.navActive);
+  root.style.setProperty('--theme-nav-inactive', theme.navInactive);
+}
+function onThemeChange() {
+  var themeSelect = document.getElementById('theme');
+  if (themeSelect) {
+    applyTheme(parseInt(themeSelect.value));
+  }
+}
+function submitFormAjax(form, successMsg, restartMsg) {
+  var formData = new FormData(form);
+  fetch(form.action, { method: 'POST', body: formData })
+  .then(response => response.json())
+  .then(data => {
+    if (data.success) {
+      if (data.restart) {
+        showTempMessage(restartMsg || 'Settings saved, restarting in 5 seconds...', 'info', 5000);
+        setTimeout(() => location.reload(), 5000);
+      } else {
+        showTempMessage(successMsg || 'Settings saved successfully!', 'success', 5000);
+      }
+    } else {
+      showTempMessage('Error: ' + (data.error || 'Failed to save settings'), 'error', 5000);
+    }
+  })
+  .catch(() => showTempMessage('Network error occurred', 'error', 5000));
+  return false;
+}
+function pollLogs() {
+  fetch('/logs')
+    .then(response => response.json())
+    .then(data => {
+      if (data.logs && data.logs.length > 0) {
+        data.logs.forEach(log => {
+          if (log.timestamp > lastLogTimestamp) {
+            lastLogTimestamp = Math.max(lastLogTimestamp, log.timestamp);
+          }
+        });
+      }
+    })
+    .catch(() => {});
+}
+function updateServerSettings() {
+  var serverInput = document.getElementById('imap_server');
+  var portField = document.getElementById('imap_port');
+  var sslField = document.getElementById('imap_use_ssl');
+  
+  if (serverInput.value === 'imap.gmail.com' || serverInput.value === 'outlook.office365.com' || serverInput.value === 'imap.mail.yahoo.com') {
+    portField.value = '993';
+    sslField.value = '1';
+  }
+}
+function updateToggleVisual(checkbox) {
+  var toggle = checkbox.parentElement;
+  var slider = toggle.querySelector('.toggle-slider');
+  if (checkbox.checked) {
+    toggle.classList.add('is-active');
+    toggle.classList.remove('is-inactive');
+    slider.classList.add('is-active');
+    slider.classList.remove('is-inactive');
+  } else {
+    toggle.classList.add('is-inactive');
+    toggle.classList.remove('is-active');
+    slider.classList.add('is-inactive');
+    slider.classList.remove('is-active');
+  }
+}
+function universalToggleSwitch(switchElement, hiddenInputId, callback) {
+  var slider = switchElement.querySelector('.toggle-slider');
+  var hiddenInput = hiddenInputId ? document.getElementById(hiddenInputId) : null;
+  var currentEnabled = switchElement.classList.contains('is-active');
+  var newEnabled = !currentEnabled;
+  if (newEnabled) {
+    switchElement.classList.add('is-active');
+    switchElement.classList.remove('is-inactive');
+    slider.classList.add('is-active');
+    slider.classList.remove('is-inactive');
+  } else {
+    switchElement.classList.add('is-inactive');
+    switchElement.classList.remove('is-active');
+    slider.classList.add('is-inactive');
+    slider.classList.remove('is-active');
+  }
+  if (hiddenInput) hiddenInput.value = newEnabled ? '1' : '0';
+  if (callback) callback(newEnabled);
+  return newEnabled;
+}
+document.addEventListener('DOMContentLoaded', function() {
+  var toggles = document.querySelectorAll('.toggle-switch input[type="checkbox"]');
+  toggles.forEach(function(toggle) {
+    toggle.addEventListener('change', function() {
+      updateToggleVisual(this);
+    });
+  });
+});
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Regenerates web_assets.h from the stylesheets and script in this directory.
+
+Each asset is gzip-compressed (mtime 0, so output is reproducible) and embedded as a
+byte array; the ETag is derived from the uncompressed content. Run after editing any
+of the source files:
+
+    python3 include/web_assets/gen_web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# (symbol, URL path, content type, source files concatenated in order)
+ASSETS = [
+    ("THEME_LIGHT_CSS", "/assets/theme-0.css", "text/css", ["theme-light.css", "base.css"]),
+    ("THEME_DARK_CSS", "/assets/theme-1.css", "text/css", ["theme-dark.css", "base.css"]),
+    ("APP_JS", "/assets/app.js", "application/javascript", ["app.js"]),
+]
+
+
+def read_sources(names):
+    content = b""
+    for name in names:
+        with open(os.path.join(HERE, name), "rb") as source:
+            content += source.read()
+    return content
+
+
+def byte_lines(data, per_line=12):
+    for offset in range(0, len(data), per_line):
+        yield "    " + " ".join("0x%02x," % b for b in data[offset:offset + per_line])
+
+
+def main():
+    out = []
+    out.append("#ifndef WEB_ASSETS_H")
+    out.append("#define WEB_ASSETS_H")
+    out.append("")
+    out.append("/* Generated by gen_web_assets.py from the .css/.js files in this directory - do not edit */")
+    out.append("")
+    out.append("#include <stddef.h>")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append("struct WebAsset {")
+    out.append("    const char* path;")
+    out.append("    const char* content_type;")
+    out.append("    const char* etag;               /* Quoted, as sent in the ETag header */")
+    out.append("    const uint8_t* data;            /* gzip */")
+    out.append("    size_t length;")
+    out.append("    size_t raw_length;")
+    out.append("};")
+    out.append("")
+
+    table = []
+    for symbol, path, content_type, sources in ASSETS:
+        raw = read_sources(sources)
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(raw).hexdigest()[:16]
+
+        out.append("/* %s: %d bytes, %d gzipped */" % (" + ".join(sources), len(raw), len(packed)))
+        out.append("static const uint8_t WEB_ASSET_%s_GZ[] = {" % symbol)
+        out.extend(byte_lines(packed))
+        out.append("};")
+        out.append("")
+        table.append('    { "%s", "%s", "\\"%s\\"", WEB_ASSET_%s_GZ, sizeof(WEB_ASSET_%s_GZ), %d },'
+                     % (path, content_type, etag, symbol, symbol, len(raw)))
+
+    out.append("enum {")
+    for symbol, _, _, _ in ASSETS:
+        out.append("    WEB_ASSET_%s," % symbol)
+    out.append("    WEB_ASSET_COUNT")
+    out.append("};")
+    out.append("")
+    out.append("static const struct WebAsset web_assets[WEB_ASSET_COUNT] = {")
+    out.extend(table)
+    out.append("};")
+    out.append("")
+    out.append("#endif /* WEB_ASSETS_H */")
+
+    with open(os.path.join(HERE, "web_assets.h"), "w") as header:
+        header.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,526 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+/* Generated by gen_web_assets.py from the .css/.js files in this directory - do not edit */
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct WebAsset {
+    const char* path;
+    const char* content_type;
+    const char* etag;               /* Quoted, as sent in the ETag header */
+    const uint8_t* data;            /* gzip */
+    size_t length;
+    size_t raw_length;
+};
+
+/* theme-light.css + base.css: 8830 bytes, 2145 gzipped */
+static const uint8_t WEB_ASSET_THEME_LIGHT_CSS_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x59,
+    0x5b, 0x6f, 0xe3, 0xba, 0x11, 0x7e, 0xcf, 0xaf, 0x60, 0xb1, 0x38, 0x48,
+    0x8c, 0x5a, 0xae, 0x2c, 0xc7, 0x5e, 0x27, 0x46, 0x1f, 0xce, 0x16, 0x1b,
+    0xe0, 0xbc, 0xf4, 0xa5, 0x28, 0xd0, 0xa2, 0xe8, 0x03, 0x2d, 0xd1, 0x36,
+    0xbb, 0x92, 0x28, 0x50, 0x74, 0x9c, 0xec, 0xc1, 0xfe, 0xf7, 0xce, 0x90,
+    0xba, 0x90, 0x12, 0x75, 0xc9, 0x1e, 0x1b, 0x09, 0x12, 0x91, 0xc3, 0xb9,
+    0x7f, 0x33, 0x43, 0x3d, 0x4b, 0x21, 0x14, 0xf9, 0xfd, 0x8e, 0x90, 0x20,
+    0x50, 0x17, 0x96, 0xb1, 0xe0, 0x78, 0x7e, 0x26, 0x9f, 0x5e, 0xf4, 0xe7,
+    0x60, 0x3d, 0x8e, 0xa9, 0x4c, 0x70, 0x61, 0xff, 0xf2, 0xf4, 0xf2, 0xab,
+    0xbd, 0xa0, 0xd8, 0x9b, 0x82, 0x85, 0x48, 0x7f, 0xec, 0x05, 0x1a, 0xc7,
+    0x2c, 0xc7, 0xa5, 0x8d, 0xfe, 0xd8, 0x4b, 0xc7, 0xab, 0x52, 0x22, 0x1f,
+    0x59, 0x0a, 0x2e, 0xe2, 0x95, 0x49, 0xd8, 0x10, 0xea, 0x8f, 0xbd, 0x81,
+    0xe7, 0xc5, 0x55, 0x79, 0x45, 0x3c, 0x0a, 0x99, 0x68, 0xa2, 0xaf, 0x21,
+    0x7e, 0xed, 0xa5, 0x9c, 0xbe, 0x82, 0x3c, 0x8a, 0xbf, 0x32, 0x2f, 0x53,
+    0x5c, 0xe6, 0x79, 0xb3, 0xe1, 0x49, 0x7f, 0x9c, 0xa3, 0x69, 0xfc, 0xed,
+    0x2c, 0xc5, 0x35, 0x4f, 0xbc, 0x9c, 0x91, 0xbe, 0x96, 0xf8, 0x25, 0xc4,
+    0xef, 0xe1, 0xee, 0xc7, 0xdd, 0x51, 0x24, 0xef, 0xe4, 0x77, 0x72, 0x12,
+    0xb9, 0x0a, 0x4e, 0x34, 0xe3, 0xe9, 0xfb, 0x33, 0xb9, 0xff, 0x07, 0x3b,
+    0x0b, 0x46, 0xfe, 0xf9, 0xdb, 0xfd, 0x92, 0xfc, 0x2a, 0x39, 0x4d, 0x97,
+    0xa4, 0xa4, 0x79, 0x19, 0x94, 0x4c, 0xf2, 0xd3, 0x81, 0x64, 0x54, 0x9e,
+    0x39, 0x18, 0x26, 0x3c, 0x90, 0x82, 0x26, 0x09, 0xcf, 0xc1, 0x19, 0x51,
+    0x58, 0xbc, 0x1d, 0x48, 0x2b, 0x41, 0x10, 0x8b, 0x54, 0x00, 0xa7, 0x57,
+    0x2a, 0x1f, 0x5a, 0xa7, 0x2d, 0x0e, 0xc4, 0xf3, 0x1c, 0x9d, 0x03, 0x2b,
+    0x29, 0xcf, 0x59, 0x70, 0x61, 0xfc, 0x7c, 0x01, 0xcb, 0xad, 0x57, 0xbb,
+    0x03, 0x51, 0x12, 0xb8, 0x72, 0xc5, 0xd1, 0x0b, 0x34, 0x4d, 0x49, 0xb8,
+    0xda, 0x94, 0x84, 0xd1, 0x92, 0x1d, 0xc8, 0x8f, 0xbb, 0x55, 0x0c, 0x22,
+    0x53, 0xa0, 0x91, 0x20, 0x7e, 0x46, 0xdf, 0x82, 0x1b, 0x4f, 0xd4, 0xe5,
+    0x99, 0xec, 0x43, 0x2d, 0x4a, 0x23, 0x24, 0xa1, 0x57, 0x25, 0xa6, 0x44,
+    0xc3, 0xc0, 0x59, 0x58, 0xea, 0x6c, 0x8c, 0x3a, 0xda, 0x57, 0x81, 0xa4,
+    0x09, 0xbf, 0x96, 0x20, 0xd3, 0xce, 0x3c, 0x7c, 0x0b, 0xca, 0x0b, 0x4d,
+    0xc4, 0x0d, 0x0f, 0xdf, 0x17, 0x6f, 0x64, 0x13, 0xc1, 0x2f, 0x79, 0x3e,
+    0xd2, 0x87, 0x70, 0xa9, 0xbf, 0xab, 0xf5, 0xa2, 0x26, 0x06, 0x2a, 0x58,
+    0x2c, 0x45, 0xca, 0x13, 0xd7, 0x16, 0x7a, 0x75, 0x31, 0xa5, 0xe3, 0x85,
+    0xd1, 0x44, 0x2b, 0x88, 0x36, 0x0a, 0x68, 0xca, 0xcf, 0xb0, 0x0d, 0x23,
+    0x96, 0xc9, 0x5a, 0x45, 0x38, 0x0a, 0x82, 0x31, 0xab, 0x65, 0x6e, 0x89,
+    0x2e, 0x6b, 0xa0, 0xf3, 0xe8, 0x6a, 0x42, 0x7e, 0xe1, 0xf8, 0x51, 0xbb,
+    0xbf, 0xe4, 0xdf, 0x21, 0xb0, 0xa2, 0x55, 0xc4, 0xb2, 0xea, 0xc9, 0xad,
+    0xf2, 0xc6, 0x06, 0xa2, 0x9b, 0xa4, 0x4c, 0x01, 0xdb, 0xa0, 0x2c, 0x68,
+    0xac, 0x6d, 0x14, 0x84, 0xab, 0x2d, 0x72, 0xb4, 0x35, 0xd0, 0xec, 0xfc,
+    0x3a, 0x14, 0x7e, 0x69, 0x2a, 0xe7, 0xd7, 0xb2, 0xac, 0x41, 0x09, 0x30,
+    0x6b, 0x88, 0x42, 0x09, 0xe4, 0xa4, 0x20, 0x1e, 0xc3, 0xd5, 0x7e, 0x9a,
+    0xcd, 0x49, 0xc8, 0x2c, 0x40, 0x0f, 0x17, 0x3a, 0x1e, 0x1c, 0xd3, 0x44,
+    0x8f, 0x95, 0x69, 0xac, 0x4d, 0x29, 0x3d, 0xb2, 0x14, 0xb6, 0x26, 0xbc,
+    0x2c, 0x52, 0x0a, 0x5c, 0x8e, 0xa9, 0x88, 0xbf, 0xf5, 0xac, 0xba, 0x47,
+    0x4a, 0xc7, 0x18, 0x5b, 0x34, 0xc6, 0xb0, 0x26, 0x96, 0x29, 0xd7, 0x8f,
+    0x73, 0xec, 0x63, 0xc9, 0xa4, 0x61, 0x63, 0x49, 0xec, 0x47, 0x25, 0x4b,
+    0x59, 0xdc, 0x79, 0x86, 0x9c, 0xa8, 0x64, 0x14, 0x9e, 0x6a, 0x8a, 0xa0,
+    0x54, 0x09, 0x68, 0x52, 0x25, 0xc0, 0x3a, 0x0c, 0x7f, 0xb1, 0x42, 0x19,
+    0x85, 0x68, 0x42, 0xd7, 0x84, 0x64, 0x34, 0x1e, 0x92, 0xdd, 0xb0, 0x8f,
+    0x1a, 0x13, 0x54, 0x6a, 0xb5, 0x79, 0xc0, 0xbf, 0x6b, 0x1e, 0x15, 0x05,
+    0x3c, 0x9a, 0x4a, 0x34, 0x2d, 0xef, 0x28, 0x0c, 0x8c, 0x27, 0x44, 0xd7,
+    0x58, 0xcf, 0x27, 0x11, 0x5f, 0x4b, 0x9f, 0xc9, 0x7c, 0x2b, 0xb5, 0xe1,
+    0x9a, 0xb5, 0xc6, 0x7c, 0xe6, 0x09, 0x18, 0x51, 0x5c, 0x15, 0x02, 0xd1,
+    0x33, 0xc9, 0x45, 0xce, 0x1a, 0x5b, 0x8c, 0xa5, 0x91, 0x0b, 0x08, 0xf8,
+    0xdd, 0x80, 0x7d, 0x3d, 0x5b, 0xa3, 0xb0, 0xd2, 0x0e, 0x25, 0x7a, 0x36,
+    0x7f, 0xa6, 0x54, 0xb1, 0x7f, 0x3f, 0x04, 0x00, 0x12, 0x0b, 0xad, 0x9f,
+    0xa9, 0x2c, 0x20, 0xc7, 0x04, 0x94, 0xea, 0x6d, 0xad, 0x1d, 0x6f, 0x17,
+    0xae, 0x58, 0xd7, 0xe9, 0xd1, 0xde, 0x76, 0xba, 0xa3, 0x8f, 0xeb, 0xdb,
+    0xf8, 0x2a, 0x4b, 0x3c, 0xa5, 0x10, 0xdc, 0x20, 0x4b, 0xcf, 0xd9, 0xfd,
+    0x04, 0xd0, 0x80, 0x94, 0xb0, 0x58, 0x48, 0x6a, 0x7c, 0x65, 0xce, 0x6f,
+    0xb2, 0x89, 0xe7, 0x1a, 0xcf, 0x9d, 0xa4, 0xd2, 0xd9, 0x44, 0x76, 0xdd,
+    0xa4, 0xe8, 0x7b, 0xb9, 0x2a, 0xbd, 0xba, 0x5a, 0xcd, 0xb4, 0x85, 0x29,
+    0x6d, 0x8b, 0x41, 0x0b, 0x47, 0xda, 0xc2, 0xae, 0xaf, 0x74, 0x66, 0xf4,
+    0xc1, 0x7b, 0x6b, 0xbb, 0x62, 0x55, 0x82, 0x8e, 0x79, 0x42, 0xe5, 0xfb,
+    0xa4, 0x20, 0x76, 0x81, 0x1e, 0x0d, 0x71, 0xcf, 0xe1, 0x33, 0x75, 0x6d,
+    0x5b, 0x84, 0x9e, 0xef, 0xad, 0x43, 0xaf, 0x10, 0x6f, 0x65, 0xe9, 0x3d,
+    0xec, 0x53, 0xb4, 0xa7, 0x9f, 0x1f, 0xb7, 0xe4, 0x4f, 0x3c, 0x2b, 0x84,
+    0x54, 0x34, 0x57, 0xee, 0x39, 0xce, 0x42, 0xef, 0xc8, 0x11, 0x29, 0x3f,
+    0xad, 0xd9, 0x67, 0xb6, 0x79, 0x1c, 0xa0, 0x67, 0x09, 0x57, 0x7e, 0xb2,
+    0x30, 0xfc, 0x7c, 0x3c, 0x9d, 0x3e, 0x2a, 0x0f, 0x9e, 0x37, 0x26, 0x4c,
+    0x18, 0x6e, 0x77, 0xc7, 0xcd, 0x00, 0x71, 0x42, 0xf3, 0xf3, 0x10, 0x61,
+    0x12, 0x6f, 0xb6, 0x1f, 0x37, 0x8f, 0x39, 0x71, 0x4c, 0xa0, 0x78, 0x1f,
+    0x41, 0x3b, 0xd7, 0x25, 0x07, 0x77, 0xda, 0x15, 0xe8, 0x94, 0x32, 0x48,
+    0x8d, 0xff, 0x5d, 0x4b, 0xc5, 0x4f, 0xef, 0x01, 0xf6, 0x37, 0xba, 0x37,
+    0x1d, 0xad, 0xf7, 0x7d, 0x5e, 0x3a, 0xea, 0x0b, 0x80, 0x39, 0x64, 0xd2,
+    0x20, 0x73, 0x55, 0x08, 0xc7, 0x91, 0xbf, 0x12, 0x89, 0x62, 0x43, 0x08,
+    0xb2, 0x40, 0xf6, 0x1f, 0xec, 0xd6, 0x6a, 0xbd, 0xd5, 0x2c, 0x5d, 0x94,
+    0xd1, 0x20, 0x33, 0x80, 0x06, 0x7d, 0xd8, 0xb0, 0x91, 0x65, 0xd3, 0x50,
+    0x76, 0x1a, 0x9b, 0x8e, 0xd0, 0x9b, 0x46, 0x68, 0x47, 0xb5, 0x11, 0x08,
+    0x99, 0x4e, 0xce, 0x42, 0xd4, 0xa4, 0x92, 0x01, 0x42, 0xc0, 0xc3, 0x56,
+    0xfb, 0x95, 0xa2, 0xc7, 0x2a, 0xcb, 0x26, 0x3a, 0x28, 0x47, 0xd0, 0xf1,
+    0x22, 0x31, 0xab, 0x2a, 0x3a, 0x12, 0xd4, 0xd2, 0xfa, 0x65, 0xe8, 0xe8,
+    0xe3, 0xa5, 0x6c, 0x02, 0x72, 0x18, 0x8a, 0xa6, 0xe1, 0xa6, 0xc6, 0x55,
+    0xe0, 0x50, 0x2a, 0xaa, 0x74, 0x91, 0x6c, 0x23, 0x60, 0x87, 0x75, 0xc6,
+    0xdb, 0x2c, 0x47, 0x76, 0x17, 0x8e, 0x0d, 0x58, 0xd3, 0x67, 0x3a, 0x01,
+    0xe1, 0x96, 0xa7, 0x86, 0xc9, 0x38, 0x88, 0xad, 0xc3, 0x2f, 0x4f, 0xfb,
+    0x75, 0x17, 0x01, 0xc7, 0xc0, 0x7d, 0xbd, 0x5b, 0x92, 0xf5, 0x7e, 0x0b,
+    0xbf, 0xa2, 0xa7, 0x25, 0x86, 0x8a, 0xad, 0xd1, 0x8a, 0x49, 0x29, 0x06,
+    0x12, 0xf7, 0xeb, 0xcb, 0x23, 0x7c, 0x3e, 0xc2, 0x2a, 0xda, 0x00, 0x87,
+    0xdd, 0xde, 0xfc, 0x34, 0x9c, 0xe2, 0x0b, 0xc5, 0x36, 0xe2, 0x8a, 0x11,
+    0x5e, 0xcf, 0x5b, 0x76, 0x1e, 0x4c, 0xbb, 0xb8, 0x4a, 0x7f, 0x25, 0x8a,
+    0xc1, 0xae, 0x74, 0xaa, 0xd5, 0x2c, 0xa4, 0x38, 0x4b, 0xb0, 0x2a, 0x8c,
+    0x8a, 0xb2, 0xdb, 0x30, 0xd6, 0x93, 0xd7, 0x7e, 0xc6, 0x20, 0x37, 0xd0,
+    0x29, 0xee, 0x5a, 0x97, 0x5b, 0x62, 0x62, 0xfc, 0x9c, 0x52, 0xb4, 0xd4,
+    0x85, 0x27, 0x09, 0xcb, 0x5d, 0x31, 0xbb, 0x9c, 0x86, 0x24, 0x3e, 0xf1,
+    0x14, 0xbb, 0xf5, 0x66, 0x3e, 0xd4, 0x32, 0xdb, 0x13, 0x2f, 0xb6, 0x1b,
+    0x60, 0xe2, 0x33, 0x0a, 0x03, 0x39, 0xf7, 0xf0, 0x14, 0x26, 0xec, 0xbc,
+    0xf4, 0x65, 0xe3, 0xd2, 0xd7, 0x4a, 0x0d, 0x68, 0xd3, 0x07, 0x99, 0xc7,
+    0x56, 0xba, 0xcb, 0x66, 0x02, 0x1f, 0xc6, 0xf1, 0x6f, 0xb5, 0xc1, 0x41,
+    0xab, 0x83, 0xea, 0xeb, 0xdd, 0x8c, 0x99, 0xc1, 0x33, 0xe2, 0x54, 0x9d,
+    0xdc, 0xac, 0xb6, 0xda, 0x67, 0x68, 0x9c, 0xed, 0x69, 0x1a, 0xa4, 0xe2,
+    0x3c, 0xd9, 0x84, 0xd4, 0x68, 0xf5, 0x47, 0xc6, 0x89, 0xce, 0xc5, 0x01,
+    0x16, 0x99, 0x4b, 0x3b, 0x6c, 0xda, 0x61, 0x13, 0x40, 0x61, 0x34, 0x23,
+    0xbc, 0x7b, 0x47, 0xf1, 0x37, 0x71, 0x95, 0x1c, 0x72, 0xe9, 0xef, 0xec,
+    0x76, 0xbf, 0x24, 0x99, 0xc8, 0x05, 0x4e, 0xa6, 0xcc, 0x53, 0x62, 0x3a,
+    0x17, 0x0b, 0x8f, 0x53, 0xdd, 0xa7, 0x65, 0x8a, 0x84, 0xbf, 0xf6, 0x4d,
+    0xbd, 0xab, 0x86, 0x49, 0x6b, 0xdf, 0x4a, 0xf1, 0x8c, 0x01, 0x98, 0x64,
+    0xc5, 0x2c, 0xb4, 0x76, 0xe2, 0xe2, 0x28, 0xd2, 0x64, 0xd2, 0x3f, 0x9f,
+    0x14, 0xcb, 0x8a, 0x00, 0x78, 0x94, 0xf4, 0x8c, 0x15, 0xa1, 0xad, 0x5f,
+    0x27, 0xfe, 0xc6, 0x90, 0x1e, 0xf3, 0xcd, 0x18, 0x53, 0x9a, 0x73, 0xcd,
+    0x3f, 0xdf, 0x81, 0x6f, 0xa2, 0x4b, 0x39, 0x5e, 0x51, 0xd9, 0xd5, 0xfc,
+    0x31, 0xec, 0x54, 0xf3, 0x09, 0x2c, 0xf7, 0x61, 0xf7, 0xf4, 0x55, 0x48,
+    0x34, 0xd0, 0x92, 0xff, 0xeb, 0x21, 0xa6, 0x69, 0xfc, 0x80, 0x79, 0x4c,
+    0xfe, 0x4c, 0xb0, 0xb1, 0x58, 0x74, 0xa2, 0xb4, 0xa1, 0x72, 0x93, 0xce,
+    0xb1, 0xc4, 0xaa, 0xbc, 0x88, 0x1b, 0x5e, 0x8f, 0x78, 0x39, 0x84, 0x0b,
+    0x0f, 0xc1, 0xc7, 0xeb, 0x4a, 0xf7, 0x88, 0x0f, 0x57, 0x8b, 0xee, 0x01,
+    0x37, 0x2a, 0x73, 0x30, 0xb9, 0xff, 0x88, 0x97, 0xed, 0xd3, 0xd7, 0xf0,
+    0xcb, 0xd4, 0x11, 0x3c, 0x3f, 0x09, 0x3f, 0xfd, 0xe6, 0xcb, 0x3e, 0x7a,
+    0xd9, 0xf5, 0xe9, 0xcd, 0xb8, 0x0c, 0x0e, 0x3c, 0x7e, 0xe3, 0xd0, 0x71,
+    0x41, 0x46, 0x21, 0xa4, 0x2e, 0x89, 0xff, 0xb9, 0x69, 0x1d, 0x06, 0x57,
+    0xab, 0xf9, 0x79, 0x60, 0xb5, 0xe9, 0x5b, 0xea, 0x95, 0xfe, 0x88, 0x8c,
+    0xd1, 0xd8, 0x99, 0x92, 0x0d, 0xac, 0xc0, 0x99, 0x25, 0x53, 0x4e, 0xa3,
+    0x5c, 0x9f, 0xa2, 0x5b, 0x45, 0x64, 0x10, 0x0c, 0xc1, 0x9c, 0x43, 0x36,
+    0x07, 0xc4, 0x3a, 0x0d, 0x79, 0xa5, 0x4f, 0x26, 0xbe, 0x37, 0xca, 0xcc,
+    0x44, 0x43, 0xdf, 0xc4, 0x30, 0x2e, 0x5e, 0xc5, 0xed, 0x3f, 0xea, 0xbd,
+    0x60, 0x7f, 0xbd, 0xc7, 0xf5, 0xfb, 0xff, 0xfe, 0x0c, 0xb3, 0x1f, 0x77,
+    0xe6, 0xbe, 0xe3, 0xe7, 0x68, 0x57, 0x4a, 0x9c, 0xcf, 0x29, 0x0b, 0xca,
+    0x1b, 0x57, 0xf1, 0xc5, 0x01, 0x96, 0xb6, 0x31, 0xae, 0x00, 0xc3, 0x74,
+    0xff, 0x35, 0x90, 0x9a, 0x3b, 0xb5, 0x79, 0xf7, 0x09, 0x93, 0x05, 0x7f,
+    0xf0, 0xe2, 0xc0, 0x92, 0x10, 0x0a, 0x8c, 0x6e, 0x9d, 0x5a, 0x09, 0xe9,
+    0x11, 0xca, 0xce, 0x15, 0xc3, 0xdb, 0xa0, 0x1f, 0xf2, 0xae, 0x64, 0x8d,
+    0x5c, 0x59, 0x07, 0x46, 0xa5, 0xa6, 0x9b, 0x73, 0x94, 0xd8, 0x62, 0x6b,
+    0x61, 0x8b, 0x9c, 0xb2, 0x93, 0xaa, 0xc4, 0x34, 0x7d, 0x76, 0x60, 0xfa,
+    0xc6, 0x80, 0xe5, 0xf4, 0x98, 0xb2, 0xa4, 0xc5, 0x7c, 0xdf, 0x78, 0xed,
+    0x92, 0x80, 0x9e, 0x5d, 0x1a, 0xcf, 0xcc, 0x89, 0x37, 0x5d, 0x30, 0x80,
+    0x05, 0x52, 0xa3, 0x5b, 0x67, 0x40, 0x3c, 0xd3, 0xa2, 0xb6, 0xb4, 0xb5,
+    0x2f, 0xb8, 0x49, 0x5a, 0x0c, 0x6d, 0xd6, 0x17, 0xb5, 0x7a, 0x27, 0xee,
+    0x02, 0xc5, 0xe1, 0x77, 0x4b, 0xad, 0x0b, 0x67, 0x70, 0x64, 0xea, 0xc6,
+    0x58, 0x3e, 0x63, 0x20, 0x75, 0xf6, 0x1f, 0x88, 0x9e, 0xde, 0x02, 0xb0,
+    0x64, 0x56, 0xb6, 0x33, 0x5c, 0x7d, 0xb6, 0xf9, 0xbf, 0x7f, 0xa8, 0x97,
+    0xa8, 0xa3, 0x19, 0x5e, 0xdc, 0x95, 0x10, 0xda, 0x5c, 0xdf, 0x88, 0x35,
+    0xb3, 0x44, 0x68, 0x66, 0x89, 0x9f, 0x6b, 0x3f, 0xf6, 0x9e, 0xee, 0x63,
+    0xd6, 0xbb, 0x81, 0x5a, 0xa0, 0x11, 0x97, 0x6c, 0xad, 0xfe, 0xb7, 0x99,
+    0xb8, 0x43, 0x5b, 0x1b, 0x38, 0xde, 0x9d, 0xad, 0x9d, 0xbd, 0xa1, 0x89,
+    0x77, 0x84, 0xb9, 0x14, 0x56, 0x58, 0x67, 0x4e, 0x58, 0xad, 0x7b, 0x17,
+    0xf3, 0xba, 0x0c, 0x03, 0x4d, 0x76, 0x0c, 0xa2, 0xd0, 0x73, 0xef, 0x5d,
+    0x33, 0x87, 0x75, 0xcf, 0xb2, 0xc5, 0xaf, 0x2d, 0x8b, 0x6e, 0x24, 0xb7,
+    0x3b, 0x9a, 0x5b, 0x13, 0x37, 0x6c, 0xdb, 0x0d, 0x6d, 0x55, 0xeb, 0x96,
+    0xb2, 0x7a, 0x47, 0x55, 0xb4, 0xba, 0x95, 0xaa, 0x5e, 0xce, 0x20, 0x95,
+    0x93, 0xb9, 0xd3, 0xae, 0x83, 0x5b, 0x2b, 0x5e, 0xb6, 0x03, 0xfb, 0xe0,
+    0xa5, 0x97, 0x9f, 0xce, 0x1a, 0xb3, 0x7d, 0xf7, 0x36, 0x71, 0xdc, 0x07,
+    0x21, 0x87, 0x1d, 0x82, 0x03, 0x58, 0xba, 0x6e, 0x0a, 0x7b, 0x1b, 0xad,
+    0xf3, 0xab, 0xad, 0xd5, 0xce, 0xea, 0xde, 0x32, 0x16, 0x19, 0xa4, 0x93,
+    0xb2, 0xa7, 0xea, 0x7d, 0x35, 0x4f, 0x3a, 0xbd, 0x6c, 0xb8, 0xda, 0x6f,
+    0xd1, 0xff, 0x2d, 0x65, 0xc6, 0x20, 0xa4, 0x33, 0x67, 0x1c, 0x0f, 0x9b,
+    0x16, 0xae, 0xf7, 0x1a, 0xa2, 0xa5, 0xab, 0x63, 0xab, 0x25, 0xdb, 0x62,
+    0xeb, 0x16, 0x7a, 0xaf, 0xf9, 0xfd, 0xe1, 0x26, 0x12, 0xea, 0xbc, 0x3b,
+    0x31, 0xd3, 0x7b, 0xaf, 0x29, 0xed, 0x34, 0x9f, 0x46, 0xff, 0xb0, 0x82,
+    0xeb, 0xf0, 0xe0, 0x1f, 0x40, 0xbb, 0xa3, 0x5d, 0xed, 0x0b, 0xa7, 0xad,
+    0xfc, 0xbc, 0x68, 0x05, 0xa9, 0x9b, 0xc0, 0xee, 0x9b, 0x9c, 0x7a, 0xbd,
+    0x06, 0xae, 0xc9, 0x0a, 0x59, 0x65, 0x7a, 0xf3, 0x2e, 0x6a, 0xfb, 0x4b,
+    0x35, 0x79, 0xb4, 0x78, 0xb1, 0x1d, 0x2c, 0x7a, 0x6e, 0x57, 0x6d, 0xf5,
+    0xd9, 0x4f, 0x5a, 0x9d, 0xb9, 0x60, 0x65, 0x37, 0x4a, 0xda, 0x9d, 0xe8,
+    0x17, 0x57, 0xf7, 0xea, 0x46, 0xe1, 0x2c, 0x79, 0x02, 0xf4, 0x92, 0x31,
+    0x5b, 0x77, 0x7c, 0x7a, 0x20, 0x66, 0x0d, 0x1a, 0x46, 0x6c, 0x84, 0x51,
+    0xd5, 0x6b, 0x96, 0xa3, 0xa4, 0x27, 0x59, 0xff, 0x38, 0x60, 0xeb, 0x9d,
+    0x25, 0x9d, 0xd8, 0x7b, 0xaa, 0x42, 0xcf, 0x1c, 0x7c, 0x13, 0x1f, 0x65,
+    0xd9, 0xc5, 0x76, 0x9a, 0x32, 0xa9, 0xba, 0x31, 0x78, 0x70, 0x30, 0xde,
+    0x0f, 0xdd, 0x3d, 0x43, 0xb6, 0xc7, 0x05, 0x23, 0x17, 0xbb, 0x1e, 0x37,
+    0x77, 0x71, 0xcc, 0x7d, 0xd5, 0x63, 0xc3, 0x1b, 0x12, 0xcc, 0x3d, 0x75,
+    0xe6, 0x6b, 0xdf, 0x79, 0x43, 0xb1, 0xeb, 0x15, 0x6d, 0xa1, 0x81, 0x8b,
+    0x4b, 0xe4, 0x1e, 0x34, 0x6f, 0x8b, 0xff, 0x48, 0x01, 0x37, 0x1d, 0x81,
+    0xa2, 0x52, 0x0d, 0xc4, 0x05, 0xa6, 0x95, 0x72, 0xca, 0x8d, 0x35, 0x7b,
+    0xd6, 0x58, 0xae, 0x67, 0xd0, 0xce, 0x7b, 0x6b, 0xfd, 0xcc, 0xea, 0x0c,
+    0x44, 0xda, 0x17, 0x55, 0xaf, 0x24, 0x5c, 0x9a, 0xaa, 0xaf, 0x47, 0x61,
+    0x88, 0xa3, 0x2a, 0x7a, 0x76, 0x76, 0xcb, 0x63, 0x84, 0xfe, 0x78, 0x7b,
+    0x51, 0x1f, 0xa2, 0xe3, 0x15, 0x0c, 0x91, 0x07, 0x11, 0x90, 0xeb, 0xff,
+    0x0c, 0x33, 0xd0, 0x93, 0xfc, 0x05, 0x4d, 0x94, 0x93, 0x08, 0x77, 0xfe,
+    0x1f, 0x67, 0x2b, 0x1d, 0xc0, 0x7e, 0x22, 0x00, 0x00,
+};
+
+/* theme-dark.css + base.css: 8830 bytes, 2148 gzipped */
+static const uint8_t WEB_ASSET_THEME_DARK_CSS_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x59,
+    0xdd, 0x6f, 0xdb, 0x38, 0x12, 0x7f, 0xcf, 0x5f, 0xa1, 0x43, 0xb1, 0x48,
+    0x8c, 0xb3, 0x7c, 0xb2, 0x64, 0xbb, 0x4e, 0x8c, 0x7b, 0x68, 0x0f, 0x2d,
+    0xb0, 0x2f, 0xf7, 0xb2, 0x58, 0x60, 0x17, 0x8b, 0x7d, 0xa0, 0x25, 0xda,
+    0xe6, 0x55, 0x12, 0x05, 0x8a, 0x8e, 0x93, 0x16, 0xfd, 0xdf, 0x6f, 0x86,
+    0xd4, 0x07, 0x29, 0x51, 0x1f, 0x69, 0x23, 0x34, 0x68, 0x44, 0x0e, 0xe7,
+    0xfb, 0x37, 0x33, 0xd4, 0x93, 0xe0, 0x5c, 0x7a, 0xdf, 0xee, 0x3c, 0xcf,
+    0xf7, 0xe5, 0x85, 0x66, 0xd4, 0x3f, 0x9e, 0x9f, 0xbc, 0x77, 0xeb, 0x10,
+    0x9f, 0x83, 0xf1, 0x3a, 0x26, 0x22, 0xc1, 0x85, 0x4f, 0xf8, 0x98, 0x0b,
+    0x92, 0xbe, 0x48, 0x58, 0xf8, 0x14, 0xe0, 0x63, 0x2e, 0x90, 0x38, 0xa6,
+    0x39, 0x2e, 0x7d, 0x56, 0x3f, 0xe6, 0xd2, 0xf1, 0x2a, 0x25, 0xcf, 0x61,
+    0x69, 0x13, 0xe0, 0xd3, 0x5f, 0xf2, 0x2f, 0xfc, 0x99, 0x0a, 0xd8, 0xb0,
+    0x55, 0x3f, 0xe6, 0x06, 0x96, 0x17, 0x57, 0x3c, 0x35, 0xfc, 0x80, 0x8f,
+    0x45, 0xca, 0x45, 0xa2, 0x88, 0xfa, 0xa7, 0xe6, 0xe4, 0x19, 0xe4, 0x91,
+    0xec, 0x99, 0x0e, 0x2e, 0xb3, 0xbc, 0xd9, 0xb0, 0x57, 0x3f, 0xd6, 0xd1,
+    0x24, 0xfe, 0x72, 0x16, 0xfc, 0x9a, 0x27, 0x4e, 0xce, 0x48, 0x5f, 0x4b,
+    0x1c, 0x7d, 0xc0, 0xe7, 0x70, 0xf7, 0xfd, 0xee, 0xc8, 0x93, 0x57, 0xef,
+    0x9b, 0x77, 0xe2, 0xb9, 0xf4, 0x4f, 0x24, 0x63, 0xe9, 0xeb, 0x93, 0x77,
+    0xff, 0x1b, 0x3d, 0x73, 0xea, 0xfd, 0xfe, 0xeb, 0xfd, 0xd2, 0xfb, 0x20,
+    0x18, 0x49, 0x97, 0x5e, 0x49, 0xf2, 0xd2, 0x2f, 0xa9, 0x60, 0xa7, 0x83,
+    0x97, 0x11, 0x71, 0x66, 0x60, 0x98, 0xe0, 0xe0, 0x15, 0x24, 0x49, 0x58,
+    0x0e, 0xce, 0x08, 0x83, 0xe2, 0xe5, 0xe0, 0xb5, 0x12, 0xf8, 0x31, 0x4f,
+    0x39, 0x70, 0x7a, 0x26, 0xe2, 0xa1, 0x75, 0xda, 0xe2, 0xe0, 0x39, 0xde,
+    0xa3, 0x73, 0x60, 0x25, 0x65, 0x39, 0xf5, 0x2f, 0x94, 0x9d, 0x2f, 0x60,
+    0xb9, 0xf5, 0x6a, 0x77, 0xf0, 0xa4, 0x00, 0xae, 0x4c, 0x32, 0xf4, 0x02,
+    0x49, 0x53, 0x2f, 0x58, 0x45, 0xa5, 0x47, 0x49, 0x49, 0x0f, 0xde, 0xf7,
+    0xbb, 0x55, 0x0c, 0x22, 0x13, 0xa0, 0x11, 0x20, 0x7e, 0x46, 0x5e, 0xfc,
+    0x1b, 0x4b, 0xe4, 0xe5, 0xc9, 0xdb, 0x07, 0x4a, 0x94, 0x46, 0x48, 0x8f,
+    0x5c, 0x25, 0x9f, 0x12, 0x0d, 0x03, 0x67, 0x61, 0xa8, 0x13, 0x69, 0x75,
+    0x94, 0xaf, 0x7c, 0x41, 0x12, 0x76, 0x2d, 0x41, 0xa6, 0x9d, 0x7e, 0xf9,
+    0xe2, 0x97, 0x17, 0x92, 0xf0, 0x1b, 0x1e, 0xbe, 0x2f, 0x5e, 0xbc, 0x28,
+    0x84, 0x5f, 0xe2, 0x7c, 0x24, 0x0f, 0xc1, 0x52, 0x3d, 0xab, 0xf5, 0xa2,
+    0x26, 0x06, 0x2a, 0x58, 0x2c, 0x79, 0xca, 0x12, 0xdb, 0x16, 0x6a, 0x75,
+    0x31, 0xa5, 0xe3, 0x85, 0x92, 0x44, 0x29, 0x88, 0x36, 0xf2, 0x49, 0xca,
+    0xce, 0xb0, 0x0d, 0x23, 0x96, 0x8a, 0x5a, 0x45, 0x38, 0x0a, 0x82, 0x31,
+    0xab, 0x65, 0x6e, 0x89, 0x2e, 0x6b, 0xa0, 0x73, 0xe8, 0xaa, 0x43, 0x7e,
+    0x61, 0xf9, 0x51, 0xb9, 0xbf, 0x64, 0x5f, 0x21, 0xb0, 0xc2, 0x55, 0x48,
+    0xb3, 0xea, 0xcd, 0xad, 0xf2, 0x46, 0x14, 0xc0, 0x9e, 0x94, 0x4a, 0x60,
+    0xeb, 0x97, 0x05, 0x89, 0x95, 0x8d, 0xfc, 0x60, 0xb5, 0x45, 0x8e, 0xa6,
+    0x06, 0x8a, 0x9d, 0x5b, 0x87, 0xc2, 0x2d, 0x4d, 0xe5, 0xfc, 0x5a, 0x96,
+    0x35, 0x28, 0x01, 0x66, 0x0d, 0x50, 0x28, 0x8e, 0x9c, 0x24, 0xc4, 0x63,
+    0xb0, 0xda, 0x4f, 0xb3, 0x39, 0x71, 0x91, 0xf9, 0xe8, 0xe1, 0x42, 0xc5,
+    0x83, 0x65, 0x9a, 0x70, 0x53, 0x99, 0xc6, 0xd8, 0x94, 0x92, 0x23, 0x4d,
+    0x61, 0x6b, 0xc2, 0xca, 0x22, 0x25, 0xc0, 0xe5, 0x98, 0xf2, 0xf8, 0x4b,
+    0xcf, 0xaa, 0x7b, 0xa4, 0xb4, 0x8c, 0xb1, 0x45, 0x63, 0x0c, 0x6b, 0x62,
+    0x98, 0x72, 0xbd, 0x99, 0x63, 0x1f, 0x43, 0x26, 0x05, 0x1b, 0x4b, 0xcf,
+    0x7c, 0x55, 0xd2, 0x94, 0xc6, 0x9d, 0x77, 0xc8, 0x89, 0x08, 0x4a, 0xe0,
+    0xad, 0xa2, 0xf0, 0x4b, 0x99, 0x80, 0x26, 0x55, 0x02, 0xac, 0x83, 0xe0,
+    0x17, 0x23, 0x94, 0x51, 0x88, 0x26, 0x74, 0x75, 0x48, 0x86, 0xe3, 0x21,
+    0xd9, 0x0d, 0xfb, 0xb0, 0x31, 0x41, 0xa5, 0x56, 0x9b, 0x07, 0xec, 0xab,
+    0xe2, 0x51, 0x51, 0xc0, 0xab, 0xa9, 0x44, 0x53, 0xf2, 0x8e, 0xc2, 0xc0,
+    0x78, 0x42, 0x74, 0x8d, 0xf5, 0x74, 0xe2, 0xf1, 0xb5, 0x74, 0x99, 0xcc,
+    0xb5, 0x52, 0x1b, 0xae, 0x59, 0x6b, 0xcc, 0xa7, 0xdf, 0x80, 0x11, 0xf9,
+    0x55, 0x22, 0x10, 0x3d, 0x79, 0x39, 0xcf, 0x69, 0x63, 0x8b, 0xb1, 0x34,
+    0xb2, 0x01, 0x01, 0x9f, 0x08, 0xec, 0xeb, 0xd8, 0x1a, 0x06, 0x95, 0x76,
+    0x28, 0xd1, 0x93, 0xfe, 0x6f, 0x4a, 0x24, 0xfd, 0xf3, 0xc1, 0x07, 0x90,
+    0x58, 0x28, 0xfd, 0x74, 0x65, 0x01, 0x39, 0x26, 0xa0, 0x54, 0x6d, 0x6b,
+    0xed, 0x78, 0xbb, 0x30, 0x49, 0xbb, 0x4e, 0x0f, 0xf7, 0xa6, 0xd3, 0x2d,
+    0x7d, 0x6c, 0xdf, 0xc6, 0x57, 0x51, 0xe2, 0x29, 0x05, 0x67, 0x1a, 0x59,
+    0x7a, 0xce, 0xee, 0x27, 0x80, 0x02, 0xa4, 0x84, 0xc6, 0x5c, 0x10, 0xed,
+    0x2b, 0x7d, 0x7e, 0x93, 0x4d, 0x2c, 0x57, 0x78, 0x6e, 0x25, 0x95, 0xca,
+    0x26, 0x6f, 0xd7, 0x4d, 0x8a, 0xbe, 0x97, 0xab, 0xd2, 0xab, 0xaa, 0xd5,
+    0x4c, 0x5b, 0xe8, 0xd2, 0xb6, 0x18, 0xb4, 0x70, 0xa8, 0x2c, 0x6c, 0xfb,
+    0x4a, 0x65, 0x46, 0x1f, 0xbc, 0xb7, 0xa6, 0x2b, 0x56, 0x25, 0xe8, 0x98,
+    0x27, 0x44, 0xbc, 0x4e, 0x0a, 0x62, 0x16, 0xe8, 0xd1, 0x10, 0x77, 0x1c,
+    0x3e, 0x53, 0xd7, 0xb6, 0x45, 0xe8, 0xf9, 0xde, 0x38, 0xf4, 0x0a, 0xf1,
+    0x56, 0x96, 0xce, 0xc3, 0xde, 0x85, 0x7b, 0xf2, 0x7e, 0xb3, 0xf5, 0xfe,
+    0xc1, 0xb2, 0x82, 0x0b, 0x49, 0x72, 0x69, 0x9f, 0x63, 0x2d, 0xf4, 0x8e,
+    0x1c, 0x91, 0xf2, 0xdd, 0x9a, 0xbe, 0xa7, 0xd1, 0x66, 0x80, 0x9e, 0x26,
+    0x4c, 0xba, 0xc9, 0x82, 0xe0, 0xfd, 0xf1, 0x74, 0x7a, 0xab, 0x3c, 0x78,
+    0xde, 0x98, 0x30, 0x41, 0xb0, 0xdd, 0x1d, 0xa3, 0x01, 0xe2, 0x84, 0xe4,
+    0xe7, 0x21, 0xc2, 0x24, 0x8e, 0xb6, 0x6f, 0x37, 0x8f, 0x3e, 0x71, 0x4c,
+    0xa0, 0x78, 0x1f, 0x46, 0x51, 0x4f, 0x20, 0x70, 0xa7, 0x59, 0x81, 0x4e,
+    0x29, 0x85, 0xd4, 0xf8, 0xdf, 0xb5, 0x94, 0xec, 0xf4, 0xea, 0x63, 0x7f,
+    0xa3, 0x7a, 0xd3, 0xd1, 0x7a, 0xdf, 0xe7, 0xa5, 0xa2, 0xbe, 0x00, 0x98,
+    0x43, 0x26, 0x0d, 0x32, 0x57, 0x85, 0x70, 0x1c, 0xf9, 0x2b, 0x91, 0x08,
+    0x36, 0x84, 0x20, 0x0b, 0x64, 0xff, 0xc1, 0x6c, 0xad, 0xd6, 0x5b, 0xc5,
+    0xd2, 0x46, 0x19, 0x05, 0x32, 0x03, 0x68, 0xd0, 0x87, 0x0d, 0x13, 0x59,
+    0xa2, 0x86, 0xb2, 0xd3, 0xd8, 0x74, 0x84, 0x8e, 0x1a, 0xa1, 0x2d, 0xd5,
+    0x46, 0x20, 0x64, 0x3a, 0x39, 0x0b, 0x5e, 0x93, 0x0a, 0x0a, 0x08, 0x01,
+    0x2f, 0x5b, 0xed, 0x57, 0x92, 0x1c, 0xab, 0x2c, 0x9b, 0xe8, 0xa0, 0x2c,
+    0x41, 0xc7, 0x8b, 0xc4, 0xac, 0xaa, 0x68, 0x49, 0x50, 0x4b, 0xeb, 0x96,
+    0xa1, 0xa3, 0x8f, 0x93, 0xb2, 0x09, 0xc8, 0x61, 0x28, 0x9a, 0x86, 0x9b,
+    0x1a, 0x57, 0x81, 0x43, 0x29, 0x89, 0x54, 0x45, 0xb2, 0x8d, 0x80, 0x1d,
+    0xd6, 0x19, 0x67, 0xb3, 0x1c, 0x9a, 0x5d, 0x38, 0x36, 0x60, 0x4d, 0x9f,
+    0x69, 0x05, 0x84, 0x5d, 0x9e, 0x1a, 0x26, 0xe3, 0x20, 0xb6, 0x0e, 0x3e,
+    0x3e, 0xee, 0xd7, 0x5d, 0x04, 0x1c, 0x03, 0xf7, 0xf5, 0x6e, 0xe9, 0xad,
+    0xf7, 0x5b, 0xf8, 0x15, 0x3e, 0x2e, 0x31, 0x54, 0x4c, 0x8d, 0x56, 0x54,
+    0x08, 0x3e, 0x90, 0xb8, 0x9f, 0x3e, 0x6f, 0xe0, 0xe7, 0x2d, 0xac, 0xc2,
+    0x08, 0x38, 0xec, 0xf6, 0xfa, 0x5f, 0xc3, 0x29, 0xbe, 0x10, 0x6c, 0x23,
+    0xae, 0x18, 0xe1, 0xf5, 0xbc, 0x65, 0xe6, 0xc1, 0xb4, 0x8b, 0xab, 0xf4,
+    0x97, 0xbc, 0x18, 0xec, 0x4a, 0xa7, 0x5a, 0xcd, 0x42, 0xf0, 0xb3, 0x00,
+    0xab, 0xc2, 0xa8, 0x28, 0xba, 0x0d, 0x63, 0x3d, 0x79, 0xed, 0x67, 0x0c,
+    0x72, 0x03, 0x9d, 0xe2, 0xae, 0x75, 0xb9, 0x21, 0x26, 0xc6, 0xcf, 0x29,
+    0x45, 0x4b, 0x5d, 0x58, 0x92, 0xd0, 0xdc, 0x16, 0xb3, 0xcb, 0x69, 0x48,
+    0xe2, 0x13, 0x4b, 0xb1, 0x5b, 0x6f, 0xe6, 0x43, 0x25, 0xb3, 0x39, 0xf1,
+    0x62, 0xbb, 0x01, 0x26, 0x3e, 0xa3, 0x30, 0x90, 0x73, 0x0f, 0x8f, 0x41,
+    0x42, 0xcf, 0x4b, 0x57, 0x36, 0x2e, 0x5d, 0xad, 0xd4, 0x80, 0x36, 0x7d,
+    0x90, 0xd9, 0xb4, 0xd2, 0x5d, 0xa2, 0x09, 0x7c, 0x18, 0xc7, 0xbf, 0x55,
+    0x84, 0x83, 0x56, 0x07, 0xd5, 0xd7, 0xbb, 0x19, 0x33, 0x83, 0x63, 0xc4,
+    0xa9, 0x3a, 0xb9, 0x59, 0x6d, 0xb5, 0xcb, 0xd0, 0x38, 0xdb, 0x93, 0xd4,
+    0x4f, 0xf9, 0x79, 0xb2, 0x09, 0xa9, 0xd1, 0xea, 0x67, 0xc6, 0x89, 0xce,
+    0xc5, 0x01, 0x16, 0x99, 0x4b, 0x3b, 0x6c, 0x9a, 0x61, 0xe3, 0x43, 0x61,
+    0xd4, 0x23, 0xbc, 0x7d, 0x47, 0xf1, 0x1f, 0x7e, 0x15, 0x0c, 0x72, 0xe9,
+    0xbf, 0xf4, 0x76, 0xbf, 0xf4, 0x32, 0x9e, 0x73, 0x9c, 0x4c, 0xa9, 0xa3,
+    0xc4, 0x74, 0x2e, 0x16, 0x36, 0x53, 0xdd, 0xa7, 0x61, 0x8a, 0x84, 0x3d,
+    0xf7, 0x4d, 0xbd, 0xab, 0x86, 0x49, 0x63, 0xdf, 0x4a, 0xb2, 0x8c, 0x02,
+    0x98, 0x64, 0xc5, 0x2c, 0xb4, 0xb6, 0xe2, 0xe2, 0xc8, 0xd3, 0x64, 0xd2,
+    0x3f, 0xef, 0x24, 0xcd, 0x0a, 0x1f, 0x78, 0x94, 0xe4, 0x8c, 0x15, 0xa1,
+    0xad, 0x5f, 0x27, 0xf6, 0x42, 0x91, 0x1e, 0xf3, 0x4d, 0x1b, 0x53, 0xe8,
+    0x73, 0xf5, 0x1f, 0x5f, 0x81, 0x6f, 0xa2, 0x4a, 0x79, 0x80, 0xf1, 0x67,
+    0x54, 0xf3, 0x4d, 0xd0, 0xa9, 0xe6, 0x13, 0x58, 0xee, 0xc2, 0xee, 0xe9,
+    0xab, 0x90, 0x70, 0xa0, 0x25, 0xff, 0xe3, 0x21, 0x26, 0x69, 0xfc, 0x80,
+    0x79, 0xec, 0xfd, 0xd3, 0xc3, 0xc6, 0x62, 0xd1, 0x89, 0xd2, 0x86, 0xca,
+    0x4e, 0x3a, 0xcb, 0x12, 0xab, 0xf2, 0xc2, 0x6f, 0x78, 0x3d, 0xe2, 0xe4,
+    0x10, 0x2c, 0x1c, 0x04, 0x6f, 0xaf, 0x2b, 0xdd, 0x23, 0xde, 0x5c, 0x2d,
+    0xba, 0x07, 0xdc, 0x88, 0xc8, 0xc1, 0xe4, 0xee, 0x23, 0x3e, 0x6f, 0x1f,
+    0x3f, 0x05, 0x1f, 0xa7, 0x8e, 0x60, 0xf9, 0x89, 0xbb, 0xe9, 0xa3, 0x8f,
+    0xfb, 0xf0, 0xf3, 0xae, 0x4f, 0xaf, 0xc7, 0x65, 0x70, 0xe0, 0xf1, 0x0b,
+    0x83, 0x8e, 0x0b, 0x32, 0x0a, 0x21, 0x75, 0xe9, 0xb9, 0xdf, 0xeb, 0xd6,
+    0x61, 0x70, 0xb5, 0x9a, 0x9f, 0x07, 0x56, 0x9b, 0xbe, 0xa5, 0x5e, 0xe9,
+    0x8f, 0xc8, 0x18, 0x8d, 0x9d, 0x29, 0x59, 0xc3, 0x0a, 0x9c, 0x59, 0x52,
+    0x69, 0x35, 0xca, 0xf5, 0x29, 0xaa, 0x55, 0x44, 0x06, 0xfe, 0x10, 0xcc,
+    0x59, 0x64, 0x73, 0x40, 0xac, 0xd3, 0x90, 0x57, 0xfa, 0x64, 0xfc, 0x6b,
+    0xa3, 0xcc, 0x4c, 0x34, 0x74, 0x4d, 0x0c, 0xe3, 0xe2, 0x55, 0xdc, 0xfe,
+    0x92, 0xaf, 0x05, 0xfd, 0xf7, 0x3d, 0xae, 0xdf, 0xff, 0xfd, 0x23, 0xcc,
+    0xbe, 0xdf, 0xe9, 0xfb, 0x8e, 0x1f, 0xa3, 0x5d, 0x49, 0x7e, 0x3e, 0xa7,
+    0xd4, 0x2f, 0x6f, 0x4c, 0xc6, 0x17, 0x0b, 0x58, 0xda, 0xc6, 0xb8, 0x02,
+    0x0c, 0xdd, 0xfd, 0xd7, 0x40, 0xaa, 0xef, 0xd4, 0xe6, 0xdd, 0x27, 0x4c,
+    0x16, 0xfc, 0xc1, 0x8b, 0x03, 0x43, 0x42, 0x28, 0x30, 0xaa, 0x75, 0x6a,
+    0x25, 0x24, 0x47, 0x28, 0x3b, 0x57, 0x0c, 0x6f, 0x8d, 0x7e, 0xc8, 0xbb,
+    0x92, 0x35, 0xb4, 0x65, 0x1d, 0x18, 0x95, 0x9a, 0x6e, 0xce, 0x52, 0x62,
+    0x8b, 0xad, 0x85, 0x29, 0x72, 0x4a, 0x4f, 0xb2, 0x12, 0x53, 0xf7, 0xd9,
+    0xbe, 0xee, 0x1b, 0x7d, 0x9a, 0x93, 0x63, 0x4a, 0x93, 0x16, 0xf3, 0x5d,
+    0xe3, 0xb5, 0x4d, 0x02, 0x7a, 0x76, 0x69, 0x1c, 0x33, 0x27, 0xde, 0x74,
+    0xc1, 0x00, 0xe6, 0x0b, 0x85, 0x6e, 0x9d, 0x01, 0xf1, 0x4c, 0x8a, 0xda,
+    0xd2, 0xc6, 0x3e, 0xff, 0x26, 0x48, 0x31, 0xb4, 0x59, 0x5d, 0xd4, 0xaa,
+    0x9d, 0xb8, 0x0b, 0x14, 0x87, 0xdf, 0x2d, 0xb5, 0x2a, 0x9c, 0xfe, 0x91,
+    0xca, 0x1b, 0xa5, 0xf9, 0x8c, 0x81, 0xd4, 0xda, 0x7f, 0xf0, 0xd4, 0xf4,
+    0xe6, 0x83, 0x25, 0xb3, 0xb2, 0x9d, 0xe1, 0xea, 0xb3, 0xf5, 0xdf, 0xfd,
+    0x43, 0x9d, 0x44, 0x1d, 0xcd, 0xf0, 0xe2, 0xae, 0x84, 0xd0, 0x66, 0xea,
+    0x46, 0xac, 0x99, 0x25, 0x02, 0x3d, 0x4b, 0xfc, 0x58, 0xfb, 0xb1, 0x77,
+    0x74, 0x1f, 0xb3, 0xbe, 0x0d, 0xd4, 0x02, 0x8d, 0xb8, 0x64, 0x6b, 0xf4,
+    0xbf, 0xcd, 0xc4, 0x1d, 0x98, 0xda, 0xc0, 0xf1, 0xf6, 0x6c, 0x6d, 0xed,
+    0x0d, 0x74, 0xbc, 0x23, 0xcc, 0xa5, 0xb0, 0x42, 0x3b, 0x73, 0xc2, 0x6a,
+    0xdd, 0xbb, 0x98, 0x57, 0x65, 0x18, 0x68, 0xb2, 0xa3, 0x1f, 0x06, 0x8e,
+    0x7b, 0xef, 0x9a, 0x39, 0xac, 0x3b, 0x96, 0x0d, 0x7e, 0x6d, 0x59, 0xb4,
+    0x23, 0xb9, 0xdd, 0xd1, 0xdc, 0x9a, 0xd8, 0x61, 0xdb, 0x6e, 0x68, 0xab,
+    0x5a, 0xb7, 0x94, 0xd5, 0x3b, 0xaa, 0xa2, 0xd5, 0xad, 0x54, 0xf5, 0x72,
+    0x06, 0xa9, 0x9c, 0xcc, 0x9d, 0x76, 0x2d, 0xdc, 0x5a, 0xb1, 0xb2, 0x1d,
+    0xd8, 0x07, 0x2f, 0xbd, 0xdc, 0x74, 0xc6, 0x98, 0xed, 0xba, 0xb7, 0x89,
+    0xe3, 0x3e, 0x08, 0x59, 0xec, 0x10, 0x1c, 0xc0, 0xd2, 0x75, 0x53, 0xd8,
+    0xdb, 0x68, 0x9c, 0x5f, 0x6d, 0xad, 0x76, 0x56, 0xf7, 0x96, 0x31, 0xcf,
+    0x20, 0x9d, 0xa4, 0x39, 0x55, 0xef, 0xab, 0x79, 0xd2, 0xea, 0x65, 0x83,
+    0xd5, 0x7e, 0x8b, 0xfe, 0x6f, 0x29, 0x33, 0x0a, 0x21, 0x9d, 0x59, 0xe3,
+    0x78, 0xd0, 0xb4, 0x70, 0xbd, 0xcf, 0x10, 0x2d, 0x5d, 0x1d, 0x5b, 0x2d,
+    0xd9, 0x16, 0x5b, 0xb7, 0xc0, 0x79, 0xcd, 0xef, 0x0e, 0x37, 0x9e, 0x10,
+    0xeb, 0xdb, 0x89, 0x9e, 0xde, 0x7b, 0x4d, 0x69, 0xa7, 0xf9, 0xd4, 0xfa,
+    0x07, 0x15, 0x5c, 0x07, 0x07, 0xf7, 0x00, 0xda, 0x1d, 0xed, 0x6a, 0x5f,
+    0x58, 0x6d, 0xe5, 0xfb, 0x45, 0x2b, 0x48, 0xdd, 0x04, 0x76, 0xbf, 0xe4,
+    0xd4, 0xeb, 0x35, 0x70, 0x4d, 0x56, 0xc8, 0x2a, 0xd3, 0x9b, 0x6f, 0x51,
+    0xdb, 0x5f, 0xaa, 0xc9, 0xa3, 0xc5, 0x8b, 0xed, 0x60, 0xd1, 0xb3, 0xbb,
+    0x6a, 0xa3, 0xcf, 0x7e, 0x54, 0xea, 0xcc, 0x05, 0x2b, 0xb3, 0x51, 0x52,
+    0xee, 0x44, 0xbf, 0xd8, 0xba, 0x57, 0x37, 0x0a, 0x67, 0xc1, 0x12, 0xa0,
+    0x17, 0x94, 0x9a, 0xba, 0xe3, 0xdb, 0x83, 0xa7, 0xd7, 0xa0, 0x61, 0xc4,
+    0x46, 0x18, 0x55, 0xbd, 0x66, 0x39, 0x4a, 0x7a, 0x12, 0xf5, 0x3f, 0x0b,
+    0x6c, 0x9d, 0xb3, 0xa4, 0x15, 0x7b, 0x8f, 0x55, 0xe8, 0xe9, 0x83, 0x6f,
+    0xfc, 0xad, 0x2c, 0xbb, 0xd8, 0x4e, 0x52, 0x2a, 0x64, 0x37, 0x06, 0x0f,
+    0x16, 0xc6, 0xbb, 0xa1, 0xbb, 0x67, 0xc8, 0xf6, 0x38, 0x7f, 0xe4, 0x62,
+    0xd7, 0xe1, 0xe6, 0x2e, 0x8e, 0xd9, 0x9f, 0x7a, 0x4c, 0x78, 0x43, 0x82,
+    0xb9, 0xa7, 0xce, 0xfc, 0xec, 0x3b, 0x6f, 0x28, 0xb6, 0xbd, 0xa2, 0x2c,
+    0x34, 0x70, 0x71, 0x89, 0xdc, 0xfd, 0xe6, 0x6b, 0xf1, 0xcf, 0x14, 0x70,
+    0xdd, 0x11, 0x48, 0x22, 0xe4, 0x40, 0x5c, 0x60, 0x5a, 0x49, 0xab, 0xdc,
+    0x18, 0xb3, 0x67, 0x8d, 0xe5, 0x6a, 0x06, 0xed, 0x7c, 0xb7, 0x56, 0xef,
+    0x8c, 0xce, 0x80, 0xa7, 0x7d, 0x51, 0xd5, 0x4a, 0xc2, 0x84, 0xae, 0xfa,
+    0x6a, 0x14, 0x86, 0x38, 0xaa, 0xa2, 0x67, 0x67, 0xb6, 0x3c, 0x5a, 0xe8,
+    0xb7, 0xb7, 0x17, 0xf5, 0x21, 0x2a, 0x5e, 0xc1, 0x10, 0xb9, 0x1f, 0x02,
+    0xb9, 0xfa, 0x4b, 0x33, 0x03, 0x3d, 0xbd, 0x7f, 0xa1, 0x89, 0x72, 0x2f,
+    0xc4, 0x9d, 0xff, 0x07, 0x57, 0xa4, 0xd5, 0x5b, 0x7e, 0x22, 0x00, 0x00,
+};
+
+/* app.js: 4771 bytes, 1489 gzipped */
+static const uint8_t WEB_ASSET_APP_JS_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x58,
+    0x6d, 0x6f, 0xdb, 0x36, 0x10, 0xfe, 0x9e, 0x5f, 0xc1, 0x76, 0x40, 0x29,
+    0x63, 0xb2, 0xe6, 0xb6, 0xcb, 0xd0, 0x24, 0x48, 0x8b, 0xac, 0x89, 0xb1,
+    0x00, 0x4d, 0x5b, 0x20, 0xc1, 0xbe, 0x14, 0x45, 0x41, 0x4b, 0xb4, 0xa5,
+    0x86, 0x22, 0x55, 0x92, 0x72, 0x6a, 0xa4, 0xfe, 0xef, 0x3b, 0x92, 0x22,
+    0x45, 0xd9, 0x71, 0xe3, 0x7d, 0x18, 0x26, 0xa3, 0xb5, 0x48, 0xde, 0xcb,
+    0x73, 0xbc, 0x87, 0x77, 0x8c, 0xe7, 0x2d, 0xcf, 0x75, 0x25, 0x38, 0x52,
+    0xa5, 0xb8, 0xbb, 0xa1, 0x75, 0x73, 0x45, 0x95, 0x22, 0x0b, 0x9a, 0xd4,
+    0xee, 0x3b, 0x45, 0x7a, 0xd5, 0xc0, 0xff, 0x45, 0x2b, 0x89, 0x91, 0x1b,
+    0xa1, 0xfb, 0x03, 0x84, 0x96, 0x44, 0xa2, 0x5a, 0x2d, 0xce, 0xab, 0x25,
+    0x3a, 0x45, 0x85, 0xc8, 0xdb, 0x9a, 0x72, 0x9d, 0x2d, 0xa8, 0xbe, 0x60,
+    0xd4, 0xbc, 0xfe, 0xb9, 0xba, 0x2c, 0x12, 0xac, 0xc1, 0xdc, 0xb8, 0xb3,
+    0x83, 0x47, 0x27, 0xa0, 0x57, 0xcd, 0x51, 0xf2, 0xc4, 0x29, 0x3a, 0x43,
+    0xe8, 0x01, 0x33, 0xb9, 0xa4, 0x44, 0xd3, 0xce, 0x52, 0x82, 0x8b, 0x6a,
+    0xe9, 0x94, 0xbd, 0x6c, 0x56, 0x15, 0x20, 0x3e, 0xb4, 0xee, 0xd6, 0x83,
+    0x89, 0x99, 0x28, 0x56, 0x19, 0x69, 0x1a, 0xca, 0x8b, 0xb7, 0x65, 0xc5,
+    0x8a, 0xa4, 0xf3, 0x69, 0xc4, 0xd6, 0x07, 0xc1, 0x90, 0xa6, 0xdf, 0xf5,
+    0x5b, 0xc1, 0x35, 0xa8, 0x80, 0xc5, 0xce, 0xd6, 0x49, 0xbf, 0x9e, 0x33,
+    0xa2, 0xd4, 0x7b, 0x52, 0x53, 0x58, 0x35, 0xdb, 0x80, 0x7e, 0x45, 0xd8,
+    0x6e, 0x94, 0xf5, 0xa7, 0xa8, 0xbe, 0xa9, 0x6a, 0x2a, 0x5a, 0x9d, 0xcc,
+    0xbb, 0x5d, 0x4c, 0x86, 0x51, 0x39, 0x03, 0xef, 0x2a, 0xa5, 0x33, 0x49,
+    0x6b, 0xb1, 0xa4, 0x09, 0xb6, 0xda, 0x0e, 0x47, 0xbf, 0xa9, 0xe8, 0xc7,
+    0x0f, 0x74, 0x38, 0x99, 0x4c, 0x60, 0x7e, 0x7d, 0x60, 0xf6, 0x56, 0x97,
+    0x10, 0xbc, 0x02, 0xaf, 0x9f, 0x40, 0xf0, 0x7e, 0xb6, 0x38, 0xc6, 0xbf,
+    0x4c, 0xed, 0x83, 0xd3, 0x9c, 0xc8, 0xc2, 0x0c, 0x5f, 0x4d, 0x8f, 0xa6,
+    0x67, 0x38, 0x35, 0x21, 0xc0, 0xf0, 0x85, 0x7d, 0x70, 0x4a, 0xf2, 0x1c,
+    0x82, 0x81, 0x89, 0x97, 0xf6, 0xc1, 0xe9, 0xac, 0xd5, 0x5a, 0xf0, 0xad,
+    0x89, 0xbf, 0x00, 0x8c, 0x84, 0xd9, 0x89, 0x7d, 0x70, 0x5a, 0xf1, 0xa6,
+    0xd5, 0x91, 0x97, 0x99, 0x90, 0x85, 0x15, 0xb8, 0x98, 0x98, 0x0f, 0x4e,
+    0x39, 0x59, 0x9e, 0x41, 0x88, 0x4b, 0x1a, 0x99, 0x82, 0xb9, 0x4b, 0x4e,
+    0xfc, 0xec, 0x91, 0x7d, 0xf0, 0x3a, 0x0d, 0x90, 0x9f, 0xbf, 0x30, 0x9f,
+    0x00, 0xf9, 0xf9, 0x85, 0xf9, 0x04, 0xc8, 0xde, 0x72, 0x80, 0x1c, 0x7c,
+    0x7b, 0xc8, 0xbf, 0x4f, 0xcc, 0x67, 0x13, 0xf2, 0xa1, 0x7d, 0x7a, 0xc8,
+    0x2f, 0xce, 0xcc, 0x27, 0x82, 0xec, 0xd5, 0x62, 0xc8, 0xd1, 0x5c, 0x04,
+    0xf9, 0x95, 0x7d, 0xf0, 0xfa, 0xe0, 0xf3, 0xc9, 0x81, 0x4f, 0x21, 0x02,
+    0xda, 0xb0, 0xd5, 0x8d, 0x49, 0x40, 0x62, 0xd3, 0x70, 0xc9, 0x0b, 0xfa,
+    0xbd, 0xa7, 0xbd, 0x9d, 0x33, 0x7c, 0xb0, 0x29, 0xfa, 0xd4, 0x8b, 0x7c,
+    0x3e, 0xe9, 0x24, 0xa4, 0x10, 0x3a, 0xe6, 0xb3, 0x7f, 0xe9, 0x18, 0x6d,
+    0xc4, 0x8c, 0x48, 0xa6, 0xf4, 0x8a, 0xd1, 0x0c, 0x58, 0xf4, 0x51, 0x8a,
+    0x86, 0x4a, 0xbd, 0x4a, 0xf0, 0x78, 0x6c, 0xed, 0x8d, 0x67, 0x0b, 0x9c,
+    0x3a, 0x0f, 0xd9, 0x6c, 0x31, 0xda, 0x47, 0xc3, 0xec, 0x71, 0xd0, 0x31,
+    0x83, 0xbd, 0xb4, 0x4c, 0x2a, 0x82, 0x96, 0x19, 0xec, 0xa5, 0xe5, 0x32,
+    0x16, 0xf4, 0xdc, 0x70, 0x2f, 0x4d, 0x97, 0xc9, 0x3e, 0x36, 0x3b, 0xfc,
+    0x17, 0x9a, 0xe3, 0xd2, 0x90, 0x60, 0x43, 0xdf, 0x12, 0x63, 0x2f, 0x23,
+    0x96, 0x32, 0x41, 0xdb, 0x8e, 0xf6, 0x73, 0x6e, 0xa9, 0xd5, 0xbb, 0xb5,
+    0xc3, 0xbd, 0x34, 0x81, 0x6f, 0x63, 0x47, 0xb7, 0xa0, 0x1d, 0x68, 0xb9,
+    0xb7, 0x81, 0x8a, 0x6f, 0x9b, 0xf0, 0x2c, 0xb6, 0x25, 0x23, 0x70, 0x57,
+    0x70, 0x4b, 0xdc, 0xb7, 0x25, 0xe1, 0x50, 0xc2, 0x37, 0x48, 0x7b, 0x4d,
+    0x19, 0xcd, 0xf5, 0x4f, 0x0b, 0xb6, 0x11, 0xeb, 0x2b, 0x75, 0xa4, 0xe5,
+    0xeb, 0x5a, 0x74, 0x38, 0x1a, 0x22, 0x15, 0x30, 0x5f, 0xc7, 0x62, 0xd9,
+    0x92, 0xb0, 0x96, 0x8e, 0xba, 0x3a, 0x1b, 0x01, 0x53, 0xed, 0xac, 0xae,
+    0xf4, 0x54, 0xc8, 0xfa, 0xec, 0x2b, 0xf9, 0x9e, 0xcc, 0xe1, 0x25, 0x85,
+    0x49, 0x60, 0x8e, 0x52, 0x57, 0x6a, 0x91, 0x22, 0x49, 0x95, 0x26, 0x52,
+    0xc3, 0x7b, 0x8f, 0xda, 0x48, 0x9d, 0x13, 0x4d, 0x00, 0x32, 0xa7, 0x77,
+    0x68, 0xda, 0x0d, 0xad, 0xb6, 0x75, 0x31, 0xa7, 0x3a, 0x2f, 0xed, 0x30,
+    0x23, 0xd6, 0x4f, 0x8a, 0xee, 0xa1, 0x8c, 0xeb, 0x52, 0x14, 0xc7, 0x08,
+    0x7f, 0xfc, 0x70, 0x7d, 0x03, 0x5b, 0x66, 0x7a, 0xc1, 0x71, 0x6f, 0x6b,
+    0x3d, 0x02, 0xc5, 0x0c, 0x30, 0xf3, 0x04, 0x7c, 0x36, 0x82, 0x2b, 0x38,
+    0xcd, 0xaf, 0x91, 0x7f, 0xcf, 0xbe, 0x2a, 0x53, 0xc6, 0x7b, 0xa1, 0xc2,
+    0x02, 0x78, 0xdd, 0xc5, 0x6f, 0xb6, 0xc5, 0xcc, 0x64, 0x1d, 0x76, 0xbf,
+    0x2f, 0xd1, 0x4a, 0x17, 0x49, 0xbf, 0x82, 0xb6, 0x7a, 0x6b, 0x1f, 0xac,
+    0xa9, 0xfc, 0xf8, 0x9a, 0x6a, 0x5d, 0xf1, 0x85, 0x42, 0x8a, 0x2c, 0x69,
+    0x11, 0xf6, 0x02, 0xa6, 0x50, 0xc5, 0xd1, 0x21, 0x34, 0x9a, 0x5c, 0xf0,
+    0x42, 0x65, 0x59, 0x06, 0xe1, 0xe0, 0x8a, 0xcf, 0x05, 0x7c, 0x77, 0xfd,
+    0x22, 0xb8, 0xe8, 0x9b, 0x11, 0xe4, 0x1d, 0xf0, 0x32, 0x91, 0xdb, 0xde,
+    0x02, 0x78, 0x98, 0x20, 0x45, 0x32, 0xda, 0x50, 0x59, 0x23, 0xca, 0x20,
+    0xf4, 0xdd, 0x20, 0xfb, 0xec, 0x3c, 0x00, 0xd2, 0xe7, 0x6e, 0xde, 0x32,
+    0xb6, 0x7a, 0x62, 0x60, 0x75, 0x13, 0x9b, 0xc8, 0xd6, 0x07, 0x0f, 0x38,
+    0xdb, 0x74, 0x85, 0x2f, 0xa4, 0x14, 0x12, 0x52, 0x06, 0x0d, 0xd6, 0x6d,
+    0x22, 0x35, 0x13, 0xd6, 0xef, 0x94, 0x54, 0x0c, 0xfc, 0x69, 0x61, 0x1d,
+    0x9b, 0x38, 0x2d, 0x0c, 0x0c, 0xf1, 0x60, 0x2b, 0x35, 0xf4, 0x68, 0xfc,
+    0xb9, 0x14, 0x43, 0xf8, 0x40, 0x0e, 0xb7, 0x19, 0x5b, 0x0e, 0xdf, 0x53,
+    0x7d, 0x27, 0xe4, 0x2d, 0x72, 0x7e, 0x44, 0x9e, 0xb7, 0x52, 0x52, 0x53,
+    0x40, 0x87, 0x36, 0xdd, 0x11, 0xa5, 0xba, 0x95, 0x1c, 0xcd, 0x09, 0x84,
+    0x30, 0x38, 0x6d, 0x8d, 0x60, 0xec, 0x9d, 0x58, 0xa8, 0xee, 0xa0, 0x39,
+    0x36, 0xe2, 0xdf, 0x98, 0x30, 0xf0, 0x2c, 0x9a, 0xbd, 0x78, 0xf6, 0x30,
+    0xd3, 0x22, 0x46, 0x19, 0x83, 0xe8, 0xd9, 0x33, 0x14, 0x06, 0x19, 0xa3,
+    0x7c, 0xa1, 0x4b, 0xf4, 0x1a, 0x4d, 0x62, 0x9a, 0xf5, 0xeb, 0xc0, 0xf6,
+    0x0b, 0x02, 0x60, 0x60, 0x10, 0x5b, 0xf4, 0x56, 0x61, 0x3a, 0xd3, 0xc0,
+    0x16, 0xa0, 0x59, 0xdd, 0x80, 0x15, 0xb8, 0xa5, 0x68, 0x08, 0xe4, 0xc6,
+    0x4f, 0x8d, 0x06, 0x1a, 0x68, 0x6b, 0x1d, 0x0e, 0xe4, 0x15, 0xd1, 0x65,
+    0x56, 0xc3, 0x51, 0xde, 0x5c, 0x4b, 0xd1, 0xc0, 0x7a, 0x44, 0x51, 0x4f,
+    0x06, 0xfb, 0xb6, 0x49, 0x90, 0x6e, 0x23, 0xe2, 0xa4, 0xdd, 0xaf, 0x87,
+    0xc5, 0xad, 0x6d, 0x20, 0x40, 0x28, 0x34, 0x12, 0xca, 0xbd, 0x67, 0x63,
+    0x54, 0xe3, 0x94, 0x5d, 0xb8, 0x34, 0x45, 0xfd, 0x67, 0x35, 0xae, 0xaa,
+    0x49, 0xf3, 0xc5, 0xc9, 0xba, 0x4a, 0x67, 0x74, 0x1b, 0x21, 0xf5, 0xb4,
+    0xa2, 0xac, 0x78, 0x54, 0xd3, 0x48, 0xf6, 0x7a, 0x4a, 0xb1, 0xfd, 0xd4,
+    0x5a, 0x45, 0xbf, 0x80, 0xb0, 0xd3, 0xec, 0xca, 0x6b, 0x04, 0xd8, 0xd5,
+    0x4d, 0x74, 0x7a, 0x0a, 0xf7, 0x5a, 0x23, 0x9f, 0x2d, 0x6a, 0xa0, 0x7d,
+    0x96, 0x8b, 0x1a, 0x9b, 0x43, 0xb0, 0x43, 0x12, 0x0e, 0x3b, 0x13, 0xe2,
+    0x36, 0x13, 0xf3, 0x79, 0x95, 0xd3, 0x97, 0x7f, 0x1c, 0x3e, 0xa6, 0x60,
+    0x4d, 0x5b, 0xcb, 0x2b, 0x52, 0x0a, 0x61, 0xc5, 0x7d, 0xae, 0xc3, 0x16,
+    0x78, 0x05, 0x84, 0x8f, 0x8e, 0x5e, 0x76, 0x17, 0x6b, 0x1f, 0x67, 0xbf,
+    0xf6, 0x1c, 0x6f, 0xd5, 0x78, 0x97, 0x9f, 0x1b, 0xb1, 0x58, 0x30, 0xfa,
+    0x77, 0xa5, 0x5a, 0xc2, 0x92, 0xbc, 0xa4, 0xf9, 0xed, 0x4c, 0xc4, 0xd7,
+    0x27, 0xbb, 0x0c, 0x16, 0xfc, 0x52, 0x06, 0x7d, 0x64, 0x78, 0x39, 0xb2,
+    0x1b, 0xcb, 0x2a, 0x68, 0xb1, 0xe6, 0x9a, 0x65, 0xe5, 0xb3, 0x6f, 0x2d,
+    0x95, 0x2b, 0xd7, 0x63, 0x84, 0x4c, 0x70, 0xe6, 0xa6, 0xc7, 0x4e, 0xac,
+    0xef, 0x58, 0xc1, 0xa8, 0x7d, 0xa1, 0x85, 0x0f, 0xae, 0xb3, 0xd2, 0x5f,
+    0xc7, 0x49, 0x61, 0x32, 0xa3, 0x7c, 0x6f, 0xee, 0xd8, 0xb8, 0x25, 0xe6,
+    0x6f, 0xed, 0x20, 0x19, 0x9a, 0x70, 0x27, 0xeb, 0x5c, 0x3f, 0x6a, 0x72,
+    0x4b, 0x6c, 0xa7, 0xc9, 0x41, 0x8d, 0xdc, 0x09, 0x78, 0x13, 0xc6, 0xcf,
+    0x20, 0xef, 0x09, 0xf8, 0xd1, 0xc8, 0x76, 0x98, 0x1c, 0x26, 0x9f, 0xc3,
+    0xbc, 0x54, 0x84, 0xb9, 0xfc, 0x5f, 0xdf, 0x55, 0xe6, 0x20, 0x2b, 0xfb,
+    0xd5, 0xe5, 0x36, 0x45, 0x65, 0x55, 0x14, 0x94, 0x5b, 0x5a, 0x5e, 0x42,
+    0x9f, 0xcb, 0x09, 0x63, 0x33, 0x92, 0xdf, 0x46, 0x67, 0xd8, 0xa7, 0x7d,
+    0xa0, 0xb8, 0x4f, 0xf6, 0x8d, 0x76, 0x64, 0x1e, 0x4c, 0x0c, 0x9c, 0xa1,
+    0x37, 0x3b, 0x0f, 0xe8, 0x40, 0x6e, 0x84, 0x8e, 0x11, 0x87, 0x9e, 0xe6,
+    0x4d, 0xda, 0xbe, 0x00, 0xec, 0xe4, 0x64, 0x66, 0xba, 0xd0, 0x26, 0xb0,
+    0x7e, 0x8f, 0xa0, 0x43, 0x6b, 0x52, 0x71, 0xb5, 0xb5, 0x4b, 0xc6, 0x0a,
+    0xdc, 0x5e, 0x7a, 0x0b, 0x4f, 0x86, 0x36, 0x3d, 0x75, 0x7b, 0x19, 0x4f,
+    0xda, 0x5d, 0xae, 0x76, 0x10, 0x6d, 0x87, 0xf4, 0xff, 0x46, 0xe1, 0xc7,
+    0xe0, 0x6f, 0xa1, 0x79, 0x3c, 0x80, 0xff, 0x9c, 0xd0, 0x2e, 0x15, 0x11,
+    0x23, 0x46, 0x31, 0x8d, 0x42, 0xf5, 0x8b, 0xf2, 0xf9, 0xc6, 0x94, 0x42,
+    0x20, 0x0d, 0x9e, 0xe0, 0x50, 0x84, 0x02, 0xad, 0xfd, 0x5b, 0x9c, 0xdc,
+    0xe8, 0x46, 0xd1, 0xcf, 0x9a, 0x3e, 0x17, 0xf8, 0x09, 0x61, 0x5c, 0x2c,
+    0xe1, 0xc5, 0x40, 0xa5, 0x9c, 0x02, 0xe1, 0xcf, 0x3f, 0x5c, 0x75, 0x3f,
+    0x53, 0xbc, 0x83, 0xab, 0x9c, 0xbd, 0xa7, 0x6c, 0xfc, 0xe2, 0xd0, 0x97,
+    0x56, 0x15, 0xf7, 0xa2, 0xc1, 0xc1, 0x39, 0x63, 0x2c, 0x3a, 0x3b, 0x76,
+    0xb7, 0x91, 0xfd, 0x1b, 0xe8, 0x93, 0xf9, 0x6d, 0xe3, 0xf4, 0xa9, 0x2f,
+    0x9e, 0x4f, 0x3f, 0xbb, 0xed, 0xe8, 0xec, 0x85, 0xcb, 0x44, 0x70, 0xe9,
+    0x16, 0x36, 0x6a, 0xeb, 0x36, 0xea, 0xdc, 0xfe, 0x15, 0xb2, 0x8d, 0xd5,
+    0x3c, 0x0f, 0xf4, 0x0a, 0x5d, 0x56, 0xca, 0x5f, 0xe2, 0x5c, 0x3a, 0x4c,
+    0xfb, 0x87, 0x7f, 0xff, 0x00, 0x2b, 0x7b, 0xaa, 0x4c, 0xa3, 0x12, 0x00,
+    0x00,
+};
+
+enum {
+    WEB_ASSET_THEME_LIGHT_CSS,
+    WEB_ASSET_THEME_DARK_CSS,
+    WEB_ASSET_APP_JS,
+    WEB_ASSET_COUNT
+};
+
+static const struct WebAsset web_assets[WEB_ASSET_COUNT] = {
+    { "/assets/theme-0.css", "text/css", "\"8c297670fe7e841f\"", WEB_ASSET_THEME_LIGHT_CSS_GZ, sizeof(WEB_ASSET_THEME_LIGHT_CSS_GZ), 8830 },
+    { "/assets/theme-1.css", "text/css", "\"bdf4d7e425416588\"", WEB_ASSET_THEME_DARK_CSS_GZ, sizeof(WEB_ASSET_THEME_DARK_CSS_GZ), 8830 },
+    { "/assets/app.js", "application/javascript", "\"5eaa7b19131044a7\"", WEB_ASSET_APP_JS_GZ, sizeof(WEB_ASSET_APP_JS_GZ), 4771 },
+};
+
+#endif /* WEB_ASSETS_H */